@@ -81,6 +81,36 @@ RES _ResourceLoader::load(const String &p_path, const String &p_type_hint, bool
 	return ret;
 }
 
+Error _ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads) {
+
+	return ResourceLoader::load_threaded_request(p_path, p_type_hint, p_use_sub_threads);
+}
+
+_ResourceLoader::ThreadLoadStatus _ResourceLoader::load_threaded_get_status(const String &p_path, Array p_progress) {
+
+	float progress = 0;
+	ThreadLoadStatus status = (ThreadLoadStatus)ResourceLoader::load_threaded_get_status(p_path, &progress);
+
+	if (p_progress.size() < 1) {
+		p_progress.resize(1);
+	}
+	p_progress[0] = progress;
+
+	return status;
+}
+
+RES _ResourceLoader::load_threaded_get(const String &p_path) {
+
+	Error err = OK;
+	RES ret = ResourceLoader::load_threaded_get(p_path, &err);
+
+	if (err != OK) {
+		ERR_EXPLAIN("Error loading resource: '" + p_path + "'");
+		ERR_FAIL_COND_V(err != OK, ret);
+	}
+	return ret;
+}
+
 PoolVector<String> _ResourceLoader::get_recognized_extensions_for_type(const String &p_type) {
 
 	List<String> exts;
@@ -126,6 +156,14 @@ void _ResourceLoader::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_abort_on_missing_resources", "abort"), &_ResourceLoader::set_abort_on_missing_resources);
 	ClassDB::bind_method(D_METHOD("get_dependencies", "path"), &_ResourceLoader::get_dependencies);
 	ClassDB::bind_method(D_METHOD("has", "path"), &_ResourceLoader::has);
+	ClassDB::bind_method(D_METHOD("load_threaded_request", "path", "type_hint", "use_sub_threads"), &_ResourceLoader::load_threaded_request, DEFVAL(""), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("load_threaded_get_status", "path", "progress"), &_ResourceLoader::load_threaded_get_status, DEFVAL(Array()));
+	ClassDB::bind_method(D_METHOD("load_threaded_get", "path"), &_ResourceLoader::load_threaded_get);
+
+	BIND_ENUM_CONSTANT(THREAD_LOAD_INVALID_RESOURCE);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_IN_PROGRESS);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_FAILED);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_LOADED);
 }
 
 _ResourceLoader::_ResourceLoader() {
@@ -2414,6 +2452,120 @@ _Thread::~_Thread() {
 }
 /////////////////////////////////////
 
+_ThreadPool *_ThreadPool::singleton = NULL;
+
+void _ThreadPool::_task_func(void *p_userdata, uint32_t p_index) {
+
+	ScriptTask *task = (ScriptTask *)p_userdata;
+	Object *instance = ObjectDB::get_instance(task->instance);
+	ERR_FAIL_COND(!instance);
+
+	Variant index = p_index;
+	const Variant *args[2] = { &index, &task->userdata };
+	const Variant **argptrs = task->indexed ? args : &args[1];
+	int argcount = task->indexed ? 2 : 1;
+
+	Variant::CallError ce;
+	instance->call(task->method, argptrs, argcount, ce);
+	if (ce.error != Variant::CallError::CALL_OK) {
+		ERR_EXPLAIN("ThreadPool task failed: " + Variant::get_call_error_text(instance, task->method, argptrs, argcount, ce));
+		ERR_FAIL();
+	}
+}
+
+int64_t _ThreadPool::_add_script_task(ScriptTask *p_task, uint32_t p_elements, int p_tasks) {
+
+	ThreadPool::GroupID group = ThreadPool::get_singleton()->add_group_task(_task_func, p_task, p_elements, p_tasks);
+
+	mutex->lock();
+	tasks.set(group, p_task);
+	mutex->unlock();
+
+	return group;
+}
+
+int64_t _ThreadPool::add_task(Object *p_instance, const StringName &p_method, const Variant &p_userdata) {
+
+	ERR_FAIL_COND_V(!p_instance, ThreadPool::INVALID_GROUP_ID);
+	ERR_FAIL_COND_V(p_method == StringName(), ThreadPool::INVALID_GROUP_ID);
+
+	ScriptTask *task = memnew(ScriptTask);
+	task->instance = p_instance->get_instance_id();
+	task->method = p_method;
+	task->userdata = p_userdata;
+	task->indexed = false;
+
+	return _add_script_task(task, 1, 1);
+}
+
+int64_t _ThreadPool::add_group_task(Object *p_instance, const StringName &p_method, int p_elements, const Variant &p_userdata, int p_tasks) {
+
+	ERR_FAIL_COND_V(!p_instance, ThreadPool::INVALID_GROUP_ID);
+	ERR_FAIL_COND_V(p_method == StringName(), ThreadPool::INVALID_GROUP_ID);
+	ERR_FAIL_COND_V(p_elements < 0, ThreadPool::INVALID_GROUP_ID);
+
+	ScriptTask *task = memnew(ScriptTask);
+	task->instance = p_instance->get_instance_id();
+	task->method = p_method;
+	task->userdata = p_userdata;
+	task->indexed = true;
+
+	return _add_script_task(task, p_elements, p_tasks);
+}
+
+bool _ThreadPool::is_group_completed(int64_t p_group) const {
+
+	return ThreadPool::get_singleton()->is_group_completed(p_group);
+}
+
+void _ThreadPool::wait_for_group(int64_t p_group) {
+
+	mutex->lock();
+	ScriptTask **taskp = tasks.getptr(p_group);
+	ScriptTask *task = taskp ? *taskp : NULL;
+	if (task)
+		tasks.erase(p_group);
+	mutex->unlock();
+
+	ERR_FAIL_COND(!task);
+
+	ThreadPool::get_singleton()->wait_for_group(p_group);
+	memdelete(task);
+}
+
+int _ThreadPool::get_thread_count() const {
+
+	return ThreadPool::get_singleton()->get_thread_count();
+}
+
+void _ThreadPool::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("add_task", "instance", "method", "userdata"), &_ThreadPool::add_task, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("add_group_task", "instance", "method", "elements", "userdata", "tasks"), &_ThreadPool::add_group_task, DEFVAL(Variant()), DEFVAL(-1));
+	ClassDB::bind_method(D_METHOD("is_group_completed", "group"), &_ThreadPool::is_group_completed);
+	ClassDB::bind_method(D_METHOD("wait_for_group", "group"), &_ThreadPool::wait_for_group);
+	ClassDB::bind_method(D_METHOD("get_thread_count"), &_ThreadPool::get_thread_count);
+}
+
+_ThreadPool::_ThreadPool() {
+
+	singleton = this;
+	mutex = Mutex::create();
+}
+
+_ThreadPool::~_ThreadPool() {
+
+	const ThreadPool::GroupID *k = NULL;
+	while ((k = tasks.next(k))) {
+		memdelete(tasks[*k]);
+	}
+
+	memdelete(mutex);
+	singleton = NULL;
+}
+
+/////////////////////////////////////
+
 PoolStringArray _ClassDB::get_class_list() const {
 
 	List<StringName> classes;
@@ -40,6 +40,7 @@
 #include "os/os.h"
 #include "os/semaphore.h"
 #include "os/thread.h"
+#include "os/thread_pool.h"
 
 class _ResourceLoader : public Object {
 	GDCLASS(_ResourceLoader, Object);
@@ -49,9 +50,19 @@ protected:
 	static _ResourceLoader *singleton;
 
 public:
+	enum ThreadLoadStatus {
+		THREAD_LOAD_INVALID_RESOURCE,
+		THREAD_LOAD_IN_PROGRESS,
+		THREAD_LOAD_FAILED,
+		THREAD_LOAD_LOADED
+	};
+
 	static _ResourceLoader *get_singleton() { return singleton; }
 	Ref<ResourceInteractiveLoader> load_interactive(const String &p_path, const String &p_type_hint = "");
 	RES load(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false);
+	Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false);
+	ThreadLoadStatus load_threaded_get_status(const String &p_path, Array p_progress = Array());
+	RES load_threaded_get(const String &p_path);
 	PoolVector<String> get_recognized_extensions_for_type(const String &p_type);
 	void set_abort_on_missing_resources(bool p_abort);
 	PoolStringArray get_dependencies(const String &p_path);
@@ -60,6 +71,8 @@ public:
 	_ResourceLoader();
 };
 
+VARIANT_ENUM_CAST(_ResourceLoader::ThreadLoadStatus);
+
 class _ResourceSaver : public Object {
 	GDCLASS(_ResourceSaver, Object);
 
@@ -617,6 +630,41 @@ public:
 
 VARIANT_ENUM_CAST(_Thread::Priority);
 
+class _ThreadPool : public Object {
+
+	GDCLASS(_ThreadPool, Object);
+
+	struct ScriptTask {
+		ObjectID instance;
+		StringName method;
+		Variant userdata;
+		bool indexed;
+	};
+
+	static _ThreadPool *singleton;
+
+	Mutex *mutex;
+	HashMap<ThreadPool::GroupID, ScriptTask *> tasks;
+
+	static void _task_func(void *p_userdata, uint32_t p_index);
+	int64_t _add_script_task(ScriptTask *p_task, uint32_t p_elements, int p_tasks);
+
+protected:
+	static void _bind_methods();
+
+public:
+	static _ThreadPool *get_singleton() { return singleton; }
+
+	int64_t add_task(Object *p_instance, const StringName &p_method, const Variant &p_userdata = Variant());
+	int64_t add_group_task(Object *p_instance, const StringName &p_method, int p_elements, const Variant &p_userdata = Variant(), int p_tasks = -1);
+	bool is_group_completed(int64_t p_group) const;
+	void wait_for_group(int64_t p_group);
+	int get_thread_count() const;
+
+	_ThreadPool();
+	~_ThreadPool();
+};
+
 class _ClassDB : public Object {
 
 	GDCLASS(_ClassDB, Object)
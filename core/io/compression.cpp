@@ -29,7 +29,13 @@
 /*************************************************************************/
 
 #include "compression.h"
+#include "hash_map.h"
+#include "hashfuncs.h"
+#include "map.h"
+#include "marshalls.h"
 #include "os/copymem.h"
+#include "os/mutex.h"
+#include "os/rw_lock.h"
 #include "project_settings.h"
 #include "zip_io.h"
 
@@ -38,7 +44,32 @@
 #include <zlib.h>
 #include <zstd.h>
 
-int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode) {
+struct Compression::Dictionary {
+
+	uint32_t id;
+	Vector<uint8_t> data;
+	ZSTD_DDict *ddict;
+	Mutex *lock;
+	mutable Map<int, ZSTD_CDict *> cdicts; // by level, made the first time one is used
+};
+
+static RWLock *dictionary_lock = NULL;
+static HashMap<uint32_t, Compression::Dictionary *> dictionaries;
+
+static ZSTD_CDict *_get_cdict(const Compression::Dictionary *p_dict, int p_level) {
+
+	MutexLock lock(p_dict->lock);
+
+	Map<int, ZSTD_CDict *>::Element *E = p_dict->cdicts.find(p_level);
+	if (E)
+		return E->get();
+
+	ZSTD_CDict *cdict = ZSTD_createCDict(p_dict->data.ptr(), p_dict->data.size(), p_level);
+	p_dict->cdicts[p_level] = cdict;
+	return cdict;
+}
+
+int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode, int p_level, const Dictionary *p_dict) {
 
 	switch (p_mode) {
 		case MODE_FASTLZ: {
@@ -62,7 +93,7 @@ int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size,
 			strm.zalloc = zipio_alloc;
 			strm.zfree = zipio_free;
 			strm.opaque = Z_NULL;
-			int level = p_mode == MODE_DEFLATE ? zlib_level : gzip_level;
+			int level = p_level >= 0 ? p_level : (p_mode == MODE_DEFLATE ? zlib_level : gzip_level);
 			int err = deflateInit2(&strm, level, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY);
 			if (err != Z_OK)
 				return -1;
@@ -79,14 +110,20 @@ int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size,
 
 		} break;
 		case MODE_ZSTD: {
+			int level = p_level >= 0 ? p_level : zstd_level;
+			int max_dst_size = get_max_compressed_buffer_size(p_src_size, MODE_ZSTD);
 			ZSTD_CCtx *cctx = ZSTD_createCCtx();
-			ZSTD_CCtx_setParameter(cctx, ZSTD_p_compressionLevel, zstd_level);
-			if (zstd_long_distance_matching) {
-				ZSTD_CCtx_setParameter(cctx, ZSTD_p_enableLongDistanceMatching, 1);
-				ZSTD_CCtx_setParameter(cctx, ZSTD_p_windowLog, zstd_window_log_size);
+			int ret;
+			if (p_dict) {
+				ret = ZSTD_compress_usingCDict(cctx, p_dst, max_dst_size, p_src, p_src_size, _get_cdict(p_dict, level));
+			} else {
+				ZSTD_CCtx_setParameter(cctx, ZSTD_p_compressionLevel, level);
+				if (zstd_long_distance_matching) {
+					ZSTD_CCtx_setParameter(cctx, ZSTD_p_enableLongDistanceMatching, 1);
+					ZSTD_CCtx_setParameter(cctx, ZSTD_p_windowLog, zstd_window_log_size);
+				}
+				ret = ZSTD_compressCCtx(cctx, p_dst, max_dst_size, p_src, p_src_size, level);
 			}
-			int max_dst_size = get_max_compressed_buffer_size(p_src_size, MODE_ZSTD);
-			int ret = ZSTD_compressCCtx(cctx, p_dst, max_dst_size, p_src, p_src_size, zstd_level);
 			ZSTD_freeCCtx(cctx);
 			return ret;
 		} break;
@@ -131,7 +168,7 @@ int Compression::get_max_compressed_buffer_size(int p_src_size, Mode p_mode) {
 	ERR_FAIL_V(-1);
 }
 
-int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode) {
+int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode, const Dictionary *p_dict) {
 
 	switch (p_mode) {
 		case MODE_FASTLZ: {
@@ -175,7 +212,12 @@ int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p
 		case MODE_ZSTD: {
 			ZSTD_DCtx *dctx = ZSTD_createDCtx();
 			if (zstd_long_distance_matching) ZSTD_DCtx_setMaxWindowSize(dctx, 1 << zstd_window_log_size);
-			int ret = ZSTD_decompressDCtx(dctx, p_dst, p_dst_max_size, p_src, p_src_size);
+			int ret;
+			if (p_dict) {
+				ret = ZSTD_decompress_usingDDict(dctx, p_dst, p_dst_max_size, p_src, p_src_size, p_dict->ddict);
+			} else {
+				ret = ZSTD_decompressDCtx(dctx, p_dst, p_dst_max_size, p_src, p_src_size);
+			}
 			ZSTD_freeDCtx(dctx);
 			return ret;
 		} break;
@@ -184,6 +226,216 @@ int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p
 	ERR_FAIL_V(-1);
 }
 
+// Builds a raw content dictionary, a simplified take on the COVER algorithm
+// zstd's own trainer uses: the samples are split in as many epochs as the
+// dictionary has segments, and from each epoch the segment whose 8 byte
+// sequences appear in the most samples is kept. The best segments go last,
+// where matches are cheapest to encode.
+
+#define DICT_DMER_SIZE 8
+#define DICT_SEGMENT_SIZE 256
+#define DICT_TABLE_BITS 20
+
+static _FORCE_INLINE_ uint32_t _dmer_hash(const uint8_t *p_data) {
+
+	uint64_t v;
+	copymem(&v, p_data, DICT_DMER_SIZE);
+	return (v * 0x9E3779B97F4A7C15ULL) >> (64 - DICT_TABLE_BITS);
+}
+
+struct _DictSegment {
+
+	const uint8_t *data;
+	int size;
+	uint64_t score;
+
+	bool operator<(const _DictSegment &p_segment) const {
+		return score < p_segment.score;
+	}
+};
+
+Vector<uint8_t> Compression::train_dictionary(const Vector<Vector<uint8_t> > &p_samples, int p_max_size) {
+
+	Vector<uint8_t> dict;
+	ERR_FAIL_COND_V(p_max_size < DICT_SEGMENT_SIZE, dict);
+
+	int64_t total = 0;
+	for (int i = 0; i < p_samples.size(); i++) {
+		total += p_samples[i].size();
+	}
+	ERR_FAIL_COND_V(total == 0, dict);
+
+	// in how many samples each sequence appears
+	Vector<uint32_t> freq;
+	Vector<uint32_t> seen;
+	freq.resize(1 << DICT_TABLE_BITS);
+	seen.resize(1 << DICT_TABLE_BITS);
+	uint32_t *f = freq.ptrw();
+	uint32_t *w = seen.ptrw();
+	for (int i = 0; i < (1 << DICT_TABLE_BITS); i++) {
+		f[i] = 0;
+		w[i] = 0xFFFFFFFF;
+	}
+
+	for (int i = 0; i < p_samples.size(); i++) {
+		const uint8_t *data = p_samples[i].ptr();
+		for (int j = 0; j + DICT_DMER_SIZE <= p_samples[i].size(); j++) {
+			uint32_t h = _dmer_hash(&data[j]);
+			if (w[h] != uint32_t(i)) {
+				w[h] = i;
+				f[h]++;
+			}
+		}
+	}
+
+	int segment_count = p_max_size / DICT_SEGMENT_SIZE;
+	int64_t epoch_size = MAX(total / segment_count, int64_t(1));
+	Vector<_DictSegment> segments;
+
+	int sample = 0;
+	int64_t sample_start = 0;
+
+	for (int e = 0; e < segment_count && sample < p_samples.size(); e++) {
+
+		int64_t epoch_end = e == segment_count - 1 ? total : (e + 1) * epoch_size;
+
+		_DictSegment best;
+		best.data = NULL;
+		best.size = 0;
+		best.score = 0;
+
+		// windows start inside the epoch and stay inside their sample
+		while (sample < p_samples.size() && sample_start < epoch_end) {
+
+			const uint8_t *data = p_samples[sample].ptr();
+			int size = p_samples[sample].size();
+			int from = MAX(int64_t(e) * epoch_size - sample_start, int64_t(0));
+			int to = MIN(epoch_end - sample_start, int64_t(size));
+			int last_dmer = size - DICT_DMER_SIZE; // last position a sequence starts at
+
+			uint64_t score = 0;
+			for (int j = from; j <= MIN(from + DICT_SEGMENT_SIZE - DICT_DMER_SIZE, last_dmer); j++) {
+				score += f[_dmer_hash(&data[j])];
+			}
+
+			for (int j = from; j < to; j++) {
+
+				if (score > best.score) {
+					best.data = &data[j];
+					best.size = MIN(DICT_SEGMENT_SIZE, size - j);
+					best.score = score;
+				}
+
+				// slide the window one byte
+				if (j <= last_dmer)
+					score -= f[_dmer_hash(&data[j])];
+				int in = j + 1 + DICT_SEGMENT_SIZE - DICT_DMER_SIZE;
+				if (in <= last_dmer)
+					score += f[_dmer_hash(&data[in])];
+			}
+
+			if (sample_start + size > epoch_end)
+				break; //the sample goes on in the next epoch
+
+			sample_start += size;
+			sample++;
+		}
+
+		if (!best.data)
+			continue;
+
+		//what a segment covers is worth nothing to the next ones
+		for (int j = 0; j + DICT_DMER_SIZE <= best.size; j++) {
+			f[_dmer_hash(&best.data[j])] = 0;
+		}
+		segments.push_back(best);
+	}
+
+	segments.sort();
+
+	for (int i = 0; i < segments.size(); i++) {
+		int ofs = dict.size();
+		dict.resize(ofs + segments[i].size);
+		copymem(&dict.ptrw()[ofs], segments[i].data, segments[i].size);
+	}
+
+	//a raw dictionary must not look like a zstd one
+	while (dict.size() >= 4 && decode_uint32(dict.ptr()) == ZSTD_MAGIC_DICTIONARY) {
+		dict.remove(0);
+	}
+
+	return dict;
+}
+
+uint32_t Compression::get_dictionary_id(const Vector<uint8_t> &p_dictionary) {
+
+	uint32_t id = hash_djb2_buffer(p_dictionary.ptr(), p_dictionary.size()) & 0xFFFFFF;
+	return id ? id : 1;
+}
+
+uint32_t Compression::add_dictionary(const Vector<uint8_t> &p_dictionary) {
+
+	ERR_FAIL_COND_V(p_dictionary.size() < 8, 0);
+
+	uint32_t id = get_dictionary_id(p_dictionary);
+
+	RWLockWrite lock(dictionary_lock);
+
+	Dictionary **existing = dictionaries.getptr(id);
+	if (existing) {
+		//the id is only a hash, data compressed with one must never be read with the other
+		const Vector<uint8_t> &data = (*existing)->data;
+		bool same = data.size() == p_dictionary.size() && memcmp(data.ptr(), p_dictionary.ptr(), data.size()) == 0;
+		ERR_EXPLAIN("A different compression dictionary with the same id (" + itos(id) + ") was already added");
+		ERR_FAIL_COND_V(!same, 0);
+
+	} else {
+
+		Dictionary *dict = memnew(Dictionary);
+		dict->id = id;
+		dict->data = p_dictionary;
+		dict->ddict = ZSTD_createDDict(p_dictionary.ptr(), p_dictionary.size());
+		dict->lock = Mutex::create();
+		dictionaries.set(id, dict);
+	}
+
+	return id;
+}
+
+const Compression::Dictionary *Compression::get_dictionary(uint32_t p_id) {
+
+	RWLockRead lock(dictionary_lock);
+
+	Dictionary **dict = dictionaries.getptr(p_id);
+	return dict ? *dict : NULL;
+}
+
+void Compression::setup() {
+
+	dictionary_lock = RWLock::create();
+}
+
+void Compression::cleanup() {
+
+	const uint32_t *K = NULL;
+	while ((K = dictionaries.next(K))) {
+
+		Dictionary *dict = dictionaries[*K];
+		for (Map<int, ZSTD_CDict *>::Element *E = dict->cdicts.front(); E; E = E->next()) {
+			ZSTD_freeCDict(E->get());
+		}
+		ZSTD_freeDDict(dict->ddict);
+		memdelete(dict->lock);
+		memdelete(dict);
+	}
+	dictionaries.clear();
+
+	if (dictionary_lock) {
+		memdelete(dictionary_lock);
+		dictionary_lock = NULL;
+	}
+}
+
 int Compression::zlib_level = Z_DEFAULT_COMPRESSION;
 int Compression::gzip_level = Z_DEFAULT_COMPRESSION;
 int Compression::zstd_level = 3;
@@ -32,6 +32,7 @@
 #define COMPRESSION_H
 
 #include "typedefs.h"
+#include "vector.h"
 
 class Compression {
 
@@ -49,9 +50,20 @@ public:
 		MODE_GZIP
 	};
 
-	static int compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD);
+	struct Dictionary; // zstd dictionary, ready to use
+
+	// p_level overrides the level of the mode, -1 uses the project setting. Dictionaries only apply to MODE_ZSTD.
+	static int compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD, int p_level = -1, const Dictionary *p_dict = NULL);
 	static int get_max_compressed_buffer_size(int p_src_size, Mode p_mode = MODE_ZSTD);
-	static int decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD);
+	static int decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD, const Dictionary *p_dict = NULL);
+
+	static Vector<uint8_t> train_dictionary(const Vector<Vector<uint8_t> > &p_samples, int p_max_size);
+	static uint32_t get_dictionary_id(const Vector<uint8_t> &p_dictionary); ///< 24 bits, never 0
+	static uint32_t add_dictionary(const Vector<uint8_t> &p_dictionary); ///< returns the id, or 0 if a different dictionary has it, dictionaries stay until cleanup()
+	static const Dictionary *get_dictionary(uint32_t p_id);
+
+	static void setup();
+	static void cleanup();
 
 	Compression();
 };
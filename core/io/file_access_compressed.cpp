@@ -29,8 +29,9 @@
 /*************************************************************************/
 
 #include "file_access_compressed.h"
+#include "os/copymem.h"
 #include "print_string.h"
-void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, int p_block_size) {
+void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, int p_block_size, int p_level, uint32_t p_dictionary) {
 
 	magic = p_magic.ascii().get_data();
 	if (magic.length() > 4)
@@ -42,6 +43,158 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 
 	cmode = p_mode;
 	block_size = p_block_size;
+	level = p_level;
+	dictionary_id = 0;
+	dictionary = NULL;
+
+	if (p_dictionary) {
+		ERR_EXPLAIN("Compression dictionaries need MODE_ZSTD");
+		ERR_FAIL_COND(p_mode != Compression::MODE_ZSTD);
+		dictionary = Compression::get_dictionary(p_dictionary);
+		ERR_EXPLAIN("Unknown compression dictionary: " + itos(p_dictionary));
+		ERR_FAIL_COND(!dictionary);
+		dictionary_id = p_dictionary;
+	}
+}
+
+void FileAccessCompressed::set_read_ahead(int p_blocks) {
+
+	_discard_window(windows[0]);
+	_discard_window(windows[1]);
+	read_ahead = MAX(p_blocks, 0);
+	sequential_blocks = 0;
+}
+
+void FileAccessCompressed::BlockRun::decompress(uint32_t p_index, int p_unused) {
+
+	const int *offsets = comp_offsets.ptr();
+	Compression::decompress(dst + size_t(p_index) * block_size, sizes.ptr()[p_index], comp.ptr() + offsets[p_index], offsets[p_index + 1] - offsets[p_index], mode, dictionary);
+}
+
+int FileAccessCompressed::_get_block_size(int p_block) const {
+
+	return p_block == read_block_count - 1 ? read_total % block_size : block_size;
+}
+
+void FileAccessCompressed::_fetch_run(BlockRun &r_run, int p_first, int p_count) const {
+
+	// blocks are stored one after the other, read them all at once
+	int from = read_blocks[p_first].offset;
+	int to = read_blocks[p_first + p_count - 1].offset + read_blocks[p_first + p_count - 1].csize;
+
+	r_run.mode = cmode;
+	r_run.dictionary = dictionary;
+	r_run.first = p_first;
+	r_run.count = p_count;
+	r_run.block_size = block_size;
+	r_run.comp.resize(to - from);
+	r_run.comp_offsets.resize(p_count + 1);
+	r_run.sizes.resize(p_count);
+
+	for (int i = 0; i < p_count; i++) {
+		r_run.comp_offsets[i] = read_blocks[p_first + i].offset - from;
+		r_run.sizes[i] = _get_block_size(p_first + i);
+	}
+	r_run.comp_offsets[p_count] = to - from;
+
+	f->seek(from);
+	f->get_buffer(r_run.comp.ptrw(), to - from);
+}
+
+void FileAccessCompressed::_fetch_window(ReadAheadWindow &r_window, int p_first) const {
+
+	int count = MIN(read_ahead, read_block_count - p_first);
+
+	r_window.data.resize(count * block_size);
+	_fetch_run(r_window.run, p_first, count);
+	r_window.run.dst = r_window.data.ptrw();
+	r_window.group = ThreadPool::get_singleton()->add_template_group_task(&r_window.run, &BlockRun::decompress, 0, count);
+}
+
+void FileAccessCompressed::_discard_window(ReadAheadWindow &r_window) const {
+
+	if (r_window.group != ThreadPool::INVALID_GROUP_ID) {
+		ThreadPool::get_singleton()->wait_for_group(r_window.group);
+		r_window.group = ThreadPool::INVALID_GROUP_ID;
+	}
+	r_window.run.count = 0;
+}
+
+void FileAccessCompressed::_read_block(int p_block) const {
+
+	if (read_ahead > 0) {
+
+		ReadAheadWindow *current = NULL;
+		ReadAheadWindow *next = NULL;
+
+		for (int i = 0; i < 2; i++) {
+			const BlockRun &run = windows[i].run;
+			if (run.count && p_block >= run.first && p_block < run.first + run.count) {
+				current = &windows[i];
+				next = &windows[1 - i];
+			}
+		}
+
+		sequential_blocks = p_block == read_block + 1 ? sequential_blocks + 1 : 0;
+
+		if (!current && sequential_blocks >= 2) {
+			//reading front to back, start reading ahead
+			_discard_window(windows[0]);
+			_discard_window(windows[1]);
+			_fetch_window(windows[0], p_block);
+			current = &windows[0];
+			next = &windows[1];
+		}
+
+		if (current) {
+
+			if (current->group != ThreadPool::INVALID_GROUP_ID) {
+				ThreadPool::get_singleton()->wait_for_group(current->group);
+				current->group = ThreadPool::INVALID_GROUP_ID;
+			}
+
+			//start on the next window while this one is read
+			int next_first = current->run.first + current->run.count;
+			if (next_first < read_block_count && (next->run.count == 0 || next->run.first != next_first)) {
+				_discard_window(*next);
+				_fetch_window(*next, next_first);
+			}
+
+			read_ptr = current->data.ptrw() + (p_block - current->run.first) * block_size;
+			read_block = p_block;
+			read_block_size = _get_block_size(p_block);
+			return;
+		}
+
+		//a seek elsewhere, read just this block
+	}
+
+	f->seek(read_blocks[p_block].offset);
+	f->get_buffer(comp_buffer.ptrw(), read_blocks[p_block].csize);
+	Compression::decompress(buffer.ptrw(), block_size, comp_buffer.ptr(), read_blocks[p_block].csize, cmode, dictionary);
+	read_ptr = buffer.ptrw();
+	read_block = p_block;
+	read_block_size = _get_block_size(p_block);
+}
+
+bool FileAccessCompressed::_enter_block(int p_block) const {
+
+	if (p_block >= read_block_count || _get_block_size(p_block) == 0)
+		return false;
+
+	_read_block(p_block);
+	read_pos = 0;
+	return true;
+}
+
+void FileAccessCompressed::_decompress_blocks(int p_first, int p_count, uint8_t *p_dst) const {
+
+	BlockRun run;
+	_fetch_run(run, p_first, p_count);
+	run.dst = p_dst;
+
+	ThreadPool::GroupID group = ThreadPool::get_singleton()->add_template_group_task(&run, &BlockRun::decompress, 0, p_count);
+	ThreadPool::get_singleton()->wait_for_group(group);
 }
 
 #define WRITE_FIT(m_bytes)                                  \
@@ -59,7 +212,18 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 Error FileAccessCompressed::open_after_magic(FileAccess *p_base) {
 
 	f = p_base;
-	cmode = (Compression::Mode)f->get_32();
+	uint32_t mode = f->get_32();
+	cmode = (Compression::Mode)(mode & 0xFF);
+	dictionary_id = mode >> 8;
+	dictionary = NULL;
+	if (dictionary_id) {
+		dictionary = Compression::get_dictionary(dictionary_id);
+		if (!dictionary) {
+			f = NULL;
+			ERR_EXPLAIN("File was compressed with a dictionary that is not loaded: " + itos(dictionary_id));
+			ERR_FAIL_V(ERR_FILE_UNRECOGNIZED);
+		}
+	}
 	block_size = f->get_32();
 	read_total = f->get_32();
 	int bc = (read_total / block_size) + 1;
@@ -78,16 +242,17 @@ Error FileAccessCompressed::open_after_magic(FileAccess *p_base) {
 	comp_buffer.resize(max_bs);
 	buffer.resize(block_size);
 	read_ptr = buffer.ptrw();
-	f->get_buffer(comp_buffer.ptrw(), read_blocks[0].csize);
 	at_end = false;
 	read_eof = false;
 	read_block_count = bc;
-	read_block_size = read_blocks.size() == 1 ? read_total : block_size;
-
-	Compression::decompress(buffer.ptrw(), read_block_size, comp_buffer.ptr(), read_blocks[0].csize, cmode);
 	read_block = 0;
+	read_block_size = 0;
 	read_pos = 0;
 
+	if (!_enter_block(0)) {
+		at_end = true; //empty file
+	}
+
 	return OK;
 }
 
@@ -129,7 +294,12 @@ Error FileAccessCompressed::_open(const String &p_path, int p_mode_flags) {
 			return ERR_FILE_UNRECOGNIZED;
 		}
 
-		open_after_magic(f);
+		FileAccess *base = f;
+		err = open_after_magic(base);
+		if (err != OK) {
+			memdelete(base);
+			return err;
+		}
 	}
 
 	return OK;
@@ -144,7 +314,7 @@ void FileAccessCompressed::close() {
 
 		CharString mgc = magic.utf8();
 		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //write header 4
-		f->store_32(cmode); //write compression mode 4
+		f->store_32(cmode | (dictionary_id << 8)); //write compression mode and dictionary 4
 		f->store_32(block_size); //write block size 4
 		f->store_32(write_max); //max amount of data written 4
 		int bc = (write_max / block_size) + 1;
@@ -161,7 +331,7 @@ void FileAccessCompressed::close() {
 
 			Vector<uint8_t> cblock;
 			cblock.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
-			int s = Compression::compress(cblock.ptrw(), bp, bl, cmode);
+			int s = Compression::compress(cblock.ptrw(), bp, bl, cmode, level, dictionary);
 
 			f->store_buffer(cblock.ptr(), s);
 			block_sizes.push_back(s);
@@ -177,6 +347,10 @@ void FileAccessCompressed::close() {
 
 	} else {
 
+		_discard_window(windows[0]);
+		_discard_window(windows[1]);
+		windows[0].data.clear();
+		windows[1].data.clear();
 		comp_buffer.clear();
 		buffer.clear();
 		read_blocks.clear();
@@ -203,18 +377,15 @@ void FileAccessCompressed::seek(size_t p_position) {
 	} else {
 
 		ERR_FAIL_COND(p_position > read_total);
+		read_eof = false;
 		if (p_position == read_total) {
 			at_end = true;
 		} else {
 
+			at_end = false;
 			int block_idx = p_position / block_size;
 			if (block_idx != read_block) {
-
-				read_block = block_idx;
-				f->seek(read_blocks[read_block].offset);
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				_read_block(block_idx);
 			}
 
 			read_pos = p_position % block_size;
@@ -241,7 +412,7 @@ size_t FileAccessCompressed::get_position() const {
 		return write_pos;
 	} else {
 
-		return read_block * block_size + read_pos;
+		return at_end ? read_total : read_block * block_size + read_pos;
 	}
 }
 size_t FileAccessCompressed::get_len() const {
@@ -278,21 +449,8 @@ uint8_t FileAccessCompressed::get_8() const {
 	uint8_t ret = read_ptr[read_pos];
 
 	read_pos++;
-	if (read_pos >= read_block_size) {
-		read_block++;
-
-		if (read_block < read_block_count) {
-			//read another block of compressed data
-			f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-			Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-			read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-			read_pos = 0;
-
-		} else {
-			read_block--;
-			at_end = true;
-			ret = 0;
-		}
+	if (read_pos >= read_block_size && !_enter_block(read_block + 1)) {
+		at_end = true;
 	}
 
 	return ret;
@@ -307,27 +465,32 @@ int FileAccessCompressed::get_buffer(uint8_t *p_dst, int p_length) const {
 		return 0;
 	}
 
-	for (int i = 0; i < p_length; i++) {
-
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
-		if (read_pos >= read_block_size) {
-			read_block++;
-
-			if (read_block < read_block_count) {
-				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-				read_pos = 0;
-
-			} else {
-				read_block--;
-				at_end = true;
-				if (i < p_length - 1)
-					read_eof = true;
-				return i;
-			}
+	int dst_pos = 0;
+
+	while (dst_pos < p_length) {
+
+		int amount = MIN(read_block_size - read_pos, p_length - dst_pos);
+		copymem(&p_dst[dst_pos], &read_ptr[read_pos], amount);
+		dst_pos += amount;
+		read_pos += amount;
+
+		if (read_pos < read_block_size)
+			break;
+
+		//the block is used up, decompress the whole ones that follow straight into the destination, in parallel
+		int next = read_block + 1;
+		int whole = MIN((p_length - dst_pos) / int(block_size), read_block_count - 1 - next);
+		if (whole >= 2) {
+			_decompress_blocks(next, whole, &p_dst[dst_pos]);
+			dst_pos += whole * block_size;
+			next += whole;
+		}
+
+		if (!_enter_block(next)) {
+			at_end = true;
+			if (dst_pos < p_length)
+				read_eof = true;
+			return dst_pos;
 		}
 	}
 
@@ -377,6 +540,9 @@ FileAccessCompressed::FileAccessCompressed() {
 	f = NULL;
 	magic = "GCMP";
 	cmode = Compression::MODE_ZSTD;
+	level = -1;
+	dictionary_id = 0;
+	dictionary = NULL;
 	writing = false;
 	write_ptr = 0;
 	write_buffer_size = 0;
@@ -390,6 +556,12 @@ FileAccessCompressed::FileAccessCompressed() {
 	read_block_count = 0;
 	read_block_size = 0;
 	read_pos = 0;
+	read_ahead = 0;
+	sequential_blocks = 0;
+	for (int i = 0; i < 2; i++) {
+		windows[i].run.count = 0;
+		windows[i].group = ThreadPool::INVALID_GROUP_ID;
+	}
 }
 
 FileAccessCompressed::~FileAccessCompressed() {
@@ -33,10 +33,14 @@
 
 #include "io/compression.h"
 #include "os/file_access.h"
+#include "os/thread_pool.h"
 
 class FileAccessCompressed : public FileAccess {
 
 	Compression::Mode cmode;
+	int level;
+	uint32_t dictionary_id; // stored above the mode, 0 when not using one
+	const Compression::Dictionary *dictionary;
 	bool writing;
 	uint32_t write_pos;
 	uint8_t *write_ptr;
@@ -51,8 +55,43 @@ class FileAccessCompressed : public FileAccess {
 		int offset;
 	};
 
+	// Decompresses a run of consecutive blocks, one per thread pool element.
+	struct BlockRun {
+		Compression::Mode mode;
+		const Compression::Dictionary *dictionary;
+		int first;
+		int count;
+		Vector<uint8_t> comp; // compressed blocks, as stored in the file
+		Vector<int> comp_offsets;
+		Vector<int> sizes;
+		uint8_t *dst; // blocks are block_size apart
+		int block_size;
+
+		void decompress(uint32_t p_index, int p_unused);
+	};
+
+	// Read ahead: while the blocks of one window are read, the next window
+	// is decompressed on the thread pool.
+	struct ReadAheadWindow {
+		BlockRun run;
+		Vector<uint8_t> data;
+		ThreadPool::GroupID group;
+	};
+
+	mutable ReadAheadWindow windows[2];
+	int read_ahead;
+	mutable int sequential_blocks; // blocks read in order since the last seek
+
+	int _get_block_size(int p_block) const;
+	void _fetch_run(BlockRun &r_run, int p_first, int p_count) const;
+	void _fetch_window(ReadAheadWindow &r_window, int p_first) const;
+	void _discard_window(ReadAheadWindow &r_window) const;
+	void _read_block(int p_block) const;
+	bool _enter_block(int p_block) const;
+	void _decompress_blocks(int p_first, int p_count, uint8_t *p_dst) const;
+
 	mutable Vector<uint8_t> comp_buffer;
-	uint8_t *read_ptr;
+	mutable uint8_t *read_ptr;
 	mutable int read_block;
 	int read_block_count;
 	mutable int read_block_size;
@@ -65,7 +104,9 @@ class FileAccessCompressed : public FileAccess {
 	FileAccess *f;
 
 public:
-	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, int p_block_size = 4096);
+	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, int p_block_size = 4096, int p_level = -1, uint32_t p_dictionary = 0); ///< p_dictionary must be added to Compression, readers need it too
+	uint32_t get_dictionary_id() const { return dictionary_id; }
+	void set_read_ahead(int p_blocks); ///< decompress the next blocks on worker threads, in windows of p_blocks, 0 to disable
 
 	Error open_after_magic(FileAccess *p_base);
 
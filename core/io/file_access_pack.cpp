@@ -29,12 +29,13 @@
 /*************************************************************************/
 
 #include "file_access_pack.h"
+#include "io/compression.h"
+#include "io/marshalls.h"
+#include "os/os.h"
 #include "version.h"
 
 #include <stdio.h>
 
-#define PACK_VERSION 1
-
 Error PackedData::add_pack(const String &p_path) {
 
 	for (int i = 0; i < sources.size(); i++) {
@@ -53,7 +54,15 @@ void PackedData::add_path(const String &pkg_path, const String &path, uint64_t o
 	PathMD5 pmd5(path.md5_buffer());
 	//printf("adding path %ls, %lli, %lli\n", path.c_str(), pmd5.a, pmd5.b);
 
-	bool exists = files.has(pmd5);
+	if (layers.empty() || layers[layers.size() - 1]->indexed) {
+		PackedLayer *layer = memnew(PackedLayer);
+		layer->indexed = false;
+		layer->in_tree = false;
+		layers.push_back(layer);
+	}
+	PackedLayer *layer = layers[layers.size() - 1];
+
+	bool exists = layer->files.has(pmd5);
 
 	PackedFile pf;
 	pf.pack = pkg_path;
@@ -63,37 +72,235 @@ void PackedData::add_path(const String &pkg_path, const String &path, uint64_t o
 		pf.md5[i] = p_md5[i];
 	pf.src = p_src;
 
-	files[pmd5] = pf;
+	layer->files[pmd5] = pf;
 
 	if (!exists) {
-		//search for dir
-		String p = path.replace_first("res://", "");
-		PackedDir *cd = root;
+		layer->new_paths.push_back(path);
+	}
+}
 
-		if (p.find("/") != -1) { //in a subdir
+void PackedData::add_index(const PackedIndex &p_index) {
 
-			Vector<String> ds = p.get_base_dir().split("/");
+	PackedLayer *layer = memnew(PackedLayer);
+	layer->indexed = true;
+	layer->in_tree = false;
+	layer->index = p_index;
+	layers.push_back(layer);
+}
 
-			for (int j = 0; j < ds.size(); j++) {
+static int _index_find(const uint8_t *p_entries, uint32_t p_count, const uint8_t *p_path_md5) {
 
-				if (!cd->subdirs.has(ds[j])) {
+	int low = 0;
+	int high = int(p_count) - 1;
 
-					PackedDir *pd = memnew(PackedDir);
-					pd->name = ds[j];
-					pd->parent = cd;
-					cd->subdirs[pd->name] = pd;
-					cd = pd;
-				} else {
-					cd = cd->subdirs[ds[j]];
-				}
+	while (low <= high) {
+
+		int middle = (low + high) / 2;
+		int cmp = memcmp(p_path_md5, p_entries + size_t(middle) * PACK_INDEX_ENTRY_SIZE, 16);
+		if (cmp < 0) {
+			high = middle - 1;
+		} else if (cmp > 0) {
+			low = middle + 1;
+		} else {
+			return middle;
+		}
+	}
+
+	return -1;
+}
+
+bool PackedData::_find_path(const String &p_path, PackedFile *r_file) const {
+
+	Vector<uint8_t> md5 = p_path.md5_buffer();
+	PathMD5 pmd5(md5);
+
+	for (int i = layers.size() - 1; i >= 0; i--) {
+
+		const PackedLayer *layer = layers[i];
+
+		if (!layer->indexed) {
+
+			const PackedFile *pf = layer->files.getptr(pmd5);
+			if (!pf)
+				continue;
+			if (r_file)
+				*r_file = *pf;
+			return true;
+		}
+
+		const PackedIndex &index = layer->index;
+		int idx = _index_find(index.entries, index.count, md5.ptr());
+		if (idx < 0)
+			continue;
+
+		if (r_file) {
+			const uint8_t *entry = index.entries + size_t(idx) * PACK_INDEX_ENTRY_SIZE;
+			r_file->pack = index.pack;
+			r_file->offset = decode_uint64(&entry[16]);
+			r_file->size = decode_uint64(&entry[24]);
+			copymem(r_file->md5, &entry[32], 16);
+			r_file->src = index.src;
+		}
+		return true;
+	}
+
+	return false;
+}
+
+String PackedData::_get_index_path(const PackedIndex &p_index, const uint8_t *p_entry, FileAccess *p_file) {
+
+	uint64_t ofs = p_index.start + decode_uint64(&p_entry[48]);
+
+	if (p_index.data) {
+
+		ERR_FAIL_COND_V(ofs + 4 > p_index.data_size, String());
+		uint32_t len = decode_uint32(&p_index.data[ofs]);
+		ERR_FAIL_COND_V(ofs + 4 + len > p_index.data_size, String());
+
+		String path;
+		path.parse_utf8((const char *)&p_index.data[ofs + 4], len);
+		return path;
+	}
+
+	ERR_FAIL_COND_V(!p_file, String());
+	p_file->seek(ofs);
+	uint32_t len = p_file->get_32();
+	ERR_FAIL_COND_V(ofs + 4 + len > p_file->get_len(), String());
+
+	CharString cs;
+	cs.resize(len + 1);
+	p_file->get_buffer((uint8_t *)cs.ptr(), len);
+	cs[len] = 0;
+
+	String path;
+	path.parse_utf8(cs.ptr());
+	return path;
+}
+
+void PackedData::_add_to_tree(const String &p_path) {
+
+	//search for dir
+	String p = p_path.replace_first("res://", "");
+	PackedDir *cd = root;
+
+	if (p.find("/") != -1) { //in a subdir
+
+		Vector<String> ds = p.get_base_dir().split("/");
+
+		for (int j = 0; j < ds.size(); j++) {
+
+			if (!cd->subdirs.has(ds[j])) {
+
+				PackedDir *pd = memnew(PackedDir);
+				pd->name = ds[j];
+				pd->parent = cd;
+				cd->subdirs[pd->name] = pd;
+				cd = pd;
+			} else {
+				cd = cd->subdirs[ds[j]];
 			}
 		}
-		String filename = path.get_file();
-		// Don't add as a file if the path points to a directoryy
-		if (!filename.empty()) {
-			cd->files.insert(filename);
+	}
+	String filename = p_path.get_file();
+	// Don't add as a file if the path points to a directoryy
+	if (!filename.empty()) {
+		cd->files.insert(filename);
+	}
+}
+
+PackedData::PackedDir *PackedData::_get_root() {
+
+	MutexLock lock(root_lock);
+
+	for (int i = 0; i < layers.size(); i++) {
+
+		PackedLayer *layer = layers[i];
+
+		if (!layer->indexed) {
+
+			for (int j = 0; j < layer->new_paths.size(); j++) {
+				_add_to_tree(layer->new_paths[j]);
+			}
+			layer->new_paths.clear();
+
+		} else if (!layer->in_tree) {
+
+			const PackedIndex &index = layer->index;
+			FileAccess *f = NULL;
+			if (!index.data) {
+				f = FileAccess::open(index.pack, FileAccess::READ);
+				ERR_CONTINUE(!f);
+			}
+
+			for (uint32_t j = 0; j < index.count; j++) {
+
+				String path = _get_index_path(index, index.entries + size_t(j) * PACK_INDEX_ENTRY_SIZE, f);
+				if (path != String()) {
+					_add_to_tree(path);
+				}
+			}
+
+			if (f) {
+				memdelete(f);
+			}
+			layer->in_tree = true;
 		}
 	}
+
+	return root;
+}
+
+struct _PackIndexRecord {
+
+	uint8_t data[PACK_INDEX_ENTRY_SIZE];
+
+	bool operator<(const _PackIndexRecord &p_record) const {
+		return memcmp(data, p_record.data, 16) < 0;
+	}
+};
+
+void PackedData::store_index(FileAccess *p_file, uint64_t p_pack_start, const Vector<IndexEntry> &p_entries) {
+
+	Vector<_PackIndexRecord> records;
+	records.resize(p_entries.size());
+
+	for (int i = 0; i < p_entries.size(); i++) {
+
+		const IndexEntry &e = p_entries[i];
+		uint8_t *r = records[i].data;
+
+		Vector<uint8_t> path_md5 = e.path.md5_buffer();
+		copymem(&r[0], path_md5.ptr(), 16);
+		encode_uint64(e.offset, &r[16]);
+		encode_uint64(e.size, &r[24]);
+		copymem(&r[32], e.md5, 16);
+		encode_uint64(e.path_offset, &r[48]);
+	}
+
+	records.sort();
+
+	uint64_t index_ofs = p_file->get_position();
+	for (int i = 0; i < records.size(); i++) {
+		p_file->store_buffer(records[i].data, PACK_INDEX_ENTRY_SIZE);
+	}
+	uint64_t end = p_file->get_position();
+
+	p_file->seek(p_pack_start + PACK_HEADER_FLAGS_OFFSET);
+	p_file->store_32(PACK_FLAG_INDEX);
+	p_file->store_64(index_ofs - p_pack_start);
+	p_file->seek(end);
+}
+
+void PackedData::store_dictionary(FileAccess *p_file, uint64_t p_pack_start, const Vector<uint8_t> &p_dictionary) {
+
+	uint64_t dictionary_ofs = p_file->get_position();
+	p_file->store_buffer(p_dictionary.ptr(), p_dictionary.size());
+	uint64_t end = p_file->get_position();
+
+	p_file->seek(p_pack_start + PACK_HEADER_DICTIONARY_OFFSET);
+	p_file->store_64(dictionary_ofs - p_pack_start);
+	p_file->store_32(p_dictionary.size());
+	p_file->seek(end);
 }
 
 void PackedData::add_pack_source(PackSource *p_source) {
@@ -110,6 +317,7 @@ PackedData::PackedData() {
 	singleton = this;
 	root = memnew(PackedDir);
 	root->parent = NULL;
+	root_lock = Mutex::create();
 	disabled = false;
 
 	add_pack_source(memnew(PackedSourcePCK));
@@ -124,10 +332,16 @@ void PackedData::_free_packed_dirs(PackedDir *p_dir) {
 
 PackedData::~PackedData() {
 
+	for (int i = 0; i < layers.size(); i++) {
+		memdelete(layers[i]);
+	}
 	for (int i = 0; i < sources.size(); i++) {
 		memdelete(sources[i]);
 	}
 	_free_packed_dirs(root);
+	if (root_lock) {
+		memdelete(root_lock);
+	}
 }
 
 //////////////////////////////////////////////////////////////////
@@ -165,6 +379,7 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 		}
 	}
 
+	uint64_t pack_start = f->get_position() - 4;
 	uint32_t version = f->get_32();
 	uint32_t ver_major = f->get_32();
 	uint32_t ver_minor = f->get_32();
@@ -175,13 +390,88 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 	ERR_EXPLAIN("Pack created with a newer version of the engine: " + itos(ver_major) + "." + itos(ver_minor) + "." + itos(ver_rev));
 	ERR_FAIL_COND_V(ver_major > VERSION_MAJOR || (ver_major == VERSION_MAJOR && ver_minor > VERSION_MINOR), false);
 
-	for (int i = 0; i < 16; i++) {
+	uint32_t flags = f->get_32();
+	uint64_t index_ofs = f->get_64();
+	uint64_t dictionary_ofs = f->get_64();
+	uint32_t dictionary_size = f->get_32();
+	for (int i = 0; i < 10; i++) {
 		//reserved
 		f->get_32();
 	}
 
 	int file_count = f->get_32();
 
+	String abs_path = f->get_path_absolute();
+
+	if (abs_path != "" && !mappings.has(p_path)) {
+		Mapping mapping;
+		mapping.data = OS::get_singleton()->map_file(abs_path, mapping.size);
+		if (mapping.data) {
+			mappings[p_path] = mapping;
+		}
+	}
+
+	if (dictionary_size) {
+
+		//files compressed with it can't be opened without it
+		Vector<uint8_t> dictionary;
+		dictionary.resize(dictionary_size);
+		uint64_t pos = f->get_position();
+		f->seek(pack_start + dictionary_ofs);
+		if (f->get_buffer(dictionary.ptrw(), dictionary_size) != int(dictionary_size)) {
+			memdelete(f);
+			ERR_EXPLAIN("Pack file dictionary is truncated: " + p_path);
+			ERR_FAIL_V(false);
+		}
+		f->seek(pos);
+		if (!Compression::add_dictionary(dictionary)) {
+			memdelete(f);
+			ERR_EXPLAIN("Pack file dictionary clashes with one already in use: " + p_path);
+			ERR_FAIL_V(false);
+		}
+	}
+
+	if (flags & PACK_FLAG_INDEX) {
+
+		PackedData::PackedIndex index;
+		index.pack = p_path;
+		index.src = this;
+		index.count = file_count;
+		index.start = pack_start;
+		index.data = NULL;
+		index.data_size = 0;
+
+		uint64_t index_size = uint64_t(file_count) * PACK_INDEX_ENTRY_SIZE;
+		const Map<String, Mapping>::Element *E = mappings.find(p_path);
+
+		if (E && pack_start + index_ofs + index_size <= E->get().size) {
+
+			index.data = E->get().data;
+			index.data_size = E->get().size;
+			index.entries = index.data + pack_start + index_ofs;
+
+		} else {
+
+			//not mapped, keep the index in memory
+			if (!indices.has(p_path) || indices[p_path].size() != index_size) {
+				Vector<uint8_t> entries;
+				entries.resize(index_size);
+				f->seek(pack_start + index_ofs);
+				if (f->get_buffer(entries.ptrw(), index_size) != int(index_size)) {
+					memdelete(f);
+					ERR_EXPLAIN("Pack file index is truncated: " + p_path);
+					ERR_FAIL_V(false);
+				}
+				indices[p_path] = entries;
+			}
+			index.entries = indices[p_path].ptr();
+		}
+
+		memdelete(f);
+		PackedData::get_singleton()->add_index(index);
+		return true;
+	}
+
 	for (int i = 0; i < file_count; i++) {
 
 		uint32_t sl = f->get_32();
@@ -200,14 +490,28 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 		PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5, this);
 	};
 
+	memdelete(f);
+
 	return true;
 };
 
 FileAccess *PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
 
+	const Map<String, Mapping>::Element *E = mappings.find(p_file->pack);
+	if (E && p_file->offset + p_file->size <= E->get().size) {
+		return memnew(FileAccessPack(p_path, *p_file, E->get().data));
+	}
+
 	return memnew(FileAccessPack(p_path, *p_file));
 };
 
+PackedSourcePCK::~PackedSourcePCK() {
+
+	for (Map<String, Mapping>::Element *E = mappings.front(); E; E = E->next()) {
+		OS::get_singleton()->unmap_file(E->get().data, E->get().size);
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 
 Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
@@ -218,12 +522,16 @@ Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
 
 void FileAccessPack::close() {
 
-	f->close();
+	if (f) {
+		f->close();
+	} else {
+		data = NULL;
+	}
 }
 
 bool FileAccessPack::is_open() const {
 
-	return f->is_open();
+	return f ? f->is_open() : data != NULL;
 }
 
 void FileAccessPack::seek(size_t p_position) {
@@ -234,7 +542,9 @@ void FileAccessPack::seek(size_t p_position) {
 		eof = false;
 	}
 
-	f->seek(pf.offset + p_position);
+	if (f) {
+		f->seek(pf.offset + p_position);
+	}
 	pos = p_position;
 }
 void FileAccessPack::seek_end(int64_t p_position) {
@@ -262,6 +572,10 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (data) {
+		return data[pos++];
+	}
+
 	pos++;
 	return f->get_8();
 }
@@ -277,18 +591,37 @@ int FileAccessPack::get_buffer(uint8_t *p_dst, int p_length) const {
 		to_read = int64_t(pf.size) - int64_t(pos);
 	}
 
+	size_t from = pos;
 	pos += p_length;
 
 	if (to_read <= 0)
 		return 0;
-	f->get_buffer(p_dst, to_read);
+
+	if (data) {
+		copymem(p_dst, &data[from], to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_buffer_ptr(int p_length) const {
+
+	if (!data || eof || p_length < 0 || pos + p_length > pf.size)
+		return NULL;
+
+	const uint8_t *ptr = &data[pos];
+	pos += p_length;
+
+	return ptr;
+}
+
 void FileAccessPack::set_endian_swap(bool p_swap) {
 	FileAccess::set_endian_swap(p_swap);
-	f->set_endian_swap(p_swap);
+	if (f) {
+		f->set_endian_swap(p_swap);
+	}
 }
 
 Error FileAccessPack::get_error() const {
@@ -318,16 +651,25 @@ bool FileAccessPack::file_exists(const String &p_name) {
 	return false;
 }
 
-FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
+FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_pack_data) :
 		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+		f(NULL),
+		data(NULL) {
+	pos = 0;
+	eof = false;
+
+	if (p_pack_data) {
+		//read in place, several threads can do it at once
+		data = p_pack_data + pf.offset;
+		return;
+	}
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	if (!f) {
 		ERR_EXPLAIN("Can't open pack-referenced file: " + String(pf.pack));
 		ERR_FAIL_COND(!f);
 	}
 	f->seek(pf.offset);
-	pos = 0;
-	eof = false;
 }
 
 FileAccessPack::~FileAccessPack() {
@@ -419,7 +761,7 @@ Error DirAccessPack::change_dir(String p_dir) {
 	PackedData::PackedDir *pd;
 
 	if (absolute)
-		pd = PackedData::get_singleton()->root;
+		pd = PackedData::get_singleton()->_get_root();
 	else
 		pd = current;
 
@@ -491,7 +833,7 @@ size_t DirAccessPack::get_space_left() {
 
 DirAccessPack::DirAccessPack() {
 
-	current = PackedData::get_singleton()->root;
+	current = PackedData::get_singleton()->_get_root();
 	cdir = false;
 }
 
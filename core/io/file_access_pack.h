@@ -31,12 +31,25 @@
 #ifndef FILE_ACCESS_PACK_H
 #define FILE_ACCESS_PACK_H
 
+#include "hash_map.h"
 #include "list.h"
 #include "map.h"
 #include "os/dir_access.h"
 #include "os/file_access.h"
+#include "os/mutex.h"
 #include "print_string.h"
 
+#define PACK_VERSION 1
+
+// The first reserved header field holds format flags. With PACK_FLAG_INDEX
+// set, the next two hold the offset (from the pack start) of a file index
+// sorted by path md5, so the pack can be mounted without reading its
+// file list. Packs without it are still read the old way.
+#define PACK_FLAG_INDEX 1
+#define PACK_HEADER_FLAGS_OFFSET 20
+#define PACK_HEADER_DICTIONARY_OFFSET 32 // offset and size of the compression dictionary, size 0 when there is none
+#define PACK_INDEX_ENTRY_SIZE 56 // path md5, offset, size, md5, offset of the path in the file list
+
 class PackSource;
 
 class PackedData {
@@ -54,6 +67,26 @@ public:
 		PackSource *src;
 	};
 
+	struct PackedIndex {
+
+		String pack;
+		PackSource *src;
+		const uint8_t *entries; //PACK_INDEX_ENTRY_SIZE bytes each, sorted by path md5
+		uint32_t count;
+		const uint8_t *data; //whole pack file if mapped, path strings are read from it, else from the file
+		uint64_t data_size;
+		uint64_t start; //offset of the pack in its file
+	};
+
+	struct IndexEntry {
+
+		String path;
+		uint64_t offset;
+		uint64_t size;
+		uint8_t md5[16];
+		uint64_t path_offset; //from the pack start, of the path as stored in the file list
+	};
+
 private:
 	struct PackedDir {
 		PackedDir *parent;
@@ -88,21 +121,45 @@ private:
 		};
 	};
 
-	Map<PathMD5, PackedFile> files;
+	struct PathMD5Hasher {
+		static _FORCE_INLINE_ uint32_t hash(const PathMD5 &p_md5) { return uint32_t(p_md5.a); }
+	};
+
+	// Packs are searched newest first, each one either added path by path
+	// or through the index it stores.
+	struct PackedLayer {
+
+		HashMap<PathMD5, PackedFile, PathMD5Hasher> files;
+		Vector<String> new_paths; //not in the directory tree yet
+
+		bool indexed;
+		bool in_tree;
+		PackedIndex index;
+	};
+
+	Vector<PackedLayer *> layers;
 
 	Vector<PackSource *> sources;
 
-	PackedDir *root;
-	//Map<String,PackedDir*> dirs;
+	PackedDir *root; //built on first use by DirAccessPack
+	Mutex *root_lock;
 
 	static PackedData *singleton;
 	bool disabled;
 
+	bool _find_path(const String &p_path, PackedFile *r_file) const;
+	static String _get_index_path(const PackedIndex &p_index, const uint8_t *p_entry, FileAccess *p_file);
+	void _add_to_tree(const String &p_path);
+	PackedDir *_get_root();
 	void _free_packed_dirs(PackedDir *p_dir);
 
 public:
 	void add_pack_source(PackSource *p_source);
 	void add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src); // for PackSource
+	void add_index(const PackedIndex &p_index); // for PackSource, the entries must stay valid while the source exists
+
+	static void store_index(FileAccess *p_file, uint64_t p_pack_start, const Vector<IndexEntry> &p_entries); // for pack writers, after the file data
+	static void store_dictionary(FileAccess *p_file, uint64_t p_pack_start, const Vector<uint8_t> &p_dictionary); // same, the dictionary is added to Compression when mounting
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -127,9 +184,20 @@ public:
 
 class PackedSourcePCK : public PackSource {
 
+	struct Mapping {
+		const uint8_t *data;
+		size_t size;
+	};
+
+	//packs mapped in memory, read without going through a FileAccess
+	Map<String, Mapping> mappings;
+	//file indices of the packs that could not be mapped
+	Map<String, Vector<uint8_t> > indices;
+
 public:
 	virtual bool try_open_pack(const String &p_path);
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+	virtual ~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
@@ -140,6 +208,8 @@ class FileAccessPack : public FileAccess {
 	mutable bool eof;
 
 	FileAccess *f;
+	const uint8_t *data; //when the pack is mapped, the file contents
+
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 
@@ -157,6 +227,7 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *get_buffer_ptr(int p_length) const;
 
 	virtual void set_endian_swap(bool p_swap);
 
@@ -169,26 +240,25 @@ public:
 
 	virtual bool file_exists(const String &p_name);
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_pack_data = NULL);
 	~FileAccessPack();
 };
 
 FileAccess *PackedData::try_open_path(const String &p_path) {
 
 	//print_line("try open path " + p_path);
-	PathMD5 pmd5(p_path.md5_buffer());
-	Map<PathMD5, PackedFile>::Element *E = files.find(pmd5);
-	if (!E)
+	PackedFile pf;
+	if (!_find_path(p_path, &pf))
 		return NULL; //not found
-	if (E->get().offset == 0)
+	if (pf.offset == 0)
 		return NULL; //was erased
 
-	return E->get().src->get_file(p_path, &E->get());
+	return pf.src->get_file(p_path, &pf);
 }
 
 bool PackedData::has_path(const String &p_path) {
 
-	return files.has(PathMD5(p_path.md5_buffer()));
+	return _find_path(p_path, NULL);
 }
 
 class DirAccessPack : public DirAccess {
@@ -1415,3 +1415,782 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 	return OK;
 }
+
+/* Compact encoding */
+
+// Tags are the variant type in the low 5 bits and a type specific format in the high 3 bits.
+#define COMPACT_TYPE_MASK 0x1F
+#define COMPACT_FORMAT_SHIFT 5
+
+enum {
+	COMPACT_REAL_FLOAT = 0,
+	COMPACT_REAL_DOUBLE = 1,
+
+	COMPACT_VECTOR_FLOAT = 0,
+	COMPACT_VECTOR_HALF = 1,
+	COMPACT_VECTOR_QUANTIZED = 2, //quat only
+
+	COMPACT_OBJECT_NULL = 0,
+	COMPACT_OBJECT_AS_ID = 1,
+	COMPACT_OBJECT_FULL = 2,
+
+	COMPACT_ARRAY_TAGGED = 0,
+	COMPACT_ARRAY_PACKED = 1, //all elements share one tag, written once
+};
+
+// Both only track the length when there is no buffer, so sizes are computed with the same code.
+struct CompactWriter {
+
+	uint8_t *buf;
+	int len;
+
+	_FORCE_INLINE_ void put_u8(uint8_t p_value) {
+		if (buf)
+			buf[len] = p_value;
+		len++;
+	}
+	_FORCE_INLINE_ void put_varint(uint64_t p_value) {
+		len += encode_varint(p_value, buf ? &buf[len] : NULL);
+	}
+	_FORCE_INLINE_ void put_zigzag(int64_t p_value) {
+		put_varint((uint64_t(p_value) << 1) ^ uint64_t(p_value >> 63));
+	}
+	_FORCE_INLINE_ void put_float(float p_value) {
+		if (buf)
+			encode_float(p_value, &buf[len]);
+		len += 4;
+	}
+	_FORCE_INLINE_ void put_double(double p_value) {
+		if (buf)
+			encode_double(p_value, &buf[len]);
+		len += 8;
+	}
+	_FORCE_INLINE_ void put_half(float p_value) {
+		if (buf)
+			encode_uint16(Math::make_half_float(p_value), &buf[len]);
+		len += 2;
+	}
+	_FORCE_INLINE_ void put_snorm16(float p_value) {
+		if (buf)
+			encode_uint16(int16_t(Math::round(CLAMP(p_value, -1.0, 1.0) * 32767.0)), &buf[len]);
+		len += 2;
+	}
+	_FORCE_INLINE_ void put_data(const uint8_t *p_data, int p_size) {
+		if (buf)
+			copymem(&buf[len], p_data, p_size);
+		len += p_size;
+	}
+	void put_string(const String &p_string) {
+		CharString utf8 = p_string.utf8();
+		put_varint(utf8.length());
+		put_data((const uint8_t *)utf8.get_data(), utf8.length());
+	}
+	void put_vector(real_t p_x, real_t p_y, int p_format) {
+		if (p_format == COMPACT_VECTOR_HALF) {
+			put_half(p_x);
+			put_half(p_y);
+		} else {
+			put_float(p_x);
+			put_float(p_y);
+		}
+	}
+	void put_vector(real_t p_x, real_t p_y, real_t p_z, int p_format) {
+		put_vector(p_x, p_y, p_format);
+		if (p_format == COMPACT_VECTOR_HALF)
+			put_half(p_z);
+		else
+			put_float(p_z);
+	}
+};
+
+struct CompactReader {
+
+	const uint8_t *buf;
+	int len;
+	int pos;
+
+	_FORCE_INLINE_ bool has(int p_size) const { return p_size >= 0 && len - pos >= p_size; }
+
+	_FORCE_INLINE_ uint8_t get_u8() { return buf[pos++]; }
+	_FORCE_INLINE_ bool get_varint(uint64_t &r_value) {
+		int used = decode_varint(&buf[pos], len - pos, r_value);
+		pos += used;
+		return used > 0;
+	}
+	_FORCE_INLINE_ bool get_zigzag(int64_t &r_value) {
+		uint64_t u;
+		if (!get_varint(u))
+			return false;
+		r_value = int64_t(u >> 1) ^ -int64_t(u & 1);
+		return true;
+	}
+	_FORCE_INLINE_ bool get_count(int p_element_size, int &r_count) {
+		uint64_t count;
+		if (!get_varint(count) || count > 0x7FFFFFFF || !has(int64_t(count) * p_element_size > 0x7FFFFFFF ? -1 : int(count) * p_element_size))
+			return false;
+		r_count = count;
+		return true;
+	}
+	_FORCE_INLINE_ float get_float() {
+		pos += 4;
+		return decode_float(&buf[pos - 4]);
+	}
+	_FORCE_INLINE_ double get_double() {
+		pos += 8;
+		return decode_double(&buf[pos - 8]);
+	}
+	_FORCE_INLINE_ float get_half() {
+		pos += 2;
+		return Math::half_to_float(decode_uint16(&buf[pos - 2]));
+	}
+	_FORCE_INLINE_ float get_snorm16() {
+		pos += 2;
+		return MAX(int16_t(decode_uint16(&buf[pos - 2])) / 32767.0, -1.0);
+	}
+	bool get_string(String &r_string) {
+		int size;
+		if (!get_count(1, size))
+			return false;
+		r_string.parse_utf8((const char *)&buf[pos], size);
+		pos += size;
+		return true;
+	}
+	bool get_vector(real_t *r_values, int p_count, int p_format) {
+		if (!has(p_count * (p_format == COMPACT_VECTOR_HALF ? 2 : 4)))
+			return false;
+		for (int i = 0; i < p_count; i++)
+			r_values[i] = p_format == COMPACT_VECTOR_HALF ? get_half() : get_float();
+		return true;
+	}
+};
+
+static int _compact_vector_format(uint32_t p_flags) {
+
+	return (p_flags & ENCODE_COMPACT_HALF_VECTORS) ? COMPACT_VECTOR_HALF : COMPACT_VECTOR_FLOAT;
+}
+
+static uint8_t _compact_tag(const Variant &p_variant, uint32_t p_flags, bool p_object_as_id) {
+
+	Variant::Type type = p_variant.get_type();
+	int format = 0;
+
+	switch (type) {
+
+		case Variant::BOOL: {
+
+			format = p_variant.operator bool(); //the value fits in the tag
+		} break;
+		case Variant::REAL: {
+
+			double d = p_variant;
+			format = double(float(d)) == d ? COMPACT_REAL_FLOAT : COMPACT_REAL_DOUBLE;
+		} break;
+		case Variant::VECTOR2:
+		case Variant::VECTOR3:
+		case Variant::POOL_VECTOR2_ARRAY:
+		case Variant::POOL_VECTOR3_ARRAY: {
+
+			format = _compact_vector_format(p_flags);
+		} break;
+		case Variant::QUAT: {
+
+			format = (p_flags & ENCODE_COMPACT_QUANTIZED_QUATS) ? COMPACT_VECTOR_QUANTIZED : _compact_vector_format(p_flags);
+		} break;
+		case Variant::OBJECT: {
+
+			if (p_object_as_id)
+				format = COMPACT_OBJECT_AS_ID;
+			else
+				format = p_variant.operator Object *() ? COMPACT_OBJECT_FULL : COMPACT_OBJECT_NULL;
+		} break;
+		case Variant::ARRAY: {
+
+			Array array = p_variant;
+			format = COMPACT_ARRAY_PACKED;
+
+			if (array.size() < 2) {
+				format = COMPACT_ARRAY_TAGGED;
+			} else {
+				uint8_t tag = _compact_tag(array[0], p_flags, p_object_as_id);
+				for (int i = 1; i < array.size(); i++) {
+					if (_compact_tag(array[i], p_flags, p_object_as_id) != tag) {
+						format = COMPACT_ARRAY_TAGGED;
+						break;
+					}
+				}
+			}
+		} break;
+		default: {
+		}
+	}
+
+	return type | (format << COMPACT_FORMAT_SHIFT);
+}
+
+static Error _encode_compact(const Variant &p_variant, uint8_t p_tag, CompactWriter &w, uint32_t p_flags, bool p_object_as_id);
+
+static Error _encode_compact_tagged(const Variant &p_variant, CompactWriter &w, uint32_t p_flags, bool p_object_as_id) {
+
+	uint8_t tag = _compact_tag(p_variant, p_flags, p_object_as_id);
+	w.put_u8(tag);
+	return _encode_compact(p_variant, tag, w, p_flags, p_object_as_id);
+}
+
+static Error _encode_compact(const Variant &p_variant, uint8_t p_tag, CompactWriter &w, uint32_t p_flags, bool p_object_as_id) {
+
+	int format = p_tag >> COMPACT_FORMAT_SHIFT;
+
+	switch (p_variant.get_type()) {
+
+		case Variant::NIL:
+		case Variant::BOOL:
+		case Variant::_RID: {
+
+			//nothing to do, bools are stored in the tag
+		} break;
+		case Variant::INT: {
+
+			w.put_zigzag(p_variant.operator int64_t());
+		} break;
+		case Variant::REAL: {
+
+			if (format == COMPACT_REAL_DOUBLE)
+				w.put_double(p_variant.operator double());
+			else
+				w.put_float(p_variant.operator float());
+		} break;
+		case Variant::STRING: {
+
+			w.put_string(p_variant);
+		} break;
+		case Variant::VECTOR2: {
+
+			Vector2 v = p_variant;
+			w.put_vector(v.x, v.y, format);
+		} break;
+		case Variant::RECT2: {
+
+			Rect2 r = p_variant;
+			w.put_vector(r.position.x, r.position.y, COMPACT_VECTOR_FLOAT);
+			w.put_vector(r.size.x, r.size.y, COMPACT_VECTOR_FLOAT);
+		} break;
+		case Variant::VECTOR3: {
+
+			Vector3 v = p_variant;
+			w.put_vector(v.x, v.y, v.z, format);
+		} break;
+		case Variant::TRANSFORM2D: {
+
+			Transform2D t = p_variant;
+			for (int i = 0; i < 3; i++)
+				w.put_vector(t.elements[i].x, t.elements[i].y, COMPACT_VECTOR_FLOAT);
+		} break;
+		case Variant::PLANE: {
+
+			Plane p = p_variant;
+			w.put_vector(p.normal.x, p.normal.y, p.normal.z, COMPACT_VECTOR_FLOAT);
+			w.put_float(p.d);
+		} break;
+		case Variant::QUAT: {
+
+			Quat q = p_variant;
+			if (format == COMPACT_VECTOR_QUANTIZED) {
+				//fixed point only makes sense for unit quaternions
+				q.normalize();
+				w.put_snorm16(q.x);
+				w.put_snorm16(q.y);
+				w.put_snorm16(q.z);
+				w.put_snorm16(q.w);
+			} else {
+				w.put_vector(q.x, q.y, format);
+				w.put_vector(q.z, q.w, format);
+			}
+		} break;
+		case Variant::AABB: {
+
+			AABB aabb = p_variant;
+			w.put_vector(aabb.position.x, aabb.position.y, aabb.position.z, COMPACT_VECTOR_FLOAT);
+			w.put_vector(aabb.size.x, aabb.size.y, aabb.size.z, COMPACT_VECTOR_FLOAT);
+		} break;
+		case Variant::BASIS: {
+
+			Basis b = p_variant;
+			for (int i = 0; i < 3; i++)
+				w.put_vector(b.elements[i].x, b.elements[i].y, b.elements[i].z, COMPACT_VECTOR_FLOAT);
+		} break;
+		case Variant::TRANSFORM: {
+
+			Transform t = p_variant;
+			for (int i = 0; i < 3; i++)
+				w.put_vector(t.basis.elements[i].x, t.basis.elements[i].y, t.basis.elements[i].z, COMPACT_VECTOR_FLOAT);
+			w.put_vector(t.origin.x, t.origin.y, t.origin.z, COMPACT_VECTOR_FLOAT);
+		} break;
+		case Variant::COLOR: {
+
+			Color c = p_variant;
+			w.put_vector(c.r, c.g, c.b, COMPACT_VECTOR_FLOAT);
+			w.put_float(c.a);
+		} break;
+		case Variant::NODE_PATH: {
+
+			w.put_string(String(p_variant.operator NodePath()));
+		} break;
+		case Variant::OBJECT: {
+
+			if (format == COMPACT_OBJECT_AS_ID) {
+
+				Object *obj = p_variant;
+				w.put_varint(obj ? obj->get_instance_id() : 0);
+			} else if (format == COMPACT_OBJECT_FULL) {
+
+				//objects are rare and big, they keep the regular encoding
+				int len;
+				Error err = encode_variant(p_variant, NULL, len);
+				if (err)
+					return err;
+				w.put_varint(len);
+				encode_variant(p_variant, w.buf ? &w.buf[w.len] : NULL, len);
+				w.len += len;
+			}
+		} break;
+		case Variant::DICTIONARY: {
+
+			Dictionary d = p_variant;
+			List<Variant> keys;
+			d.get_key_list(&keys);
+
+			w.put_varint(d.size());
+			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+
+				Error err = _encode_compact_tagged(E->get(), w, p_flags, p_object_as_id);
+				if (err)
+					return err;
+				err = _encode_compact_tagged(d[E->get()], w, p_flags, p_object_as_id);
+				if (err)
+					return err;
+			}
+		} break;
+		case Variant::ARRAY: {
+
+			Array array = p_variant;
+			w.put_varint(array.size());
+
+			if (format == COMPACT_ARRAY_PACKED) {
+
+				uint8_t tag = _compact_tag(array[0], p_flags, p_object_as_id);
+				w.put_u8(tag);
+				for (int i = 0; i < array.size(); i++) {
+					Error err = _encode_compact(array[i], tag, w, p_flags, p_object_as_id);
+					if (err)
+						return err;
+				}
+			} else {
+
+				for (int i = 0; i < array.size(); i++) {
+					Error err = _encode_compact_tagged(array[i], w, p_flags, p_object_as_id);
+					if (err)
+						return err;
+				}
+			}
+		} break;
+		case Variant::POOL_BYTE_ARRAY: {
+
+			PoolVector<uint8_t> data = p_variant;
+			PoolVector<uint8_t>::Read r = data.read();
+			w.put_varint(data.size());
+			w.put_data(r.ptr(), data.size());
+		} break;
+		case Variant::POOL_INT_ARRAY: {
+
+			PoolVector<int> data = p_variant;
+			PoolVector<int>::Read r = data.read();
+			w.put_varint(data.size());
+			for (int i = 0; i < data.size(); i++)
+				w.put_zigzag(r[i]);
+		} break;
+		case Variant::POOL_REAL_ARRAY: {
+
+			PoolVector<real_t> data = p_variant;
+			PoolVector<real_t>::Read r = data.read();
+			w.put_varint(data.size());
+			for (int i = 0; i < data.size(); i++)
+				w.put_float(r[i]);
+		} break;
+		case Variant::POOL_STRING_ARRAY: {
+
+			PoolVector<String> data = p_variant;
+			PoolVector<String>::Read r = data.read();
+			w.put_varint(data.size());
+			for (int i = 0; i < data.size(); i++)
+				w.put_string(r[i]);
+		} break;
+		case Variant::POOL_VECTOR2_ARRAY: {
+
+			PoolVector<Vector2> data = p_variant;
+			PoolVector<Vector2>::Read r = data.read();
+			w.put_varint(data.size());
+			for (int i = 0; i < data.size(); i++)
+				w.put_vector(r[i].x, r[i].y, format);
+		} break;
+		case Variant::POOL_VECTOR3_ARRAY: {
+
+			PoolVector<Vector3> data = p_variant;
+			PoolVector<Vector3>::Read r = data.read();
+			w.put_varint(data.size());
+			for (int i = 0; i < data.size(); i++)
+				w.put_vector(r[i].x, r[i].y, r[i].z, format);
+		} break;
+		case Variant::POOL_COLOR_ARRAY: {
+
+			PoolVector<Color> data = p_variant;
+			PoolVector<Color>::Read r = data.read();
+			w.put_varint(data.size());
+			for (int i = 0; i < data.size(); i++) {
+				w.put_vector(r[i].r, r[i].g, r[i].b, COMPACT_VECTOR_FLOAT);
+				w.put_float(r[i].a);
+			}
+		} break;
+		default: { ERR_FAIL_V(ERR_BUG); }
+	}
+
+	return OK;
+}
+
+Error encode_variant_compact(const Variant &p_variant, uint8_t *r_buffer, int &r_len, uint32_t p_flags, bool p_object_as_id) {
+
+	CompactWriter w;
+	w.buf = r_buffer;
+	w.len = 0;
+
+	Error err = _encode_compact_tagged(p_variant, w, p_flags, p_object_as_id);
+	r_len = w.len;
+	return err;
+}
+
+static Error _decode_compact(Variant &r_variant, uint8_t p_tag, CompactReader &r, bool p_allow_objects);
+
+static Error _decode_compact_tagged(Variant &r_variant, CompactReader &r, bool p_allow_objects) {
+
+	ERR_FAIL_COND_V(!r.has(1), ERR_INVALID_DATA);
+	return _decode_compact(r_variant, r.get_u8(), r, p_allow_objects);
+}
+
+#define COMPACT_READ_VECTOR(m_count, m_format)                                  \
+	real_t v[m_count];                                                         \
+	ERR_FAIL_COND_V(!r.get_vector(v, m_count, m_format), ERR_INVALID_DATA);
+
+static Error _decode_compact(Variant &r_variant, uint8_t p_tag, CompactReader &r, bool p_allow_objects) {
+
+	int type = p_tag & COMPACT_TYPE_MASK;
+	int format = p_tag >> COMPACT_FORMAT_SHIFT;
+
+	ERR_FAIL_COND_V(type >= Variant::VARIANT_MAX, ERR_INVALID_DATA);
+
+	switch (type) {
+
+		case Variant::NIL: {
+
+			r_variant = Variant();
+		} break;
+		case Variant::BOOL: {
+
+			r_variant = bool(format & 1);
+		} break;
+		case Variant::INT: {
+
+			int64_t val;
+			ERR_FAIL_COND_V(!r.get_zigzag(val), ERR_INVALID_DATA);
+			r_variant = val;
+		} break;
+		case Variant::REAL: {
+
+			if (format == COMPACT_REAL_DOUBLE) {
+				ERR_FAIL_COND_V(!r.has(8), ERR_INVALID_DATA);
+				r_variant = r.get_double();
+			} else {
+				ERR_FAIL_COND_V(!r.has(4), ERR_INVALID_DATA);
+				r_variant = r.get_float();
+			}
+		} break;
+		case Variant::STRING: {
+
+			String str;
+			ERR_FAIL_COND_V(!r.get_string(str), ERR_INVALID_DATA);
+			r_variant = str;
+		} break;
+		case Variant::VECTOR2: {
+
+			COMPACT_READ_VECTOR(2, format);
+			r_variant = Vector2(v[0], v[1]);
+		} break;
+		case Variant::RECT2: {
+
+			COMPACT_READ_VECTOR(4, COMPACT_VECTOR_FLOAT);
+			r_variant = Rect2(v[0], v[1], v[2], v[3]);
+		} break;
+		case Variant::VECTOR3: {
+
+			COMPACT_READ_VECTOR(3, format);
+			r_variant = Vector3(v[0], v[1], v[2]);
+		} break;
+		case Variant::TRANSFORM2D: {
+
+			COMPACT_READ_VECTOR(6, COMPACT_VECTOR_FLOAT);
+			r_variant = Transform2D(v[0], v[1], v[2], v[3], v[4], v[5]);
+		} break;
+		case Variant::PLANE: {
+
+			COMPACT_READ_VECTOR(4, COMPACT_VECTOR_FLOAT);
+			r_variant = Plane(v[0], v[1], v[2], v[3]);
+		} break;
+		case Variant::QUAT: {
+
+			if (format == COMPACT_VECTOR_QUANTIZED) {
+				ERR_FAIL_COND_V(!r.has(8), ERR_INVALID_DATA);
+				real_t x = r.get_snorm16();
+				real_t y = r.get_snorm16();
+				real_t z = r.get_snorm16();
+				real_t w = r.get_snorm16();
+				r_variant = Quat(x, y, z, w);
+			} else {
+				COMPACT_READ_VECTOR(4, format);
+				r_variant = Quat(v[0], v[1], v[2], v[3]);
+			}
+		} break;
+		case Variant::AABB: {
+
+			COMPACT_READ_VECTOR(6, COMPACT_VECTOR_FLOAT);
+			r_variant = AABB(Vector3(v[0], v[1], v[2]), Vector3(v[3], v[4], v[5]));
+		} break;
+		case Variant::BASIS: {
+
+			COMPACT_READ_VECTOR(9, COMPACT_VECTOR_FLOAT);
+			r_variant = Basis(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8]);
+		} break;
+		case Variant::TRANSFORM: {
+
+			COMPACT_READ_VECTOR(12, COMPACT_VECTOR_FLOAT);
+			r_variant = Transform(Basis(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8]), Vector3(v[9], v[10], v[11]));
+		} break;
+		case Variant::COLOR: {
+
+			COMPACT_READ_VECTOR(4, COMPACT_VECTOR_FLOAT);
+			r_variant = Color(v[0], v[1], v[2], v[3]);
+		} break;
+		case Variant::NODE_PATH: {
+
+			String str;
+			ERR_FAIL_COND_V(!r.get_string(str), ERR_INVALID_DATA);
+			r_variant = NodePath(str);
+		} break;
+		case Variant::_RID: {
+
+			r_variant = RID();
+		} break;
+		case Variant::OBJECT: {
+
+			if (format == COMPACT_OBJECT_AS_ID) {
+
+				uint64_t id;
+				ERR_FAIL_COND_V(!r.get_varint(id), ERR_INVALID_DATA);
+
+				if (id == 0) {
+					r_variant = (Object *)NULL;
+				} else {
+					Ref<EncodedObjectAsID> obj_as_id;
+					obj_as_id.instance();
+					obj_as_id->set_object_id(id);
+
+					r_variant = obj_as_id;
+				}
+			} else if (format == COMPACT_OBJECT_FULL) {
+
+				int len;
+				ERR_FAIL_COND_V(!r.get_count(1, len), ERR_INVALID_DATA);
+				Error err = decode_variant(r_variant, &r.buf[r.pos], len, NULL, p_allow_objects);
+				if (err)
+					return err;
+				r.pos += len;
+			} else {
+				r_variant = (Object *)NULL;
+			}
+		} break;
+		case Variant::DICTIONARY: {
+
+			int count;
+			ERR_FAIL_COND_V(!r.get_count(2, count), ERR_INVALID_DATA);
+
+			Dictionary d;
+
+			for (int i = 0; i < count; i++) {
+
+				Variant key, value;
+				Error err = _decode_compact_tagged(key, r, p_allow_objects);
+				ERR_FAIL_COND_V(err, err);
+				err = _decode_compact_tagged(value, r, p_allow_objects);
+				ERR_FAIL_COND_V(err, err);
+
+				d[key] = value;
+			}
+
+			r_variant = d;
+		} break;
+		case Variant::ARRAY: {
+
+			int count;
+			uint8_t tag = 0;
+
+			if (format == COMPACT_ARRAY_PACKED) {
+
+				//elements may take no space at all, so the size of the data does not bound the count
+				ERR_FAIL_COND_V(!r.get_count(0, count) || !r.has(1), ERR_INVALID_DATA);
+				ERR_FAIL_COND_V(count > r.len * 8, ERR_INVALID_DATA);
+				tag = r.get_u8();
+			} else {
+				ERR_FAIL_COND_V(!r.get_count(1, count), ERR_INVALID_DATA);
+			}
+
+			Array varr;
+			varr.resize(count);
+
+			if (format == COMPACT_ARRAY_PACKED) {
+				for (int i = 0; i < count; i++) {
+					Error err = _decode_compact(varr[i], tag, r, p_allow_objects);
+					ERR_FAIL_COND_V(err, err);
+				}
+			} else {
+				for (int i = 0; i < count; i++) {
+					Error err = _decode_compact_tagged(varr[i], r, p_allow_objects);
+					ERR_FAIL_COND_V(err, err);
+				}
+			}
+
+			r_variant = varr;
+		} break;
+		case Variant::POOL_BYTE_ARRAY: {
+
+			int count;
+			ERR_FAIL_COND_V(!r.get_count(1, count), ERR_INVALID_DATA);
+
+			PoolVector<uint8_t> data;
+			if (count) {
+				data.resize(count);
+				PoolVector<uint8_t>::Write w = data.write();
+				copymem(w.ptr(), &r.buf[r.pos], count);
+				r.pos += count;
+			}
+			r_variant = data;
+		} break;
+		case Variant::POOL_INT_ARRAY: {
+
+			int count;
+			ERR_FAIL_COND_V(!r.get_count(1, count), ERR_INVALID_DATA);
+
+			PoolVector<int> data;
+			if (count) {
+				data.resize(count);
+				PoolVector<int>::Write w = data.write();
+				for (int i = 0; i < count; i++) {
+					int64_t val;
+					ERR_FAIL_COND_V(!r.get_zigzag(val), ERR_INVALID_DATA);
+					w[i] = val;
+				}
+			}
+			r_variant = data;
+		} break;
+		case Variant::POOL_REAL_ARRAY: {
+
+			int count;
+			ERR_FAIL_COND_V(!r.get_count(4, count), ERR_INVALID_DATA);
+
+			PoolVector<real_t> data;
+			if (count) {
+				data.resize(count);
+				PoolVector<real_t>::Write w = data.write();
+				for (int i = 0; i < count; i++)
+					w[i] = r.get_float();
+			}
+			r_variant = data;
+		} break;
+		case Variant::POOL_STRING_ARRAY: {
+
+			int count;
+			ERR_FAIL_COND_V(!r.get_count(1, count), ERR_INVALID_DATA);
+
+			PoolVector<String> data;
+			if (count) {
+				data.resize(count);
+				PoolVector<String>::Write w = data.write();
+				for (int i = 0; i < count; i++)
+					ERR_FAIL_COND_V(!r.get_string(w[i]), ERR_INVALID_DATA);
+			}
+			r_variant = data;
+		} break;
+		case Variant::POOL_VECTOR2_ARRAY: {
+
+			int count;
+			ERR_FAIL_COND_V(!r.get_count(format == COMPACT_VECTOR_HALF ? 4 : 8, count), ERR_INVALID_DATA);
+
+			PoolVector<Vector2> data;
+			if (count) {
+				data.resize(count);
+				PoolVector<Vector2>::Write w = data.write();
+				for (int i = 0; i < count; i++) {
+					COMPACT_READ_VECTOR(2, format);
+					w[i] = Vector2(v[0], v[1]);
+				}
+			}
+			r_variant = data;
+		} break;
+		case Variant::POOL_VECTOR3_ARRAY: {
+
+			int count;
+			ERR_FAIL_COND_V(!r.get_count(format == COMPACT_VECTOR_HALF ? 6 : 12, count), ERR_INVALID_DATA);
+
+			PoolVector<Vector3> data;
+			if (count) {
+				data.resize(count);
+				PoolVector<Vector3>::Write w = data.write();
+				for (int i = 0; i < count; i++) {
+					COMPACT_READ_VECTOR(3, format);
+					w[i] = Vector3(v[0], v[1], v[2]);
+				}
+			}
+			r_variant = data;
+		} break;
+		case Variant::POOL_COLOR_ARRAY: {
+
+			int count;
+			ERR_FAIL_COND_V(!r.get_count(16, count), ERR_INVALID_DATA);
+
+			PoolVector<Color> data;
+			if (count) {
+				data.resize(count);
+				PoolVector<Color>::Write w = data.write();
+				for (int i = 0; i < count; i++) {
+					COMPACT_READ_VECTOR(4, COMPACT_VECTOR_FLOAT);
+					w[i] = Color(v[0], v[1], v[2], v[3]);
+				}
+			}
+			r_variant = data;
+		} break;
+		default: { ERR_FAIL_V(ERR_BUG); }
+	}
+
+	return OK;
+}
+
+#undef COMPACT_READ_VECTOR
+
+Error decode_variant_compact(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_objects) {
+
+	CompactReader r;
+	r.buf = p_buffer;
+	r.len = p_len;
+	r.pos = 0;
+
+	Error err = _decode_compact_tagged(r_variant, r, p_allow_objects);
+	if (r_len)
+		*r_len = r.pos;
+	return err;
+}
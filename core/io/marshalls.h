@@ -125,6 +125,25 @@ static inline int encode_cstring(const char *p_string, uint8_t *p_data) {
 	return len + 1;
 }
 
+// LEB128 style, 7 bits per byte. Passing a NULL p_arr only returns the encoded size.
+static inline unsigned int encode_varint(uint64_t p_uint, uint8_t *p_arr) {
+
+	unsigned int len = 1;
+
+	while (p_uint >= 0x80) {
+
+		if (p_arr) {
+			*p_arr = (p_uint & 0x7F) | 0x80;
+			p_arr++;
+		}
+		p_uint >>= 7;
+		len++;
+	}
+
+	if (p_arr) *p_arr = p_uint;
+	return len;
+}
+
 static inline uint16_t decode_uint16(const uint8_t *p_arr) {
 
 	uint16_t u = 0;
@@ -184,6 +203,23 @@ static inline double decode_double(const uint8_t *p_arr) {
 	return md.d;
 }
 
+// Returns the amount of bytes read, or 0 if the buffer ends before the value does.
+static inline unsigned int decode_varint(const uint8_t *p_arr, int p_len, uint64_t &r_uint) {
+
+	uint64_t u = 0;
+
+	for (int i = 0; i < 10 && i < p_len; i++) {
+
+		u |= uint64_t(p_arr[i] & 0x7F) << (i * 7);
+		if (!(p_arr[i] & 0x80)) {
+			r_uint = u;
+			return i + 1;
+		}
+	}
+
+	return 0;
+}
+
 class EncodedObjectAsID : public Reference {
 	GDCLASS(EncodedObjectAsID, Reference);
 
@@ -202,4 +238,14 @@ public:
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL, bool p_allow_objects = true);
 Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_object_as_id = false);
 
+enum EncodeCompactFlags {
+	ENCODE_COMPACT_HALF_VECTORS = 1, // Vector2, Vector3, Quat and their pool arrays as half floats
+	ENCODE_COMPACT_QUANTIZED_QUATS = 2, // Quat components as 16 bits fixed point, wins over half floats
+};
+
+// Compact format: one byte tags, varints, no padding and packed homogeneous arrays.
+// Not compatible with the format above, both ends must agree on which one is used.
+Error decode_variant_compact(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL, bool p_allow_objects = true);
+Error encode_variant_compact(const Variant &p_variant, uint8_t *r_buffer, int &r_len, uint32_t p_flags = 0, bool p_object_as_id = false);
+
 #endif
@@ -37,6 +37,8 @@
 PacketPeer::PacketPeer() {
 
 	allow_object_decoding = false;
+	compact_encoding = false;
+	compact_encoding_flags = 0;
 	last_get_error = OK;
 }
 
@@ -50,6 +52,26 @@ bool PacketPeer::is_object_decoding_allowed() const {
 	return allow_object_decoding;
 }
 
+void PacketPeer::set_compact_encoding(bool p_enable) {
+
+	compact_encoding = p_enable;
+}
+
+bool PacketPeer::is_compact_encoding_enabled() const {
+
+	return compact_encoding;
+}
+
+void PacketPeer::set_compact_encoding_flags(int p_flags) {
+
+	compact_encoding_flags = p_flags;
+}
+
+int PacketPeer::get_compact_encoding_flags() const {
+
+	return compact_encoding_flags;
+}
+
 Error PacketPeer::get_packet_buffer(PoolVector<uint8_t> &r_buffer) {
 
 	const uint8_t *buffer;
@@ -87,13 +109,20 @@ Error PacketPeer::get_var(Variant &r_variant) {
 	if (err)
 		return err;
 
+	if (compact_encoding)
+		return decode_variant_compact(r_variant, buffer, buffer_size, NULL, allow_object_decoding);
+
 	return decode_variant(r_variant, buffer, buffer_size, NULL, allow_object_decoding);
 }
 
 Error PacketPeer::put_var(const Variant &p_packet) {
 
 	int len;
-	Error err = encode_variant(p_packet, NULL, len, !allow_object_decoding); // compute len first
+	Error err;
+	if (compact_encoding)
+		err = encode_variant_compact(p_packet, NULL, len, compact_encoding_flags, !allow_object_decoding);
+	else
+		err = encode_variant(p_packet, NULL, len, !allow_object_decoding); // compute len first
 	if (err)
 		return err;
 
@@ -102,7 +131,10 @@ Error PacketPeer::put_var(const Variant &p_packet) {
 
 	uint8_t *buf = (uint8_t *)alloca(len);
 	ERR_FAIL_COND_V(!buf, ERR_OUT_OF_MEMORY);
-	err = encode_variant(p_packet, buf, len, !allow_object_decoding);
+	if (compact_encoding)
+		err = encode_variant_compact(p_packet, buf, len, compact_encoding_flags, !allow_object_decoding);
+	else
+		err = encode_variant(p_packet, buf, len, !allow_object_decoding);
 	ERR_FAIL_COND_V(err, err);
 
 	return put_packet(buf, len);
@@ -142,7 +174,17 @@ void PacketPeer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_allow_object_decoding", "enable"), &PacketPeer::set_allow_object_decoding);
 	ClassDB::bind_method(D_METHOD("is_object_decoding_allowed"), &PacketPeer::is_object_decoding_allowed);
 
+	ClassDB::bind_method(D_METHOD("set_compact_encoding", "enable"), &PacketPeer::set_compact_encoding);
+	ClassDB::bind_method(D_METHOD("is_compact_encoding_enabled"), &PacketPeer::is_compact_encoding_enabled);
+	ClassDB::bind_method(D_METHOD("set_compact_encoding_flags", "flags"), &PacketPeer::set_compact_encoding_flags);
+	ClassDB::bind_method(D_METHOD("get_compact_encoding_flags"), &PacketPeer::get_compact_encoding_flags);
+
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "allow_object_decoding"), "set_allow_object_decoding", "is_object_decoding_allowed");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "compact_encoding"), "set_compact_encoding", "is_compact_encoding_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "compact_encoding_flags", PROPERTY_HINT_FLAGS, "Half Vectors,Quantized Quats"), "set_compact_encoding_flags", "get_compact_encoding_flags");
+
+	BIND_ENUM_CONSTANT(COMPACT_ENCODING_HALF_VECTORS);
+	BIND_ENUM_CONSTANT(COMPACT_ENCODING_QUANTIZED_QUATS);
 };
 
 /***************/
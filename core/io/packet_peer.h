@@ -31,6 +31,7 @@
 #ifndef PACKET_PEER_H
 #define PACKET_PEER_H
 
+#include "io/marshalls.h"
 #include "io/stream_peer.h"
 #include "object.h"
 #include "ring_buffer.h"
@@ -50,8 +51,15 @@ class PacketPeer : public Reference {
 	mutable Error last_get_error;
 
 	bool allow_object_decoding;
+	bool compact_encoding;
+	int compact_encoding_flags;
 
 public:
+	enum CompactEncodingFlags {
+		COMPACT_ENCODING_HALF_VECTORS = ENCODE_COMPACT_HALF_VECTORS,
+		COMPACT_ENCODING_QUANTIZED_QUATS = ENCODE_COMPACT_QUANTIZED_QUATS,
+	};
+
 	virtual int get_available_packet_count() const = 0;
 	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size) = 0; ///< buffer is GONE after next get_packet
 	virtual Error put_packet(const uint8_t *p_buffer, int p_buffer_size) = 0;
@@ -69,6 +77,12 @@ public:
 	void set_allow_object_decoding(bool p_enable);
 	bool is_object_decoding_allowed() const;
 
+	void set_compact_encoding(bool p_enable);
+	bool is_compact_encoding_enabled() const;
+
+	void set_compact_encoding_flags(int p_flags);
+	int get_compact_encoding_flags() const;
+
 	PacketPeer();
 	~PacketPeer() {}
 };
@@ -106,4 +120,6 @@ public:
 	PacketPeerStream();
 };
 
+VARIANT_ENUM_CAST(PacketPeer::CompactEncodingFlags);
+
 #endif // PACKET_STREAM_H
@@ -30,7 +30,9 @@
 
 #include "pck_packer.h"
 
+#include "core/io/file_access_pack.h"
 #include "core/os/file_access.h"
+#include "core/version.h"
 
 static uint64_t _align(uint64_t p_n, int p_alignment) {
 
@@ -70,9 +72,9 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment) {
 	alignment = p_alignment;
 
 	file->store_32(0x43504447); // MAGIC
-	file->store_32(0); // # version
-	file->store_32(0); // # major
-	file->store_32(0); // # minor
+	file->store_32(PACK_VERSION); // # version
+	file->store_32(VERSION_MAJOR); // # major
+	file->store_32(VERSION_MINOR); // # minor
 	file->store_32(0); // # revision
 
 	for (int i = 0; i < 16; i++) {
@@ -96,7 +98,9 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src) {
 	pf.path = p_file;
 	pf.src_path = p_src;
 	pf.size = f->get_len();
+	pf.offset = 0;
 	pf.offset_offset = 0;
+	pf.path_offset = 0;
 
 	files.push_back(pf);
 
@@ -119,6 +123,7 @@ Error PCKPacker::flush(bool p_verbose) {
 
 	for (int i = 0; i < files.size(); i++) {
 
+		files[i].path_offset = file->get_position();
 		file->store_pascal_string(files[i].path);
 		files[i].offset_offset = file->get_position();
 		file->store_64(0); // offset
@@ -155,6 +160,7 @@ Error PCKPacker::flush(bool p_verbose) {
 		file->seek(files[i].offset_offset); // go back to store the file's offset
 		file->store_64(ofs);
 		file->seek(pos);
+		files[i].offset = ofs;
 
 		ofs = _align(ofs + files[i].size, alignment);
 		_pad(file, ofs - pos);
@@ -173,6 +179,21 @@ Error PCKPacker::flush(bool p_verbose) {
 	if (p_verbose)
 		printf("\n");
 
+	// write the index looked up when the pack is mounted
+
+	Vector<PackedData::IndexEntry> index;
+	index.resize(files.size());
+	for (int i = 0; i < files.size(); i++) {
+
+		PackedData::IndexEntry &e = index[i];
+		e.path = files[i].path;
+		e.offset = files[i].offset;
+		e.size = files[i].size;
+		zeromem(e.md5, 16);
+		e.path_offset = files[i].path_offset;
+	};
+	PackedData::store_index(file, 0, index);
+
 	file->close();
 	memdelete(buf);
 
@@ -49,7 +49,9 @@ class PCKPacker : public Reference {
 		String path;
 		String src_path;
 		int size;
+		uint64_t offset;
 		uint64_t offset_offset;
+		uint64_t path_offset;
 	};
 	Vector<File> files;
 
@@ -111,9 +111,14 @@ StringName ResourceInteractiveLoaderBinary::_get_string() {
 		}
 		if (len == 0)
 			return StringName();
-		f->get_buffer((uint8_t *)&str_buf[0], len);
 		String s;
-		s.parse_utf8(&str_buf[0]);
+		const uint8_t *ptr = f->get_buffer_ptr(len);
+		if (ptr) {
+			s.parse_utf8((const char *)ptr, len);
+		} else {
+			f->get_buffer((uint8_t *)&str_buf[0], len);
+			s.parse_utf8(&str_buf[0]);
+		}
 		return s;
 	}
 
@@ -809,9 +814,14 @@ String ResourceInteractiveLoaderBinary::get_unicode_string() {
 	}
 	if (len == 0)
 		return String();
-	f->get_buffer((uint8_t *)&str_buf[0], len);
 	String s;
-	s.parse_utf8(&str_buf[0]);
+	const uint8_t *ptr = f->get_buffer_ptr(len);
+	if (ptr) {
+		s.parse_utf8((const char *)ptr, len);
+	} else {
+		f->get_buffer((uint8_t *)&str_buf[0], len);
+		s.parse_utf8(&str_buf[0]);
+	}
 	return s;
 }
 
@@ -833,6 +843,16 @@ void ResourceInteractiveLoaderBinary::get_dependencies(FileAccess *p_f, List<Str
 	}
 }
 
+static void _skip_compressed_header(FileAccess *p_f) {
+
+	//files compressed whole on export keep their RSRC header, and their offsets count it
+	uint8_t header[4];
+	p_f->get_buffer(header, 4);
+	if (header[0] != 'R' || header[1] != 'S' || header[2] != 'R' || header[3] != 'C') {
+		p_f->seek(0);
+	}
+}
+
 void ResourceInteractiveLoaderBinary::open(FileAccess *p_f) {
 
 	error = OK;
@@ -843,8 +863,15 @@ void ResourceInteractiveLoaderBinary::open(FileAccess *p_f) {
 	if (header[0] == 'R' && header[1] == 'S' && header[2] == 'C' && header[3] == 'C') {
 		//compressed
 		FileAccessCompressed *fac = memnew(FileAccessCompressed);
-		fac->open_after_magic(f);
+		error = fac->open_after_magic(f);
+		if (error != OK) {
+			memdelete(fac);
+			ERR_EXPLAIN("Failed to open compressed binary resource file: " + local_path);
+			ERR_FAIL();
+		}
+		fac->set_read_ahead(64); //resources are mostly read front to back
 		f = fac;
+		_skip_compressed_header(f);
 
 	} else if (header[0] != 'R' || header[1] != 'S' || header[2] != 'R' || header[3] != 'C') {
 		//not normal
@@ -941,8 +968,13 @@ String ResourceInteractiveLoaderBinary::recognize(FileAccess *p_f) {
 	if (header[0] == 'R' && header[1] == 'S' && header[2] == 'C' && header[3] == 'C') {
 		//compressed
 		FileAccessCompressed *fac = memnew(FileAccessCompressed);
-		fac->open_after_magic(f);
+		error = fac->open_after_magic(f);
+		if (error != OK) {
+			memdelete(fac);
+			return "";
+		}
 		f = fac;
+		_skip_compressed_header(f);
 
 	} else if (header[0] != 'R' || header[1] != 'S' || header[2] != 'R' || header[3] != 'C') {
 		//not normal
@@ -1069,12 +1101,17 @@ Error ResourceFormatLoaderBinary::rename_dependencies(const String &p_path, cons
 	if (header[0] == 'R' && header[1] == 'S' && header[2] == 'C' && header[3] == 'C') {
 		//compressed
 		FileAccessCompressed *fac = memnew(FileAccessCompressed);
-		fac->open_after_magic(f);
+		Error err = fac->open_after_magic(f);
+		if (err != OK) {
+			memdelete(fac);
+			memdelete(f);
+			ERR_FAIL_COND_V(err, ERR_FILE_CORRUPT);
+		}
 		f = fac;
 
 		FileAccessCompressed *facw = memnew(FileAccessCompressed);
-		facw->configure("RSCC");
-		Error err = facw->_open(p_path + ".depren", FileAccess::WRITE);
+		facw->configure("RSCC", Compression::MODE_ZSTD, 4096, -1, fac->get_dictionary_id());
+		err = facw->_open(p_path + ".depren", FileAccess::WRITE);
 		if (err) {
 			memdelete(fac);
 			memdelete(facw);
@@ -187,41 +187,31 @@ RES ResourceLoader::_load(const String &p_path, const String &p_original_path, c
 	return RES();
 }
 
-RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p_no_cache, Error *r_error) {
-
-	if (r_error)
-		*r_error = ERR_CANT_OPEN;
+String ResourceLoader::_validate_local_path(const String &p_path) {
 
-	String local_path;
 	if (p_path.is_rel_path())
-		local_path = "res://" + p_path;
+		return "res://" + p_path;
 	else
-		local_path = ProjectSettings::get_singleton()->localize_path(p_path);
+		return ProjectSettings::get_singleton()->localize_path(p_path);
+}
 
-	if (!p_no_cache && ResourceCache::has(local_path)) {
-
-		if (OS::get_singleton()->is_stdout_verbose())
-			print_line("load resource: " + local_path + " (cached)");
-		if (r_error)
-			*r_error = OK;
-		return RES(ResourceCache::get(local_path));
-	}
+RES ResourceLoader::_load_and_cache(const String &p_local_path, const String &p_type_hint, bool p_no_cache, Error *r_error) {
 
 	bool xl_remapped = false;
-	String path = _path_remap(local_path, &xl_remapped);
+	String path = _path_remap(p_local_path, &xl_remapped);
 
 	ERR_FAIL_COND_V(path == "", RES());
 
 	if (OS::get_singleton()->is_stdout_verbose())
 		print_line("load resource: " + path);
 
-	RES res = _load(path, local_path, p_type_hint, p_no_cache, r_error);
+	RES res = _load(path, p_local_path, p_type_hint, p_no_cache, r_error);
 
 	if (res.is_null()) {
 		return RES();
 	}
 	if (!p_no_cache)
-		res->set_path(local_path);
+		res->set_path(p_local_path);
 
 	if (xl_remapped)
 		res->set_as_translation_remapped(true);
@@ -239,6 +229,317 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p
 	return res;
 }
 
+RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p_no_cache, Error *r_error) {
+
+	if (r_error)
+		*r_error = ERR_CANT_OPEN;
+
+	String local_path = _validate_local_path(p_path);
+
+	if (p_no_cache) {
+		return _load_and_cache(local_path, p_type_hint, true, r_error);
+	}
+
+	load_task_mutex->lock();
+
+	RES cached = ResourceCache::get_ref(local_path);
+	if (cached.is_valid()) {
+
+		load_task_mutex->unlock();
+
+		if (OS::get_singleton()->is_stdout_verbose())
+			print_line("load resource: " + local_path + " (cached)");
+		if (r_error)
+			*r_error = OK;
+		return cached;
+	}
+
+	// join the load of another thread, or start it here
+	LoadTask *task;
+	LoadTask **E = load_tasks.getptr(local_path);
+	if (E) {
+		task = *E;
+		task->refs++;
+		load_task_mutex->unlock();
+	} else {
+		task = _request_task(local_path, p_type_hint, false, false);
+		task->started = true;
+		task->thread = Thread::get_caller_id();
+		load_task_mutex->unlock();
+		_run_task(task);
+	}
+
+	Error err = _wait_for_task(task);
+
+	load_task_mutex->lock();
+	RES res = task->resource;
+	if (err == OK) {
+		err = task->error;
+	}
+	load_task_mutex->unlock();
+
+	_release_task(task);
+
+	if (r_error)
+		*r_error = err;
+	return res;
+}
+
+ResourceLoader::LoadTask *ResourceLoader::_request_task(const String &p_local_path, const String &p_type_hint, bool p_use_sub_threads, bool p_queue) {
+
+	// with load_task_mutex held
+
+	LoadTask **E = load_tasks.getptr(p_local_path);
+	if (E) {
+		(*E)->refs++;
+		return *E;
+	}
+
+	LoadTask *task = memnew(LoadTask);
+	task->local_path = p_local_path;
+	task->type_hint = p_type_hint;
+	task->use_sub_threads = p_use_sub_threads;
+	task->group = ThreadPool::INVALID_GROUP_ID;
+	task->started = false;
+	task->thread = 0;
+	task->status = THREAD_LOAD_IN_PROGRESS;
+	task->error = OK;
+	task->requests = 0;
+	task->refs = 1;
+	task->waiters = 0;
+	task->done = Semaphore::create();
+
+	task->resource = ResourceCache::get_ref(p_local_path);
+	if (task->resource.is_valid()) {
+		task->status = THREAD_LOAD_LOADED;
+		task->started = true;
+	}
+
+	load_tasks.set(p_local_path, task);
+
+	if (p_queue && !task->started) {
+		// whoever waits for it first runs it if no worker picked it up yet
+		task->group = ThreadPool::get_singleton()->add_task(_thread_load_function, task);
+	}
+
+	return task;
+}
+
+void ResourceLoader::_run_task(LoadTask *p_task) {
+
+	if (p_task->use_sub_threads) {
+
+		// queue the dependencies first, so they load in parallel with this one
+		List<String> deps;
+		get_dependencies(p_task->local_path, &deps, true);
+
+		load_task_mutex->lock();
+		for (List<String>::Element *E = deps.front(); E; E = E->next()) {
+
+			String path = E->get().get_slice("::", 0);
+			String type = E->get().get_slice("::", 1);
+			p_task->dependencies.push_back(_request_task(_validate_local_path(path), type, true, true));
+		}
+		load_task_mutex->unlock();
+	}
+
+	Error err = OK;
+	RES res = _load_and_cache(p_task->local_path, p_task->type_hint, false, &err);
+
+	load_task_mutex->lock();
+
+	p_task->resource = res;
+	p_task->error = res.is_valid() ? OK : (err != OK ? err : ERR_CANT_OPEN);
+	p_task->status = res.is_valid() ? THREAD_LOAD_LOADED : THREAD_LOAD_FAILED;
+
+	for (int i = 0; i < p_task->waiters; i++) {
+		p_task->done->post();
+	}
+	p_task->waiters = 0;
+
+	Vector<LoadTask *> dependencies = p_task->dependencies;
+	p_task->dependencies.clear();
+
+	load_task_mutex->unlock();
+
+	for (int i = 0; i < dependencies.size(); i++) {
+		_wait_for_task(dependencies[i]);
+		_release_task(dependencies[i]);
+	}
+}
+
+void ResourceLoader::_thread_load_function(void *p_task) {
+
+	LoadTask *task = (LoadTask *)p_task;
+
+	load_task_mutex->lock();
+	if (task->started) {
+		// already run by a thread waiting for it
+		load_task_mutex->unlock();
+		return;
+	}
+	task->started = true;
+	task->thread = Thread::get_caller_id();
+	load_task_mutex->unlock();
+
+	_run_task(task);
+}
+
+Error ResourceLoader::_wait_for_task(LoadTask *p_task) {
+
+	Thread::ID caller = Thread::get_caller_id();
+
+	load_task_mutex->lock();
+
+	if (p_task->status != THREAD_LOAD_IN_PROGRESS) {
+		load_task_mutex->unlock();
+		return OK;
+	}
+
+	if (!p_task->started) {
+		// not picked up by a worker yet, load it here
+		p_task->started = true;
+		p_task->thread = caller;
+		load_task_mutex->unlock();
+		_run_task(p_task);
+		return OK;
+	}
+
+	// follow the chain of loading threads waiting for each other
+	LoadTask *t = p_task;
+	while (t) {
+		if (t->thread == caller) {
+			load_task_mutex->unlock();
+			ERR_EXPLAIN("Cyclic resource inclusion while loading: " + p_task->local_path);
+			ERR_FAIL_V(ERR_CYCLIC_LINK);
+		}
+		LoadTask **w = thread_waits.getptr(t->thread);
+		t = w ? *w : NULL;
+	}
+
+	p_task->waiters++;
+	thread_waits.set(caller, p_task);
+	load_task_mutex->unlock();
+
+	p_task->done->wait();
+
+	load_task_mutex->lock();
+	thread_waits.erase(caller);
+	load_task_mutex->unlock();
+
+	return OK;
+}
+
+void ResourceLoader::_release_task(LoadTask *p_task) {
+
+	load_task_mutex->lock();
+
+	p_task->refs--;
+	if (p_task->refs > 0) {
+		load_task_mutex->unlock();
+		return;
+	}
+
+	ERR_FAIL_COND(p_task->status == THREAD_LOAD_IN_PROGRESS);
+
+	load_tasks.erase(p_task->local_path);
+	load_task_mutex->unlock();
+
+	if (p_task->group != ThreadPool::INVALID_GROUP_ID) {
+		ThreadPool::get_singleton()->wait_for_group(p_task->group);
+	}
+
+	memdelete(p_task->done);
+	memdelete(p_task);
+}
+
+Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads) {
+
+	String local_path = _validate_local_path(p_path);
+
+	load_task_mutex->lock();
+
+	LoadTask *task = _request_task(local_path, p_type_hint, p_use_sub_threads, ThreadPool::get_singleton()->get_thread_count() > 0);
+	task->requests++;
+
+	bool run_here = !task->started && task->group == ThreadPool::INVALID_GROUP_ID;
+	if (run_here) {
+		// no worker threads, load right away
+		task->started = true;
+		task->thread = Thread::get_caller_id();
+	}
+
+	load_task_mutex->unlock();
+
+	if (run_here) {
+		_run_task(task);
+	}
+
+	return OK;
+}
+
+ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const String &p_path, float *r_progress) {
+
+	String local_path = _validate_local_path(p_path);
+
+	MutexLock lock(load_task_mutex);
+
+	LoadTask **E = load_tasks.getptr(local_path);
+	if (!E || (*E)->requests == 0) {
+		return THREAD_LOAD_INVALID_RESOURCE;
+	}
+
+	LoadTask *task = *E;
+
+	if (r_progress) {
+		int loaded = task->status != THREAD_LOAD_IN_PROGRESS ? 1 : 0;
+		for (int i = 0; i < task->dependencies.size(); i++) {
+			if (task->dependencies[i]->status != THREAD_LOAD_IN_PROGRESS)
+				loaded++;
+		}
+		*r_progress = loaded / float(task->dependencies.size() + 1);
+	}
+
+	return task->status;
+}
+
+RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
+
+	if (r_error)
+		*r_error = ERR_INVALID_PARAMETER;
+
+	String local_path = _validate_local_path(p_path);
+
+	load_task_mutex->lock();
+
+	LoadTask **E = load_tasks.getptr(local_path);
+	if (!E || (*E)->requests == 0) {
+		load_task_mutex->unlock();
+		ERR_EXPLAIN("Resource was not requested to load in the background: " + local_path);
+		ERR_FAIL_V(RES());
+	}
+
+	LoadTask *task = *E;
+	task->requests--;
+
+	load_task_mutex->unlock();
+
+	Error err = _wait_for_task(task);
+
+	load_task_mutex->lock();
+	RES res = task->resource;
+	if (err == OK) {
+		err = task->error;
+	}
+	load_task_mutex->unlock();
+
+	_release_task(task);
+
+	if (r_error)
+		*r_error = err;
+	return res;
+}
+
 Ref<ResourceInteractiveLoader> ResourceLoader::load_interactive(const String &p_path, const String &p_type_hint, bool p_no_cache, Error *r_error) {
 
 	if (r_error)
@@ -250,12 +551,12 @@ Ref<ResourceInteractiveLoader> ResourceLoader::load_interactive(const String &p_
 	else
 		local_path = ProjectSettings::get_singleton()->localize_path(p_path);
 
-	if (!p_no_cache && ResourceCache::has(local_path)) {
+	Ref<Resource> res_cached = p_no_cache ? Ref<Resource>() : ResourceCache::get_ref(local_path);
+	if (res_cached.is_valid()) {
 
 		if (OS::get_singleton()->is_stdout_verbose())
 			print_line("load resource: " + local_path + " (cached)");
 
-		Ref<Resource> res_cached = ResourceCache::get(local_path);
 		Ref<ResourceInteractiveLoaderDefault> ril = Ref<ResourceInteractiveLoaderDefault>(memnew(ResourceInteractiveLoaderDefault));
 
 		ril->resource = res_cached;
@@ -600,3 +901,52 @@ bool ResourceLoader::timestamp_on_load = false;
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, Vector<String> > ResourceLoader::translation_remaps;
 HashMap<String, String> ResourceLoader::path_remaps;
+
+Mutex *ResourceLoader::load_task_mutex = NULL;
+HashMap<String, ResourceLoader::LoadTask *> ResourceLoader::load_tasks;
+HashMap<Thread::ID, ResourceLoader::LoadTask *> ResourceLoader::thread_waits;
+
+void ResourceLoader::setup() {
+
+	load_task_mutex = Mutex::create();
+}
+
+void ResourceLoader::finish_threaded_loads() {
+
+	// drop the background loads not started yet, wait for the running ones
+	// and release the results nobody collected
+	while (true) {
+
+		load_task_mutex->lock();
+		const String *K = load_tasks.next(NULL);
+		LoadTask *task = K ? load_tasks[*K] : NULL;
+		if (task) {
+			task->refs++;
+			if (!task->started) {
+				task->started = true;
+				task->status = THREAD_LOAD_FAILED;
+				task->error = ERR_UNAVAILABLE;
+			}
+		}
+		load_task_mutex->unlock();
+
+		if (!task)
+			break;
+
+		_wait_for_task(task);
+
+		load_task_mutex->lock();
+		int requests = task->requests;
+		task->requests = 0;
+		task->refs -= requests;
+		load_task_mutex->unlock();
+
+		_release_task(task);
+	}
+}
+
+void ResourceLoader::cleanup() {
+
+	memdelete(load_task_mutex);
+	load_task_mutex = NULL;
+}
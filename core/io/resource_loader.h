@@ -31,6 +31,7 @@
 #ifndef RESOURCE_LOADER_H
 #define RESOURCE_LOADER_H
 
+#include "os/thread_pool.h"
 #include "resource.h"
 
 /**
@@ -82,6 +83,48 @@ class ResourceLoader {
 		MAX_LOADERS = 64
 	};
 
+public:
+	enum ThreadLoadStatus {
+		THREAD_LOAD_INVALID_RESOURCE,
+		THREAD_LOAD_IN_PROGRESS,
+		THREAD_LOAD_FAILED,
+		THREAD_LOAD_LOADED
+	};
+
+private:
+	// Every cached load in flight, whether requested to load in the
+	// background or loaded by a thread calling load(), so that the same
+	// path is never loaded twice at once.
+	struct LoadTask {
+
+		String local_path;
+		String type_hint;
+		bool use_sub_threads;
+		ThreadPool::GroupID group; //queued on the thread pool, if requested
+		bool started;
+		Thread::ID thread; //loading it, once started
+		ThreadLoadStatus status;
+		Error error;
+		RES resource;
+		int requests; //pending load_threaded_get() calls
+		int refs; //requests, waiting threads and depending tasks
+		int waiters;
+		Semaphore *done;
+		Vector<LoadTask *> dependencies; //requested on sub threads
+	};
+
+	static Mutex *load_task_mutex;
+	static HashMap<String, LoadTask *> load_tasks;
+	static HashMap<Thread::ID, LoadTask *> thread_waits; //task each blocked thread waits for
+
+	static String _validate_local_path(const String &p_path);
+	static RES _load_and_cache(const String &p_local_path, const String &p_type_hint, bool p_no_cache, Error *r_error);
+	static LoadTask *_request_task(const String &p_local_path, const String &p_type_hint, bool p_use_sub_threads, bool p_queue);
+	static void _run_task(LoadTask *p_task);
+	static void _thread_load_function(void *p_task);
+	static Error _wait_for_task(LoadTask *p_task);
+	static void _release_task(LoadTask *p_task);
+
 	static ResourceFormatLoader *loader[MAX_LOADERS];
 	static int loader_count;
 	static bool timestamp_on_load;
@@ -107,6 +150,10 @@ public:
 	static Ref<ResourceInteractiveLoader> load_interactive(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false, Error *r_error = NULL);
 	static RES load(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false, Error *r_error = NULL);
 
+	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false);
+	static ThreadLoadStatus load_threaded_get_status(const String &p_path, float *r_progress = NULL);
+	static RES load_threaded_get(const String &p_path, Error *r_error = NULL);
+
 	static void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions);
 	static void add_resource_format_loader(ResourceFormatLoader *p_format_loader, bool p_at_front = false);
 	static String get_resource_type(const String &p_path);
@@ -145,6 +192,10 @@ public:
 	static void reload_translation_remaps();
 	static void load_translation_remaps();
 	static void clear_translation_remaps();
+
+	static void finish_threaded_loads(); // before the loaders and servers are unregistered
+	static void setup();
+	static void cleanup();
 };
 
 #endif
@@ -0,0 +1,71 @@
+/*************************************************************************/
+/*  tcp_poller.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "tcp_poller.h"
+
+TCP_Poller *(*TCP_Poller::_create)() = NULL;
+
+Ref<TCP_Poller> TCP_Poller::create_ref() {
+
+	if (!_create)
+		return NULL;
+	return Ref<TCP_Poller>(_create());
+}
+
+TCP_Poller *TCP_Poller::create() {
+
+	if (!_create)
+		return NULL;
+	return _create();
+}
+
+Array TCP_Poller::_get_ready() const {
+
+	Array ready;
+	for (int i = 0; i < get_ready_count(); i++) {
+		ready.push_back(get_ready(i));
+	}
+	return ready;
+}
+
+void TCP_Poller::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("add_peer", "peer"), &TCP_Poller::add_peer);
+	ClassDB::bind_method(D_METHOD("add_server", "server"), &TCP_Poller::add_server);
+	ClassDB::bind_method(D_METHOD("remove", "object"), &TCP_Poller::remove);
+	ClassDB::bind_method(D_METHOD("has", "object"), &TCP_Poller::has);
+	ClassDB::bind_method(D_METHOD("get_count"), &TCP_Poller::get_count);
+	ClassDB::bind_method(D_METHOD("clear"), &TCP_Poller::clear);
+	ClassDB::bind_method(D_METHOD("wait", "timeout_msec"), &TCP_Poller::wait, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("get_ready"), &TCP_Poller::_get_ready);
+}
+
+TCP_Poller::TCP_Poller() {
+}
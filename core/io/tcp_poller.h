@@ -0,0 +1,70 @@
+/*************************************************************************/
+/*  tcp_poller.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TCP_POLLER_H
+#define TCP_POLLER_H
+
+#include "io/stream_peer_tcp.h"
+#include "io/tcp_server.h"
+
+// Watches many TCP connections and servers at once, so they do not need to
+// be polled one by one every frame to find the few that have something to do.
+
+class TCP_Poller : public Reference {
+
+	GDCLASS(TCP_Poller, Reference);
+
+protected:
+	static TCP_Poller *(*_create)();
+
+	Array _get_ready() const;
+
+	//bind helper
+	static void _bind_methods();
+
+public:
+	virtual Error add_peer(const Ref<StreamPeerTCP> &p_peer) = 0;
+	virtual Error add_server(const Ref<TCP_Server> &p_server) = 0;
+	virtual void remove(const Ref<Reference> &p_object) = 0;
+	virtual bool has(const Ref<Reference> &p_object) const = 0;
+	virtual int get_count() const = 0;
+	virtual void clear() = 0;
+
+	virtual int wait(int p_timeout_msec = 0) = 0; //returns the amount of ready objects
+	virtual int get_ready_count() const = 0;
+	virtual Ref<Reference> get_ready(int p_index) const = 0;
+
+	static Ref<TCP_Poller> create_ref();
+	static TCP_Poller *create();
+
+	TCP_Poller();
+};
+
+#endif // TCP_POLLER_H
@@ -0,0 +1,197 @@
+/*************************************************************************/
+/*  local_vector.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef LOCAL_VECTOR_H
+#define LOCAL_VECTOR_H
+
+#include "error_macros.h"
+#include "os/copymem.h"
+#include "os/memory.h"
+
+/**
+ * A plain dynamic array for hot internal bookkeeping.
+ *
+ * Unlike Vector, it is not copy-on-write and does not release its memory
+ * when cleared, so containers that are emptied and refilled every frame
+ * stop allocating once they reach their working size.
+ *
+ * Storage is grown with memrealloc, so T must be relocatable (it must not
+ * keep pointers into itself). LocalVector itself is, so they can be nested.
+ */
+template <class T>
+class LocalVector {
+
+	T *data;
+	uint32_t count;
+	uint32_t capacity;
+
+public:
+	_FORCE_INLINE_ T *ptr() { return data; }
+	_FORCE_INLINE_ const T *ptr() const { return data; }
+	_FORCE_INLINE_ uint32_t size() const { return count; }
+	_FORCE_INLINE_ bool empty() const { return count == 0; }
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+
+	void reserve(uint32_t p_size) {
+
+		if (p_size <= capacity)
+			return;
+		capacity = next_power_of_2(p_size);
+		data = (T *)memrealloc(data, capacity * sizeof(T));
+		CRASH_COND(!data);
+	}
+
+	void resize(uint32_t p_size) {
+
+		if (p_size < count) {
+			for (uint32_t i = p_size; i < count; i++) {
+				data[i].~T();
+			}
+			count = p_size;
+		} else if (p_size > count) {
+			reserve(p_size);
+			for (uint32_t i = count; i < p_size; i++) {
+				memnew_placement(&data[i], T);
+			}
+			count = p_size;
+		}
+	}
+
+	_FORCE_INLINE_ void push_back(const T &p_elem) {
+
+		if (unlikely(count == capacity)) {
+			reserve(count + 1);
+		}
+		memnew_placement(&data[count], T(p_elem));
+		count++;
+	}
+
+	void remove(uint32_t p_index) {
+
+		ERR_FAIL_COND(p_index >= count);
+		for (uint32_t i = p_index; i + 1 < count; i++) {
+			data[i] = data[i + 1];
+		}
+		count--;
+		data[count].~T();
+	}
+
+	// Removes by moving the last element into the hole, order is not kept.
+	_FORCE_INLINE_ void remove_unordered(uint32_t p_index) {
+
+		ERR_FAIL_COND(p_index >= count);
+		count--;
+		if (p_index < count) {
+			data[p_index] = data[count];
+		}
+		data[count].~T();
+	}
+
+	int64_t find(const T &p_val, uint32_t p_from = 0) const {
+
+		for (uint32_t i = p_from; i < count; i++) {
+			if (data[i] == p_val) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	bool erase_unordered(const T &p_val) {
+
+		int64_t idx = find(p_val);
+		if (idx < 0)
+			return false;
+		remove_unordered(idx);
+		return true;
+	}
+
+	// Destroys the elements but keeps the memory around for reuse.
+	void clear() {
+
+		resize(0);
+	}
+
+	// Destroys the elements and frees the memory.
+	void reset() {
+
+		clear();
+		if (data) {
+			memfree(data);
+			data = NULL;
+			capacity = 0;
+		}
+	}
+
+	_FORCE_INLINE_ T &operator[](uint32_t p_index) {
+
+		CRASH_COND(p_index >= count);
+		return data[p_index];
+	}
+	_FORCE_INLINE_ const T &operator[](uint32_t p_index) const {
+
+		CRASH_COND(p_index >= count);
+		return data[p_index];
+	}
+
+	void operator=(const LocalVector &p_from) {
+
+		if (&p_from == this)
+			return;
+		clear();
+		reserve(p_from.count);
+		for (uint32_t i = 0; i < p_from.count; i++) {
+			memnew_placement(&data[i], T(p_from.data[i]));
+		}
+		count = p_from.count;
+	}
+
+	_FORCE_INLINE_ LocalVector(const LocalVector &p_from) {
+
+		data = NULL;
+		count = 0;
+		capacity = 0;
+		*this = p_from;
+	}
+
+	_FORCE_INLINE_ LocalVector() {
+
+		data = NULL;
+		count = 0;
+		capacity = 0;
+	}
+
+	_FORCE_INLINE_ ~LocalVector() {
+
+		reset();
+	}
+};
+
+#endif // LOCAL_VECTOR_H
@@ -30,16 +30,27 @@
 
 #include "a_star.h"
 #include "geometry.h"
+#include "os/thread_pool.h"
 #include "scene/scene_string_names.h"
 #include "script_language.h"
 
 int AStar::get_available_point_id() const {
 
-	if (points.empty()) {
+	if (point_map.empty()) {
 		return 1;
 	}
 
-	return points.back()->key() + 1;
+	if (max_id_dirty) {
+		max_id = -1;
+		const int *k = NULL;
+		while ((k = point_map.next(k))) {
+			if (*k > max_id)
+				max_id = *k;
+		}
+		max_id_dirty = false;
+	}
+
+	return max_id + 1;
 }
 
 void AStar::add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale) {
@@ -47,114 +58,184 @@ void AStar::add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale) {
 	ERR_FAIL_COND(p_id < 0);
 	ERR_FAIL_COND(p_weight_scale < 1);
 
-	if (!points.has(p_id)) {
-		Point *pt = memnew(Point);
-		pt->id = p_id;
-		pt->pos = p_pos;
-		pt->weight_scale = p_weight_scale;
-		pt->prev_point = NULL;
-		pt->last_pass = 0;
-		points[p_id] = pt;
+	uint32_t idx = _get_point_index(p_id);
+
+	if (idx == INVALID_INDEX) {
+
+		if (free_point != INVALID_INDEX) {
+			idx = free_point;
+			free_point = points[idx].next_free;
+		} else {
+			idx = points.size();
+			points.resize(idx + 1);
+		}
+
+		Point &pt = points[idx];
+		pt.id = p_id;
+		pt.pos = p_pos;
+		pt.weight_scale = p_weight_scale;
+		pt.next_free = INVALID_INDEX;
+		point_map.set(p_id, idx);
+
+		if (p_id > max_id)
+			max_id = p_id;
 	} else {
-		points[p_id]->pos = p_pos;
-		points[p_id]->weight_scale = p_weight_scale;
+		points[idx].pos = p_pos;
+		points[idx].weight_scale = p_weight_scale;
 	}
 }
 
 Vector3 AStar::get_point_position(int p_id) const {
 
-	ERR_FAIL_COND_V(!points.has(p_id), Vector3());
+	uint32_t idx = _get_point_index(p_id);
+	ERR_FAIL_COND_V(idx == INVALID_INDEX, Vector3());
 
-	return points[p_id]->pos;
+	return points[idx].pos;
 }
 
 void AStar::set_point_position(int p_id, const Vector3 &p_pos) {
 
-	ERR_FAIL_COND(!points.has(p_id));
+	uint32_t idx = _get_point_index(p_id);
+	ERR_FAIL_COND(idx == INVALID_INDEX);
 
-	points[p_id]->pos = p_pos;
+	points[idx].pos = p_pos;
 }
 
 real_t AStar::get_point_weight_scale(int p_id) const {
 
-	ERR_FAIL_COND_V(!points.has(p_id), 0);
+	uint32_t idx = _get_point_index(p_id);
+	ERR_FAIL_COND_V(idx == INVALID_INDEX, 0);
 
-	return points[p_id]->weight_scale;
+	return points[idx].weight_scale;
 }
 
 void AStar::set_point_weight_scale(int p_id, real_t p_weight_scale) {
 
-	ERR_FAIL_COND(!points.has(p_id));
+	uint32_t idx = _get_point_index(p_id);
+	ERR_FAIL_COND(idx == INVALID_INDEX);
 	ERR_FAIL_COND(p_weight_scale < 1);
 
-	points[p_id]->weight_scale = p_weight_scale;
+	points[idx].weight_scale = p_weight_scale;
+}
+
+void AStar::_remove_neighbour(Point &p_point, uint32_t p_neighbour) {
+
+	int64_t pos = p_point.neighbours.find(p_neighbour);
+	if (pos >= 0) {
+		p_point.neighbours.remove(pos); // keep connection order
+	} else {
+		p_point.unlinked_neighbours.erase_unordered(p_neighbour);
+	}
 }
 
 void AStar::remove_point(int p_id) {
 
-	ERR_FAIL_COND(!points.has(p_id));
+	uint32_t idx = _get_point_index(p_id);
+	ERR_FAIL_COND(idx == INVALID_INDEX);
+
+	Point &p = points[idx];
+
+	for (uint32_t i = 0; i < p.neighbours.size(); i++) {
 
-	Point *p = points[p_id];
+		Point &n = points[p.neighbours[i]];
+		segments.erase(_segment_key(p_id, n.id));
+		_remove_neighbour(n, idx);
+	}
 
-	for (int i = 0; i < p->neighbours.size(); i++) {
+	for (uint32_t i = 0; i < p.unlinked_neighbours.size(); i++) {
 
-		Segment s(p_id, p->neighbours[i]->id);
-		segments.erase(s);
-		p->neighbours[i]->neighbours.erase(p);
+		Point &n = points[p.unlinked_neighbours[i]];
+		segments.erase(_segment_key(p_id, n.id));
+		_remove_neighbour(n, idx);
 	}
 
-	memdelete(p);
-	points.erase(p_id);
+	p.id = -1;
+	p.neighbours.reset();
+	p.unlinked_neighbours.reset();
+	p.next_free = free_point;
+	free_point = idx;
+
+	point_map.erase(p_id);
+
+	if (p_id == max_id)
+		max_id_dirty = true;
 }
 
 void AStar::connect_points(int p_id, int p_with_id, bool bidirectional) {
 
-	ERR_FAIL_COND(!points.has(p_id));
-	ERR_FAIL_COND(!points.has(p_with_id));
+	uint32_t a_idx = _get_point_index(p_id);
+	uint32_t b_idx = _get_point_index(p_with_id);
+	ERR_FAIL_COND(a_idx == INVALID_INDEX);
+	ERR_FAIL_COND(b_idx == INVALID_INDEX);
 	ERR_FAIL_COND(p_id == p_with_id);
 
-	Point *a = points[p_id];
-	Point *b = points[p_with_id];
-	a->neighbours.push_back(b);
+	Point &a = points[a_idx];
+	Point &b = points[b_idx];
 
-	if (bidirectional)
-		b->neighbours.push_back(a);
+	if (a.neighbours.find(b_idx) < 0) {
+		a.neighbours.push_back(b_idx);
+		a.unlinked_neighbours.erase_unordered(b_idx);
+	}
 
-	Segment s(p_id, p_with_id);
-	if (s.from == p_id) {
-		s.from_point = a;
-		s.to_point = b;
-	} else {
-		s.from_point = b;
-		s.to_point = a;
+	if (bidirectional) {
+		if (b.neighbours.find(a_idx) < 0) {
+			b.neighbours.push_back(a_idx);
+			b.unlinked_neighbours.erase_unordered(a_idx);
+		}
+	} else if (b.neighbours.find(a_idx) < 0 && b.unlinked_neighbours.find(a_idx) < 0) {
+		b.unlinked_neighbours.push_back(a_idx);
 	}
 
-	segments.insert(s);
+	uint64_t key = _segment_key(p_id, p_with_id);
+	if (!segments.has(key)) {
+		Segment s;
+		if (p_id < p_with_id) {
+			s.from_point = a_idx;
+			s.to_point = b_idx;
+		} else {
+			s.from_point = b_idx;
+			s.to_point = a_idx;
+		}
+		segments.set(key, s);
+	}
 }
+
 void AStar::disconnect_points(int p_id, int p_with_id) {
 
-	Segment s(p_id, p_with_id);
-	ERR_FAIL_COND(!segments.has(s));
+	uint64_t key = _segment_key(p_id, p_with_id);
+	ERR_FAIL_COND(!segments.has(key));
+
+	segments.erase(key);
 
-	segments.erase(s);
+	uint32_t a_idx = _get_point_index(p_id);
+	uint32_t b_idx = _get_point_index(p_with_id);
 
-	Point *a = points[p_id];
-	Point *b = points[p_with_id];
-	a->neighbours.erase(b);
-	b->neighbours.erase(a);
+	_remove_neighbour(points[a_idx], b_idx);
+	_remove_neighbour(points[b_idx], a_idx);
 }
 
 bool AStar::has_point(int p_id) const {
 
-	return points.has(p_id);
+	return point_map.has(p_id);
 }
 
 Array AStar::get_points() {
 
-	Array point_list;
+	Vector<int> ids;
+	ids.resize(point_map.size());
+	int *w = ids.ptrw();
 
-	for (const Map<int, Point *>::Element *E = points.front(); E; E = E->next()) {
-		point_list.push_back(E->key());
+	int i = 0;
+	const int *k = NULL;
+	while ((k = point_map.next(k))) {
+		w[i++] = *k;
+	}
+	ids.sort();
+
+	Array point_list;
+	point_list.resize(ids.size());
+	for (i = 0; i < ids.size(); i++) {
+		point_list[i] = ids[i];
 	}
 
 	return point_list;
@@ -162,14 +243,19 @@ Array AStar::get_points() {
 
 PoolVector<int> AStar::get_point_connections(int p_id) {
 
-	ERR_FAIL_COND_V(!points.has(p_id), PoolVector<int>());
+	uint32_t idx = _get_point_index(p_id);
+	ERR_FAIL_COND_V(idx == INVALID_INDEX, PoolVector<int>());
 
-	PoolVector<int> point_list;
+	const Point &p = points[idx];
 
-	Point *p = points[p_id];
+	PoolVector<int> point_list;
+	point_list.resize(p.neighbours.size());
 
-	for (int i = 0; i < p->neighbours.size(); i++) {
-		point_list.push_back(p->neighbours[i]->id);
+	{
+		PoolVector<int>::Write w = point_list.write();
+		for (uint32_t i = 0; i < p.neighbours.size(); i++) {
+			w[i] = points[p.neighbours[i]].id;
+		}
 	}
 
 	return point_list;
@@ -177,18 +263,19 @@ PoolVector<int> AStar::get_point_connections(int p_id) {
 
 bool AStar::are_points_connected(int p_id, int p_with_id) const {
 
-	Segment s(p_id, p_with_id);
-	return segments.has(s);
+	return segments.has(_segment_key(p_id, p_with_id));
 }
 
 void AStar::clear() {
 
-	for (const Map<int, Point *>::Element *E = points.front(); E; E = E->next()) {
-
-		memdelete(E->get());
-	}
+	points.reset();
+	point_map.clear();
 	segments.clear();
-	points.clear();
+	free_point = INVALID_INDEX;
+	max_id = -1;
+	max_id_dirty = false;
+	solve_data.states.reset();
+	solve_data.open_heap.reset();
 }
 
 int AStar::get_closest_point(const Vector3 &p_point) const {
@@ -196,12 +283,16 @@ int AStar::get_closest_point(const Vector3 &p_point) const {
 	int closest_id = -1;
 	real_t closest_dist = 1e20;
 
-	for (const Map<int, Point *>::Element *E = points.front(); E; E = E->next()) {
+	for (uint32_t i = 0; i < points.size(); i++) {
+
+		const Point &p = points[i];
+		if (p.id < 0)
+			continue;
 
-		real_t d = p_point.distance_squared_to(E->get()->pos);
-		if (closest_id < 0 || d < closest_dist) {
+		real_t d = p_point.distance_squared_to(p.pos);
+		if (closest_id < 0 || d < closest_dist || (d == closest_dist && p.id < closest_id)) {
 			closest_dist = d;
-			closest_id = E->key();
+			closest_id = p.id;
 		}
 	}
 
@@ -211,22 +302,27 @@ int AStar::get_closest_point(const Vector3 &p_point) const {
 Vector3 AStar::get_closest_position_in_segment(const Vector3 &p_point) const {
 
 	real_t closest_dist = 1e20;
+	uint64_t closest_key = 0;
 	bool found = false;
 	Vector3 closest_point;
 
-	for (const Set<Segment>::Element *E = segments.front(); E; E = E->next()) {
+	const uint64_t *k = NULL;
+	while ((k = segments.next(k))) {
+
+		const Segment &s = segments.get(*k);
 
 		Vector3 segment[2] = {
-			E->get().from_point->pos,
-			E->get().to_point->pos,
+			points[s.from_point].pos,
+			points[s.to_point].pos,
 		};
 
 		Vector3 p = Geometry::get_closest_point_to_segment(p_point, segment);
 		real_t d = p_point.distance_squared_to(p);
-		if (!found || d < closest_dist) {
+		if (!found || d < closest_dist || (d == closest_dist && *k < closest_key)) {
 
 			closest_point = p;
 			closest_dist = d;
+			closest_key = *k;
 			found = true;
 		}
 	}
@@ -234,100 +330,160 @@ Vector3 AStar::get_closest_position_in_segment(const Vector3 &p_point) const {
 	return closest_point;
 }
 
-bool AStar::_solve(Point *begin_point, Point *end_point) {
+void AStar::SolveData::prepare(uint32_t p_point_count) {
+
+	if (states.size() < p_point_count) {
+		uint32_t from = states.size();
+		states.resize(p_point_count);
+		for (uint32_t i = from; i < p_point_count; i++) {
+			states[i].last_pass = 0;
+		}
+	}
 
 	pass++;
+	open_count = 0;
+	open_heap.clear();
+}
 
-	SelfList<Point>::List open_list;
+void AStar::SolveData::heap_push(uint32_t p_point) {
 
-	bool found_route = false;
+	states[p_point].heap_pos = open_heap.size();
+	states[p_point].open_order = open_count++;
+	open_heap.push_back(p_point);
+	heap_update(p_point);
+}
 
-	for (int i = 0; i < begin_point->neighbours.size(); i++) {
+void AStar::SolveData::heap_update(uint32_t p_point) {
 
-		Point *n = begin_point->neighbours[i];
-		n->prev_point = begin_point;
-		n->distance = _compute_cost(begin_point->id, n->id) * n->weight_scale;
-		n->last_pass = pass;
-		open_list.add(&n->list);
+	// Costs only decrease while a point is open, so sifting up is enough.
+	uint32_t pos = states[p_point].heap_pos;
 
-		if (end_point == n) {
-			found_route = true;
+	while (pos > 0) {
+		uint32_t parent = (pos - 1) >> 1;
+		uint32_t parent_point = open_heap[parent];
+		if (!is_before(p_point, parent_point))
 			break;
-		}
+		open_heap[pos] = parent_point;
+		states[parent_point].heap_pos = pos;
+		pos = parent;
 	}
 
-	while (!found_route) {
+	open_heap[pos] = p_point;
+	states[p_point].heap_pos = pos;
+}
 
-		if (open_list.first() == NULL) {
-			// No path found
+uint32_t AStar::SolveData::heap_pop() {
+
+	uint32_t top = open_heap[0];
+	states[top].heap_pos = INVALID_INDEX;
+
+	uint32_t last = open_heap[open_heap.size() - 1];
+	open_heap.resize(open_heap.size() - 1);
+
+	uint32_t count = open_heap.size();
+	if (count == 0)
+		return top;
+
+	uint32_t pos = 0;
+
+	while (true) {
+		uint32_t child = (pos << 1) + 1;
+		if (child >= count)
 			break;
-		}
-		// Check open list
+		if (child + 1 < count && is_before(open_heap[child + 1], open_heap[child]))
+			child++;
+		if (!is_before(open_heap[child], last))
+			break;
+		open_heap[pos] = open_heap[child];
+		states[open_heap[pos]].heap_pos = pos;
+		pos = child;
+	}
 
-		SelfList<Point> *least_cost_point = NULL;
-		real_t least_cost = 1e30;
+	open_heap[pos] = last;
+	states[last].heap_pos = pos;
 
-		// TODO: Cache previous results
-		for (SelfList<Point> *E = open_list.first(); E; E = E->next()) {
+	return top;
+}
 
-			Point *p = E->self();
+bool AStar::_has_script_costs() const {
 
-			real_t cost = p->distance;
-			cost += _estimate_cost(p->id, end_point->id);
+	ScriptInstance *si = get_script_instance();
+	if (!si)
+		return false;
 
-			if (cost < least_cost) {
+	return si->has_method(SceneStringNames::get_singleton()->_estimate_cost) || si->has_method(SceneStringNames::get_singleton()->_compute_cost);
+}
 
-				least_cost_point = E;
-				least_cost = cost;
-			}
-		}
+bool AStar::_solve(uint32_t p_begin_point, uint32_t p_end_point, SolveData &r_data, bool p_script_costs) {
+
+	r_data.prepare(points.size());
+
+	SolveData::State *states = r_data.states.ptr();
+	const Point *pts = points.ptr();
+	const Point &end_point = pts[p_end_point];
+
+	SolveData::State &begin_state = states[p_begin_point];
+	begin_state.last_pass = r_data.pass;
+	begin_state.prev_point = INVALID_INDEX;
+	begin_state.heap_pos = INVALID_INDEX;
+	begin_state.distance = 0;
+	begin_state.estimate = 0;
+	begin_state.cost = 0;
+
+	uint32_t p_idx = p_begin_point;
+
+	while (true) {
 
-		Point *p = least_cost_point->self();
 		// Open the neighbours for search
-		int es = p->neighbours.size();
+		const Point &p = pts[p_idx];
+		real_t p_distance = states[p_idx].distance;
 
-		for (int i = 0; i < es; i++) {
+		for (uint32_t i = 0; i < p.neighbours.size(); i++) {
 
-			Point *e = p->neighbours[i];
+			uint32_t e_idx = p.neighbours[i];
+			const Point &e = pts[e_idx];
+			SolveData::State &es = states[e_idx];
 
-			real_t distance = _compute_cost(p->id, e->id) * e->weight_scale + p->distance;
+			real_t cost = p_script_costs ? _compute_cost(p.id, e.id) : p.pos.distance_to(e.pos);
+			real_t distance = cost * e.weight_scale + p_distance;
 
-			if (e->last_pass == pass) {
+			if (es.last_pass == r_data.pass) {
 				// Already visited, is this cheaper?
 
-				if (e->distance > distance) {
+				if (es.distance > distance) {
+
+					es.prev_point = p_idx;
+					es.distance = distance;
+					es.cost = distance + es.estimate;
 
-					e->prev_point = p;
-					e->distance = distance;
+					if (es.heap_pos != INVALID_INDEX)
+						r_data.heap_update(e_idx);
 				}
 			} else {
 				// Add to open neighbours
 
-				e->prev_point = p;
-				e->distance = distance;
-				e->last_pass = pass; // Mark as used
-				open_list.add(&e->list);
+				es.last_pass = r_data.pass; // Mark as used
+				es.prev_point = p_idx;
+				es.distance = distance;
 
-				if (e == end_point) {
+				if (e_idx == p_end_point) {
 					// End reached; stop algorithm
-					found_route = true;
-					break;
+					return true;
 				}
+
+				es.estimate = p_script_costs ? _estimate_cost(e.id, end_point.id) : e.pos.distance_to(end_point.pos);
+				es.cost = distance + es.estimate;
+				r_data.heap_push(e_idx);
 			}
 		}
 
-		if (found_route)
-			break;
-
-		open_list.remove(least_cost_point);
-	}
+		if (r_data.open_heap.empty()) {
+			// No path found
+			return false;
+		}
 
-	// Clear the openf list
-	while (open_list.first()) {
-		open_list.remove(open_list.first());
+		p_idx = r_data.heap_pop();
 	}
-
-	return found_route;
 }
 
 float AStar::_estimate_cost(int p_from_id, int p_to_id) {
@@ -335,7 +491,7 @@ float AStar::_estimate_cost(int p_from_id, int p_to_id) {
 	if (get_script_instance() && get_script_instance()->has_method(SceneStringNames::get_singleton()->_estimate_cost))
 		return get_script_instance()->call(SceneStringNames::get_singleton()->_estimate_cost, p_from_id, p_to_id);
 
-	return points[p_from_id]->pos.distance_to(points[p_to_id]->pos);
+	return points[_get_point_index(p_from_id)].pos.distance_to(points[_get_point_index(p_to_id)].pos);
 }
 
 float AStar::_compute_cost(int p_from_id, int p_to_id) {
@@ -343,39 +499,35 @@ float AStar::_compute_cost(int p_from_id, int p_to_id) {
 	if (get_script_instance() && get_script_instance()->has_method(SceneStringNames::get_singleton()->_compute_cost))
 		return get_script_instance()->call(SceneStringNames::get_singleton()->_compute_cost, p_from_id, p_to_id);
 
-	return points[p_from_id]->pos.distance_to(points[p_to_id]->pos);
+	return points[_get_point_index(p_from_id)].pos.distance_to(points[_get_point_index(p_to_id)].pos);
 }
 
 PoolVector<Vector3> AStar::get_point_path(int p_from_id, int p_to_id) {
 
-	ERR_FAIL_COND_V(!points.has(p_from_id), PoolVector<Vector3>());
-	ERR_FAIL_COND_V(!points.has(p_to_id), PoolVector<Vector3>());
+	uint32_t begin_point = _get_point_index(p_from_id);
+	uint32_t end_point = _get_point_index(p_to_id);
+	ERR_FAIL_COND_V(begin_point == INVALID_INDEX, PoolVector<Vector3>());
+	ERR_FAIL_COND_V(end_point == INVALID_INDEX, PoolVector<Vector3>());
 
-	pass++;
-
-	Point *a = points[p_from_id];
-	Point *b = points[p_to_id];
-
-	if (a == b) {
+	if (begin_point == end_point) {
 		PoolVector<Vector3> ret;
-		ret.push_back(a->pos);
+		ret.push_back(points[begin_point].pos);
 		return ret;
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
+	bool found_route = _solve(begin_point, end_point, solve_data, _has_script_costs());
 
 	if (!found_route)
 		return PoolVector<Vector3>();
 
+	const SolveData::State *states = solve_data.states.ptr();
+
 	// Midpoints
-	Point *p = end_point;
+	uint32_t p = end_point;
 	int pc = 1; // Begin point
 	while (p != begin_point) {
 		pc++;
-		p = p->prev_point;
+		p = states[p].prev_point;
 	}
 
 	PoolVector<Vector3> path;
@@ -384,49 +536,40 @@ PoolVector<Vector3> AStar::get_point_path(int p_from_id, int p_to_id) {
 	{
 		PoolVector<Vector3>::Write w = path.write();
 
-		Point *p = end_point;
+		p = end_point;
 		int idx = pc - 1;
 		while (p != begin_point) {
-			w[idx--] = p->pos;
-			p = p->prev_point;
+			w[idx--] = points[p].pos;
+			p = states[p].prev_point;
 		}
 
-		w[0] = p->pos; // Assign first
+		w[0] = points[p].pos; // Assign first
 	}
 
 	return path;
 }
 
-PoolVector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
-
-	ERR_FAIL_COND_V(!points.has(p_from_id), PoolVector<int>());
-	ERR_FAIL_COND_V(!points.has(p_to_id), PoolVector<int>());
+PoolVector<int> AStar::_get_id_path(uint32_t p_from_point, uint32_t p_to_point, SolveData &r_data, bool p_script_costs) {
 
-	pass++;
-
-	Point *a = points[p_from_id];
-	Point *b = points[p_to_id];
-
-	if (a == b) {
+	if (p_from_point == p_to_point) {
 		PoolVector<int> ret;
-		ret.push_back(a->id);
+		ret.push_back(points[p_from_point].id);
 		return ret;
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
+	bool found_route = _solve(p_from_point, p_to_point, r_data, p_script_costs);
 
 	if (!found_route)
 		return PoolVector<int>();
 
+	const SolveData::State *states = r_data.states.ptr();
+
 	// Midpoints
-	Point *p = end_point;
+	uint32_t p = p_to_point;
 	int pc = 1; // Begin point
-	while (p != begin_point) {
+	while (p != p_from_point) {
 		pc++;
-		p = p->prev_point;
+		p = states[p].prev_point;
 	}
 
 	PoolVector<int> path;
@@ -435,19 +578,100 @@ PoolVector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
 	{
 		PoolVector<int>::Write w = path.write();
 
-		p = end_point;
+		p = p_to_point;
 		int idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
+		while (p != p_from_point) {
+			w[idx--] = points[p].id;
+			p = states[p].prev_point;
 		}
 
-		w[0] = p->id; // Assign first
+		w[0] = points[p].id; // Assign first
 	}
 
 	return path;
 }
 
+PoolVector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
+
+	uint32_t begin_point = _get_point_index(p_from_id);
+	uint32_t end_point = _get_point_index(p_to_id);
+	ERR_FAIL_COND_V(begin_point == INVALID_INDEX, PoolVector<int>());
+	ERR_FAIL_COND_V(end_point == INVALID_INDEX, PoolVector<int>());
+
+	return _get_id_path(begin_point, end_point, solve_data, _has_script_costs());
+}
+
+void AStar::_solve_batch(uint32_t p_batch, BatchData *p_data) {
+
+	SolveData data;
+
+	for (uint32_t i = p_batch; i < p_data->count; i += p_data->batches) {
+
+		if (p_data->from_points[i] == INVALID_INDEX || p_data->to_points[i] == INVALID_INDEX)
+			continue;
+
+		p_data->results[i] = _get_id_path(p_data->from_points[i], p_data->to_points[i], data, false);
+	}
+}
+
+Array AStar::get_id_path_batch(const PoolVector<int> &p_from_ids, const PoolVector<int> &p_to_ids) {
+
+	ERR_FAIL_COND_V(p_from_ids.size() != p_to_ids.size(), Array());
+
+	uint32_t count = p_from_ids.size();
+
+	Vector<uint32_t> from_points;
+	Vector<uint32_t> to_points;
+	from_points.resize(count);
+	to_points.resize(count);
+
+	{
+		PoolVector<int>::Read from_r = p_from_ids.read();
+		PoolVector<int>::Read to_r = p_to_ids.read();
+
+		for (uint32_t i = 0; i < count; i++) {
+			from_points[i] = _get_point_index(from_r[i]);
+			to_points[i] = _get_point_index(to_r[i]);
+			if (from_points[i] == INVALID_INDEX || to_points[i] == INVALID_INDEX) {
+				ERR_PRINTS("Invalid point pair in path batch: " + itos(from_r[i]) + " -> " + itos(to_r[i]));
+			}
+		}
+	}
+
+	Vector<PoolVector<int> > results;
+	results.resize(count);
+
+	BatchData batch_data;
+	batch_data.from_points = from_points.ptr();
+	batch_data.to_points = to_points.ptr();
+	batch_data.results = results.ptrw();
+	batch_data.count = count;
+
+	ThreadPool *pool = ThreadPool::get_singleton();
+	bool script_costs = _has_script_costs();
+
+	if (!pool || count < 2 || script_costs) {
+		// Script costs can't be called from several threads at once.
+		for (uint32_t i = 0; i < count; i++) {
+			if (from_points[i] != INVALID_INDEX && to_points[i] != INVALID_INDEX)
+				batch_data.results[i] = _get_id_path(from_points[i], to_points[i], solve_data, script_costs);
+		}
+	} else {
+		// Every batch keeps its own search state, so only the graph is shared (read only).
+		batch_data.batches = MIN(count, (uint32_t)pool->get_thread_count() + 1);
+		ThreadPool::GroupID group = pool->add_template_group_task(this, &AStar::_solve_batch, &batch_data, batch_data.batches);
+		pool->wait_for_group(group);
+	}
+
+	Array ret;
+	ret.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		ret[i] = results[i];
+	}
+
+	return ret;
+}
+
 void AStar::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_available_point_id"), &AStar::get_available_point_id);
@@ -473,6 +697,7 @@ void AStar::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStar::get_point_path);
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStar::get_id_path);
+	ClassDB::bind_method(D_METHOD("get_id_path_batch", "from_ids", "to_ids"), &AStar::get_id_path_batch);
 
 	BIND_VMETHOD(MethodInfo(Variant::REAL, "_estimate_cost", PropertyInfo(Variant::INT, "from_id"), PropertyInfo(Variant::INT, "to_id")));
 	BIND_VMETHOD(MethodInfo(Variant::REAL, "_compute_cost", PropertyInfo(Variant::INT, "from_id"), PropertyInfo(Variant::INT, "to_id")));
@@ -480,11 +705,12 @@ void AStar::_bind_methods() {
 
 AStar::AStar() {
 
-	pass = 1;
+	free_point = INVALID_INDEX;
+	max_id = -1;
+	max_id_dirty = false;
 }
 
 AStar::~AStar() {
 
-	pass = 1;
 	clear();
 }
@@ -31,8 +31,10 @@
 #ifndef ASTAR_H
 #define ASTAR_H
 
+#include "hash_map.h"
+#include "local_vector.h"
 #include "reference.h"
-#include "self_list.h"
+
 /**
 	A* pathfinding algorithm
 
@@ -43,56 +45,104 @@ class AStar : public Reference {
 
 	GDCLASS(AStar, Reference)
 
-	uint64_t pass;
+	enum {
+		INVALID_INDEX = 0xFFFFFFFF
+	};
 
+	// Points live in a flat array, neighbours refer to each other by index.
 	struct Point {
 
-		SelfList<Point> list;
-
-		int id;
+		int id; // -1 while the slot is free
 		Vector3 pos;
 		real_t weight_scale;
-		uint64_t last_pass;
-
-		Vector<Point *> neighbours;
 
-		// Used for pathfinding
-		Point *prev_point;
-		real_t distance;
+		LocalVector<uint32_t> neighbours;
+		LocalVector<uint32_t> unlinked_neighbours; // points connected to this one in a single direction
 
-		Point() :
-				list(this) {}
+		uint32_t next_free;
 	};
 
-	Map<int, Point *> points;
+	LocalVector<Point> points;
+	HashMap<int, uint32_t> point_map;
+	uint32_t free_point;
+
+	mutable int max_id;
+	mutable bool max_id_dirty;
 
 	struct Segment {
-		union {
-			struct {
-				int32_t from;
-				int32_t to;
-			};
-			uint64_t key;
+
+		uint32_t from_point;
+		uint32_t to_point;
+	};
+
+	// Keyed like the point ids pair, lowest id in the lower bits.
+	static _FORCE_INLINE_ uint64_t _segment_key(int p_from, int p_to) {
+		if (p_from > p_to) {
+			SWAP(p_from, p_to);
+		}
+		return ((uint64_t)(uint32_t)p_to << 32) | (uint64_t)(uint32_t)p_from;
+	}
+
+	HashMap<uint64_t, Segment> segments;
+
+	// Per query search state, kept apart from the points so queries can run concurrently.
+	struct SolveData {
+
+		struct State {
+			uint64_t last_pass;
+			uint32_t prev_point;
+			uint32_t heap_pos; // INVALID_INDEX when not in the open list
+			uint32_t open_order; // ties on cost go to the point opened last
+			real_t distance;
+			real_t estimate;
+			real_t cost; // distance plus estimate
 		};
 
-		Point *from_point;
-		Point *to_point;
+		uint64_t pass;
+		uint32_t open_count;
+		LocalVector<State> states;
+		LocalVector<uint32_t> open_heap; // binary heap on cost, then open order
+
+		// Matches the open list this heap replaced, which took the first
+		// cheapest point and had new points added in front.
+		_FORCE_INLINE_ bool is_before(uint32_t p_a, uint32_t p_b) const {
+			const State &a = states[p_a];
+			const State &b = states[p_b];
+			return a.cost < b.cost || (a.cost == b.cost && a.open_order > b.open_order);
+		}
 
-		bool operator<(const Segment &p_s) const { return key < p_s.key; }
-		Segment() { key = 0; }
-		Segment(int p_from, int p_to) {
-			if (p_from > p_to) {
-				SWAP(p_from, p_to);
-			}
+		void prepare(uint32_t p_point_count);
+		void heap_push(uint32_t p_point);
+		uint32_t heap_pop();
+		void heap_update(uint32_t p_point);
 
-			from = p_from;
-			to = p_to;
+		SolveData() {
+			pass = 1;
+			open_count = 0;
 		}
 	};
 
-	Set<Segment> segments;
+	SolveData solve_data;
+
+	struct BatchData {
+
+		const uint32_t *from_points;
+		const uint32_t *to_points;
+		PoolVector<int> *results;
+		uint32_t count;
+		uint32_t batches;
+	};
+
+	_FORCE_INLINE_ uint32_t _get_point_index(int p_id) const {
+		const uint32_t *idx = point_map.getptr(p_id);
+		return idx ? *idx : INVALID_INDEX;
+	}
 
-	bool _solve(Point *begin_point, Point *end_point);
+	bool _has_script_costs() const;
+	bool _solve(uint32_t p_begin_point, uint32_t p_end_point, SolveData &r_data, bool p_script_costs);
+	PoolVector<int> _get_id_path(uint32_t p_from_point, uint32_t p_to_point, SolveData &r_data, bool p_script_costs);
+	void _solve_batch(uint32_t p_batch, BatchData *p_data);
+	void _remove_neighbour(Point &p_point, uint32_t p_neighbour);
 
 protected:
 	static void _bind_methods();
@@ -124,6 +174,7 @@ public:
 
 	PoolVector<Vector3> get_point_path(int p_from_id, int p_to_id);
 	PoolVector<int> get_id_path(int p_from_id, int p_to_id);
+	Array get_id_path_batch(const PoolVector<int> &p_from_ids, const PoolVector<int> &p_to_ids);
 
 	AStar();
 	~AStar();
@@ -0,0 +1,328 @@
+/*************************************************************************/
+/*  aabb_tree.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "aabb_tree.h"
+
+uint32_t AABBTree::_alloc_node() {
+
+	uint32_t idx;
+	if (free_node != INVALID_INDEX) {
+		idx = free_node;
+		free_node = nodes[idx].parent;
+	} else {
+		idx = nodes.size();
+		nodes.resize(idx + 1);
+	}
+
+	Node &n = nodes[idx];
+	n.parent = INVALID_INDEX;
+	n.children[0] = INVALID_INDEX;
+	n.children[1] = INVALID_INDEX;
+	n.item = INVALID_INDEX;
+	n.height = 0;
+	return idx;
+}
+
+void AABBTree::_free_node(uint32_t p_node) {
+
+	nodes[p_node].parent = free_node;
+	free_node = p_node;
+}
+
+void AABBTree::_insert_leaf(uint32_t p_leaf) {
+
+	if (root == INVALID_INDEX) {
+		root = p_leaf;
+		nodes[root].parent = INVALID_INDEX;
+		return;
+	}
+
+	// find the sibling that grows the total surface area the least
+	AABB leaf_aabb = nodes[p_leaf].aabb;
+	uint32_t index = root;
+
+	while (!nodes[index].is_leaf()) {
+
+		const Node &n = nodes[index];
+
+		real_t area = surface_area(n.aabb);
+		real_t combined_area = surface_area(merge(n.aabb, leaf_aabb));
+
+		// cost of making a new parent for this node and the leaf
+		real_t cost = 2.0 * combined_area;
+		// cost of pushing the leaf further down
+		real_t inheritance_cost = 2.0 * (combined_area - area);
+
+		real_t child_cost[2];
+		for (int i = 0; i < 2; i++) {
+			const Node &child = nodes[n.children[i]];
+			child_cost[i] = surface_area(merge(child.aabb, leaf_aabb)) + inheritance_cost;
+			if (!child.is_leaf()) {
+				child_cost[i] -= surface_area(child.aabb);
+			}
+		}
+
+		if (cost < child_cost[0] && cost < child_cost[1])
+			break;
+
+		index = child_cost[0] < child_cost[1] ? n.children[0] : n.children[1];
+	}
+
+	uint32_t sibling = index;
+	uint32_t old_parent = nodes[sibling].parent;
+	uint32_t new_parent = _alloc_node(); // may reallocate nodes, take no references before this
+
+	nodes[new_parent].parent = old_parent;
+	nodes[new_parent].aabb = merge(leaf_aabb, nodes[sibling].aabb);
+	nodes[new_parent].height = nodes[sibling].height + 1;
+	nodes[new_parent].children[0] = sibling;
+	nodes[new_parent].children[1] = p_leaf;
+	nodes[sibling].parent = new_parent;
+	nodes[p_leaf].parent = new_parent;
+
+	if (old_parent != INVALID_INDEX) {
+		Node &op = nodes[old_parent];
+		op.children[op.children[0] == sibling ? 0 : 1] = new_parent;
+	} else {
+		root = new_parent;
+	}
+
+	_refit_parents(nodes[p_leaf].parent);
+}
+
+void AABBTree::_remove_leaf(uint32_t p_leaf) {
+
+	if (p_leaf == root) {
+		root = INVALID_INDEX;
+		return;
+	}
+
+	uint32_t parent = nodes[p_leaf].parent;
+	uint32_t grand_parent = nodes[parent].parent;
+	uint32_t sibling = nodes[parent].children[nodes[parent].children[0] == p_leaf ? 1 : 0];
+
+	_free_node(parent);
+
+	if (grand_parent == INVALID_INDEX) {
+		root = sibling;
+		nodes[sibling].parent = INVALID_INDEX;
+		return;
+	}
+
+	Node &gp = nodes[grand_parent];
+	gp.children[gp.children[0] == parent ? 0 : 1] = sibling;
+	nodes[sibling].parent = grand_parent;
+
+	_refit_parents(grand_parent);
+}
+
+// Rebalances and recomputes the bounds from p_node up to the root.
+void AABBTree::_refit_parents(uint32_t p_node) {
+
+	uint32_t index = p_node;
+	while (index != INVALID_INDEX) {
+
+		index = _balance(index);
+
+		Node &n = nodes[index];
+		const Node &c0 = nodes[n.children[0]];
+		const Node &c1 = nodes[n.children[1]];
+		n.height = 1 + MAX(c0.height, c1.height);
+		n.aabb = merge(c0.aabb, c1.aabb);
+
+		index = n.parent;
+	}
+}
+
+// Rotates the taller child of p_node up if the subtree is unbalanced, returns the new subtree root.
+uint32_t AABBTree::_balance(uint32_t p_node) {
+
+	uint32_t ia = p_node;
+	Node *a = &nodes[ia];
+
+	if (a->is_leaf() || a->height < 2)
+		return ia;
+
+	uint32_t ib = a->children[0];
+	uint32_t ic = a->children[1];
+	Node *b = &nodes[ib];
+	Node *c = &nodes[ic];
+
+	int balance = c->height - b->height;
+
+	if (balance > 1) {
+
+		// rotate c up
+		uint32_t i_f = c->children[0];
+		uint32_t i_g = c->children[1];
+		Node *f = &nodes[i_f];
+		Node *g = &nodes[i_g];
+
+		c->children[0] = ia;
+		c->parent = a->parent;
+		a->parent = ic;
+
+		if (c->parent != INVALID_INDEX) {
+			Node &cp = nodes[c->parent];
+			cp.children[cp.children[0] == ia ? 0 : 1] = ic;
+		} else {
+			root = ic;
+		}
+
+		if (f->height > g->height) {
+			c->children[1] = i_f;
+			a->children[1] = i_g;
+			g->parent = ia;
+			a->aabb = merge(b->aabb, g->aabb);
+			c->aabb = merge(a->aabb, f->aabb);
+			a->height = 1 + MAX(b->height, g->height);
+			c->height = 1 + MAX(a->height, f->height);
+		} else {
+			c->children[1] = i_g;
+			a->children[1] = i_f;
+			f->parent = ia;
+			a->aabb = merge(b->aabb, f->aabb);
+			c->aabb = merge(a->aabb, g->aabb);
+			a->height = 1 + MAX(b->height, f->height);
+			c->height = 1 + MAX(a->height, g->height);
+		}
+
+		return ic;
+	}
+
+	if (balance < -1) {
+
+		// rotate b up
+		uint32_t i_d = b->children[0];
+		uint32_t i_e = b->children[1];
+		Node *d = &nodes[i_d];
+		Node *e = &nodes[i_e];
+
+		b->children[0] = ia;
+		b->parent = a->parent;
+		a->parent = ib;
+
+		if (b->parent != INVALID_INDEX) {
+			Node &bp = nodes[b->parent];
+			bp.children[bp.children[0] == ia ? 0 : 1] = ib;
+		} else {
+			root = ib;
+		}
+
+		if (d->height > e->height) {
+			b->children[1] = i_d;
+			a->children[0] = i_e;
+			e->parent = ia;
+			a->aabb = merge(c->aabb, e->aabb);
+			b->aabb = merge(a->aabb, d->aabb);
+			a->height = 1 + MAX(c->height, e->height);
+			b->height = 1 + MAX(a->height, d->height);
+		} else {
+			b->children[1] = i_e;
+			a->children[0] = i_d;
+			d->parent = ia;
+			a->aabb = merge(c->aabb, d->aabb);
+			b->aabb = merge(a->aabb, e->aabb);
+			a->height = 1 + MAX(c->height, d->height);
+			b->height = 1 + MAX(a->height, e->height);
+		}
+
+		return ib;
+	}
+
+	return ia;
+}
+
+uint32_t AABBTree::create(const AABB &p_aabb, uint32_t p_item) {
+
+	ERR_FAIL_COND_V(p_item == INVALID_INDEX, INVALID_INDEX);
+
+	uint32_t leaf = _alloc_node();
+	nodes[leaf].aabb = p_aabb;
+	nodes[leaf].item = p_item;
+	_insert_leaf(leaf);
+	leaf_count++;
+
+	return leaf;
+}
+
+void AABBTree::erase(uint32_t p_leaf) {
+
+	ERR_FAIL_COND(p_leaf >= nodes.size() || !nodes[p_leaf].is_leaf());
+
+	_remove_leaf(p_leaf);
+	nodes[p_leaf].item = INVALID_INDEX;
+	_free_node(p_leaf);
+	leaf_count--;
+}
+
+void AABBTree::move(uint32_t p_leaf, const AABB &p_aabb) {
+
+	ERR_FAIL_COND(p_leaf >= nodes.size() || !nodes[p_leaf].is_leaf());
+
+	_remove_leaf(p_leaf);
+	nodes[p_leaf].aabb = p_aabb;
+	_insert_leaf(p_leaf);
+}
+
+void AABBTree::refit(uint32_t p_leaf, const AABB &p_aabb) {
+
+	ERR_FAIL_COND(p_leaf >= nodes.size() || !nodes[p_leaf].is_leaf());
+
+	nodes[p_leaf].aabb = p_aabb;
+
+	uint32_t index = nodes[p_leaf].parent;
+	while (index != INVALID_INDEX) {
+
+		Node &n = nodes[index];
+		AABB aabb = merge(nodes[n.children[0]].aabb, nodes[n.children[1]].aabb);
+		if (aabb == n.aabb)
+			break; // nothing changes further up
+		n.aabb = aabb;
+
+		index = n.parent;
+	}
+}
+
+void AABBTree::clear() {
+
+	nodes.reset();
+	free_node = INVALID_INDEX;
+	root = INVALID_INDEX;
+	leaf_count = 0;
+}
+
+AABBTree::AABBTree() {
+
+	free_node = INVALID_INDEX;
+	root = INVALID_INDEX;
+	leaf_count = 0;
+}
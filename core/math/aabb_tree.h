@@ -0,0 +1,144 @@
+/*************************************************************************/
+/*  aabb_tree.h                                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef AABB_TREE_H
+#define AABB_TREE_H
+
+#include "aabb.h"
+#include "local_vector.h"
+
+/* Dynamic AABB tree over user supplied bounds. Each leaf carries an item index
+ * that is handed back by queries. Insertion picks the sibling with the lowest
+ * surface area cost and rotations keep the tree balanced, so leaves can be
+ * added, removed and moved at any time. */
+
+class AABBTree {
+public:
+	enum {
+		INVALID_INDEX = 0xFFFFFFFF
+	};
+
+private:
+	enum {
+		STACK_SIZE = 128 // tree is kept balanced, height will never get close
+	};
+
+	struct Node {
+
+		AABB aabb;
+		uint32_t parent; // next free node while unused
+		uint32_t children[2];
+		uint32_t item; // INVALID_INDEX for internal nodes
+		int height; // 0 for leaves
+
+		_FORCE_INLINE_ bool is_leaf() const { return item != INVALID_INDEX; }
+	};
+
+	LocalVector<Node> nodes;
+	uint32_t free_node;
+	uint32_t root;
+	uint32_t leaf_count;
+
+	uint32_t _alloc_node();
+	void _free_node(uint32_t p_node);
+	void _insert_leaf(uint32_t p_leaf);
+	void _remove_leaf(uint32_t p_leaf);
+	void _refit_parents(uint32_t p_node);
+	uint32_t _balance(uint32_t p_node);
+
+public:
+	static _FORCE_INLINE_ AABB merge(const AABB &p_a, const AABB &p_b) {
+		Vector3 min = p_a.position;
+		Vector3 max = p_a.position + p_a.size;
+		Vector3 b_min = p_b.position;
+		Vector3 b_max = p_b.position + p_b.size;
+		for (int i = 0; i < 3; i++) {
+			min[i] = MIN(min[i], b_min[i]);
+			max[i] = MAX(max[i], b_max[i]);
+		}
+		return AABB(min, max - min);
+	}
+
+	static _FORCE_INLINE_ real_t surface_area(const AABB &p_aabb) {
+		const Vector3 &s = p_aabb.size;
+		return 2.0 * (s.x * s.y + s.y * s.z + s.z * s.x);
+	}
+
+	// Returns the leaf, which stays valid until erased.
+	uint32_t create(const AABB &p_aabb, uint32_t p_item);
+	void erase(uint32_t p_leaf);
+	// Removes and re-inserts the leaf, finding the best place for the new bounds.
+	void move(uint32_t p_leaf, const AABB &p_aabb);
+	// Only enlarges or shrinks the ancestors of the leaf. Much cheaper than move()
+	// for small displacements, but the tree degrades if used for long distances.
+	void refit(uint32_t p_leaf, const AABB &p_aabb);
+
+	_FORCE_INLINE_ const AABB &get_aabb(uint32_t p_leaf) const { return nodes[p_leaf].aabb; }
+	_FORCE_INLINE_ uint32_t get_item(uint32_t p_leaf) const { return nodes[p_leaf].item; }
+	_FORCE_INLINE_ uint32_t get_leaf_count() const { return leaf_count; }
+	_FORCE_INLINE_ bool empty() const { return root == INVALID_INDEX; }
+
+	// Calls p_visitor(item) for every leaf whose bounds pass p_test, subtrees whose
+	// bounds fail it are skipped. The query stops when the visitor returns false.
+	template <class T, class V>
+	void query(const T &p_test, V &p_visitor) const {
+
+		if (root == INVALID_INDEX)
+			return;
+
+		uint32_t stack[STACK_SIZE];
+		int stack_size = 0;
+		stack[stack_size++] = root;
+
+		while (stack_size) {
+
+			const Node &n = nodes[stack[--stack_size]];
+
+			if (!p_test(n.aabb))
+				continue;
+
+			if (n.is_leaf()) {
+				if (!p_visitor(n.item))
+					return;
+			} else {
+				ERR_FAIL_COND(stack_size + 2 > STACK_SIZE);
+				stack[stack_size++] = n.children[0];
+				stack[stack_size++] = n.children[1];
+			}
+		}
+	}
+
+	void clear();
+
+	AABBTree();
+};
+
+#endif // AABB_TREE_H
@@ -33,6 +33,7 @@
 
 #include "aabb.h"
 #include "list.h"
+#include "local_vector.h"
 #include "map.h"
 #include "print_string.h"
 #include "variant.h"
@@ -352,6 +353,7 @@ private:
 	};
 
 	void _cull_convex(Octant *p_octant, _CullConvexData *p_cull);
+	void _cull_convex_threadsafe(const Octant *p_octant, const Plane *p_planes, int p_plane_count, LocalVector<T *> &r_result, uint32_t p_result_max, uint32_t p_mask) const;
 	void _cull_aabb(Octant *p_octant, const AABB &p_aabb, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
 	void _cull_segment(Octant *p_octant, const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
 	void _cull_point(Octant *p_octant, const Vector3 &p_point, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
@@ -381,6 +383,8 @@ public:
 	int get_subindex(OctreeElementID p_id) const;
 
 	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
+	// Does not write to the octree, so several can run at once (as long as nothing modifies the octree meanwhile).
+	void cull_convex_threadsafe(const Vector<Plane> &p_convex, LocalVector<T *> &r_result, uint32_t p_result_max, uint32_t p_mask = 0xFFFFFFFF) const;
 	int cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF);
 	int cull_segment(const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF);
 
@@ -1072,6 +1076,54 @@ void Octree<T, use_pairs, AL>::_cull_convex(Octant *p_octant, _CullConvexData *p
 	}
 }
 
+template <class T, bool use_pairs, class AL>
+void Octree<T, use_pairs, AL>::_cull_convex_threadsafe(const Octant *p_octant, const Plane *p_planes, int p_plane_count, LocalVector<T *> &r_result, uint32_t p_result_max, uint32_t p_mask) const {
+
+	for (int l = 0; l < (use_pairs ? 2 : 1); l++) {
+
+		const List<Element *, AL> &list = l == 0 ? p_octant->elements : p_octant->pairable_elements;
+
+		for (const typename List<Element *, AL>::Element *I = list.front(); I; I = I->next()) {
+
+			const Element *e = I->get();
+
+			if (use_pairs && !(e->pairable_type & p_mask))
+				continue;
+
+			if (!e->aabb.intersects_convex_shape(p_planes, p_plane_count))
+				continue;
+
+			if (e->octant_owners.size() > 1) {
+				// Elements in several octants are only reported from the first of them that the cull visits,
+				// which is the first one intersecting the convex (an octant is visited if it and its parents do).
+				const Octant *first = NULL;
+				for (const typename List<typename Element::OctantOwner, AL>::Element *F = e->octant_owners.front(); F; F = F->next()) {
+					if (F->get().octant->aabb.intersects_convex_shape(p_planes, p_plane_count)) {
+						first = F->get().octant;
+						break;
+					}
+				}
+
+				if (first && first != p_octant)
+					continue;
+			}
+
+			r_result.push_back(e->userdata);
+			if (r_result.size() >= p_result_max)
+				return;
+		}
+	}
+
+	for (int i = 0; i < 8; i++) {
+
+		if (p_octant->children[i] && p_octant->children[i]->aabb.intersects_convex_shape(p_planes, p_plane_count)) {
+			_cull_convex_threadsafe(p_octant->children[i], p_planes, p_plane_count, r_result, p_result_max, p_mask);
+			if (r_result.size() >= p_result_max)
+				return;
+		}
+	}
+}
+
 template <class T, bool use_pairs, class AL>
 void Octree<T, use_pairs, AL>::_cull_aabb(Octant *p_octant, const AABB &p_aabb, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) {
 
@@ -1313,6 +1365,17 @@ int Octree<T, use_pairs, AL>::cull_convex(const Vector<Plane> &p_convex, T **p_r
 	return result_count;
 }
 
+template <class T, bool use_pairs, class AL>
+void Octree<T, use_pairs, AL>::cull_convex_threadsafe(const Vector<Plane> &p_convex, LocalVector<T *> &r_result, uint32_t p_result_max, uint32_t p_mask) const {
+
+	r_result.clear();
+
+	if (!root || p_result_max == 0)
+		return;
+
+	_cull_convex_threadsafe(root, &p_convex[0], p_convex.size(), r_result, p_result_max, p_mask);
+}
+
 template <class T, bool use_pairs, class AL>
 int Octree<T, use_pairs, AL>::cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) {
 
@@ -257,7 +257,7 @@ void MessageQueue::_call_function(Object *p_target, const StringName &p_func, co
 	}
 
 	Variant::CallError ce;
-	p_target->call(p_func, argptrs, p_argcount, ce);
+	p_target->call_cached(&call_caches[p_func.hash() & (CALL_CACHE_SIZE - 1)], p_func, argptrs, p_argcount, ce);
 	if (p_show_error && ce.error != Variant::CallError::CALL_OK) {
 
 		ERR_PRINTS("Error calling deferred method: " + Variant::get_call_error_text(p_target, p_func, argptrs, p_argcount, ce));
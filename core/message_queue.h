@@ -41,7 +41,8 @@ class MessageQueue {
 
 	enum {
 
-		DEFAULT_QUEUE_SIZE_KB = 1024
+		DEFAULT_QUEUE_SIZE_KB = 1024,
+		CALL_CACHE_SIZE = 64 // power of two, deferred calls pick an entry by method name hash
 	};
 
 	Mutex *mutex;
@@ -71,6 +72,8 @@ class MessageQueue {
 	uint32_t buffer_max_used;
 	uint32_t buffer_size;
 
+	MethodCallCache call_caches[CALL_CACHE_SIZE];
+
 	void _call_function(Object *p_target, const StringName &p_func, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	static MessageQueue *singleton;
@@ -919,6 +919,90 @@ Variant Object::call(const StringName &p_method, const Variant **p_args, int p_a
 	return ret;
 }
 
+uint32_t MethodCallCache::global_version = 1;
+
+void MethodCallCache::invalidate_all() {
+
+	atomic_increment(&global_version);
+}
+
+Variant Object::call_cached(MethodCallCache *p_cache, const StringName &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error) {
+
+	const void *script_key = NULL;
+	if (script_instance) {
+		script_key = script_instance->get_method_cache_key();
+		if (!script_key) {
+			//this script language can't hand out its methods
+			return call(p_method, p_args, p_argcount, r_error);
+		}
+	}
+
+	const void *class_key = get_class_name().data_unique_pointer();
+	const void *method_key = p_method.data_unique_pointer();
+	uint32_t version = atomic_load_acquire(&MethodCallCache::global_version);
+
+	volatile MethodCallCache *cache = p_cache;
+	MethodBind *method_bind = NULL;
+	const void *script_method = NULL;
+	bool hit = false;
+
+	//seqlock: an even sequence read with acquire, the entry, then a read
+	//barrier so the entry is read before the sequence is checked again
+	uint32_t sequence = atomic_load_acquire(&p_cache->sequence);
+	if (!(sequence & 1) && cache->version == version && cache->method_key == method_key && cache->class_key == class_key && cache->script_key == script_key) {
+		method_bind = cache->method_bind;
+		script_method = cache->script_method;
+		atomic_read_barrier();
+		hit = cache->sequence == sequence;
+	}
+
+	if (!hit) {
+
+		method_bind = NULL;
+		script_method = NULL;
+
+		//free and overridden call() must always go through call()
+		if (!_has_call_override() && p_method != CoreStringNames::get_singleton()->_free) {
+			if (script_instance) {
+				script_method = script_instance->get_method_handle(p_method);
+			}
+			if (!script_method) {
+				method_bind = ClassDB::get_method(get_class_name(), p_method);
+			}
+		}
+
+		//the increments are full barriers, so readers see the odd sequence
+		//before the entry changes and the entry before it is even again
+		if (atomic_increment(&p_cache->writers) == 1) {
+			atomic_increment(&p_cache->sequence);
+			cache->version = version;
+			cache->method_key = method_key;
+			cache->class_key = class_key;
+			cache->script_key = script_key;
+			cache->method_bind = method_bind;
+			cache->script_method = script_method;
+			atomic_increment(&p_cache->sequence);
+		}
+		atomic_decrement(&p_cache->writers);
+	}
+
+	if (script_method) {
+
+		r_error.error = Variant::CallError::CALL_OK;
+		OBJ_DEBUG_LOCK
+		return script_instance->call_method_handle(script_method, p_args, p_argcount, r_error);
+	}
+
+	if (method_bind) {
+
+		r_error.error = Variant::CallError::CALL_OK;
+		OBJ_DEBUG_LOCK
+		return method_bind->call(this, p_args, p_argcount, r_error);
+	}
+
+	return call(p_method, p_args, p_argcount, r_error);
+}
+
 void Object::notification(int p_notification, bool p_reversed) {
 
 	_notificationv(p_notification, p_reversed);
@@ -1145,71 +1229,83 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 
 	List<_ObjectSignalDisconnectData> disconnect_data;
 
-	//copy on write will ensure that disconnecting the signal or even deleting the object will not affect the signal calling.
-	//this happens automatically and will not change the performance of calling.
-	//awesome, isn't it?
-	VMap<Signal::Target, Signal::Slot> slot_map = s->slot_map;
+	if (s->emit_list_dirty) {
+		_update_emit_list(s);
+	}
 
-	int ssize = slot_map.size();
+	//only a reference is taken, so disconnecting the signal or even deleting the object will not affect the signal calling.
+	Vector<Signal::Emitter> emit_list = s->emit_list;
+	const Signal::Emitter *emitters = emit_list.ptr();
+	int ssize = emit_list.size();
 
-	OBJ_DEBUG_LOCK
+	const Variant **bind_args = NULL;
+	if (s->emit_max_binds) {
+		bind_args = (const Variant **)alloca(sizeof(Variant *) * (p_argcount + s->emit_max_binds));
+		for (int j = 0; j < p_argcount; j++) {
+			bind_args[j] = p_args[j];
+		}
+	}
 
-	Vector<const Variant *> bind_mem;
+	OBJ_DEBUG_LOCK
 
 	Error err = OK;
 
 	for (int i = 0; i < ssize; i++) {
 
-		const Connection &c = slot_map.getv(i).conn;
+		const Signal::Emitter &e = emitters[i];
 
 		Object *target;
 #ifdef DEBUG_ENABLED
-		target = ObjectDB::get_instance(slot_map.getk(i)._id);
+		target = ObjectDB::get_instance(e.target_id);
 		ERR_CONTINUE(!target);
 #else
-		target = c.target;
+		target = e.target;
 #endif
 
 		const Variant **args = p_args;
 		int argc = p_argcount;
 
-		if (c.binds.size()) {
+		if (e.binds.size()) {
 			//handle binds
-			bind_mem.resize(p_argcount + c.binds.size());
-
-			for (int j = 0; j < p_argcount; j++) {
-				bind_mem[j] = p_args[j];
-			}
-			for (int j = 0; j < c.binds.size(); j++) {
-				bind_mem[p_argcount + j] = &c.binds[j];
+			for (int j = 0; j < e.binds.size(); j++) {
+				bind_args[p_argcount + j] = &e.binds.ptr()[j];
 			}
 
-			args = (const Variant **)bind_mem.ptr();
-			argc = bind_mem.size();
+			args = bind_args;
+			argc = p_argcount + e.binds.size();
 		}
 
-		if (c.flags & CONNECT_DEFERRED) {
-			MessageQueue::get_singleton()->push_call(target->get_instance_id(), c.method, args, argc, true);
+		if (e.flags & CONNECT_DEFERRED) {
+			MessageQueue::get_singleton()->push_call(target->get_instance_id(), e.method, args, argc, true);
 		} else {
 			Variant::CallError ce;
-			target->call(c.method, args, argc, ce);
+
+			if (e.method_bind && !target->script_instance) {
+				// same method call() would find, without looking it up again
+#ifdef DEBUG_ENABLED
+				_ObjectDebugLock target_lock(target);
+#endif
+				e.method_bind->call(target, args, argc, ce);
+			} else {
+				target->call(e.method, args, argc, ce);
+			}
 
 			if (ce.error != Variant::CallError::CALL_OK) {
 
 				if (ce.error == Variant::CallError::CALL_ERROR_INVALID_METHOD && !ClassDB::class_exists(target->get_class_name())) {
 					//most likely object is not initialized yet, do not throw error.
 				} else {
-					ERR_PRINTS("Error calling method from signal '" + String(p_name) + "': " + Variant::get_call_error_text(target, c.method, args, argc, ce));
+					ERR_PRINTS("Error calling method from signal '" + String(p_name) + "': " + Variant::get_call_error_text(target, e.method, args, argc, ce));
 					err = ERR_METHOD_NOT_FOUND;
 				}
 			}
 		}
 
-		if (c.flags & CONNECT_ONESHOT) {
+		if (e.flags & CONNECT_ONESHOT) {
 			_ObjectSignalDisconnectData dd;
 			dd.signal = p_name;
 			dd.target = target;
-			dd.method = c.method;
+			dd.method = e.method;
 			disconnect_data.push_back(dd);
 		}
 	}
@@ -1224,6 +1320,35 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 	return err;
 }
 
+void Object::_update_emit_list(Signal *p_signal) {
+
+	const VMap<Signal::Target, Signal::Slot> &slot_map = p_signal->slot_map;
+
+	Vector<Signal::Emitter> emit_list;
+	emit_list.resize(slot_map.size());
+	Signal::Emitter *w = emit_list.ptrw();
+	int max_binds = 0;
+
+	for (int i = 0; i < slot_map.size(); i++) {
+
+		const Connection &c = slot_map.getv(i).conn;
+
+		w[i].target = c.target;
+		w[i].target_id = slot_map.getk(i)._id;
+		w[i].method = c.method;
+		//an overridden call() must see every call, so such targets take the slow path
+		w[i].method_bind = c.target->_has_call_override() ? NULL : ClassDB::get_method(c.target->get_class_name(), c.method);
+		w[i].flags = c.flags;
+		w[i].binds = c.binds;
+
+		max_binds = MAX(max_binds, c.binds.size());
+	}
+
+	p_signal->emit_list = emit_list;
+	p_signal->emit_max_binds = max_binds;
+	p_signal->emit_list_dirty = false;
+}
+
 Error Object::emit_signal(const StringName &p_name, VARIANT_ARG_DECLARE) {
 
 	VARIANT_ARGPTRS;
@@ -1425,6 +1550,7 @@ Error Object::connect(const StringName &p_signal, Object *p_to_object, const Str
 	slot.conn = conn;
 	slot.cE = p_to_object->connections.push_back(conn);
 	s->slot_map[target] = slot;
+	s->emit_list_dirty = true;
 
 	return OK;
 }
@@ -1474,6 +1600,7 @@ void Object::disconnect(const StringName &p_signal, Object *p_to_object, const S
 
 	p_to_object->connections.erase(s->slot_map[target].cE);
 	s->slot_map.erase(target);
+	s->emit_list_dirty = true;
 
 	if (s->slot_map.empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
 		//not user signal, delete
@@ -1910,56 +2037,94 @@ void postinitialize_handler(Object *p_object) {
 	p_object->_postinitialize();
 }
 
-HashMap<ObjectID, Object *> ObjectDB::instances;
-ObjectID ObjectDB::instance_counter = 1;
+ObjectDB::Slot *ObjectDB::slot_chunks[OBJECTDB_MAX_CHUNKS];
+uint32_t ObjectDB::chunk_count = 0;
+uint32_t ObjectDB::slot_count = 0;
+Vector<uint32_t> ObjectDB::free_slots;
+uint32_t ObjectDB::object_count = 0;
+#ifdef DEBUG_ENABLED
 HashMap<Object *, ObjectID, ObjectDB::ObjectPtrHash> ObjectDB::instance_checks;
+#endif
+
 ObjectID ObjectDB::add_instance(Object *p_object) {
 
 	ERR_FAIL_COND_V(p_object->get_instance_id() != 0, 0);
 
-	rw_lock->write_lock();
-	instances[++instance_counter] = p_object;
+	MutexLock lock(slot_lock);
+
+	uint32_t slot;
+	if (free_slots.size()) {
+		slot = free_slots[free_slots.size() - 1];
+		free_slots.resize(free_slots.size() - 1);
+	} else {
+		if (slot_count > OBJECTDB_SLOT_MASK) {
+			//an object without an ID could not be found or freed properly
+			ERR_EXPLAIN("Too many objects, all ObjectDB slots are in use.");
+			CRASH_NOW();
+		}
+		slot = slot_count++;
+		if ((slot >> OBJECTDB_CHUNK_BITS) == chunk_count) {
+			Slot *chunk = memnew_arr(Slot, OBJECTDB_CHUNK_SIZE);
+			for (int i = 0; i < OBJECTDB_CHUNK_SIZE; i++) {
+				chunk[i].id = 0;
+				chunk[i].object = NULL;
+				chunk[i].validator = 0;
+			}
+			slot_chunks[chunk_count] = chunk;
+			atomic_increment(&chunk_count); //the chunk is ready before it counts
+		}
+	}
+
+	Slot &s = slot_chunks[slot >> OBJECTDB_CHUNK_BITS][slot & OBJECTDB_CHUNK_MASK];
+	s.validator++; //never 0, so neither is the ID
+	ObjectID id = (s.validator << OBJECTDB_SLOT_BITS) | slot;
+
+	s.object = p_object;
+	atomic_store_release(&s.id, id);
+	object_count++;
+
 #ifdef DEBUG_ENABLED
-	instance_checks[p_object] = instance_counter;
+	instance_checks[p_object] = id;
 #endif
-	rw_lock->write_unlock();
 
-	return instance_counter;
+	return id;
 }
 
 void ObjectDB::remove_instance(Object *p_object) {
 
-	rw_lock->write_lock();
+	ObjectID id = p_object->get_instance_id();
+	uint32_t slot = id & OBJECTDB_SLOT_MASK;
 
-	instances.erase(p_object->get_instance_id());
-#ifdef DEBUG_ENABLED
-	instance_checks.erase(p_object);
-#endif
+	MutexLock lock(slot_lock);
 
-	rw_lock->write_unlock();
-}
-Object *ObjectDB::get_instance(ObjectID p_instance_ID) {
+	ERR_FAIL_COND(slot >= slot_count);
+	Slot &s = slot_chunks[slot >> OBJECTDB_CHUNK_BITS][slot & OBJECTDB_CHUNK_MASK];
+	ERR_FAIL_COND(s.id != id || s.object != p_object);
 
-	rw_lock->read_lock();
-	Object **obj = instances.getptr(p_instance_ID);
-	rw_lock->read_unlock();
+	atomic_store_release(&s.id, ObjectID(0));
+	s.object = NULL;
+	//a slot out of validators is retired, its next ID would repeat an old one
+	if (s.validator < OBJECTDB_VALIDATOR_MAX) {
+		free_slots.push_back(slot);
+	}
+	object_count--;
 
-	if (!obj)
-		return NULL;
-	return *obj;
+#ifdef DEBUG_ENABLED
+	instance_checks.erase(p_object);
+#endif
 }
 
 void ObjectDB::debug_objects(DebugFunc p_func) {
 
-	rw_lock->read_lock();
+	MutexLock lock(slot_lock);
 
-	const ObjectID *K = NULL;
-	while ((K = instances.next(K))) {
+	for (uint32_t i = 0; i < slot_count; i++) {
 
-		p_func(instances[*K]);
+		const Slot &s = slot_chunks[i >> OBJECTDB_CHUNK_BITS][i & OBJECTDB_CHUNK_MASK];
+		if (s.id) {
+			p_func(s.object);
+		}
 	}
-
-	rw_lock->read_unlock();
 }
 
 void Object::get_argument_options(const StringName &p_function, int p_idx, List<String> *r_options) const {
@@ -1967,42 +2132,51 @@ void Object::get_argument_options(const StringName &p_function, int p_idx, List<
 
 int ObjectDB::get_object_count() {
 
-	rw_lock->read_lock();
-	int count = instances.size();
-	rw_lock->read_unlock();
-
-	return count;
+	return object_count;
 }
 
-RWLock *ObjectDB::rw_lock = NULL;
+Mutex *ObjectDB::slot_lock = NULL;
 
 void ObjectDB::setup() {
 
-	rw_lock = RWLock::create();
+	slot_lock = Mutex::create();
 }
 
 void ObjectDB::cleanup() {
 
-	rw_lock->write_lock();
-	if (instances.size()) {
+	slot_lock->lock();
+	if (object_count) {
 
 		WARN_PRINT("ObjectDB Instances still exist!");
 		if (OS::get_singleton()->is_stdout_verbose()) {
-			const ObjectID *K = NULL;
-			while ((K = instances.next(K))) {
+			for (uint32_t i = 0; i < slot_count; i++) {
+
+				const Slot &s = slot_chunks[i >> OBJECTDB_CHUNK_BITS][i & OBJECTDB_CHUNK_MASK];
+				if (!s.id)
+					continue;
 
 				String node_name;
-				if (instances[*K]->is_class("Node"))
-					node_name = " - Node Name: " + String(instances[*K]->call("get_name"));
-				if (instances[*K]->is_class("Resource"))
-					node_name = " - Resource Name: " + String(instances[*K]->call("get_name")) + " Path: " + String(instances[*K]->call("get_path"));
-				print_line("Leaked Instance: " + String(instances[*K]->get_class()) + ":" + itos(*K) + node_name);
+				if (s.object->is_class("Node"))
+					node_name = " - Node Name: " + String(s.object->call("get_name"));
+				if (s.object->is_class("Resource"))
+					node_name = " - Resource Name: " + String(s.object->call("get_name")) + " Path: " + String(s.object->call("get_path"));
+				print_line("Leaked Instance: " + String(s.object->get_class()) + ":" + itos(s.id) + node_name);
 			}
 		}
 	}
-	instances.clear();
+
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		memdelete_arr(slot_chunks[i]);
+	}
+	chunk_count = 0;
+	slot_count = 0;
+	object_count = 0;
+	free_slots.clear();
+#ifdef DEBUG_ENABLED
 	instance_checks.clear();
-	rw_lock->write_unlock();
+#endif
+	slot_lock->unlock();
 
-	memdelete(rw_lock);
+	memdelete(slot_lock);
+	slot_lock = NULL;
 }
@@ -33,7 +33,9 @@
 
 #include "list.h"
 #include "map.h"
+#include "os/mutex.h"
 #include "os/rw_lock.h"
+#include "safe_refcount.h"
 #include "set.h"
 #include "variant.h"
 #include "vmap.h"
@@ -380,9 +382,44 @@ public:                                                        \
                                                                \
 private:
 
+class MethodBind;
 class ScriptInstance;
 typedef uint64_t ObjectID;
 
+// Per call site cache for Object::call_cached(). An entry remembers the method
+// resolved for one (class, script, method) triple, and is only trusted while
+// its version matches global_version, which is bumped whenever script code is
+// recompiled or freed. Entries may be shared between threads, so they are
+// guarded like a seqlock: sequence is odd while the single writer fills the
+// entry, and readers discard what they read if sequence moved meanwhile.
+struct MethodCallCache {
+
+	static uint32_t global_version;
+	static void invalidate_all();
+
+	uint32_t version;
+	uint32_t sequence;
+	uint32_t writers;
+	const void *method_key;
+	const void *class_key;
+	const void *script_key;
+	MethodBind *method_bind;
+	const void *script_method;
+
+	void clear() { version = 0; }
+
+	MethodCallCache() {
+		version = 0;
+		sequence = 0;
+		writers = 0;
+		method_key = NULL;
+		class_key = NULL;
+		script_key = NULL;
+		method_bind = NULL;
+		script_method = NULL;
+	}
+};
+
 class Object {
 public:
 	enum ConnectFlags {
@@ -444,12 +481,34 @@ private:
 			List<Connection>::Element *cE;
 		};
 
+		// What emission needs from each slot, resolved ahead of time. The
+		// list is rebuilt on the first emission after connections change,
+		// emissions only take a reference to it.
+		struct Emitter {
+
+			Object *target;
+			ObjectID target_id;
+			StringName method;
+			MethodBind *method_bind; //used while the target has no script
+			uint32_t flags;
+			Vector<Variant> binds;
+		};
+
 		MethodInfo user;
 		VMap<Target, Slot> slot_map;
+		Vector<Emitter> emit_list;
+		int emit_max_binds;
+		bool emit_list_dirty;
 		int lock;
-		Signal() { lock = 0; }
+		Signal() {
+			lock = 0;
+			emit_max_binds = 0;
+			emit_list_dirty = true;
+		}
 	};
 
+	void _update_emit_list(Signal *p_signal);
+
 	HashMap<StringName, Signal, StringNameHasher> signal_map;
 	List<Connection> connections;
 #ifdef DEBUG_ENABLED
@@ -494,6 +553,7 @@ protected:
 	virtual bool _getv(const StringName &p_name, Variant &r_property) const { return false; };
 	virtual void _get_property_listv(List<PropertyInfo> *p_list, bool p_reversed) const {};
 	virtual void _notificationv(int p_notification, bool p_reversed){};
+	virtual bool _has_call_override() const { return false; } // classes overriding call() must return true, so call_cached() and emit_signal() go through it
 
 	static String _get_category() { return ""; }
 	static void _bind_methods();
@@ -642,6 +702,7 @@ public:
 	void get_method_list(List<MethodInfo> *p_list) const;
 	Variant callv(const StringName &p_method, const Array &p_args);
 	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error);
+	Variant call_cached(MethodCallCache *p_cache, const StringName &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error);
 	virtual void call_multilevel(const StringName &p_method, const Variant **p_args, int p_argcount);
 	virtual void call_multilevel_reversed(const StringName &p_method, const Variant **p_args, int p_argcount);
 	Variant call(const StringName &p_name, VARIANT_ARG_LIST); // C++ helper
@@ -728,6 +789,28 @@ void postinitialize_handler(Object *p_object);
 
 class ObjectDB {
 
+	// Objects are kept in slots, in chunks that never move. An ObjectID has
+	// the slot index in its lower bits and the slot's validator above them,
+	// which is bumped every time the slot is handed out. Checking an ID is an
+	// array lookup and a compare, without locking. A slot whose validator
+	// runs out is retired instead of reused, so IDs never come back to life.
+	enum {
+		OBJECTDB_SLOT_BITS = 24,
+		OBJECTDB_SLOT_MASK = (1 << OBJECTDB_SLOT_BITS) - 1,
+		OBJECTDB_CHUNK_BITS = 12,
+		OBJECTDB_CHUNK_SIZE = 1 << OBJECTDB_CHUNK_BITS,
+		OBJECTDB_CHUNK_MASK = OBJECTDB_CHUNK_SIZE - 1,
+		OBJECTDB_MAX_CHUNKS = 1 << (OBJECTDB_SLOT_BITS - OBJECTDB_CHUNK_BITS)
+	};
+
+	static const uint64_t OBJECTDB_VALIDATOR_MAX = (uint64_t(1) << (64 - OBJECTDB_SLOT_BITS)) - 1;
+
+	struct Slot {
+		ObjectID id; //0 while free, set last and cleared first
+		Object *object;
+		uint64_t validator; //last one handed out
+	};
+
 	struct ObjectPtrHash {
 
 		static _FORCE_INLINE_ uint32_t hash(const Object *p_obj) {
@@ -741,14 +824,19 @@ class ObjectDB {
 		}
 	};
 
-	static HashMap<ObjectID, Object *> instances;
+	static Slot *slot_chunks[OBJECTDB_MAX_CHUNKS];
+	static uint32_t chunk_count;
+	static uint32_t slot_count; //slots handed out at least once
+	static Vector<uint32_t> free_slots;
+	static uint32_t object_count;
+#ifdef DEBUG_ENABLED
 	static HashMap<Object *, ObjectID, ObjectPtrHash> instance_checks;
+#endif
 
-	static ObjectID instance_counter;
 	friend class Object;
 	friend void unregister_core_types();
 
-	static RWLock *rw_lock;
+	static Mutex *slot_lock;
 	static void cleanup();
 	static ObjectID add_instance(Object *p_object);
 	static void remove_instance(Object *p_object);
@@ -758,7 +846,25 @@ class ObjectDB {
 public:
 	typedef void (*DebugFunc)(Object *p_obj);
 
-	static Object *get_instance(ObjectID p_instance_ID);
+	_FORCE_INLINE_ static Object *get_instance(ObjectID p_instance_ID) {
+
+		uint32_t slot = p_instance_ID & OBJECTDB_SLOT_MASK;
+		if ((slot >> OBJECTDB_CHUNK_BITS) >= atomic_load_acquire(&chunk_count))
+			return NULL;
+
+		const Slot &s = slot_chunks[slot >> OBJECTDB_CHUNK_BITS][slot & OBJECTDB_CHUNK_MASK];
+		if (atomic_load_acquire(&s.id) != p_instance_ID)
+			return NULL;
+
+		//the object was set before the ID, check the ID again in case the slot was freed meanwhile
+		Object *object = s.object;
+		atomic_read_barrier();
+		if (s.id != p_instance_ID)
+			return NULL;
+
+		return object;
+	}
+
 	static void debug_objects(DebugFunc p_func);
 	static int get_object_count();
 
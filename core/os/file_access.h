@@ -109,6 +109,7 @@ public:
 	virtual real_t get_real() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_buffer_ptr(int p_length) const { return NULL; } ///< get an array of bytes in place, valid until the file is closed. NULL if not supported or not enough bytes left, then use get_buffer()
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(String delim = ",") const;
@@ -215,6 +215,9 @@ public:
 	virtual Error close_dynamic_library(void *p_library_handle) { return ERR_UNAVAILABLE; }
 	virtual Error get_dynamic_library_symbol_handle(void *p_library_handle, const String p_name, void *&p_symbol_handle, bool p_optional = false) { return ERR_UNAVAILABLE; }
 
+	virtual const uint8_t *map_file(const String &p_path, size_t &r_size) { return NULL; } ///< map a whole file read only, NULL if not supported
+	virtual void unmap_file(const uint8_t *p_data, size_t p_size) {}
+
 	virtual void set_keep_screen_on(bool p_enabled);
 	virtual bool is_keep_screen_on() const;
 	virtual void set_low_processor_usage_mode(bool p_enabled);
@@ -0,0 +1,425 @@
+/*************************************************************************/
+/*  thread_pool.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "thread_pool.h"
+
+#include "os/memory.h"
+#include "os/os.h"
+
+ThreadPool *ThreadPool::singleton = NULL;
+
+static _FORCE_INLINE_ uint32_t _atomic_read(const uint32_t *p_value) {
+
+	return static_cast<const volatile uint32_t &>(*p_value);
+}
+
+void ThreadPool::TaskQueue::push_back(Group *p_group, uint32_t p_amount) {
+
+	mutex->lock();
+
+	if (count + p_amount > capacity) {
+
+		uint32_t new_capacity = capacity ? capacity : 16;
+		while (new_capacity < count + p_amount)
+			new_capacity <<= 1;
+
+		Group **new_buffer = (Group **)memalloc(sizeof(Group *) * new_capacity);
+		for (uint32_t i = 0; i < count; i++) {
+			new_buffer[i] = buffer[(head + i) & (capacity - 1)];
+		}
+		if (buffer)
+			memfree(buffer);
+
+		buffer = new_buffer;
+		capacity = new_capacity;
+		head = 0;
+	}
+
+	for (uint32_t i = 0; i < p_amount; i++) {
+		buffer[(head + count) & (capacity - 1)] = p_group;
+		count++;
+	}
+
+	mutex->unlock();
+}
+
+ThreadPool::Group *ThreadPool::TaskQueue::pop_back() {
+
+	Group *group = NULL;
+
+	mutex->lock();
+	if (count > 0) {
+		count--;
+		group = buffer[(head + count) & (capacity - 1)];
+	}
+	mutex->unlock();
+
+	return group;
+}
+
+ThreadPool::Group *ThreadPool::TaskQueue::pop_front() {
+
+	Group *group = NULL;
+
+	mutex->lock();
+	if (count > 0) {
+		group = buffer[head];
+		head = (head + 1) & (capacity - 1);
+		count--;
+	}
+	mutex->unlock();
+
+	return group;
+}
+
+void ThreadPool::_thread_func(void *p_worker) {
+
+	Worker *worker = (Worker *)p_worker;
+	ThreadPool *pool = worker->pool;
+
+	worker->id = Thread::get_caller_id();
+
+	while (true) {
+
+		pool->work_available->wait();
+
+		if (pool->exit_threads)
+			break;
+
+		Group *task = pool->_pop_task(worker->index);
+		while (task) {
+			pool->_run_task(task);
+			task = pool->_pop_task(worker->index);
+		}
+	}
+}
+
+int ThreadPool::_get_worker_index() const {
+
+	if (workers.empty())
+		return -1;
+
+	Thread::ID caller = Thread::get_caller_id();
+	for (int i = 0; i < workers.size(); i++) {
+		if (workers[i]->id == caller)
+			return i;
+	}
+
+	return -1;
+}
+
+ThreadPool::Group *ThreadPool::_alloc_group() {
+
+	mutex->lock();
+
+	Group *group = free_groups;
+	if (group) {
+		free_groups = group->next_free;
+	} else {
+		group = memnew(Group);
+		group->done = Semaphore::create();
+	}
+
+	mutex->unlock();
+
+	group->id = INVALID_GROUP_ID;
+	group->func = NULL;
+	group->task_func = NULL;
+	group->userdata = NULL;
+	group->template_userdata = NULL;
+	group->elements = 0;
+	group->index = 0;
+	group->task_count = 0;
+	group->completed_tasks = 0;
+	group->next_free = NULL;
+
+	return group;
+}
+
+ThreadPool::GroupID ThreadPool::_post_group(Group *p_group, int p_tasks) {
+
+	uint32_t tasks = p_tasks < 0 ? MAX(workers.size(), 1) : p_tasks;
+	if (tasks > p_group->elements)
+		tasks = p_group->elements;
+
+	p_group->task_count = tasks;
+
+	mutex->lock();
+	p_group->id = ++last_id;
+	groups.set(p_group->id, p_group);
+	mutex->unlock();
+
+	if (tasks > 0) {
+
+		int worker_index = _get_worker_index();
+		TaskQueue *queue = worker_index >= 0 ? worker_queues[worker_index] : &global_queue;
+		queue->push_back(p_group, tasks);
+
+		uint32_t wake = MIN(tasks, (uint32_t)workers.size());
+		for (uint32_t i = 0; i < wake; i++) {
+			work_available->post();
+		}
+	}
+
+	return p_group->id;
+}
+
+void ThreadPool::_process_group(Group *p_group) {
+
+	while (true) {
+		uint32_t index = atomic_increment(&p_group->index) - 1;
+		if (index >= p_group->elements)
+			break;
+		p_group->process(index);
+	}
+}
+
+void ThreadPool::_run_task(Group *p_group) {
+
+	_process_group(p_group);
+
+	// Fetch the semaphore first, the group may be recycled as soon as the last task completes.
+	Semaphore *done = p_group->done;
+	if (atomic_increment(&p_group->completed_tasks) == p_group->task_count) {
+		done->post();
+	}
+}
+
+ThreadPool::Group *ThreadPool::_pop_task(int p_worker_index) {
+
+	Group *task = NULL;
+
+	if (p_worker_index >= 0) {
+		task = worker_queues[p_worker_index]->pop_back();
+		if (task)
+			return task;
+	}
+
+	task = global_queue.pop_front();
+	if (task)
+		return task;
+
+	int queue_count = worker_queues.size();
+	int from = p_worker_index >= 0 ? p_worker_index + 1 : 0;
+	for (int i = 0; i < queue_count; i++) {
+		int steal_index = (from + i) % queue_count;
+		if (steal_index == p_worker_index)
+			continue;
+		task = worker_queues[steal_index]->pop_front();
+		if (task)
+			return task;
+	}
+
+	return NULL;
+}
+
+ThreadPool::GroupID ThreadPool::add_task(TaskFunc p_func, void *p_userdata) {
+
+	ERR_FAIL_COND_V(!p_func, INVALID_GROUP_ID);
+
+	Group *group = _alloc_group();
+	group->task_func = p_func;
+	group->userdata = p_userdata;
+	group->elements = 1;
+	return _post_group(group, 1);
+}
+
+ThreadPool::GroupID ThreadPool::add_group_task(GroupFunc p_func, void *p_userdata, uint32_t p_elements, int p_tasks) {
+
+	ERR_FAIL_COND_V(!p_func, INVALID_GROUP_ID);
+
+	Group *group = _alloc_group();
+	group->func = p_func;
+	group->userdata = p_userdata;
+	group->elements = p_elements;
+	return _post_group(group, p_tasks);
+}
+
+bool ThreadPool::is_group_completed(GroupID p_group) const {
+
+	MutexLock lock(mutex);
+
+	Group *const *group = groups.getptr(p_group);
+	if (!group)
+		return true; // already waited for
+
+	return _atomic_read(&(*group)->completed_tasks) == (*group)->task_count;
+}
+
+void ThreadPool::wait_for_group(GroupID p_group) {
+
+	mutex->lock();
+	Group **groupp = groups.getptr(p_group);
+	Group *group = groupp ? *groupp : NULL;
+	if (group)
+		groups.erase(p_group); // Only a single thread may wait on a group.
+	mutex->unlock();
+
+	ERR_FAIL_COND(!group);
+
+	// Help with the group itself, then with anything else that is queued, until all of its tasks are done.
+	_process_group(group);
+
+	int worker_index = _get_worker_index();
+	while (_atomic_read(&group->completed_tasks) < group->task_count) {
+		Group *task = _pop_task(worker_index);
+		if (!task)
+			break;
+		_run_task(task);
+	}
+
+	if (group->task_count > 0) {
+		group->done->wait();
+	}
+
+	if (group->template_userdata) {
+		memdelete(group->template_userdata);
+	}
+
+	mutex->lock();
+	group->next_free = free_groups;
+	free_groups = group;
+	mutex->unlock();
+}
+
+void ThreadPool::init(int p_thread_count) {
+
+	ERR_FAIL_COND(initialized);
+
+#ifdef NO_THREADS
+	p_thread_count = 0;
+#else
+	if (p_thread_count < 0)
+		p_thread_count = OS::get_singleton()->get_processor_count();
+#endif
+
+	exit_threads = false;
+
+	worker_queues.resize(p_thread_count);
+	workers.resize(p_thread_count);
+
+	for (int i = 0; i < p_thread_count; i++) {
+
+		TaskQueue *queue = memnew(TaskQueue);
+		queue->mutex = Mutex::create();
+		queue->buffer = NULL;
+		queue->capacity = 0;
+		queue->head = 0;
+		queue->count = 0;
+		worker_queues[i] = queue;
+
+		Worker *worker = memnew(Worker);
+		worker->pool = this;
+		worker->index = i;
+		worker->id = 0;
+		worker->thread = NULL;
+		workers[i] = worker;
+	}
+
+	for (int i = 0; i < p_thread_count; i++) {
+		workers[i]->thread = Thread::create(_thread_func, workers[i]);
+	}
+
+	initialized = true;
+}
+
+void ThreadPool::finish() {
+
+	if (!initialized)
+		return;
+
+	exit_threads = true;
+
+	for (int i = 0; i < workers.size(); i++) {
+		work_available->post();
+	}
+
+	for (int i = 0; i < workers.size(); i++) {
+		if (workers[i]->thread) {
+			Thread::wait_to_finish(workers[i]->thread);
+			memdelete(workers[i]->thread);
+		}
+		memdelete(workers[i]);
+	}
+
+	for (int i = 0; i < worker_queues.size(); i++) {
+		if (worker_queues[i]->buffer)
+			memfree(worker_queues[i]->buffer);
+		memdelete(worker_queues[i]->mutex);
+		memdelete(worker_queues[i]);
+	}
+
+	if (groups.size()) {
+		WARN_PRINT("ThreadPool: Some task groups were never waited for.");
+	}
+
+	workers.clear();
+	worker_queues.clear();
+
+	initialized = false;
+}
+
+ThreadPool::ThreadPool() {
+
+	singleton = this;
+
+	global_queue.mutex = Mutex::create();
+	global_queue.buffer = NULL;
+	global_queue.capacity = 0;
+	global_queue.head = 0;
+	global_queue.count = 0;
+
+	work_available = Semaphore::create();
+	mutex = Mutex::create();
+	free_groups = NULL;
+	last_id = INVALID_GROUP_ID;
+	exit_threads = false;
+	initialized = false;
+}
+
+ThreadPool::~ThreadPool() {
+
+	finish();
+
+	while (free_groups) {
+		Group *group = free_groups;
+		free_groups = group->next_free;
+		memdelete(group->done);
+		memdelete(group);
+	}
+
+	if (global_queue.buffer)
+		memfree(global_queue.buffer);
+	memdelete(global_queue.mutex);
+	memdelete(work_available);
+	memdelete(mutex);
+
+	singleton = NULL;
+}
@@ -0,0 +1,183 @@
+/*************************************************************************/
+/*  thread_pool.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "hash_map.h"
+#include "os/mutex.h"
+#include "os/semaphore.h"
+#include "os/thread.h"
+#include "safe_refcount.h"
+#include "vector.h"
+
+/**
+ * Engine wide pool of persistent worker threads.
+ *
+ * Work is submitted as groups: a callback that is invoked once for every
+ * element index in [0, elements). Each group is split into a few tasks that
+ * pull indices from a shared counter, so uneven elements balance themselves.
+ * Every worker owns a local task queue; tasks queued from a worker go to its
+ * own queue (LIFO), tasks queued from any other thread go to a global queue,
+ * and idle workers steal from the others (FIFO).
+ *
+ * Every group must eventually be passed to wait_for_group(), which frees it.
+ * The waiting thread does not sleep while there is work left: it processes
+ * elements of the group it waits for and runs other queued tasks.
+ */
+
+class ThreadPool {
+public:
+	typedef void (*TaskFunc)(void *p_userdata);
+	typedef void (*GroupFunc)(void *p_userdata, uint32_t p_index);
+	typedef uint64_t GroupID;
+
+	enum {
+		INVALID_GROUP_ID = 0
+	};
+
+private:
+	struct BaseTemplateUserdata {
+		virtual void call(uint32_t p_index) = 0;
+		virtual ~BaseTemplateUserdata() {}
+	};
+
+	template <class C, class M, class U>
+	struct GroupUserdata : public BaseTemplateUserdata {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void call(uint32_t p_index) {
+			(instance->*method)(p_index, userdata);
+		}
+	};
+
+	struct Group {
+		GroupID id;
+		GroupFunc func;
+		TaskFunc task_func;
+		void *userdata;
+		BaseTemplateUserdata *template_userdata;
+		uint32_t elements;
+		uint32_t index; // next element to process, atomic
+		uint32_t task_count;
+		uint32_t completed_tasks; // atomic
+		Semaphore *done;
+		Group *next_free;
+
+		_FORCE_INLINE_ void process(uint32_t p_index) {
+			if (template_userdata) {
+				template_userdata->call(p_index);
+			} else if (task_func) {
+				task_func(userdata);
+			} else {
+				func(userdata, p_index);
+			}
+		}
+	};
+
+	struct TaskQueue {
+		Mutex *mutex;
+		Group **buffer;
+		uint32_t capacity; // always a power of two
+		uint32_t head;
+		uint32_t count;
+
+		void push_back(Group *p_group, uint32_t p_amount);
+		Group *pop_back();
+		Group *pop_front();
+	};
+
+	struct Worker {
+		ThreadPool *pool;
+		Thread *thread;
+		Thread::ID id;
+		uint32_t index;
+	};
+
+	static ThreadPool *singleton;
+
+	Vector<Worker *> workers;
+	TaskQueue global_queue;
+	Vector<TaskQueue *> worker_queues;
+
+	Semaphore *work_available;
+	Mutex *mutex; // protects groups and free_groups
+	HashMap<GroupID, Group *> groups;
+	Group *free_groups;
+	GroupID last_id;
+
+	volatile bool exit_threads;
+	bool initialized;
+
+	static void _thread_func(void *p_worker);
+
+	int _get_worker_index() const;
+	Group *_alloc_group();
+	GroupID _post_group(Group *p_group, int p_tasks);
+	void _process_group(Group *p_group);
+	void _run_task(Group *p_group);
+	Group *_pop_task(int p_worker_index);
+
+public:
+	_FORCE_INLINE_ static ThreadPool *get_singleton() { return singleton; }
+
+	GroupID add_task(TaskFunc p_func, void *p_userdata);
+	GroupID add_group_task(GroupFunc p_func, void *p_userdata, uint32_t p_elements, int p_tasks = -1);
+
+	template <class C, class M, class U>
+	GroupID add_template_group_task(C *p_instance, M p_method, U p_userdata, uint32_t p_elements, int p_tasks = -1) {
+
+		typedef GroupUserdata<C, M, U> GroupUserdataType;
+		GroupUserdataType *ud = memnew(GroupUserdataType);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+
+		Group *group = _alloc_group();
+		group->template_userdata = ud;
+		group->elements = p_elements;
+		return _post_group(group, p_tasks);
+	}
+
+	bool is_group_completed(GroupID p_group) const;
+	void wait_for_group(GroupID p_group);
+
+	int get_thread_count() const { return workers.size(); }
+	bool is_working_thread() const { return _get_worker_index() != -1; }
+
+	void init(int p_thread_count = -1);
+	void finish();
+
+	ThreadPool();
+	~ThreadPool();
+};
+
+#endif // THREAD_POOL_H
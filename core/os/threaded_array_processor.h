@@ -34,6 +34,7 @@
 #include "os/mutex.h"
 #include "os/os.h"
 #include "os/thread.h"
+#include "os/thread_pool.h"
 #include "safe_refcount.h"
 #include "thread_safe.h"
 
@@ -53,15 +54,10 @@ struct ThreadArrayProcessData {
 #ifndef NO_THREADS
 
 template <class T>
-void process_array_thread(void *ud) {
+void process_array_thread(void *ud, uint32_t p_index) {
 
 	T &data = *(T *)ud;
-	while (true) {
-		uint32_t index = atomic_increment(&data.index);
-		if (index >= data.elements)
-			break;
-		data.process(index);
-	}
+	data.process(p_index);
 }
 
 template <class C, class M, class U>
@@ -73,20 +69,18 @@ void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_us
 	data.userdata = p_userdata;
 	data.index = 0;
 	data.elements = p_elements;
-	data.process(data.index); //process first, let threads increment for next
-
-	Vector<Thread *> threads;
 
-	threads.resize(OS::get_singleton()->get_processor_count());
-
-	for (int i = 0; i < threads.size(); i++) {
-		threads[i] = Thread::create(process_array_thread<ThreadArrayProcessData<C, U> >, &data);
+	ThreadPool *pool = ThreadPool::get_singleton();
+	if (!pool) {
+		for (uint32_t i = 0; i < p_elements; i++) {
+			data.process(i);
+		}
+		return;
 	}
 
-	for (int i = 0; i < threads.size(); i++) {
-		Thread::wait_to_finish(threads[i]);
-		memdelete(threads[i]);
-	}
+	// Workers are persistent, the calling thread processes elements too while it waits.
+	ThreadPool::GroupID group = pool->add_group_task(process_array_thread<ThreadArrayProcessData<C, U> >, &data, p_elements);
+	pool->wait_for_group(group);
 }
 
 #else
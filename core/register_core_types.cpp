@@ -39,6 +39,7 @@
 #include "func_ref.h"
 #include "geometry.h"
 #include "input_map.h"
+#include "io/compression.h"
 #include "io/config_file.h"
 #include "io/http_client.h"
 #include "io/marshalls.h"
@@ -49,12 +50,14 @@
 #include "io/resource_format_binary.h"
 #include "io/resource_import.h"
 #include "io/stream_peer_ssl.h"
+#include "io/tcp_poller.h"
 #include "io/tcp_server.h"
 #include "io/translation_loader_po.h"
 #include "math/a_star.h"
 #include "math/triangle_mesh.h"
 #include "os/input.h"
 #include "os/main_loop.h"
+#include "os/thread_pool.h"
 #include "packed_data_container.h"
 #include "path_remap.h"
 #include "project_settings.h"
@@ -72,6 +75,8 @@ static _ClassDB *_classdb = NULL;
 static _Marshalls *_marshalls = NULL;
 static TranslationLoaderPO *resource_format_po = NULL;
 static _JSON *_json = NULL;
+static ThreadPool *thread_pool = NULL;
+static _ThreadPool *_thread_pool = NULL;
 
 static IP *ip = NULL;
 
@@ -89,9 +94,14 @@ void register_core_types() {
 	ObjectDB::setup();
 	ResourceCache::setup();
 	MemoryPool::setup();
+	Compression::setup();
 
 	_global_mutex = Mutex::create();
 
+	thread_pool = memnew(ThreadPool);
+
+	ResourceLoader::setup();
+
 	StringName::setup();
 
 	register_global_constants();
@@ -139,6 +149,7 @@ void register_core_types() {
 	ClassDB::register_class<StreamPeerBuffer>();
 	ClassDB::register_custom_instance_class<StreamPeerTCP>();
 	ClassDB::register_custom_instance_class<TCP_Server>();
+	ClassDB::register_custom_instance_class<TCP_Poller>();
 	ClassDB::register_custom_instance_class<PacketPeerUDP>();
 	ClassDB::register_custom_instance_class<StreamPeerSSL>();
 	ClassDB::register_virtual_class<IP>();
@@ -185,6 +196,7 @@ void register_core_types() {
 	_classdb = memnew(_ClassDB);
 	_marshalls = memnew(_Marshalls);
 	_json = memnew(_JSON);
+	_thread_pool = memnew(_ThreadPool);
 }
 
 void register_core_settings() {
@@ -207,6 +219,7 @@ void register_core_singletons() {
 	ClassDB::register_virtual_class<Input>();
 	ClassDB::register_class<InputMap>();
 	ClassDB::register_class<_JSON>();
+	ClassDB::register_class<_ThreadPool>();
 
 	Engine::get_singleton()->add_singleton(Engine::Singleton("ProjectSettings", ProjectSettings::get_singleton()));
 	Engine::get_singleton()->add_singleton(Engine::Singleton("IP", IP::get_singleton()));
@@ -221,10 +234,13 @@ void register_core_singletons() {
 	Engine::get_singleton()->add_singleton(Engine::Singleton("Input", Input::get_singleton()));
 	Engine::get_singleton()->add_singleton(Engine::Singleton("InputMap", InputMap::get_singleton()));
 	Engine::get_singleton()->add_singleton(Engine::Singleton("JSON", _JSON::get_singleton()));
+	Engine::get_singleton()->add_singleton(Engine::Singleton("ThreadPool", _ThreadPool::get_singleton()));
 }
 
 void unregister_core_types() {
 
+	ResourceLoader::cleanup();
+
 	memdelete(_resource_loader);
 	memdelete(_resource_saver);
 	memdelete(_os);
@@ -232,6 +248,7 @@ void unregister_core_types() {
 	memdelete(_classdb);
 	memdelete(_marshalls);
 	memdelete(_json);
+	memdelete(_thread_pool);
 
 	memdelete(_geometry);
 
@@ -247,6 +264,8 @@ void unregister_core_types() {
 	if (ip)
 		memdelete(ip);
 
+	memdelete(thread_pool);
+
 	ObjectDB::cleanup();
 
 	unregister_variant_methods();
@@ -254,6 +273,7 @@ void unregister_core_types() {
 
 	ClassDB::cleanup();
 	ResourceCache::clear();
+	Compression::cleanup();
 	CoreStringNames::free();
 	StringName::cleanup();
 
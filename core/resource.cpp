@@ -50,43 +50,36 @@ void Resource::set_path(const String &p_path, bool p_take_over) {
 	if (path_cache == p_path)
 		return;
 
-	if (path_cache != "") {
+	ResourceCache::lock->write_lock();
 
-		ResourceCache::lock->write_lock();
-		ResourceCache::resources.erase(path_cache);
-		ResourceCache::lock->write_unlock();
+	if (path_cache != "") {
+		ResourceCache::_erase(path_cache, this);
 	}
 
 	path_cache = "";
 
-	ResourceCache::lock->read_lock();
-	bool has_path = ResourceCache::resources.has(p_path);
-	ResourceCache::lock->read_unlock();
+	Resource **existing = ResourceCache::resources.getptr(p_path);
 
-	if (has_path) {
-		if (p_take_over) {
+	// a resource whose last reference is gone is only waiting for its destructor to leave the cache
+	if (existing && !p_take_over && (*existing)->reference_get_count() > 0) {
 
-			ResourceCache::lock->write_lock();
-			ResourceCache::resources.get(p_path)->set_name("");
-			ResourceCache::lock->write_unlock();
-		} else {
-			ResourceCache::lock->read_lock();
-			bool exists = ResourceCache::resources.has(p_path);
-			ResourceCache::lock->read_unlock();
+		ResourceCache::lock->write_unlock();
+		ERR_EXPLAIN("Another resource is loaded from path: " + p_path + " (possible cyclic resource inclusion)");
+		ERR_FAIL();
+	}
 
-			ERR_EXPLAIN("Another resource is loaded from path: " + p_path + " (possible cyclic resource inclusion)");
-			ERR_FAIL_COND(exists);
-		}
+	if (existing && p_take_over) {
+		(*existing)->set_name("");
 	}
+
 	path_cache = p_path;
 
 	if (path_cache != "") {
-
-		ResourceCache::lock->write_lock();
 		ResourceCache::resources[path_cache] = this;
-		ResourceCache::lock->write_unlock();
 	}
 
+	ResourceCache::lock->write_unlock();
+
 	_change_notify("resource_path");
 	_resource_path_changed();
 }
@@ -396,7 +389,7 @@ Resource::~Resource() {
 
 	if (path_cache != "") {
 		ResourceCache::lock->write_lock();
-		ResourceCache::resources.erase(path_cache);
+		ResourceCache::_erase(path_cache, this);
 		ResourceCache::lock->write_unlock();
 	}
 	if (owners.size()) {
@@ -454,6 +447,30 @@ Resource *ResourceCache::get(const String &p_path) {
 	return *res;
 }
 
+RES ResourceCache::get_ref(const String &p_path) {
+
+	// The reference is taken while holding the lock, so the resource can not
+	// be deleted in between. One that is already being deleted has no
+	// references left and yields a null RES instead.
+	lock->read_lock();
+
+	Resource **res = resources.getptr(p_path);
+	RES ref = res ? RES(*res) : RES();
+
+	lock->read_unlock();
+
+	return ref;
+}
+
+void ResourceCache::_erase(const String &p_path, Resource *p_resource) {
+
+	// another resource may have taken the path over meanwhile
+	Resource **res = resources.getptr(p_path);
+	if (res && *res == p_resource) {
+		resources.erase(p_path);
+	}
+}
+
 void ResourceCache::get_cached_resources(List<Ref<Resource> > *p_resources) {
 
 	lock->read_lock();
@@ -152,11 +152,13 @@ class ResourceCache {
 	static void clear();
 	friend void register_core_types();
 	static void setup();
+	static void _erase(const String &p_path, Resource *p_resource);
 
 public:
 	static void reload_externals();
 	static bool has(const String &p_path);
 	static Resource *get(const String &p_path);
+	static RES get_ref(const String &p_path); // null if not cached or already being freed, safe while other threads drop references
 	static void dump(const char *p_file = NULL, bool p_short = false);
 	static void get_cached_resources(List<Ref<Resource> > *p_resources);
 	static int get_cached_resource_count();
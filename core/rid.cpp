@@ -34,6 +34,7 @@ RID_Data::~RID_Data() {
 }
 
 SafeRefCount RID_OwnerBase::refcount;
+uint32_t RID_OwnerBase::validator_seed = 0;
 
 void RID_OwnerBase::init_rid() {
 
@@ -33,9 +33,11 @@
 
 #include "list.h"
 #include "os/memory.h"
+#include "os/mutex.h"
 #include "safe_refcount.h"
 #include "set.h"
 #include "typedefs.h"
+#include "vector.h"
 
 /**
 	@author Juan Linietsky <reduzio@gmail.com>
@@ -61,37 +63,45 @@ public:
 class RID {
 	friend class RID_OwnerBase;
 
-	mutable RID_Data *_data;
+	// Either a RID_Data pointer, or a RID_SlabOwner handle, which has the
+	// lowest bit set, the slot index above it and the slot validator in
+	// the upper 32 bits.
+	mutable uint64_t _id;
 
 public:
-	_FORCE_INLINE_ RID_Data *get_data() const { return _data; }
+	_FORCE_INLINE_ RID_Data *get_data() const { return (_id & 1) ? NULL : (RID_Data *)(uintptr_t)_id; }
 
 	_FORCE_INLINE_ bool operator==(const RID &p_rid) const {
 
-		return _data == p_rid._data;
+		return _id == p_rid._id;
 	}
 	_FORCE_INLINE_ bool operator<(const RID &p_rid) const {
 
-		return _data < p_rid._data;
+		return _id < p_rid._id;
 	}
 	_FORCE_INLINE_ bool operator<=(const RID &p_rid) const {
 
-		return _data <= p_rid._data;
+		return _id <= p_rid._id;
 	}
 	_FORCE_INLINE_ bool operator>(const RID &p_rid) const {
 
-		return _data > p_rid._data;
+		return _id > p_rid._id;
 	}
 	_FORCE_INLINE_ bool operator!=(const RID &p_rid) const {
 
-		return _data != p_rid._data;
+		return _id != p_rid._id;
 	}
-	_FORCE_INLINE_ bool is_valid() const { return _data != NULL; }
+	_FORCE_INLINE_ bool is_valid() const { return _id != 0; }
 
-	_FORCE_INLINE_ uint32_t get_id() const { return _data ? _data->get_id() : 0; }
+	_FORCE_INLINE_ uint32_t get_id() const {
+
+		if (_id & 1)
+			return _id >> 32; //the validator, unique among live RIDs of the owner
+		return _id ? get_data()->get_id() : 0;
+	}
 
 	_FORCE_INLINE_ RID() {
-		_data = NULL;
+		_id = 0;
 	}
 };
 
@@ -99,7 +109,7 @@ class RID_OwnerBase {
 protected:
 	static SafeRefCount refcount;
 	_FORCE_INLINE_ void _set_data(RID &p_rid, RID_Data *p_data) {
-		p_rid._data = p_data;
+		p_rid._id = (uintptr_t)p_data;
 		refcount.ref();
 		p_data->_id = refcount.get();
 #ifndef DEBUG_ENABLED
@@ -107,16 +117,44 @@ protected:
 #endif
 	}
 
+	static uint32_t validator_seed;
+
+	_FORCE_INLINE_ static uint32_t _new_validator() {
+
+		uint32_t validator = atomic_increment(&validator_seed);
+		return validator ? validator : atomic_increment(&validator_seed); //0 marks free slots
+	}
+
+	_FORCE_INLINE_ static void _set_handle(RID &p_rid, uint32_t p_index, uint32_t p_validator) {
+
+		p_rid._id = (uint64_t(p_validator) << 32) | (uint64_t(p_index) << 1) | 1;
+	}
+
+	_FORCE_INLINE_ static bool _is_handle(const RID &p_rid) {
+
+		return p_rid._id & 1;
+	}
+
+	_FORCE_INLINE_ static uint32_t _get_handle_index(const RID &p_rid) {
+
+		return uint32_t(p_rid._id) >> 1;
+	}
+
+	_FORCE_INLINE_ static uint32_t _get_handle_validator(const RID &p_rid) {
+
+		return p_rid._id >> 32;
+	}
+
 #ifndef DEBUG_ENABLED
 
 	_FORCE_INLINE_ bool _is_owner(const RID &p_rid) const {
 
-		return this == p_rid._data->_owner;
+		return this == p_rid.get_data()->_owner;
 	}
 
 	_FORCE_INLINE_ void _remove_owner(RID &p_rid) {
 
-		p_rid._data->_owner = NULL;
+		p_rid.get_data()->_owner = NULL;
 	}
 #
 #endif
@@ -206,4 +244,204 @@ public:
 	}
 };
 
+// Keeps the objects themselves, in chunks, instead of pointers to objects
+// allocated one by one. Its RIDs are slot handles checked in constant time
+// against the slot validator, which changes every time the slot is reused.
+// Lookups are safe from any thread while others make and free RIDs, making
+// and freeing take a lock. Objects are default constructed by make_rid()
+// and destructed by free().
+template <class T>
+class RID_SlabOwner : public RID_OwnerBase {
+
+	enum {
+		CHUNK_BYTES = 16384,
+		CHUNK_SIZE = sizeof(T) >= CHUNK_BYTES ? 1 : CHUNK_BYTES / sizeof(T)
+	};
+
+	struct Chunk {
+		T *data;
+		uint32_t *validators; //0 for free slots
+	};
+
+	// Chunks never move. When the table fills up it is copied to a bigger
+	// one, and kept until destruction for readers still looking at it.
+	struct Table {
+		uint32_t count;
+		uint32_t capacity;
+		Table *retired;
+		Chunk chunks[1];
+	};
+
+	Table *table;
+	Vector<uint32_t> free_slots;
+	uint32_t used_slots; //slots handed out at least once
+	uint32_t rid_count;
+	Mutex *lock;
+
+	static Table *_alloc_table(uint32_t p_capacity) {
+
+		Table *t = (Table *)memalloc(sizeof(Table) + sizeof(Chunk) * (p_capacity - 1));
+		t->count = 0;
+		t->capacity = p_capacity;
+		t->retired = NULL;
+		return t;
+	}
+
+	void _add_chunk() {
+
+		if (table->count == table->capacity) {
+			Table *t = _alloc_table(table->capacity * 2);
+			for (uint32_t i = 0; i < table->count; i++) {
+				t->chunks[i] = table->chunks[i];
+			}
+			t->retired = table;
+			atomic_add(&t->count, table->count); //the copy is complete before it is published
+			table = t;
+		}
+
+		Chunk &c = table->chunks[table->count];
+		c.data = (T *)memalloc(sizeof(T) * CHUNK_SIZE);
+		c.validators = (uint32_t *)memalloc(sizeof(uint32_t) * CHUNK_SIZE);
+		for (int i = 0; i < CHUNK_SIZE; i++) {
+			c.validators[i] = 0;
+		}
+		atomic_increment(&table->count); //the chunk is ready before it counts
+	}
+
+	_FORCE_INLINE_ T *_lookup(const RID &p_rid) const {
+
+		if (!_is_handle(p_rid))
+			return NULL;
+
+		uint32_t index = _get_handle_index(p_rid);
+		const Table *t = table;
+		if (index / CHUNK_SIZE >= atomic_load_acquire(&t->count))
+			return NULL;
+
+		//pairs with make_rid(), a matching validator means the object is constructed
+		const Chunk &c = t->chunks[index / CHUNK_SIZE];
+		if (atomic_load_acquire(&c.validators[index % CHUNK_SIZE]) != _get_handle_validator(p_rid))
+			return NULL;
+
+		return &c.data[index % CHUNK_SIZE];
+	}
+
+public:
+	RID make_rid() {
+
+		MutexLock ml(lock);
+
+		uint32_t index;
+		if (free_slots.size()) {
+			index = free_slots[free_slots.size() - 1];
+			free_slots.resize(free_slots.size() - 1);
+		} else {
+			if (used_slots == table->count * CHUNK_SIZE) {
+				_add_chunk();
+			}
+			index = used_slots++;
+		}
+
+		const Chunk &c = table->chunks[index / CHUNK_SIZE];
+		memnew_placement(&c.data[index % CHUNK_SIZE], T);
+		uint32_t validator = _new_validator();
+		atomic_store_release(&c.validators[index % CHUNK_SIZE], validator); //published only once constructed
+		rid_count++;
+
+		RID rid;
+		_set_handle(rid, index, validator);
+		return rid;
+	}
+
+	_FORCE_INLINE_ T *get(const RID &p_rid) {
+
+		T *ptr = _lookup(p_rid);
+#ifdef DEBUG_ENABLED
+		ERR_FAIL_COND_V(!ptr, NULL);
+#endif
+		return ptr;
+	}
+
+	_FORCE_INLINE_ T *getornull(const RID &p_rid) {
+
+		if (!p_rid.is_valid())
+			return NULL;
+
+		T *ptr = _lookup(p_rid);
+#ifdef DEBUG_ENABLED
+		ERR_FAIL_COND_V(!ptr, NULL);
+#endif
+		return ptr;
+	}
+
+	_FORCE_INLINE_ T *getptr(const RID &p_rid) {
+
+		return _lookup(p_rid);
+	}
+
+	_FORCE_INLINE_ bool owns(const RID &p_rid) const {
+
+		return _lookup(p_rid) != NULL;
+	}
+
+	void free(RID p_rid) {
+
+		MutexLock ml(lock);
+
+		T *ptr = _lookup(p_rid);
+		ERR_FAIL_COND(!ptr);
+
+		uint32_t index = _get_handle_index(p_rid);
+		table->chunks[index / CHUNK_SIZE].validators[index % CHUNK_SIZE] = 0; //no longer found from here on
+		ptr->~T();
+		free_slots.push_back(index);
+		rid_count--;
+	}
+
+	uint32_t get_rid_count() const {
+
+		return rid_count;
+	}
+
+	void get_owned_list(List<RID> *p_owned) {
+
+		MutexLock ml(lock);
+
+		for (uint32_t i = 0; i < used_slots; i++) {
+			uint32_t validator = table->chunks[i / CHUNK_SIZE].validators[i % CHUNK_SIZE];
+			if (validator) {
+				RID rid;
+				_set_handle(rid, i, validator);
+				p_owned->push_back(rid);
+			}
+		}
+	}
+
+	RID_SlabOwner() {
+
+		table = _alloc_table(8);
+		used_slots = 0;
+		rid_count = 0;
+		lock = Mutex::create();
+	}
+
+	~RID_SlabOwner() {
+
+		//like RID_Owner, objects still owned are leaked, their memory is not
+		for (uint32_t i = 0; i < table->count; i++) {
+			memfree(table->chunks[i].data);
+			memfree(table->chunks[i].validators);
+		}
+
+		while (table) {
+			Table *retired = table->retired;
+			memfree(table);
+			table = retired;
+		}
+
+		if (lock)
+			memdelete(lock);
+	}
+};
+
 #endif
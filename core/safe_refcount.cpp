@@ -166,4 +166,24 @@ uint64_t atomic_add(register uint64_t *pw, register uint64_t val) {
 uint64_t atomic_exchange_if_greater(register uint64_t *pw, register uint64_t val) {
 	return _atomic_exchange_if_greater_impl(pw, val);
 }
+
+uint32_t atomic_load_acquire(register const uint32_t *pw) {
+	return InterlockedCompareExchange((LONG volatile *)pw, 0, 0);
+}
+
+uint64_t atomic_load_acquire(register const uint64_t *pw) {
+	return InterlockedCompareExchange64((LONGLONG volatile *)pw, 0, 0);
+}
+
+void atomic_store_release(register uint32_t *pw, register uint32_t val) {
+	InterlockedExchange((LONG volatile *)pw, val);
+}
+
+void atomic_store_release(register uint64_t *pw, register uint64_t val) {
+	InterlockedExchange64((LONGLONG volatile *)pw, val);
+}
+
+void atomic_read_barrier() {
+	MemoryBarrier();
+}
 #endif
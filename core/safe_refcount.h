@@ -95,6 +95,33 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(register T *pw, register V v
 	return *pw;
 }
 
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(register const T *pw) {
+
+	return *pw;
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_release(register T *pw, register V val) {
+
+	*pw = val;
+}
+
+static _ALWAYS_INLINE_ void atomic_read_barrier() {
+}
+
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_relaxed(register const T *pw) {
+
+	return *pw;
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_relaxed(register T *pw, register V val) {
+
+	*pw = val;
+}
+
 #elif defined(__GNUC__)
 
 /* Implementation for GCC & Clang */
@@ -150,6 +177,42 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(register T *pw, register V v
 	}
 }
 
+// Publishing data: whoever loads what was stored with release also sees
+// everything written before the store.
+
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(register const T *pw) {
+
+	return __atomic_load_n(pw, __ATOMIC_ACQUIRE);
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_release(register T *pw, register V val) {
+
+	__atomic_store_n(pw, val, __ATOMIC_RELEASE);
+}
+
+// Loads before it are not reordered with loads after it.
+static _ALWAYS_INLINE_ void atomic_read_barrier() {
+
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+// No ordering, only a value that is never torn, for data that is fine to see
+// stale, such as caches other threads may rewrite.
+
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_relaxed(register const T *pw) {
+
+	return __atomic_load_n(pw, __ATOMIC_RELAXED);
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_relaxed(register T *pw, register V val) {
+
+	__atomic_store_n(pw, val, __ATOMIC_RELAXED);
+}
+
 #elif defined(_MSC_VER)
 // For MSVC use a separate compilation unit to prevent windows.h from polluting
 // the global namespace.
@@ -167,6 +230,26 @@ uint64_t atomic_sub(register uint64_t *pw, register uint64_t val);
 uint64_t atomic_add(register uint64_t *pw, register uint64_t val);
 uint64_t atomic_exchange_if_greater(register uint64_t *pw, register uint64_t val);
 
+uint32_t atomic_load_acquire(register const uint32_t *pw);
+uint64_t atomic_load_acquire(register const uint64_t *pw);
+void atomic_store_release(register uint32_t *pw, register uint32_t val);
+void atomic_store_release(register uint64_t *pw, register uint64_t val);
+void atomic_read_barrier();
+
+// Aligned word sized volatile accesses are never torn.
+
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_relaxed(register const T *pw) {
+
+	return *static_cast<const volatile T *>(pw);
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_relaxed(register T *pw, register V val) {
+
+	*static_cast<volatile T *>(pw) = val;
+}
+
 #else
 //no threads supported?
 #error Must provide atomic functions for this platform or compiler!
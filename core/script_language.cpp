@@ -168,6 +168,12 @@ Variant ScriptInstance::call(const StringName &p_method, VARIANT_ARG_DECLARE) {
 	return call(p_method, argptr, argc, error);
 }
 
+Variant ScriptInstance::call_method_handle(const void *p_handle, const Variant **p_args, int p_argcount, Variant::CallError &r_error) {
+
+	r_error.error = Variant::CallError::CALL_ERROR_INVALID_METHOD; // only called when get_method_handle() is implemented
+	return Variant();
+}
+
 void ScriptInstance::call_multilevel(const StringName &p_method, const Variant **p_args, int p_argcount) {
 	Variant::CallError ce;
 	call(p_method, p_args, p_argcount, ce); // script may not support multilevel calls
@@ -141,6 +141,12 @@ public:
 	virtual bool has_method(const StringName &p_method) const = 0;
 	virtual Variant call(const StringName &p_method, VARIANT_ARG_LIST);
 	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error) = 0;
+
+	//used by Object::call_cached(), a language returning a key resolves methods to handles that stay valid until MethodCallCache::invalidate_all()
+	virtual const void *get_method_cache_key() const { return NULL; }
+	virtual const void *get_method_handle(const StringName &p_method) const { return NULL; }
+	virtual Variant call_method_handle(const void *p_handle, const Variant **p_args, int p_argcount, Variant::CallError &r_error);
+
 	virtual void call_multilevel(const StringName &p_method, VARIANT_ARG_LIST);
 	virtual void call_multilevel(const StringName &p_method, const Variant **p_args, int p_argcount);
 	virtual void call_multilevel_reversed(const StringName &p_method, const Variant **p_args, int p_argcount);
@@ -39,7 +39,7 @@ StaticCString StaticCString::create(const char *p_ptr) {
 	return scs;
 }
 
-StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+StringName::_Shard StringName::_shards[STRING_TABLE_SHARDS];
 
 StringName _scs_create(const char *p_chr) {
 
@@ -47,50 +47,193 @@ StringName _scs_create(const char *p_chr) {
 }
 
 bool StringName::configured = false;
-Mutex *StringName::lock = NULL;
 
 void StringName::setup() {
 
-	lock = Mutex::create();
-
 	ERR_FAIL_COND(configured);
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-
-		_table[i] = NULL;
+	for (int i = 0; i < STRING_TABLE_SHARDS; i++) {
+
+		_Shard &shard = _shards[i];
+		shard.lock = RWLock::create();
+		shard.mask = (1 << STRING_TABLE_MIN_BITS) - 1;
+		shard.count = 0;
+		shard.table = memnew_arr(_Data *, shard.mask + 1);
+		for (uint32_t j = 0; j <= shard.mask; j++) {
+			shard.table[j] = NULL;
+		}
 	}
 	configured = true;
 }
 
 void StringName::cleanup() {
 
-	lock->lock();
-
 	int lost_strings = 0;
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
+	for (int i = 0; i < STRING_TABLE_SHARDS; i++) {
+
+		_Shard &shard = _shards[i];
+		shard.lock->write_lock();
 
-		while (_table[i]) {
+		for (uint32_t j = 0; j <= shard.mask; j++) {
 
-			_Data *d = _table[i];
-			lost_strings++;
-			if (OS::get_singleton()->is_stdout_verbose()) {
+			while (shard.table[j]) {
 
-				if (d->cname) {
-					print_line("Orphan StringName: " + String(d->cname));
-				} else {
-					print_line("Orphan StringName: " + String(d->name));
+				_Data *d = shard.table[j];
+				lost_strings++;
+				if (OS::get_singleton()->is_stdout_verbose()) {
+
+					if (d->cname) {
+						print_line("Orphan StringName: " + String(d->cname));
+					} else {
+						print_line("Orphan StringName: " + String(d->name));
+					}
 				}
-			}
 
-			_table[i] = _table[i]->next;
-			memdelete(d);
+				shard.table[j] = shard.table[j]->next;
+				memdelete(d);
+			}
 		}
+
+		memdelete_arr(shard.table);
+		shard.table = NULL;
+		shard.count = 0;
+		shard.lock->write_unlock();
+
+		memdelete(shard.lock);
+		shard.lock = NULL;
 	}
 	if (OS::get_singleton()->is_stdout_verbose() && lost_strings) {
 		print_line("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
-	lock->unlock();
+}
+
+// Compare an interned name with a candidate without building a String.
+
+static _FORCE_INLINE_ bool _name_equals(const char *p_cname, const String &p_name, const char *p_other) {
 
-	memdelete(lock);
+	return p_cname ? strcmp(p_cname, p_other) == 0 : p_name == p_other;
+}
+
+static _FORCE_INLINE_ bool _name_equals(const char *p_cname, const String &p_name, const CharType *p_other) {
+
+	if (!p_cname)
+		return p_name == p_other;
+
+	while (*p_cname && CharType((uint8_t)*p_cname) == *p_other) {
+		p_cname++;
+		p_other++;
+	}
+	return CharType((uint8_t)*p_cname) == *p_other;
+}
+
+static _FORCE_INLINE_ bool _name_equals(const char *p_cname, const String &p_name, const String &p_other) {
+
+	return p_cname ? p_other == p_cname : p_name == p_other;
+}
+
+template <class N>
+StringName::_Data *StringName::_find(const _Shard &p_shard, uint32_t p_hash, const N &p_name) {
+
+	_Data *d = p_shard.table[p_hash & p_shard.mask];
+
+	while (d) {
+
+		// compare hash first
+		if (d->hash == p_hash && _name_equals(d->cname, d->name, p_name))
+			return d;
+		d = d->next;
+	}
+
+	return NULL;
+}
+
+void StringName::_grow(_Shard &p_shard) {
+
+	uint32_t new_mask = (p_shard.mask << 1) | 1;
+	_Data **new_table = memnew_arr(_Data *, new_mask + 1);
+	for (uint32_t i = 0; i <= new_mask; i++) {
+		new_table[i] = NULL;
+	}
+
+	for (uint32_t i = 0; i <= p_shard.mask; i++) {
+
+		_Data *d = p_shard.table[i];
+		while (d) {
+
+			_Data *next = d->next;
+			uint32_t idx = d->hash & new_mask;
+			d->prev = NULL;
+			d->next = new_table[idx];
+			if (new_table[idx])
+				new_table[idx]->prev = d;
+			new_table[idx] = d;
+			d = next;
+		}
+	}
+
+	memdelete_arr(p_shard.table);
+	p_shard.table = new_table;
+	p_shard.mask = new_mask;
+}
+
+// Names that already exist are found under the read lock, so threads only
+// wait for each other when they add or remove names in the same shard.
+// A name whose refcount already dropped to zero is about to be removed by
+// another thread, so a new one is added in front of it.
+
+template <class N>
+StringName::_Data *StringName::_intern(uint32_t p_hash, const N &p_name, const char *p_cname) {
+
+	_Shard &shard = _get_shard(p_hash);
+
+	{
+		RWLockRead r(shard.lock);
+
+		_Data *d = _find(shard, p_hash, p_name);
+		if (d && d->refcount.ref())
+			return d;
+	}
+
+	RWLockWrite w(shard.lock);
+
+	_Data *d = _find(shard, p_hash, p_name);
+	if (d && d->refcount.ref())
+		return d; // added while waiting for the lock
+
+	d = memnew(_Data);
+	if (p_cname) {
+		d->cname = p_cname;
+	} else {
+		d->name = p_name;
+	}
+	d->refcount.init();
+	d->hash = p_hash;
+
+	uint32_t idx = p_hash & shard.mask;
+	d->next = shard.table[idx];
+	d->prev = NULL;
+	if (shard.table[idx])
+		shard.table[idx]->prev = d;
+	shard.table[idx] = d;
+
+	shard.count++;
+	if (shard.count > shard.mask + 1) {
+		_grow(shard);
+	}
+
+	return d;
+}
+
+template <class N>
+StringName StringName::_search(uint32_t p_hash, const N &p_name) {
+
+	_Shard &shard = _get_shard(p_hash);
+	RWLockRead r(shard.lock);
+
+	_Data *d = _find(shard, p_hash, p_name);
+	if (d && d->refcount.ref())
+		return StringName(d);
+
+	return StringName(); //does not exist
 }
 
 void StringName::unref() {
@@ -99,22 +242,24 @@ void StringName::unref() {
 
 	if (_data && _data->refcount.unref()) {
 
-		lock->lock();
+		_Shard &shard = _get_shard(_data->hash);
+		RWLockWrite w(shard.lock);
 
 		if (_data->prev) {
 			_data->prev->next = _data->next;
 		} else {
-			if (_table[_data->idx] != _data) {
+			uint32_t idx = _data->hash & shard.mask;
+			if (shard.table[idx] != _data) {
 				ERR_PRINT("BUG!");
 			}
-			_table[_data->idx] = _data->next;
+			shard.table[idx] = _data->next;
 		}
 
 		if (_data->next) {
 			_data->next->prev = _data->prev;
 		}
+		shard.count--;
 		memdelete(_data);
-		lock->unlock();
 	}
 
 	_data = NULL;
@@ -127,7 +272,7 @@ bool StringName::operator==(const String &p_name) const {
 		return (p_name.length() == 0);
 	}
 
-	return (_data->get_name() == p_name);
+	return _name_equals(_data->cname, _data->name, p_name);
 }
 
 bool StringName::operator==(const char *p_name) const {
@@ -137,7 +282,7 @@ bool StringName::operator==(const char *p_name) const {
 		return (p_name[0] == 0);
 	}
 
-	return (_data->get_name() == p_name);
+	return _name_equals(_data->cname, _data->name, p_name);
 }
 
 bool StringName::operator!=(const String &p_name) const {
@@ -192,44 +337,7 @@ StringName::StringName(const char *p_name) {
 	if (!p_name || p_name[0] == 0)
 		return; //empty, ignore
 
-	lock->lock();
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name)
-			break;
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			lock->unlock();
-			return;
-		} else {
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = NULL;
-	_data->next = _table[idx];
-	_data->prev = NULL;
-	if (_table[idx])
-		_table[idx]->prev = _data;
-	_table[idx] = _data;
-
-	lock->unlock();
+	_data = _intern(String::hash(p_name), p_name, NULL);
 }
 
 StringName::StringName(const StaticCString &p_static_string) {
@@ -240,44 +348,7 @@ StringName::StringName(const StaticCString &p_static_string) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	lock->lock();
-
-	uint32_t hash = String::hash(p_static_string.ptr);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr)
-			break;
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			lock->unlock();
-			return;
-		} else {
-		}
-	}
-
-	_data = memnew(_Data);
-
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = NULL;
-	if (_table[idx])
-		_table[idx]->prev = _data;
-	_table[idx] = _data;
-
-	lock->unlock();
+	_data = _intern(String::hash(p_static_string.ptr), p_static_string.ptr, p_static_string.ptr);
 }
 
 StringName::StringName(const String &p_name) {
@@ -289,43 +360,7 @@ StringName::StringName(const String &p_name) {
 	if (p_name == String())
 		return;
 
-	lock->lock();
-
-	uint32_t hash = p_name.hash();
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-
-		if (_data->hash == hash && _data->get_name() == p_name)
-			break;
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			lock->unlock();
-			return;
-		} else {
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = NULL;
-	_data->next = _table[idx];
-	_data->prev = NULL;
-	if (_table[idx])
-		_table[idx]->prev = _data;
-	_table[idx] = _data;
-
-	lock->unlock();
+	_data = _intern(p_name.hash(), p_name, NULL);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -336,30 +371,7 @@ StringName StringName::search(const char *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	lock->lock();
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name)
-			break;
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		lock->unlock();
-
-		return StringName(_data);
-	}
-
-	lock->unlock();
-	return StringName(); //does not exist
+	return _search(String::hash(p_name), p_name);
 }
 
 StringName StringName::search(const CharType *p_name) {
@@ -370,57 +382,13 @@ StringName StringName::search(const CharType *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	lock->lock();
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name)
-			break;
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		lock->unlock();
-		return StringName(_data);
-	}
-
-	lock->unlock();
-	return StringName(); //does not exist
+	return _search(String::hash(p_name), p_name);
 }
 StringName StringName::search(const String &p_name) {
 
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	lock->lock();
-
-	uint32_t hash = p_name.hash();
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name())
-			break;
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		lock->unlock();
-		return StringName(_data);
-	}
-
-	lock->unlock();
-	return StringName(); //does not exist
+	return _search(p_name.hash(), p_name);
 }
 
 StringName::StringName() {
@@ -32,7 +32,7 @@
 #define STRING_DB_H
 
 #include "hash_map.h"
-#include "os/mutex.h"
+#include "os/rw_lock.h"
 #include "safe_refcount.h"
 #include "ustring.h"
 /**
@@ -49,9 +49,11 @@ class StringName {
 
 	enum {
 
-		STRING_TABLE_BITS = 12,
-		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		// names are spread over shards by the upper bits of their hash,
+		// each with its own lock and a table that grows as needed
+		STRING_TABLE_SHARD_BITS = 6,
+		STRING_TABLE_SHARDS = 1 << STRING_TABLE_SHARD_BITS,
+		STRING_TABLE_MIN_BITS = 6,
 	};
 
 	struct _Data {
@@ -60,7 +62,6 @@ class StringName {
 		String name;
 
 		String get_name() const { return cname ? String(cname) : name; }
-		int idx;
 		uint32_t hash;
 		_Data *prev;
 		_Data *next;
@@ -71,7 +72,27 @@ class StringName {
 		}
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	struct _Shard {
+		RWLock *lock;
+		_Data **table;
+		uint32_t mask;
+		uint32_t count;
+	};
+
+	static _Shard _shards[STRING_TABLE_SHARDS];
+
+	_FORCE_INLINE_ static _Shard &_get_shard(uint32_t p_hash) {
+
+		return _shards[p_hash >> (32 - STRING_TABLE_SHARD_BITS)];
+	}
+
+	template <class N>
+	static _Data *_find(const _Shard &p_shard, uint32_t p_hash, const N &p_name);
+	template <class N>
+	static _Data *_intern(uint32_t p_hash, const N &p_name, const char *p_cname);
+	template <class N>
+	static StringName _search(uint32_t p_hash, const N &p_name);
+	static void _grow(_Shard &p_shard);
 
 	_Data *_data;
 
@@ -85,7 +106,6 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 
-	static Mutex *lock;
 	static void setup();
 	static void cleanup();
 	static bool configured;
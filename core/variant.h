@@ -60,6 +60,7 @@ class Control; // helper
 
 struct PropertyInfo;
 struct MethodInfo;
+struct MethodCallCache;
 
 typedef PoolVector<uint8_t> PoolByteArray;
 typedef PoolVector<int> PoolIntArray;
@@ -117,6 +118,7 @@ public:
 
 private:
 	friend class _VariantCall;
+	friend class VariantInternal;
 	// Variant takes 20 bytes when real_t is float, and 36 if double
 	// it only allocates extra memory for aabb/matrix.
 
@@ -355,7 +357,12 @@ public:
 		Type expected;
 	};
 
-	void call_ptr(const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error);
+	void call_ptr(const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error, MethodCallCache *p_cache = NULL);
+
+	// Resolved builtin method, lets callers skip the method lookup on repeated calls.
+	typedef const void *BuiltinMethod;
+	static BuiltinMethod get_builtin_method(Variant::Type p_type, const StringName &p_method);
+	bool call_builtin(BuiltinMethod p_method, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error);
 	Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, CallError &r_error);
 	Variant call(const StringName &p_method, const Variant &p_arg1 = Variant(), const Variant &p_arg2 = Variant(), const Variant &p_arg3 = Variant(), const Variant &p_arg4 = Variant(), const Variant &p_arg5 = Variant());
 
@@ -48,6 +48,7 @@ struct _VariantCall {
 
 	struct FuncData {
 
+		Variant::Type type;
 		int arg_count;
 		Vector<Variant> default_args;
 		Vector<Variant::Type> arg_types;
@@ -153,6 +154,7 @@ struct _VariantCall {
 		funcdata.func = p_func;
 		funcdata.default_args = p_defaultarg;
 		funcdata._const = p_const;
+		funcdata.type = p_type;
 #ifdef DEBUG_ENABLED
 		funcdata.return_type = p_return;
 		funcdata.returns = p_has_return;
@@ -992,7 +994,7 @@ Variant Variant::call(const StringName &p_method, const Variant **p_args, int p_
 	return ret;
 }
 
-void Variant::call_ptr(const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error) {
+void Variant::call_ptr(const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error, MethodCallCache *p_cache) {
 	Variant ret;
 
 	if (type == Variant::OBJECT) {
@@ -1012,7 +1014,11 @@ void Variant::call_ptr(const StringName &p_method, const Variant **p_args, int p
 		}
 
 #endif
-		ret = _get_obj().obj->call(p_method, p_args, p_argcount, r_error);
+		if (p_cache) {
+			ret = _get_obj().obj->call_cached(p_cache, p_method, p_args, p_argcount, r_error);
+		} else {
+			ret = _get_obj().obj->call(p_method, p_args, p_argcount, r_error);
+		}
 
 		//else if (type==Variant::METHOD) {
 
@@ -1035,6 +1041,33 @@ void Variant::call_ptr(const StringName &p_method, const Variant **p_args, int p
 		*r_ret = ret;
 }
 
+Variant::BuiltinMethod Variant::get_builtin_method(Variant::Type p_type, const StringName &p_method) {
+
+	ERR_FAIL_INDEX_V(p_type, VARIANT_MAX, NULL);
+
+	Map<StringName, _VariantCall::FuncData>::Element *E = _VariantCall::type_funcs[p_type].functions.find(p_method);
+	if (!E)
+		return NULL;
+
+	return &E->get();
+}
+
+bool Variant::call_builtin(BuiltinMethod p_method, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error) {
+
+	_VariantCall::FuncData *funcdata = (_VariantCall::FuncData *)p_method;
+	if (!funcdata || funcdata->type != type)
+		return false; //not resolved for this type, caller must look it up again
+
+	Variant ret;
+	r_error.error = Variant::CallError::CALL_OK;
+	funcdata->call(ret, *this, p_args, p_argcount, r_error);
+
+	if (r_error.error == Variant::CallError::CALL_OK && r_ret)
+		*r_ret = ret;
+
+	return true;
+}
+
 #define VCALL(m_type, m_method) _VariantCall::_call_##m_type##_##m_method
 
 Variant Variant::construct(const Variant::Type p_type, const Variant **p_args, int p_argcount, CallError &r_error, bool p_strict) {
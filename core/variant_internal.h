@@ -0,0 +1,95 @@
+/*************************************************************************/
+/*  variant_internal.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef VARIANT_INTERNAL_H
+#define VARIANT_INTERNAL_H
+
+#include "variant.h"
+
+// Raw access to the storage of a Variant, for interpreters that already
+// checked the type and want to skip the conversion operators.
+// Callers must guarantee the Variant holds the expected type.
+
+class VariantInternal {
+public:
+	_FORCE_INLINE_ static bool get_bool(const Variant *v) { return v->_data._bool; }
+	_FORCE_INLINE_ static int64_t get_int(const Variant *v) { return v->_data._int; }
+	_FORCE_INLINE_ static double get_real(const Variant *v) { return v->_data._real; }
+	_FORCE_INLINE_ static const Vector2 *get_vector2(const Variant *v) { return reinterpret_cast<const Vector2 *>(v->_data._mem); }
+	_FORCE_INLINE_ static const Vector3 *get_vector3(const Variant *v) { return reinterpret_cast<const Vector3 *>(v->_data._mem); }
+
+	// Numeric value of an INT or REAL Variant.
+	_FORCE_INLINE_ static double get_number(const Variant *v) { return v->type == Variant::INT ? double(v->_data._int) : v->_data._real; }
+
+	// Setters reuse the destination storage when it already holds the same type.
+
+	_FORCE_INLINE_ static void set_bool(Variant *v, bool p_value) {
+		if (v->type != Variant::BOOL) {
+			*v = p_value;
+			return;
+		}
+		v->_data._bool = p_value;
+	}
+
+	_FORCE_INLINE_ static void set_int(Variant *v, int64_t p_value) {
+		if (v->type != Variant::INT) {
+			*v = p_value;
+			return;
+		}
+		v->_data._int = p_value;
+	}
+
+	_FORCE_INLINE_ static void set_real(Variant *v, double p_value) {
+		if (v->type != Variant::REAL) {
+			*v = p_value;
+			return;
+		}
+		v->_data._real = p_value;
+	}
+
+	_FORCE_INLINE_ static void set_vector2(Variant *v, const Vector2 &p_value) {
+		if (v->type != Variant::VECTOR2) {
+			*v = p_value;
+			return;
+		}
+		*reinterpret_cast<Vector2 *>(v->_data._mem) = p_value;
+	}
+
+	_FORCE_INLINE_ static void set_vector3(Variant *v, const Vector3 &p_value) {
+		if (v->type != Variant::VECTOR3) {
+			*v = p_value;
+			return;
+		}
+		*reinterpret_cast<Vector3 *>(v->_data._mem) = p_value;
+	}
+};
+
+#endif // VARIANT_INTERNAL_H
@@ -202,9 +202,31 @@ Error ImageLoaderPNG::_load_image(void *rf_up, png_rw_ptr p_func, Ref<Image> p_i
 	return OK;
 }
 
+struct PNGReadStatus {
+
+	uint32_t offset;
+	uint32_t size;
+	const unsigned char *image;
+};
+
+static void user_read_data(png_structp png_ptr, png_bytep data, png_size_t p_length);
+
 Error ImageLoaderPNG::load_image(Ref<Image> p_image, FileAccess *f, bool p_force_linear, float p_scale) {
 
-	Error err = _load_image(f, _read_png_data, p_image);
+	Error err;
+
+	int len = f->get_len() - f->get_position();
+	const uint8_t *src = f->get_buffer_ptr(len);
+	if (src) {
+		//decode in place
+		PNGReadStatus prs;
+		prs.image = src;
+		prs.offset = 0;
+		prs.size = len;
+		err = _load_image(&prs, user_read_data, p_image);
+	} else {
+		err = _load_image(f, _read_png_data, p_image);
+	}
 	f->close();
 
 	return err;
@@ -215,13 +237,6 @@ void ImageLoaderPNG::get_recognized_extensions(List<String> *p_extensions) const
 	p_extensions->push_back("png");
 }
 
-struct PNGReadStatus {
-
-	uint32_t offset;
-	uint32_t size;
-	const unsigned char *image;
-};
-
 static void user_read_data(png_structp png_ptr, png_bytep data, png_size_t p_length) {
 
 	PNGReadStatus *rstatus;
@@ -45,6 +45,7 @@
 #include "file_access_unix.h"
 #include "packet_peer_udp_posix.h"
 #include "stream_peer_tcp_posix.h"
+#include "tcp_poller_posix.h"
 #include "tcp_server_posix.h"
 
 #ifdef __APPLE__
@@ -59,11 +60,14 @@
 #include <assert.h>
 #include <dlfcn.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <poll.h>
 #include <signal.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -111,6 +115,7 @@ void OS_Unix::initialize_core() {
 #ifndef NO_NETWORK
 	TCPServerPosix::make_default();
 	StreamPeerTCPPosix::make_default();
+	TCPPollerPosix::make_default();
 	PacketPeerUDPPosix::make_default();
 	IP_Unix::make_default();
 #endif
@@ -392,6 +397,34 @@ Error OS_Unix::get_dynamic_library_symbol_handle(void *p_library_handle, const S
 	return OK;
 }
 
+const uint8_t *OS_Unix::map_file(const String &p_path, size_t &r_size) {
+
+	int fd = open(p_path.utf8().get_data(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+		close(fd);
+		return NULL;
+	}
+
+	//the mapping keeps the file referenced, the descriptor is not needed
+	void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return NULL;
+
+	r_size = st.st_size;
+	return (const uint8_t *)data;
+}
+
+void OS_Unix::unmap_file(const uint8_t *p_data, size_t p_size) {
+
+	munmap((void *)p_data, p_size);
+}
+
 Error OS_Unix::set_cwd(const String &p_cwd) {
 
 	if (chdir(p_cwd.utf8().get_data()) != 0)
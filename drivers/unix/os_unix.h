@@ -76,6 +76,9 @@ public:
 	virtual Error close_dynamic_library(void *p_library_handle);
 	virtual Error get_dynamic_library_symbol_handle(void *p_library_handle, const String p_name, void *&p_symbol_handle, bool p_optional = false);
 
+	virtual const uint8_t *map_file(const String &p_path, size_t &r_size);
+	virtual void unmap_file(const uint8_t *p_data, size_t p_size);
+
 	virtual Error set_cwd(const String &p_cwd);
 
 	virtual String get_name();
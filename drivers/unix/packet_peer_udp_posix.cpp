@@ -164,6 +164,7 @@ void PacketPeerUDPPosix::close() {
 		::close(sockfd);
 	sockfd = -1;
 	sock_type = IP::TYPE_NONE;
+	sock_blocking = true; //new sockets start blocking
 	rb.resize(16);
 	queue_count = 0;
 }
@@ -184,7 +185,21 @@ Error PacketPeerUDPPosix::_poll(bool p_block) {
 	struct sockaddr_storage from = { 0 };
 	socklen_t len = sizeof(struct sockaddr_storage);
 	int ret;
-	while ((ret = recvfrom(sockfd, recv_buffer, MIN((int)sizeof(recv_buffer), MAX(rb.space_left() - 24, 0)), 0, (struct sockaddr *)&from, &len)) > 0) {
+	while (true) {
+
+		int space = rb.space_left() - 24;
+		if (space < (int)sizeof(recv_buffer)) {
+			//leave the packet in the socket until there is room for it, reading it
+			//into a smaller buffer would truncate it (or close the socket if empty)
+			ret = recvfrom(sockfd, recv_buffer, sizeof(recv_buffer), MSG_PEEK, (struct sockaddr *)&from, &len);
+			if (ret < 0 || ret > space)
+				break;
+			len = sizeof(struct sockaddr_storage);
+		}
+
+		ret = recvfrom(sockfd, recv_buffer, sizeof(recv_buffer), 0, (struct sockaddr *)&from, &len);
+		if (ret <= 0)
+			break;
 
 		uint32_t port = 0;
 
@@ -222,7 +237,7 @@ Error PacketPeerUDPPosix::_poll(bool p_block) {
 	};
 
 	// TODO: Should ECONNRESET be handled here?
-	if (ret == 0 || (ret == -1 && errno != EAGAIN)) {
+	if (ret == -1 && errno != EAGAIN) {
 		close();
 		return FAILED;
 	};
@@ -123,6 +123,7 @@ void StreamPeerTCPPosix::set_socket(int p_sockfd, IP_Address p_host, int p_port,
 
 	sock_type = p_sock_type;
 	sockfd = p_sockfd;
+	socket_version++;
 #ifndef NO_FCNTL
 	fcntl(sockfd, F_SETFL, O_NONBLOCK);
 #else
@@ -142,6 +143,7 @@ Error StreamPeerTCPPosix::connect_to_host(const IP_Address &p_host, uint16_t p_p
 
 	sock_type = p_host.is_ipv4() ? IP::TYPE_IPV4 : IP::TYPE_IPV6;
 	sockfd = _socket_create(sock_type, SOCK_STREAM, IPPROTO_TCP);
+	socket_version++;
 	if (sockfd == -1) {
 		ERR_PRINT("Socket creation failed!");
 		disconnect_from_host();
@@ -286,10 +288,7 @@ Error StreamPeerTCPPosix::read(uint8_t *p_buffer, int p_bytes, int &r_received,
 
 		} else if (read == 0) {
 
-			sockfd = -1;
-			status = STATUS_NONE;
-			peer_port = 0;
-			peer_host = IP_Address();
+			disconnect_from_host();
 			return ERR_FILE_EOF;
 
 		} else {
@@ -389,6 +388,7 @@ StreamPeerTCPPosix::StreamPeerTCPPosix() {
 
 	sock_type = IP::TYPE_NONE;
 	sockfd = -1;
+	socket_version = 0;
 	status = STATUS_NONE;
 	peer_port = 0;
 };
@@ -39,11 +39,14 @@
 
 class StreamPeerTCPPosix : public StreamPeerTCP {
 
+	friend class TCPPollerPosix;
+
 protected:
 	mutable Status status;
 
 	IP::Type sock_type;
 	int sockfd;
+	uint32_t socket_version; //bumped for every new socket, descriptors get reused
 
 	Error _block(int p_sockfd, bool p_read, bool p_write) const;
 
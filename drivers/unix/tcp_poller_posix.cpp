@@ -0,0 +1,359 @@
+/*************************************************************************/
+/*  tcp_poller_posix.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "tcp_poller_posix.h"
+
+#ifdef UNIX_ENABLED
+
+#include "stream_peer_tcp_posix.h"
+#include "tcp_server_posix.h"
+
+#include <errno.h>
+#include <unistd.h>
+
+TCP_Poller *TCPPollerPosix::_create() {
+
+	return memnew(TCPPollerPosix);
+}
+
+void TCPPollerPosix::make_default() {
+
+	TCP_Poller::_create = TCPPollerPosix::_create;
+}
+
+int TCPPollerPosix::_get_socket(const Entry *p_entry) const {
+
+	return p_entry->peer ? p_entry->peer->sockfd : p_entry->server->listen_sockfd;
+}
+
+uint32_t TCPPollerPosix::_get_socket_version(const Entry *p_entry) const {
+
+	return p_entry->peer ? p_entry->peer->socket_version : p_entry->server->socket_version;
+}
+
+bool TCPPollerPosix::_is_socket_changed(const Entry *p_entry) const {
+
+	int fd = _get_socket(p_entry);
+	return fd != p_entry->fd || (fd != -1 && _get_socket_version(p_entry) != p_entry->socket_version);
+}
+
+Error TCPPollerPosix::_watch(Entry *p_entry, bool p_modify) {
+
+	if (!p_modify) {
+		Map<int, Entry *>::Element *E = watched.find(p_entry->fd);
+		if (E) {
+			//the socket it was watched for got closed, and the descriptor reused
+			E->get()->fd = -1;
+			watched.erase(E);
+		}
+	}
+
+#ifdef TCP_POLLER_EPOLL
+	if (epoll_fd != -1) {
+
+		struct epoll_event event;
+		event.events = EPOLLIN | EPOLLRDHUP;
+		if (p_entry->connecting)
+			event.events |= EPOLLOUT;
+		event.data.ptr = p_entry;
+
+		int ret = epoll_ctl(epoll_fd, p_modify ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, p_entry->fd, &event);
+		if (ret == -1 && !p_modify && errno == EEXIST) {
+			ret = epoll_ctl(epoll_fd, EPOLL_CTL_MOD, p_entry->fd, &event);
+		}
+		ERR_FAIL_COND_V(ret == -1, FAILED);
+	}
+#endif
+
+	watched[p_entry->fd] = p_entry;
+	pollfds_dirty = true;
+
+	return OK;
+}
+
+void TCPPollerPosix::_unwatch(Entry *p_entry) {
+
+	Map<int, Entry *>::Element *E = watched.find(p_entry->fd);
+	if (E && E->get() == p_entry) {
+#ifdef TCP_POLLER_EPOLL
+		if (epoll_fd != -1) {
+			//fails harmlessly if the socket was already closed
+			epoll_ctl(epoll_fd, EPOLL_CTL_DEL, p_entry->fd, NULL);
+		}
+#endif
+		watched.erase(E);
+		pollfds_dirty = true;
+	}
+
+	p_entry->fd = -1;
+}
+
+void TCPPollerPosix::_process(Entry *p_entry, bool p_writable) {
+
+	if (p_entry->fd == -1 || p_entry->reported)
+		return; //taken over by another entry, or already reported during this wait
+
+	if (_is_socket_changed(p_entry)) {
+		//closed or reconnected since it was added, let the owner find out
+		_unwatch(p_entry);
+	} else if (p_entry->connecting && p_writable) {
+		//connection attempt finished, only reads matter from now on
+		p_entry->connecting = false;
+		_watch(p_entry, true);
+	}
+
+	p_entry->reported = true;
+	ready.push_back(p_entry->object);
+}
+
+void TCPPollerPosix::_check_sockets() {
+
+	//closing a socket silently drops it from epoll, and a reconnected peer has a
+	//new descriptor nobody watches, so neither would ever produce an event
+	for (Map<const Reference *, Entry *>::Element *E = entries.front(); E; E = E->next()) {
+
+		Entry *entry = E->get();
+		entry->reported = false;
+
+		if (!_is_socket_changed(entry))
+			continue;
+
+		if (entry->fd != -1) {
+			_unwatch(entry);
+		}
+
+		int fd = _get_socket(entry);
+		if (fd != -1) {
+			//reconnected, keep watching the new socket
+			entry->fd = fd;
+			entry->socket_version = _get_socket_version(entry);
+			entry->connecting = entry->peer && entry->peer->status == StreamPeerTCP::STATUS_CONNECTING;
+			if (_watch(entry, false) != OK) {
+				entry->fd = -1;
+			}
+		}
+
+		entry->reported = true;
+		ready.push_back(entry->object);
+	}
+}
+
+Error TCPPollerPosix::_add(const Ref<Reference> &p_object, StreamPeerTCPPosix *p_peer, TCPServerPosix *p_server) {
+
+	Entry *entry;
+
+	Map<const Reference *, Entry *>::Element *E = entries.find(p_object.ptr());
+	if (E) {
+		//added again, maybe after reconnecting
+		entry = E->get();
+		_unwatch(entry);
+	} else {
+		entry = memnew(Entry);
+		entry->object = p_object;
+		entry->peer = p_peer;
+		entry->server = p_server;
+		entry->reported = false;
+		entries[p_object.ptr()] = entry;
+	}
+
+	entry->fd = _get_socket(entry);
+	entry->socket_version = _get_socket_version(entry);
+	entry->connecting = p_peer && p_peer->status == StreamPeerTCP::STATUS_CONNECTING;
+
+	if (entry->fd == -1) {
+		entries.erase(p_object.ptr());
+		memdelete(entry);
+		ERR_EXPLAIN("Only connected peers and listening servers can be polled");
+		ERR_FAIL_V(ERR_UNCONFIGURED);
+	}
+
+	Error err = _watch(entry, false);
+	if (err != OK) {
+		entries.erase(p_object.ptr());
+		memdelete(entry);
+	}
+
+	return err;
+}
+
+Error TCPPollerPosix::add_peer(const Ref<StreamPeerTCP> &p_peer) {
+
+	Ref<StreamPeerTCP> ref = p_peer;
+	StreamPeerTCPPosix *peer = Object::cast_to<StreamPeerTCPPosix>(ref.ptr());
+	ERR_FAIL_COND_V(!peer, ERR_INVALID_PARAMETER);
+
+	return _add(ref, peer, NULL);
+}
+
+Error TCPPollerPosix::add_server(const Ref<TCP_Server> &p_server) {
+
+	Ref<TCP_Server> ref = p_server;
+	TCPServerPosix *server = Object::cast_to<TCPServerPosix>(ref.ptr());
+	ERR_FAIL_COND_V(!server, ERR_INVALID_PARAMETER);
+
+	return _add(ref, NULL, server);
+}
+
+void TCPPollerPosix::remove(const Ref<Reference> &p_object) {
+
+	Map<const Reference *, Entry *>::Element *E = entries.find(p_object.ptr());
+	ERR_FAIL_COND(!E);
+
+	_unwatch(E->get());
+	memdelete(E->get());
+	entries.erase(E);
+}
+
+bool TCPPollerPosix::has(const Ref<Reference> &p_object) const {
+
+	return entries.has(p_object.ptr());
+}
+
+int TCPPollerPosix::get_count() const {
+
+	return entries.size();
+}
+
+void TCPPollerPosix::clear() {
+
+	for (Map<const Reference *, Entry *>::Element *E = entries.front(); E; E = E->next()) {
+		_unwatch(E->get());
+		memdelete(E->get());
+	}
+
+	entries.clear();
+	ready.clear();
+}
+
+int TCPPollerPosix::wait(int p_timeout_msec) {
+
+	ready.clear();
+
+	_check_sockets();
+	if (ready.size()) {
+		p_timeout_msec = 0; //something to report already, only collect what else is pending
+	}
+
+#ifdef TCP_POLLER_EPOLL
+	if (epoll_fd != -1) {
+
+		events.resize(MAX(watched.size(), 1));
+
+		int ret = epoll_wait(epoll_fd, events.ptrw(), events.size(), p_timeout_msec);
+		if (ret == -1) {
+			ERR_FAIL_COND_V(errno != EINTR, 0);
+			return 0;
+		}
+
+		const struct epoll_event *r = events.ptr();
+		for (int i = 0; i < ret; i++) {
+			_process((Entry *)r[i].data.ptr, r[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP));
+		}
+
+		return ready.size();
+	}
+#endif
+
+	if (pollfds_dirty) {
+
+		pollfds.resize(watched.size());
+		pollfd_entries.resize(watched.size());
+
+		int idx = 0;
+		for (Map<int, Entry *>::Element *E = watched.front(); E; E = E->next()) {
+			struct pollfd &pfd = pollfds[idx];
+			pfd.fd = E->key();
+			pfd.events = POLLIN;
+			if (E->get()->connecting)
+				pfd.events |= POLLOUT;
+			pfd.revents = 0;
+			pollfd_entries[idx] = E->get();
+			idx++;
+		}
+
+		pollfds_dirty = false;
+	}
+
+	int ret = poll(pollfds.ptrw(), pollfds.size(), p_timeout_msec);
+	if (ret == -1) {
+		ERR_FAIL_COND_V(errno != EINTR, 0);
+		return 0;
+	}
+
+	//entries are looked up again, processing one may drop another
+	struct pollfd *r = pollfds.ptrw();
+	for (int i = 0; i < pollfds.size() && ret > 0; i++) {
+
+		if (!r[i].revents)
+			continue;
+		ret--;
+
+		Map<int, Entry *>::Element *E = watched.find(r[i].fd);
+		if (E && E->get() == pollfd_entries[i]) {
+			_process(E->get(), r[i].revents & (POLLOUT | POLLERR | POLLHUP));
+		}
+	}
+
+	return ready.size();
+}
+
+int TCPPollerPosix::get_ready_count() const {
+
+	return ready.size();
+}
+
+Ref<Reference> TCPPollerPosix::get_ready(int p_index) const {
+
+	ERR_FAIL_INDEX_V(p_index, ready.size(), Ref<Reference>());
+	return ready[p_index];
+}
+
+TCPPollerPosix::TCPPollerPosix() {
+
+	pollfds_dirty = false;
+#ifdef TCP_POLLER_EPOLL
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd == -1) {
+		WARN_PRINT("epoll is not available, falling back to poll()");
+	}
+#endif
+}
+
+TCPPollerPosix::~TCPPollerPosix() {
+
+	clear();
+#ifdef TCP_POLLER_EPOLL
+	if (epoll_fd != -1) {
+		close(epoll_fd);
+	}
+#endif
+}
+
+#endif // UNIX_ENABLED
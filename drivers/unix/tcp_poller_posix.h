@@ -0,0 +1,105 @@
+/*************************************************************************/
+/*  tcp_poller_posix.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TCP_POLLER_POSIX_H
+#define TCP_POLLER_POSIX_H
+
+#ifdef UNIX_ENABLED
+#include "core/io/tcp_poller.h"
+#include "core/map.h"
+
+#include <poll.h>
+
+#if defined(__linux__) && !defined(NO_EPOLL)
+#define TCP_POLLER_EPOLL
+#include <sys/epoll.h>
+#endif
+
+class StreamPeerTCPPosix;
+class TCPServerPosix;
+
+class TCPPollerPosix : public TCP_Poller {
+
+	struct Entry {
+
+		Ref<Reference> object;
+		StreamPeerTCPPosix *peer;
+		TCPServerPosix *server;
+		int fd;
+		uint32_t socket_version;
+		bool connecting; //also waits for the socket to be writable
+		bool reported; //already in ready during this wait
+	};
+
+	Map<const Reference *, Entry *> entries;
+	Map<int, Entry *> watched;
+	Vector<Ref<Reference> > ready;
+
+#ifdef TCP_POLLER_EPOLL
+	int epoll_fd;
+	Vector<struct epoll_event> events;
+#endif
+
+	//poll() fallback, rebuilt when the watched sockets change
+	bool pollfds_dirty;
+	Vector<struct pollfd> pollfds;
+	Vector<Entry *> pollfd_entries;
+
+	int _get_socket(const Entry *p_entry) const;
+	uint32_t _get_socket_version(const Entry *p_entry) const;
+	bool _is_socket_changed(const Entry *p_entry) const;
+	Error _watch(Entry *p_entry, bool p_modify);
+	void _unwatch(Entry *p_entry);
+	void _process(Entry *p_entry, bool p_writable);
+	void _check_sockets();
+	Error _add(const Ref<Reference> &p_object, StreamPeerTCPPosix *p_peer, TCPServerPosix *p_server);
+
+	static TCP_Poller *_create();
+
+public:
+	virtual Error add_peer(const Ref<StreamPeerTCP> &p_peer);
+	virtual Error add_server(const Ref<TCP_Server> &p_server);
+	virtual void remove(const Ref<Reference> &p_object);
+	virtual bool has(const Ref<Reference> &p_object) const;
+	virtual int get_count() const;
+	virtual void clear();
+
+	virtual int wait(int p_timeout_msec = 0);
+	virtual int get_ready_count() const;
+	virtual Ref<Reference> get_ready(int p_index) const;
+
+	static void make_default();
+
+	TCPPollerPosix();
+	~TCPPollerPosix();
+};
+
+#endif // UNIX_ENABLED
+#endif // TCP_POLLER_POSIX_H
@@ -121,6 +121,7 @@ Error TCPServerPosix::listen(uint16_t p_port, const IP_Address &p_bind_address)
 	};
 
 	listen_sockfd = sockfd;
+	socket_version++;
 
 	return OK;
 };
@@ -188,6 +189,7 @@ void TCPServerPosix::stop() {
 TCPServerPosix::TCPServerPosix() {
 
 	listen_sockfd = -1;
+	socket_version = 0;
 	sock_type = IP::TYPE_NONE;
 };
 
@@ -36,7 +36,10 @@
 
 class TCPServerPosix : public TCP_Server {
 
+	friend class TCPPollerPosix;
+
 	int listen_sockfd;
+	uint32_t socket_version; //bumped for every new socket, descriptors get reused
 	IP::Type sock_type;
 
 	static TCP_Server *_create();
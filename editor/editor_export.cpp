@@ -34,7 +34,10 @@
 #include "editor/plugins/script_editor_plugin.h"
 #include "editor_node.h"
 #include "editor_settings.h"
+#include "io/compression.h"
 #include "io/config_file.h"
+#include "io/file_access_compressed.h"
+#include "io/file_access_pack.h"
 #include "io/resource_loader.h"
 #include "io/resource_saver.h"
 #include "io/zip_io.h"
@@ -306,6 +309,121 @@ Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_pa
 	return OK;
 }
 
+Error EditorExportPlatform::_compress_pack_files(PackData &p_pack, const String &p_from_path, const String &p_to_path, Vector<uint8_t> &r_dictionary) {
+
+	int level = GLOBAL_GET("editor/export_compression_level");
+	int dictionary_size = GLOBAL_GET("editor/export_compression_dictionary_size");
+
+	FileAccess *src = FileAccess::open(p_from_path, FileAccess::READ);
+	ERR_FAIL_COND_V(!src, ERR_CANT_OPEN);
+
+	//only binary resources are compressed, they are loaded through FileAccessCompressed
+	Vector<bool> compress;
+	compress.resize(p_pack.file_ofs.size());
+	uint64_t total = 0;
+
+	for (int i = 0; i < p_pack.file_ofs.size(); i++) {
+
+		uint8_t header[4] = { 0, 0, 0, 0 };
+		src->seek(p_pack.file_ofs[i].ofs);
+		src->get_buffer(header, MIN(p_pack.file_ofs[i].size, uint64_t(4)));
+		compress[i] = header[0] == 'R' && header[1] == 'S' && header[2] == 'R' && header[3] == 'C';
+		if (compress[i])
+			total += p_pack.file_ofs[i].size;
+	}
+
+	uint32_t dictionary_id = 0;
+
+	if (dictionary_size > 0 && total > 0) {
+
+		p_pack.ep->step(TTR("Training compression dictionary"), 101, false);
+
+		//train on an even spread of files, about a hundred times the dictionary size
+		int every = 1 + total / (uint64_t(dictionary_size) * 100);
+		Vector<Vector<uint8_t> > samples;
+
+		for (int i = 0, found = 0; i < p_pack.file_ofs.size(); i++) {
+
+			if (!compress[i] || (found++ % every) != 0)
+				continue;
+
+			Vector<uint8_t> sample;
+			sample.resize(p_pack.file_ofs[i].size);
+			src->seek(p_pack.file_ofs[i].ofs);
+			src->get_buffer(sample.ptrw(), sample.size());
+			samples.push_back(sample);
+		}
+
+		r_dictionary = Compression::train_dictionary(samples, dictionary_size);
+		if (r_dictionary.size() >= 8) {
+			dictionary_id = Compression::add_dictionary(r_dictionary);
+		}
+		if (!dictionary_id) {
+			r_dictionary.clear(); //compress without it
+		}
+	}
+
+	FileAccess *dst = FileAccess::open(p_to_path, FileAccess::WRITE);
+	if (!dst) {
+		memdelete(src);
+		ERR_FAIL_V(ERR_CANT_CREATE);
+	}
+
+	String res_path = EditorSettings::get_singleton()->get_cache_dir().plus_file("packtmp_res");
+
+	for (int i = 0; i < p_pack.file_ofs.size(); i++) {
+
+		SavedData &sd = p_pack.file_ofs[i];
+
+		Vector<uint8_t> data;
+		data.resize(sd.size);
+		src->seek(sd.ofs);
+		src->get_buffer(data.ptrw(), data.size());
+
+		if (compress[i]) {
+
+			FileAccessCompressed *fac = memnew(FileAccessCompressed);
+			fac->configure("RSCC", Compression::MODE_ZSTD, 4096, level, dictionary_id);
+			if (fac->_open(res_path, FileAccess::WRITE) == OK) {
+				fac->store_buffer(data.ptr(), data.size()); //whole, the offsets in the file count the RSRC header
+				fac->close();
+
+				Vector<uint8_t> compressed = FileAccess::get_file_as_array(res_path);
+				if (compressed.size() && compressed.size() < data.size()) {
+					data = compressed;
+				}
+			}
+			memdelete(fac);
+
+			MD5_CTX ctx;
+			MD5Init(&ctx);
+			MD5Update(&ctx, (unsigned char *)data.ptr(), data.size());
+			MD5Final(&ctx);
+			for (int j = 0; j < 16; j++) {
+				sd.md5[j] = ctx.digest[j];
+			}
+		}
+
+		sd.ofs = dst->get_position();
+		sd.size = data.size();
+
+		dst->store_buffer(data.ptr(), data.size());
+		int pad = _get_pad(PCK_PADDING, sd.size);
+		for (int j = 0; j < pad; j++) {
+			dst->store_8(0);
+		}
+	}
+
+	memdelete(src);
+	memdelete(dst);
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(res_path);
+	memdelete(da);
+
+	return OK;
+}
+
 Error EditorExportPlatform::_save_zip_file(void *p_userdata, const String &p_path, const Vector<uint8_t> &p_data, int p_file, int p_total) {
 
 	String path = p_path.replace_first("res://", "");
@@ -810,6 +928,21 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 	if (err)
 		return err;
 
+	Vector<uint8_t> dictionary;
+
+	if (GLOBAL_GET("editor/compress_binary_resources_on_export")) {
+
+		String compressed_path = EditorSettings::get_singleton()->get_cache_dir().plus_file("packtmp_compressed");
+		err = _compress_pack_files(pd, tmppath, compressed_path, dictionary);
+		if (err)
+			return err;
+
+		DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+		da->remove(tmppath);
+		memdelete(da);
+		tmppath = compressed_path;
+	}
+
 	pd.file_ofs.sort(); //do sort, so we can do binary search later
 
 	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE);
@@ -841,11 +974,21 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 
 	size_t header_padding = _get_pad(PCK_PADDING, header_size);
 
+	Vector<PackedData::IndexEntry> index;
+	index.resize(pd.file_ofs.size());
+
 	for (int i = 0; i < pd.file_ofs.size(); i++) {
 
 		uint32_t string_len = pd.file_ofs[i].path_utf8.length();
 		uint32_t pad = _get_pad(4, string_len);
-		;
+
+		PackedData::IndexEntry &e = index[i];
+		e.path = String::utf8(pd.file_ofs[i].path_utf8.get_data());
+		e.offset = pd.file_ofs[i].ofs + header_padding + header_size;
+		e.size = pd.file_ofs[i].size;
+		copymem(e.md5, pd.file_ofs[i].md5.ptr(), 16);
+		e.path_offset = f->get_position();
+
 		f->store_32(string_len + pad);
 		f->store_buffer((const uint8_t *)pd.file_ofs[i].path_utf8.get_data(), string_len);
 		for (uint32_t j = 0; j < pad; j++) {
@@ -882,6 +1025,11 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 
 	memdelete(ftmp);
 
+	if (dictionary.size()) {
+		PackedData::store_dictionary(f, 0, dictionary);
+	}
+	PackedData::store_index(f, 0, index);
+
 	f->store_32(0x43504447); //GDPK
 	memdelete(f);
 
@@ -1207,6 +1355,12 @@ EditorExport::EditorExport() {
 	save_timer->connect("timeout", this, "_save");
 	block_save = false;
 
+	GLOBAL_DEF("editor/compress_binary_resources_on_export", false);
+	GLOBAL_DEF("editor/export_compression_level", 19);
+	ProjectSettings::get_singleton()->set_custom_property_info("editor/export_compression_level", PropertyInfo(Variant::INT, "editor/export_compression_level", PROPERTY_HINT_RANGE, "1,22,1"));
+	GLOBAL_DEF("editor/export_compression_dictionary_size", 112640); // 0 to compress without one
+	ProjectSettings::get_singleton()->set_custom_property_info("editor/export_compression_dictionary_size", PropertyInfo(Variant::INT, "editor/export_compression_dictionary_size", PROPERTY_HINT_RANGE, "0,1048576,1024"));
+
 	singleton = this;
 }
 
@@ -1266,7 +1266,7 @@ void EditorNode::_dialog_action(String p_file) {
 		case RESOURCE_SAVE:
 		case RESOURCE_SAVE_AS: {
 
-			uint32_t current = editor_history.get_current();
+			ObjectID current = editor_history.get_current();
 			Object *current_obj = current > 0 ? ObjectDB::get_instance(current) : NULL;
 
 			ERR_FAIL_COND(!Object::cast_to<Resource>(current_obj))
@@ -1354,7 +1354,7 @@ void EditorNode::push_item(Object *p_object, const String &p_property) {
 		return;
 	}
 
-	uint32_t id = p_object->get_instance_id();
+	ObjectID id = p_object->get_instance_id();
 	if (id != editor_history.get_current()) {
 
 		if (p_property == "")
@@ -1497,7 +1497,7 @@ void EditorNode::_property_editable_warning_pressed() {
 
 void EditorNode::_edit_current() {
 
-	uint32_t current = editor_history.get_current();
+	ObjectID current = editor_history.get_current();
 	Object *current_obj = current > 0 ? ObjectDB::get_instance(current) : NULL;
 
 	property_back->set_disabled(editor_history.is_at_beginning());
@@ -2169,7 +2169,7 @@ void EditorNode::_menu_option_confirm(int p_option, bool p_confirmed) {
 		} break;
 		case RESOURCE_SAVE: {
 
-			uint32_t current = editor_history.get_current();
+			ObjectID current = editor_history.get_current();
 			Object *current_obj = current > 0 ? ObjectDB::get_instance(current) : NULL;
 
 			ERR_FAIL_COND(!Object::cast_to<Resource>(current_obj))
@@ -2181,7 +2181,7 @@ void EditorNode::_menu_option_confirm(int p_option, bool p_confirmed) {
 		} break;
 		case RESOURCE_SAVE_AS: {
 
-			uint32_t current = editor_history.get_current();
+			ObjectID current = editor_history.get_current();
 			Object *current_obj = current > 0 ? ObjectDB::get_instance(current) : NULL;
 
 			ERR_FAIL_COND(!Object::cast_to<Resource>(current_obj))
@@ -2193,7 +2193,7 @@ void EditorNode::_menu_option_confirm(int p_option, bool p_confirmed) {
 		} break;
 		case RESOURCE_UNREF: {
 
-			uint32_t current = editor_history.get_current();
+			ObjectID current = editor_history.get_current();
 			Object *current_obj = current > 0 ? ObjectDB::get_instance(current) : NULL;
 
 			ERR_FAIL_COND(!Object::cast_to<Resource>(current_obj))
@@ -2204,7 +2204,7 @@ void EditorNode::_menu_option_confirm(int p_option, bool p_confirmed) {
 		} break;
 		case RESOURCE_COPY: {
 
-			uint32_t current = editor_history.get_current();
+			ObjectID current = editor_history.get_current();
 			Object *current_obj = current > 0 ? ObjectDB::get_instance(current) : NULL;
 
 			ERR_FAIL_COND(!Object::cast_to<Resource>(current_obj))
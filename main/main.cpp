@@ -36,6 +36,7 @@
 #include "message_queue.h"
 #include "modules/register_module_types.h"
 #include "os/os.h"
+#include "os/thread_pool.h"
 #include "platform/register_platform_apis.h"
 #include "project_settings.h"
 #include "scene/register_scene_types.h"
@@ -707,6 +708,10 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 	}
 
 	GLOBAL_DEF("memory/limits/multithreaded_server/rid_pool_prealloc", 60);
+	GLOBAL_DEF("threading/worker_pool/max_threads", -1);
+	ProjectSettings::get_singleton()->set_custom_property_info("threading/worker_pool/max_threads", PropertyInfo(Variant::INT, "threading/worker_pool/max_threads", PROPERTY_HINT_RANGE, "-1,256,1"));
+	ThreadPool::get_singleton()->init(GLOBAL_GET("threading/worker_pool/max_threads"));
+
 	GLOBAL_DEF("network/limits/debugger_stdout/max_chars_per_second", 2048);
 	GLOBAL_DEF("network/limits/debugger_stdout/max_messages_per_frame", 10);
 	GLOBAL_DEF("network/limits/debugger_stdout/max_errors_per_frame", 10);
@@ -1910,6 +1915,12 @@ void Main::cleanup() {
 	ResourceLoader::clear_translation_remaps();
 	ResourceLoader::clear_path_remaps();
 
+	// Background loads use the scene loaders and servers, unregistered below.
+	ResourceLoader::finish_threaded_loads();
+
+	// Scripts and servers may still have tasks in flight.
+	ThreadPool::get_singleton()->finish();
+
 	ScriptServer::finish_languages();
 
 #ifdef TOOLS_ENABLED
@@ -76,6 +76,7 @@ public:
 		PHYSICS_3D_ACTIVE_OBJECTS,
 		PHYSICS_3D_COLLISION_PAIRS,
 		PHYSICS_3D_ISLAND_COUNT,
+		PHYSICS_2D_NARROW_PHASE_TIME,
 		//physics
 		MONITOR_MAX
 	};
@@ -0,0 +1,499 @@
+/*************************************************************************/
+/*  test_compressed.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_compressed.h"
+
+#include "hash_map.h"
+#include "image.h"
+#include "io/compression.h"
+#include "io/file_access_compressed.h"
+#include "io/resource_loader.h"
+#include "io/resource_saver.h"
+#include "os/dir_access.h"
+#include "os/os.h"
+#include "scene/main/node.h"
+#include "scene/resources/animation.h"
+#include "scene/resources/packed_scene.h"
+#include "translation.h"
+
+namespace TestCompressed {
+
+// Reads a large compressed file byte by byte, in small chunks and in one
+// go, with and without read ahead, and seeks around in it. Then measures
+// dictionary compression on small resources.
+
+static const int file_size = 32 * 1024 * 1024 + 1234; // last block is partial
+static const int chunk_size = 1000; // not a multiple of the block size
+
+static uint8_t file_byte(int p_offset) {
+
+	// compresses about as well as typical resource data
+	return ((p_offset >> 3) * 13 + (p_offset >> 11) + (p_offset & 7)) & 0xFF;
+}
+
+static bool check_range(const uint8_t *p_data, int p_from, int p_len) {
+
+	for (int i = 0; i < p_len; i++) {
+		if (p_data[i] != file_byte(p_from + i))
+			return false;
+	}
+	return true;
+}
+
+static Error make_file(const String &p_path) {
+
+	FileAccessCompressed *fac = memnew(FileAccessCompressed);
+	fac->configure("TCMP");
+	Error err = fac->_open(p_path, FileAccess::WRITE);
+	if (err != OK) {
+		memdelete(fac);
+		return err;
+	}
+
+	Vector<uint8_t> data;
+	data.resize(file_size);
+	uint8_t *w = data.ptrw();
+	for (int i = 0; i < file_size; i++) {
+		w[i] = file_byte(i);
+	}
+	fac->store_buffer(data.ptr(), file_size);
+	memdelete(fac);
+
+	return OK;
+}
+
+static FileAccessCompressed *open_file(const String &p_path, int p_read_ahead) {
+
+	FileAccessCompressed *fac = memnew(FileAccessCompressed);
+	fac->configure("TCMP");
+	if (fac->_open(p_path, FileAccess::READ) != OK) {
+		memdelete(fac);
+		return NULL;
+	}
+	fac->set_read_ahead(p_read_ahead);
+	return fac;
+}
+
+static bool read_bytes(FileAccessCompressed *p_file) {
+
+	bool ok = true;
+	for (int i = 0; i < file_size; i++) {
+		ok = p_file->get_8() == file_byte(i) && ok;
+	}
+	p_file->get_8();
+	return ok && p_file->eof_reached();
+}
+
+static bool read_chunks(FileAccessCompressed *p_file) {
+
+	uint8_t buffer[chunk_size];
+	int pos = 0;
+
+	while (true) {
+		int read = p_file->get_buffer(buffer, chunk_size);
+		if (!check_range(buffer, pos, read))
+			return false;
+		pos += read;
+		if (read < chunk_size)
+			break;
+	}
+
+	return pos == file_size && p_file->eof_reached();
+}
+
+static bool read_whole(FileAccessCompressed *p_file) {
+
+	//start inside the first block so the bulk path begins on the next one
+	uint8_t first[10];
+	if (p_file->get_buffer(first, 10) != 10 || !check_range(first, 0, 10))
+		return false;
+
+	Vector<uint8_t> data;
+	data.resize(file_size);
+	int read = p_file->get_buffer(data.ptrw(), file_size);
+
+	return read == file_size - 10 && p_file->eof_reached() && check_range(data.ptr(), 10, read);
+}
+
+static bool read_seeks(FileAccessCompressed *p_file) {
+
+	uint8_t buffer[chunk_size];
+	uint32_t seed = 12345;
+
+	for (int i = 0; i < 2000; i++) {
+		seed = seed * 1103515245 + 12345;
+		int pos = (seed >> 4) % (file_size - chunk_size);
+		p_file->seek(pos);
+		if (p_file->get_position() != size_t(pos))
+			return false;
+		if (p_file->get_buffer(buffer, chunk_size) != chunk_size || !check_range(buffer, pos, chunk_size))
+			return false;
+	}
+
+	//the end, and back
+	p_file->seek_end();
+	p_file->get_8();
+	if (!p_file->eof_reached() || p_file->get_position() != size_t(file_size))
+		return false;
+
+	p_file->seek(file_size - 1);
+	if (p_file->eof_reached() || p_file->get_8() != file_byte(file_size - 1))
+		return false;
+
+	p_file->seek(0);
+	return p_file->get_8() == file_byte(0) && !p_file->eof_reached();
+}
+
+typedef bool (*ReadFunc)(FileAccessCompressed *);
+
+static void run_pass(const String &p_path, const char *p_name, ReadFunc p_func, int p_read_ahead) {
+
+	FileAccessCompressed *fac = open_file(p_path, p_read_ahead);
+	if (!fac) {
+		OS::get_singleton()->print("\t%-32s could not open\n", p_name);
+		return;
+	}
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	bool ok = p_func(fac);
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - from;
+	memdelete(fac);
+
+	OS::get_singleton()->print("\t%-32s %8.2f msec %s\n", p_name, usec / 1000.0, ok ? "OK" : "FAIL");
+}
+
+// Many small binary resources of a few types, compressed in blocks like
+// FileAccessCompressed does, plainly and with a dictionary trained on other
+// resources of the same kinds, as export does.
+
+static const int resources_per_type = 120;
+static const int dictionary_size = 112640;
+static const int compression_level = 19;
+
+enum ResourceKind {
+	KIND_ANIMATION,
+	KIND_SCENE,
+	KIND_IMAGE,
+	KIND_TRANSLATION,
+	KIND_MAX
+};
+
+static const char *kind_names[KIND_MAX] = { "Animation", "PackedScene", "Image", "Translation" };
+
+static uint32_t seed = 1;
+
+static uint32_t next_random() {
+
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static float next_randf() {
+
+	return (next_random() & 0xFFFF) / 65535.0;
+}
+
+static RES make_resource(ResourceKind p_kind) {
+
+	switch (p_kind) {
+
+		case KIND_ANIMATION: {
+
+			Ref<Animation> anim;
+			anim.instance();
+			anim->set_length(2 + next_random() % 8);
+			int tracks = 2 + next_random() % 6;
+			for (int i = 0; i < tracks; i++) {
+				int track = anim->add_track(Animation::TYPE_TRANSFORM);
+				anim->track_set_path(track, NodePath("Skeleton:bone_" + itos(next_random() % 40)));
+				for (int j = 0; j < 12; j++) {
+					Vector3 loc(next_randf(), next_randf() * 2, next_randf());
+					anim->transform_track_insert_key(track, j * 0.25, loc, Quat(Vector3(0, 1, 0), next_randf()), Vector3(1, 1, 1));
+				}
+			}
+			return anim;
+		} break;
+		case KIND_SCENE: {
+
+			Node *root = memnew(Node);
+			root->set_name("Room" + itos(next_random() % 100));
+			int nodes = 5 + next_random() % 20;
+			for (int i = 0; i < nodes; i++) {
+				Node *node = memnew(Node);
+				node->set_name(String(i % 3 ? "Enemy" : "Pickup") + itos(i));
+				node->set_meta("health", int(next_random() % 100));
+				node->set_meta("spawn", Vector2(next_randf() * 1000, next_randf() * 1000));
+				root->add_child(node);
+				node->set_owner(root);
+			}
+			Ref<PackedScene> scene;
+			scene.instance();
+			scene->pack(root);
+			memdelete(root);
+			return scene;
+		} break;
+		case KIND_IMAGE: {
+
+			int size = 16 << (next_random() % 3);
+			PoolVector<uint8_t> data;
+			data.resize(size * size * 4);
+			PoolVector<uint8_t>::Write w = data.write();
+			uint8_t base = next_random();
+			for (int i = 0; i < size * size; i++) {
+				w[i * 4 + 0] = base + (i % size) * 4;
+				w[i * 4 + 1] = base + (i / size) * 4;
+				w[i * 4 + 2] = next_random() & 0x0F;
+				w[i * 4 + 3] = 255;
+			}
+			w = PoolVector<uint8_t>::Write();
+			Ref<Image> image;
+			image.instance();
+			image->create(size, size, false, Image::FORMAT_RGBA8, data);
+			return image;
+		} break;
+		case KIND_TRANSLATION: {
+
+			Ref<Translation> translation;
+			translation.instance();
+			translation->set_locale("en");
+			int messages = 10 + next_random() % 30;
+			for (int i = 0; i < messages; i++) {
+				int id = next_random() % 500;
+				translation->add_message("ui_label_" + itos(id), "Label number " + itos(id) + " of the menu");
+			}
+			return translation;
+		} break;
+		default: {
+		}
+	}
+
+	return RES();
+}
+
+struct CompressionStats {
+
+	uint64_t raw;
+	uint64_t compressed;
+	uint64_t decode_usec;
+	bool ok;
+};
+
+static CompressionStats compress_files(const Vector<Vector<uint8_t> > &p_files, const Compression::Dictionary *p_dict) {
+
+	CompressionStats stats;
+	stats.raw = 0;
+	stats.compressed = 0;
+	stats.ok = true;
+
+	Vector<Vector<uint8_t> > blocks;
+	Vector<int> block_sizes;
+
+	for (int i = 0; i < p_files.size(); i++) {
+		for (int ofs = 0; ofs < p_files[i].size(); ofs += 4096) {
+
+			int size = MIN(4096, p_files[i].size() - ofs);
+			Vector<uint8_t> block;
+			block.resize(Compression::get_max_compressed_buffer_size(size));
+			block.resize(Compression::compress(block.ptrw(), &p_files[i][ofs], size, Compression::MODE_ZSTD, compression_level, p_dict));
+			stats.raw += size;
+			stats.compressed += block.size();
+			blocks.push_back(block);
+			block_sizes.push_back(size);
+		}
+	}
+
+	const int rounds = 20;
+	uint8_t dst[4096];
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < rounds; r++) {
+		for (int i = 0; i < blocks.size(); i++) {
+			int size = Compression::decompress(dst, 4096, blocks[i].ptr(), blocks[i].size(), Compression::MODE_ZSTD, p_dict);
+			stats.ok = stats.ok && size == block_sizes[i];
+		}
+	}
+	stats.decode_usec = (OS::get_singleton()->get_ticks_usec() - from) / rounds;
+
+	//and it comes back as it was
+	int block = 0;
+	for (int i = 0; i < p_files.size(); i++) {
+		for (int ofs = 0; ofs < p_files[i].size(); ofs += 4096, block++) {
+			int size = Compression::decompress(dst, 4096, blocks[block].ptr(), blocks[block].size(), Compression::MODE_ZSTD, p_dict);
+			stats.ok = stats.ok && size == block_sizes[block] && memcmp(dst, &p_files[i][ofs], size) == 0;
+		}
+	}
+
+	return stats;
+}
+
+static bool load_with_dictionary(const String &p_dir, const Vector<uint8_t> &p_resource, uint32_t p_dictionary) {
+
+	String path = p_dir.plus_file("test_dictionary.res");
+
+	FileAccessCompressed *fac = memnew(FileAccessCompressed);
+	fac->configure("RSCC", Compression::MODE_ZSTD, 4096, compression_level, p_dictionary);
+	Error err = fac->_open(path, FileAccess::WRITE);
+	if (err == OK) {
+		fac->store_buffer(p_resource.ptr(), p_resource.size()); //as export does, RSRC header included
+		fac->close();
+	}
+	memdelete(fac);
+
+	RES res = ResourceLoader::load(path, "", true);
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(path);
+	memdelete(da);
+
+	return err == OK && res.is_valid() && res->get_class() == "Animation";
+}
+
+static void test_dictionary(const String &p_dir) {
+
+	Vector<Vector<uint8_t> > files[KIND_MAX];
+	Vector<Vector<uint8_t> > samples;
+	String path = p_dir.plus_file("test_dictionary_src.res");
+
+	for (int k = 0; k < KIND_MAX; k++) {
+		for (int i = 0; i < resources_per_type; i++) {
+
+			RES res = make_resource(ResourceKind(k));
+			if (res.is_null() || ResourceSaver::save(path, res) != OK) {
+				OS::get_singleton()->print("Could not save a %s resource in %s\n", kind_names[k], p_dir.utf8().get_data());
+				return;
+			}
+
+			//train on half, measure on the other half
+			Vector<uint8_t> data = FileAccess::get_file_as_array(path);
+			if (i % 2 == 0) {
+				samples.push_back(data);
+			} else {
+				files[k].push_back(data);
+			}
+		}
+	}
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(path);
+	memdelete(da);
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	Vector<uint8_t> dictionary = Compression::train_dictionary(samples, dictionary_size);
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	uint32_t id = Compression::add_dictionary(dictionary);
+	const Compression::Dictionary *dict = Compression::get_dictionary(id);
+
+	OS::get_singleton()->print("Dictionary: %d KiB trained from %d resources in %.2f msec, zstd level %d\n", dictionary.size() / 1024, samples.size(), usec / 1000.0, compression_level);
+
+	for (int k = 0; k < KIND_MAX; k++) {
+
+		CompressionStats plain = compress_files(files[k], NULL);
+		CompressionStats trained = compress_files(files[k], dict);
+
+		OS::get_singleton()->print("\t%-12s %6.1f KiB, ratio %5.2f -> %5.2f, decode %7.1f -> %7.1f MiB/s %s\n", kind_names[k], plain.raw / 1024.0,
+				double(plain.raw) / plain.compressed, double(trained.raw) / trained.compressed,
+				plain.raw / (1024.0 * 1024.0) / (MAX(plain.decode_usec, uint64_t(1)) / 1000000.0),
+				trained.raw / (1024.0 * 1024.0) / (MAX(trained.decode_usec, uint64_t(1)) / 1000000.0),
+				plain.ok && trained.ok ? "OK" : "FAIL");
+	}
+
+	bool ok = load_with_dictionary(p_dir, files[KIND_ANIMATION][0], id);
+	OS::get_singleton()->print("\t%-32s %s\n", "load with dictionary:", ok ? "OK" : "FAIL");
+}
+
+// Ids are a 24 bit hash, so two different dictionaries can share one. Adding
+// the second must fail instead of reusing the first.
+
+static void test_dictionary_clash() {
+
+	HashMap<uint32_t, int> seen;
+	Vector<uint8_t> first;
+	Vector<uint8_t> second;
+
+	for (int i = 1; i < 1 << 20 && second.empty(); i++) {
+
+		Vector<uint8_t> dict;
+		dict.resize(16);
+		for (int j = 0; j < 16; j++) {
+			dict.ptrw()[j] = (i >> (j % 4 * 8)) ^ j;
+		}
+
+		uint32_t id = Compression::get_dictionary_id(dict);
+		const int *other = seen.getptr(id);
+		if (other) {
+			first.resize(16);
+			for (int j = 0; j < 16; j++) {
+				first.ptrw()[j] = (*other >> (j % 4 * 8)) ^ j;
+			}
+			second = dict;
+		} else {
+			seen.set(id, i);
+		}
+	}
+
+	uint32_t id = Compression::add_dictionary(first);
+	bool ok = !second.empty() && id != 0 && Compression::add_dictionary(first) == id;
+	OS::get_singleton()->print("\t%-32s (expecting an error)\n", "clashing dictionary:");
+	ok = ok && Compression::add_dictionary(second) == 0 && Compression::add_dictionary(first) == id;
+	OS::get_singleton()->print("\t%-32s %s\n", "clashing dictionary refused:", ok ? "OK" : "FAIL");
+}
+
+MainLoop *test() {
+
+	String dir = OS::get_singleton()->get_user_data_dir();
+	String path = dir.plus_file("test_compressed.bin");
+
+	if (make_file(path) != OK) {
+		OS::get_singleton()->print("Could not create the test file in %s\n", dir.utf8().get_data());
+		return NULL;
+	}
+
+	OS::get_singleton()->print("Compressed: %d KiB in %d byte blocks\n", file_size / 1024, 4096);
+
+	run_pass(path, "bytes:", read_bytes, 0);
+	run_pass(path, "bytes, read ahead:", read_bytes, 64);
+	run_pass(path, "chunks:", read_chunks, 0);
+	run_pass(path, "chunks, read ahead:", read_chunks, 64);
+	run_pass(path, "whole file:", read_whole, 0);
+	run_pass(path, "whole file, read ahead:", read_whole, 64);
+	run_pass(path, "seeks:", read_seeks, 0);
+	run_pass(path, "seeks, read ahead:", read_seeks, 64);
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(path);
+	memdelete(da);
+
+	test_dictionary(dir);
+	test_dictionary_clash();
+
+	return NULL;
+}
+} // namespace TestCompressed
@@ -569,7 +569,12 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 			switch (code[ip]) {
 
-				case GDScriptFunction::OPCODE_OPERATOR: {
+				case GDScriptFunction::OPCODE_OPERATOR:
+				case GDScriptFunction::OPCODE_OPERATOR_GENERIC:
+				case GDScriptFunction::OPCODE_OPERATOR_INT:
+				case GDScriptFunction::OPCODE_OPERATOR_REAL:
+				case GDScriptFunction::OPCODE_OPERATOR_VECTOR2:
+				case GDScriptFunction::OPCODE_OPERATOR_VECTOR3: {
 
 					int op = code[ip + 1];
 					txt += "op ";
@@ -748,7 +753,7 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 					int argc = code[ip + 1];
 					if (ret) {
-						txt += DADDR(4 + argc) + "=";
+						txt += DADDR(5 + argc) + "=";
 					}
 
 					txt += DADDR(2) + ".";
@@ -758,11 +763,11 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					for (int i = 0; i < argc; i++) {
 						if (i > 0)
 							txt += ", ";
-						txt += DADDR(4 + i);
+						txt += DADDR(5 + i);
 					}
-					txt += ")";
+					txt += ") cache " + itos(code[ip + 4]);
 
-					incr = 5 + argc;
+					incr = 6 + argc;
 
 				} break;
 				case GDScriptFunction::OPCODE_CALL_BUILT_IN: {
@@ -851,6 +856,17 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 					incr = 3;
 				} break;
+				case GDScriptFunction::OPCODE_JUMP_IF_NOT_COMPARE: {
+
+					txt += " jump-if-not ";
+					txt += DADDR(2);
+					txt += " " + Variant::get_operator_name(Variant::Operator(code[ip + 1])) + " ";
+					txt += DADDR(3);
+					txt += " to ";
+					txt += itos(code[ip + 4]);
+
+					incr = 5;
+				} break;
 				case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT: {
 
 					txt += " jump-to-default-argument ";
@@ -912,8 +928,149 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 	}
 }
 
+// Hot loops covering the typed fast paths of the VM, each function is timed on its own.
+static const char *_benchmark_source =
+		"extends Reference\n"
+		"\n"
+		"var counter = 0\n"
+		"var velocity = Vector2(1, 0)\n"
+		"\n"
+		"func int_math(n):\n"
+		"\tvar acc = 0\n"
+		"\tvar i = 0\n"
+		"\twhile i < n:\n"
+		"\t\tacc = (acc + i * 3) % 1000003\n"
+		"\t\ti += 1\n"
+		"\treturn acc\n"
+		"\n"
+		"func real_math(n):\n"
+		"\tvar x = 0.0\n"
+		"\tvar i = 0\n"
+		"\twhile i < n:\n"
+		"\t\tx = x * 0.5 + 1.25\n"
+		"\t\ti += 1\n"
+		"\treturn x\n"
+		"\n"
+		"func vector2_math(n):\n"
+		"\tvar p = Vector2()\n"
+		"\tvar v = Vector2(0.5, 0.25)\n"
+		"\tvar i = 0\n"
+		"\twhile i < n:\n"
+		"\t\tp = p + v * 0.016 - p / 64.0\n"
+		"\t\ti += 1\n"
+		"\treturn p\n"
+		"\n"
+		"func vector3_math(n):\n"
+		"\tvar p = Vector3()\n"
+		"\tvar v = Vector3(0.5, 0.25, -1.0)\n"
+		"\tvar i = 0\n"
+		"\twhile i < n:\n"
+		"\t\tp = p + v * 0.016 - p / 64.0\n"
+		"\t\ti += 1\n"
+		"\treturn p\n"
+		"\n"
+		"func member_access(n):\n"
+		"\tvar i = 0\n"
+		"\twhile i < n:\n"
+		"\t\tself.counter = counter + 1\n"
+		"\t\tvelocity = velocity * 0.99\n"
+		"\t\ti += 1\n"
+		"\treturn counter\n"
+		"\n"
+		"func builtin_methods(n):\n"
+		"\tvar v = Vector2(3, 4)\n"
+		"\tvar acc = 0.0\n"
+		"\tvar i = 0\n"
+		"\twhile i < n:\n"
+		"\t\tacc += v.length() + v.dot(v)\n"
+		"\t\ti += 1\n"
+		"\treturn acc\n"
+		"\n"
+		"func branches(n):\n"
+		"\tvar a = 0\n"
+		"\tvar b = 0\n"
+		"\tvar i = 0\n"
+		"\twhile i < n:\n"
+		"\t\tif i % 3 == 0:\n"
+		"\t\t\ta += 1\n"
+		"\t\telif i % 3 == 1:\n"
+		"\t\t\tb += 2\n"
+		"\t\telif a > b:\n"
+		"\t\t\ta -= 1\n"
+		"\t\ti += 1\n"
+		"\treturn a + b\n"
+		"\n"
+		"func _step(x):\n"
+		"\treturn x + 1\n"
+		"\n"
+		"func function_calls(n):\n"
+		"\tvar acc = 0\n"
+		"\tvar i = 0\n"
+		"\twhile i < n:\n"
+		"\t\tacc = _step(acc)\n"
+		"\t\ti += 1\n"
+		"\treturn acc\n"
+		"\n"
+		"func array_sum(n):\n"
+		"\tvar arr = []\n"
+		"\tfor j in range(1000):\n"
+		"\t\tarr.append(j)\n"
+		"\tvar acc = 0\n"
+		"\tfor i in range(n):\n"
+		"\t\tacc += arr[i % 1000]\n"
+		"\treturn acc\n";
+
+static void _run_benchmarks() {
+
+	static const char *functions[] = {
+		"int_math",
+		"real_math",
+		"vector2_math",
+		"vector3_math",
+		"member_access",
+		"builtin_methods",
+		"branches",
+		"function_calls",
+		"array_sum",
+		NULL
+	};
+
+	const int iterations = 1000000;
+
+	Ref<GDScript> script;
+	script.instance();
+	script->set_source_code(_benchmark_source);
+	Error err = script->reload();
+	ERR_FAIL_COND(err != OK);
+
+	Ref<Reference> instance = memnew(Reference);
+	instance->set_script(script.get_ref_ptr());
+
+	print_line("GDScript benchmarks, " + itos(iterations) + " iterations each:");
+
+	uint64_t total = 0;
+
+	for (int i = 0; functions[i]; i++) {
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		Variant ret = instance->call(functions[i], iterations);
+		uint64_t time = OS::get_singleton()->get_ticks_usec() - from;
+		total += time;
+
+		print_line("\t" + String(functions[i]) + ": " + rtos(time / 1000.0) + " msec (result " + String(ret) + ")");
+	}
+
+	print_line("\ttotal: " + rtos(total / 1000.0) + " msec");
+}
+
 MainLoop *test(TestType p_type) {
 
+	if (p_type == TEST_BENCHMARK) {
+
+		_run_benchmarks();
+		return NULL;
+	}
+
 	List<String> cmdlargs = OS::get_singleton()->get_cmdline_args();
 
 	if (cmdlargs.empty()) {
@@ -33,18 +33,30 @@
 
 #ifdef DEBUG_ENABLED
 
+#include "test_compressed.h"
 #include "test_gdscript.h"
 #include "test_gui.h"
 #include "test_image.h"
 #include "test_io.h"
+#include "test_marshalls.h"
 #include "test_math.h"
+#include "test_method_cache.h"
+#include "test_network.h"
+#include "test_object_db.h"
 #include "test_oa_hash_map.h"
 #include "test_ordered_hash_map.h"
+#include "test_pack.h"
 #include "test_physics.h"
 #include "test_physics_2d.h"
 #include "test_render.h"
+#include "test_replication.h"
+#include "test_resource_loader.h"
+#include "test_rid.h"
 #include "test_shader_lang.h"
+#include "test_signal.h"
 #include "test_string.h"
+#include "test_string_name.h"
+#include "test_thread_pool.h"
 
 const char **tests_get_names() {
 
@@ -53,12 +65,29 @@ const char **tests_get_names() {
 		"containers",
 		"math",
 		"render",
+		"scenario_index",
 		"multimesh",
 		"gui",
 		"io",
 		"shaderlang",
 		"physics",
+		"physics_broad_phase",
+		"physics_2d_broad_phase",
+		"physics_2d_instance_ids",
 		"oa_hash_map",
+		"thread_pool",
+		"gd_benchmark",
+		"network_rpc",
+		"marshalls",
+		"replication",
+		"pack",
+		"resource_loader",
+		"compressed",
+		"rid",
+		"string_name",
+		"object_db",
+		"signal",
+		"method_cache",
 		NULL
 	};
 
@@ -82,16 +111,36 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestPhysics::test();
 	}
 
+	if (p_test == "physics_broad_phase") {
+
+		return TestPhysics::test_broad_phase();
+	}
+
 	if (p_test == "physics_2d") {
 
 		return TestPhysics2D::test();
 	}
 
+	if (p_test == "physics_2d_broad_phase") {
+
+		return TestPhysics2D::test_broad_phase();
+	}
+
+	if (p_test == "physics_2d_instance_ids") {
+
+		return TestPhysics2D::test_instance_ids();
+	}
+
 	if (p_test == "render") {
 
 		return TestRender::test();
 	}
 
+	if (p_test == "scenario_index") {
+
+		return TestRender::test_scenario_index();
+	}
+
 	if (p_test == "oa_hash_map") {
 
 		return TestOAHashMap::test();
@@ -134,6 +183,11 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestGDScript::test(TestGDScript::TEST_BYTECODE);
 	}
 
+	if (p_test == "gd_benchmark") {
+
+		return TestGDScript::test(TestGDScript::TEST_BENCHMARK);
+	}
+
 	if (p_test == "image") {
 
 		return TestImage::test();
@@ -144,6 +198,66 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestOrderedHashMap::test();
 	}
 
+	if (p_test == "thread_pool") {
+
+		return TestThreadPool::test();
+	}
+
+	if (p_test == "network_rpc") {
+
+		return TestNetwork::test();
+	}
+
+	if (p_test == "marshalls") {
+
+		return TestMarshalls::test();
+	}
+
+	if (p_test == "replication") {
+
+		return TestReplication::test();
+	}
+
+	if (p_test == "pack") {
+
+		return TestPack::test();
+	}
+
+	if (p_test == "resource_loader") {
+
+		return TestResourceLoader::test();
+	}
+
+	if (p_test == "compressed") {
+
+		return TestCompressed::test();
+	}
+
+	if (p_test == "rid") {
+
+		return TestRID::test();
+	}
+
+	if (p_test == "string_name") {
+
+		return TestStringName::test();
+	}
+
+	if (p_test == "object_db") {
+
+		return TestObjectDB::test();
+	}
+
+	if (p_test == "signal") {
+
+		return TestSignal::test();
+	}
+
+	if (p_test == "method_cache") {
+
+		return TestMethodCache::test();
+	}
+
 	return NULL;
 }
 
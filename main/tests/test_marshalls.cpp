@@ -0,0 +1,320 @@
+/*************************************************************************/
+/*  test_marshalls.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "test_marshalls.h"
+
+#include "io/marshalls.h"
+#include "os/os.h"
+#include "print_string.h"
+
+namespace TestMarshalls {
+
+struct Random {
+
+	uint32_t seed;
+
+	uint32_t next() {
+		seed = seed * 1664525 + 1013904223;
+		return seed >> 8;
+	}
+	int range(int p_max) { return next() % p_max; }
+	real_t real() { return (int(next() % 2000001) - 1000000) / 997.0; }
+	Vector3 vector3() { return Vector3(real(), real(), real()); }
+};
+
+static Variant random_variant(Random &rng, int p_depth) {
+
+	switch (rng.range(p_depth > 2 ? 24 : 27)) {
+
+		case 0: return Variant();
+		case 1: return rng.range(2) == 1;
+		case 2: return rng.range(200) - 100;
+		case 3: return int64_t(rng.next()) * int64_t(rng.next()) * (rng.range(2) ? 1 : -1);
+		case 4: return rng.real();
+		case 5: return double(rng.real()) / 3.0;
+		case 6: return String("name_") + itos(rng.range(1000));
+		case 7: return Vector2(rng.real(), rng.real());
+		case 8: return Rect2(rng.real(), rng.real(), rng.real(), rng.real());
+		case 9: return rng.vector3();
+		case 10: return Transform2D(rng.real(), Vector2(rng.real(), rng.real()));
+		case 11: return Plane(rng.vector3(), rng.real());
+		case 12: return Quat(rng.real(), rng.real(), rng.real(), rng.real());
+		case 13: return AABB(rng.vector3(), rng.vector3());
+		case 14: return Basis(rng.vector3().normalized(), rng.real());
+		case 15: return Transform(Basis(rng.vector3().normalized(), rng.real()), rng.vector3());
+		case 16: return Color(rng.real(), rng.real(), rng.real(), rng.real());
+		case 17: return NodePath("/root/Level/Player" + itos(rng.range(64)) + ":translation:x");
+		case 18: {
+			PoolVector<uint8_t> a;
+			for (int i = rng.range(40); i > 0; i--)
+				a.push_back(rng.next());
+			return a;
+		}
+		case 19: {
+			PoolVector<int> a;
+			for (int i = rng.range(40); i > 0; i--)
+				a.push_back(int(rng.next()) - (1 << 23));
+			return a;
+		}
+		case 20: {
+			PoolVector<real_t> a;
+			for (int i = rng.range(40); i > 0; i--)
+				a.push_back(rng.real());
+			return a;
+		}
+		case 21: {
+			PoolVector<String> a;
+			for (int i = rng.range(10); i > 0; i--)
+				a.push_back(itos(rng.next()));
+			return a;
+		}
+		case 22: {
+			PoolVector<Vector3> a;
+			for (int i = rng.range(20); i > 0; i--)
+				a.push_back(rng.vector3());
+			return a;
+		}
+		case 23: {
+			PoolVector<Color> a;
+			for (int i = rng.range(10); i > 0; i--)
+				a.push_back(Color(rng.real(), rng.real(), rng.real()));
+			return a;
+		}
+		case 24: {
+			//homogeneous arrays are packed, so generate those often
+			Array a;
+			int count = rng.range(12);
+			int kind = rng.range(3);
+			for (int i = 0; i < count; i++) {
+				if (kind == 0)
+					a.push_back(rng.range(100000));
+				else if (kind == 1)
+					a.push_back(rng.vector3());
+				else
+					a.push_back(random_variant(rng, p_depth + 1));
+			}
+			return a;
+		}
+		case 25: {
+			Dictionary d;
+			for (int i = rng.range(6); i > 0; i--)
+				d[random_variant(rng, p_depth + 1)] = random_variant(rng, p_depth + 1);
+			return d;
+		}
+		default: {
+			PoolVector<Vector2> a;
+			for (int i = rng.range(20); i > 0; i--)
+				a.push_back(Vector2(rng.real(), rng.real()));
+			return a;
+		}
+	}
+}
+
+static bool same_bytes(const Vector<uint8_t> &p_a, const Vector<uint8_t> &p_b) {
+
+	return p_a.size() == p_b.size() && (p_a.size() == 0 || memcmp(p_a.ptr(), p_b.ptr(), p_a.size()) == 0);
+}
+
+// The regular encoding is deterministic, so two values are the same if they encode to the same bytes.
+static Vector<uint8_t> regular_bytes(const Variant &p_variant) {
+
+	Vector<uint8_t> data;
+	int len;
+	encode_variant(p_variant, NULL, len);
+	data.resize(len);
+	zeromem(data.ptrw(), len); //padding is skipped, not written
+	encode_variant(p_variant, data.ptrw(), len);
+	return data;
+}
+
+static Vector<uint8_t> compact_bytes(const Variant &p_variant, uint32_t p_flags = 0) {
+
+	Vector<uint8_t> data;
+	int len;
+	encode_variant_compact(p_variant, NULL, len, p_flags);
+	data.resize(len);
+	encode_variant_compact(p_variant, data.ptrw(), len, p_flags);
+	return data;
+}
+
+static bool test_round_trip(int p_iterations) {
+
+	Random rng;
+	rng.seed = 42;
+
+	for (int i = 0; i < p_iterations; i++) {
+
+		Variant v = random_variant(rng, 0);
+		Vector<uint8_t> data = compact_bytes(v);
+
+		Variant decoded;
+		int used;
+		Error err = decode_variant_compact(decoded, data.ptr(), data.size(), &used);
+
+		if (err != OK || used != data.size() || !same_bytes(regular_bytes(v), regular_bytes(decoded))) {
+			OS::get_singleton()->print("\tround trip failed at %d for %s: %s\n", i, Variant::get_type_name(v.get_type()).utf8().get_data(), String(v).utf8().get_data());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Truncated and corrupted data must fail cleanly, never read out of bounds.
+static bool test_corruption(int p_iterations) {
+
+	Random rng;
+	rng.seed = 1337;
+
+	int errors = 0;
+	int i = 0;
+
+	//decoding garbage complains a lot
+	bool print_errors = _print_error_enabled;
+	bool print_lines = _print_line_enabled;
+	_print_error_enabled = false;
+	_print_line_enabled = false;
+
+	for (; i < p_iterations; i++) {
+
+		Vector<uint8_t> data = compact_bytes(random_variant(rng, 0));
+
+		for (int j = rng.range(4); j >= 0; j--)
+			data.ptrw()[rng.range(data.size())] ^= 1 << rng.range(8);
+
+		int len = rng.range(2) ? data.size() : rng.range(data.size() + 1);
+
+		//a copy of the exact size, so tools like ASan catch overreads
+		Vector<uint8_t> cut;
+		cut.resize(len);
+		if (len)
+			copymem(cut.ptrw(), data.ptr(), len);
+
+		Variant decoded;
+		int used = 0;
+		if (decode_variant_compact(decoded, cut.ptr(), len, &used) != OK)
+			errors++;
+		else if (used > len)
+			break;
+	}
+
+	_print_error_enabled = print_errors;
+	_print_line_enabled = print_lines;
+	OS::get_singleton()->print("\t%d of %d corrupted buffers rejected\n", errors, p_iterations);
+	return i == p_iterations;
+}
+
+static bool test_lossy() {
+
+	Vector3 v(12.5, -3.25, 1000.0);
+	Variant half;
+	Vector<uint8_t> data = compact_bytes(v, ENCODE_COMPACT_HALF_VECTORS);
+	decode_variant_compact(half, data.ptr(), data.size());
+	bool half_ok = data.size() == 7 && half.get_type() == Variant::VECTOR3 && (Vector3(half) - v).length() < 1.0;
+
+	Quat q = Quat(Vector3(1, 2, 3).normalized(), 0.7);
+	Variant quantized;
+	data = compact_bytes(q, ENCODE_COMPACT_QUANTIZED_QUATS);
+	decode_variant_compact(quantized, data.ptr(), data.size());
+	Quat dq = quantized;
+	bool quat_ok = data.size() == 9 && ABS(dq.x - q.x) + ABS(dq.y - q.y) + ABS(dq.z - q.z) + ABS(dq.w - q.w) < 0.001;
+
+	OS::get_singleton()->print("\thalf vectors: %s, quantized quats: %s\n", half_ok ? "OK" : "FAIL", quat_ok ? "OK" : "FAIL");
+	return half_ok && quat_ok;
+}
+
+static void benchmark(const char *p_name, const Variant &p_variant, int p_iterations) {
+
+	Vector<uint8_t> buffer;
+	buffer.resize(1 << 16);
+	int regular_len = 0, compact_len = 0;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		Variant v;
+		encode_variant(p_variant, buffer.ptrw(), regular_len);
+		decode_variant(v, buffer.ptr(), regular_len);
+	}
+	uint64_t regular_time = OS::get_singleton()->get_ticks_usec() - from;
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		Variant v;
+		encode_variant_compact(p_variant, buffer.ptrw(), compact_len);
+		decode_variant_compact(v, buffer.ptr(), compact_len);
+	}
+	uint64_t compact_time = OS::get_singleton()->get_ticks_usec() - from;
+
+	int half_len;
+	encode_variant_compact(p_variant, NULL, half_len, ENCODE_COMPACT_HALF_VECTORS | ENCODE_COMPACT_QUANTIZED_QUATS);
+
+	OS::get_singleton()->print("\t%-18s regular %5d bytes %7.3f usec, compact %5d bytes %7.3f usec, lossy %5d bytes\n",
+			p_name, regular_len, regular_time / double(p_iterations), compact_len, compact_time / double(p_iterations), half_len);
+}
+
+MainLoop *test() {
+
+	OS::get_singleton()->print("Compact variant encoding:\n");
+
+	bool ok = test_round_trip(20000);
+	ok = test_corruption(20000) && ok;
+	ok = test_lossy() && ok;
+
+	OS::get_singleton()->print("\tfuzz: %s\n", ok ? "OK" : "FAIL");
+
+	Array ints, vectors, state;
+	Dictionary player;
+	for (int i = 0; i < 100; i++) {
+		ints.push_back(i * 7);
+		vectors.push_back(Vector3(i, i * 0.5, -i));
+	}
+	player["id"] = 17;
+	player["name"] = "player_17";
+	player["alive"] = true;
+	player["health"] = 87;
+	player["position"] = Vector3(10.5, 0, -3.25);
+	player["rotation"] = Quat(Vector3(0, 1, 0), 1.2);
+	state.push_back(player);
+	state.push_back(player.duplicate());
+
+	benchmark("bool", true, 100000);
+	benchmark("small int", 42, 100000);
+	benchmark("Vector3", Vector3(1, 2, 3), 100000);
+	benchmark("Quat", Quat(Vector3(0, 1, 0), 0.5), 100000);
+	benchmark("Transform", Transform(Basis(Vector3(0, 1, 0), 0.5), Vector3(1, 2, 3)), 100000);
+	benchmark("String", "update_remote_transform", 100000);
+	benchmark("Array of ints", ints, 10000);
+	benchmark("Array of Vector3", vectors, 10000);
+	benchmark("player state", state, 10000);
+
+	return NULL;
+}
+} // namespace TestMarshalls
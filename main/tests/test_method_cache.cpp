@@ -0,0 +1,115 @@
+/*************************************************************************/
+/*  test_method_cache.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "test_method_cache.h"
+
+#include "object.h"
+#include "os/os.h"
+#include "resource.h"
+
+namespace TestMethodCache {
+
+// Calls methods bound at different depths of the Resource hierarchy through
+// Object::call() and through a single call site cache, then checks that the
+// cache follows the class of the callee, survives invalidation and still
+// reports errors and frees objects like call() does.
+
+static const int call_budget = 2000000;
+
+static void benchmark(const StringName &p_method) {
+
+	Ref<Resource> res = memnew(Resource);
+	Variant::CallError ce;
+	MethodCallCache cache;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < call_budget; i++) {
+		res->call(p_method, NULL, 0, ce);
+	}
+	uint64_t usec_call = OS::get_singleton()->get_ticks_usec() - from;
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < call_budget; i++) {
+		res->call_cached(&cache, p_method, NULL, 0, ce);
+	}
+	uint64_t usec_cached = OS::get_singleton()->get_ticks_usec() - from;
+
+	OS::get_singleton()->print("%-16s call: %6.1f nsec, call_cached: %6.1f nsec\n",
+			String(p_method).utf8().get_data(), usec_call * 1000.0 / call_budget, usec_cached * 1000.0 / call_budget);
+}
+
+static bool check_cache() {
+
+	bool ok = true;
+	Variant::CallError ce;
+	MethodCallCache cache;
+
+	Object *obj = memnew(Object);
+	Ref<Resource> res = memnew(Resource);
+	res->set_name("res");
+
+	// the same call site alternating between classes
+	ok = ok && uint64_t(obj->call_cached(&cache, "get_instance_id", NULL, 0, ce)) == obj->get_instance_id();
+	ok = ok && uint64_t(res->call_cached(&cache, "get_instance_id", NULL, 0, ce)) == res->get_instance_id();
+	ok = ok && String(res->call_cached(&cache, "get_name", NULL, 0, ce)) == "res";
+	obj->call_cached(&cache, "get_name", NULL, 0, ce);
+	ok = ok && ce.error == Variant::CallError::CALL_ERROR_INVALID_METHOD;
+
+	// stale entries are resolved again
+	res->call_cached(&cache, "get_name", NULL, 0, ce);
+	MethodCallCache::invalidate_all();
+	ok = ok && String(res->call_cached(&cache, "get_name", NULL, 0, ce)) == "res" && cache.version == MethodCallCache::global_version;
+
+	// argument errors come from the method bind
+	Variant arg = "x";
+	const Variant *argptr = &arg;
+	res->call_cached(&cache, "get_name", &argptr, 1, ce);
+	ok = ok && ce.error == Variant::CallError::CALL_ERROR_TOO_MANY_ARGUMENTS;
+
+	// free is never cached
+	ObjectID id = obj->get_instance_id();
+	obj->call_cached(&cache, "free", NULL, 0, ce);
+	ok = ok && ce.error == Variant::CallError::CALL_OK && !ObjectDB::get_instance(id) && !cache.method_bind;
+
+	return ok;
+}
+
+MainLoop *test() {
+
+	benchmark("get_instance_id");
+	benchmark("get_name");
+	benchmark("is_local_to_scene");
+
+	OS::get_singleton()->print("Method cache: %s\n", check_cache() ? "OK" : "FAIL");
+
+	return NULL;
+}
+} // namespace TestMethodCache
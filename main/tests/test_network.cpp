@@ -0,0 +1,504 @@
+/*************************************************************************/
+/*  test_network.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "test_network.h"
+
+#include "class_db.h"
+#include "io/marshalls.h"
+#include "io/networked_multiplayer_peer.h"
+#include "io/tcp_poller.h"
+#include "io/tcp_server.h"
+#include "os/os.h"
+
+namespace TestNetwork {
+
+// Replays an RPC stream like the one of a 64 player server through the packet
+// layout SceneTree used before name indexing (full method name as a cstring)
+// and the current one (varint id into the per path name table).
+
+struct RPCRecord {
+
+	int path_id;
+	StringName name;
+	Vector<Variant> args;
+};
+
+static const char *rpc_names[] = {
+	"update_remote_transform",
+	"update_remote_velocity",
+	"play_remote_animation",
+	"set_remote_health",
+	"fire_weapon",
+	NULL
+};
+
+static Vector<RPCRecord> make_stream(int p_players, int p_records) {
+
+	Vector<RPCRecord> stream;
+	stream.resize(p_records);
+
+	uint32_t seed = 1234;
+
+	for (int i = 0; i < p_records; i++) {
+
+		seed = seed * 1664525 + 1013904223;
+		int kind = (seed >> 16) % 10;
+
+		RPCRecord &r = stream[i];
+		r.path_id = 1 + i % p_players;
+
+		if (kind < 6) {
+			//most traffic is small unreliable transform updates
+			r.name = rpc_names[0];
+			r.args.push_back(Vector3(i * 0.1, 1.0, -i * 0.2));
+			r.args.push_back(real_t(i % 360));
+		} else if (kind < 8) {
+			r.name = rpc_names[1];
+			r.args.push_back(Vector3(1, 0, 0.5));
+		} else if (kind < 9) {
+			r.name = rpc_names[2];
+			r.args.push_back("run");
+		} else {
+			r.name = rpc_names[3 + (seed >> 24) % 2];
+			r.args.push_back(int(seed & 0xFF));
+		}
+	}
+
+	return stream;
+}
+
+static int encode_rpc(const RPCRecord &p_record, bool p_indexed, const Map<StringName, int> &p_name_ids, Vector<uint8_t> &r_packet) {
+
+	int ofs = 0;
+	int len;
+
+	if (r_packet.size() < 1024)
+		r_packet.resize(1024);
+	uint8_t *w = r_packet.ptrw();
+
+	w[ofs++] = 0; //remote call
+	ofs += encode_uint32(p_record.path_id, &w[ofs]);
+
+	if (p_indexed) {
+		ofs += encode_varint(p_name_ids[p_record.name], &w[ofs]);
+	} else {
+		CharString name = String(p_record.name).utf8();
+		ofs += encode_cstring(name.get_data(), &w[ofs]);
+	}
+
+	w[ofs++] = p_record.args.size();
+	for (int i = 0; i < p_record.args.size(); i++) {
+		encode_variant(p_record.args[i], &w[ofs], len);
+		ofs += len;
+	}
+
+	return ofs;
+}
+
+static bool decode_rpc(const uint8_t *p_packet, int p_len, bool p_indexed, const Map<int, StringName> &p_names, StringName &r_name, Variant *r_args) {
+
+	int ofs = 5;
+
+	if (p_indexed) {
+		uint64_t id;
+		int id_len = decode_varint(&p_packet[ofs], p_len - ofs, id);
+		const Map<int, StringName>::Element *E = p_names.find(id);
+		if (id_len == 0 || !E)
+			return false;
+		r_name = E->get();
+		ofs += id_len;
+	} else {
+		int len_end = ofs;
+		while (len_end < p_len && p_packet[len_end])
+			len_end++;
+		if (len_end >= p_len)
+			return false;
+		r_name = String::utf8((const char *)&p_packet[ofs]);
+		ofs = len_end + 1;
+	}
+
+	int argc = p_packet[ofs++];
+	for (int i = 0; i < argc; i++) {
+		int vlen;
+		if (decode_variant(r_args[i], &p_packet[ofs], p_len - ofs, &vlen) != OK)
+			return false;
+		ofs += vlen;
+	}
+
+	return true;
+}
+
+static void replay(const Vector<RPCRecord> &p_stream, bool p_indexed, uint64_t &r_bytes, uint64_t &r_usec, bool &r_ok) {
+
+	//both ends already negotiated the name table
+	Map<StringName, int> name_ids;
+	Map<int, StringName> names;
+	for (int i = 0; rpc_names[i]; i++) {
+		name_ids[rpc_names[i]] = i + 1;
+		names[i + 1] = rpc_names[i];
+	}
+
+	Vector<uint8_t> packet;
+	Variant args[4];
+	StringName name;
+
+	r_bytes = 0;
+	r_ok = true;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < p_stream.size(); i++) {
+
+		const RPCRecord &r = p_stream[i];
+		int len = encode_rpc(r, p_indexed, name_ids, packet);
+		r_bytes += len;
+
+		if (!decode_rpc(packet.ptr(), len, p_indexed, names, name, args) || name != r.name)
+			r_ok = false;
+	}
+
+	r_usec = OS::get_singleton()->get_ticks_usec() - from;
+}
+
+// Sends bursts of small messages from an ENet client to a server on the
+// loopback, with and without batching, and checks all of them arrive.
+
+struct ENetRun {
+
+	uint64_t usec;
+	uint64_t packets;
+	uint64_t bytes;
+	int received;
+	bool ok;
+};
+
+static uint64_t enet_stat(Object *p_peer, int p_id, const char *p_stat) {
+
+	bool valid;
+	int stat = ClassDB::get_integer_constant("NetworkedMultiplayerENet", p_stat, &valid);
+	return p_peer->call("get_peer_statistic", p_id, stat);
+}
+
+static bool enet_run(int p_port, bool p_batching, int p_ticks, int p_messages, ENetRun &r_run) {
+
+	NetworkedMultiplayerPeer *server = Object::cast_to<NetworkedMultiplayerPeer>(ClassDB::instance("NetworkedMultiplayerENet"));
+	NetworkedMultiplayerPeer *client = Object::cast_to<NetworkedMultiplayerPeer>(ClassDB::instance("NetworkedMultiplayerENet"));
+	if (!server || !client)
+		return false;
+
+	Ref<NetworkedMultiplayerPeer> server_ref = server;
+	Ref<NetworkedMultiplayerPeer> client_ref = client;
+
+	if (int(server->call("create_server", p_port)) != OK || int(client->call("create_client", "127.0.0.1", p_port)) != OK)
+		return false;
+
+	uint64_t timeout = OS::get_singleton()->get_ticks_msec() + 5000;
+	while (client->get_connection_status() != NetworkedMultiplayerPeer::CONNECTION_CONNECTED) {
+		server->poll();
+		client->poll();
+		if (OS::get_singleton()->get_ticks_msec() > timeout)
+			return false;
+		OS::get_singleton()->delay_usec(1000);
+	}
+
+	client->set("batching", p_batching);
+	client->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+	client->set_target_peer(1);
+
+	uint8_t message[24];
+	r_run.received = 0;
+	r_run.ok = true;
+	r_run.usec = 0;
+
+	for (int t = 0; t < p_ticks; t++) {
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < p_messages; i++) {
+			encode_uint32(t * p_messages + i, message);
+			client->put_packet(message, sizeof(message));
+		}
+		client->poll();
+		r_run.usec += OS::get_singleton()->get_ticks_usec() - from;
+
+		server->poll();
+		while (server->get_available_packet_count()) {
+			const uint8_t *packet;
+			int len;
+			server->get_packet(&packet, len);
+			if (len != sizeof(message) || decode_uint32(packet) != uint32_t(r_run.received))
+				r_run.ok = false;
+			r_run.received++;
+		}
+	}
+
+	timeout = OS::get_singleton()->get_ticks_msec() + 5000;
+	while (r_run.received < p_ticks * p_messages && OS::get_singleton()->get_ticks_msec() < timeout) {
+		client->poll();
+		server->poll();
+		while (server->get_available_packet_count()) {
+			const uint8_t *packet;
+			int len;
+			server->get_packet(&packet, len);
+			if (len != sizeof(message) || decode_uint32(packet) != uint32_t(r_run.received))
+				r_run.ok = false;
+			r_run.received++;
+		}
+		OS::get_singleton()->delay_usec(1000);
+	}
+
+	r_run.packets = enet_stat(client, 1, "PEER_STAT_PACKETS_SENT");
+	r_run.bytes = enet_stat(client, 1, "PEER_STAT_BYTES_SENT");
+	if (r_run.received != p_ticks * p_messages || enet_stat(server, client->get_unique_id(), "PEER_STAT_MESSAGES_RECEIVED") != uint64_t(r_run.received))
+		r_run.ok = false;
+
+	client->call("close_connection");
+	server->call("close_connection");
+
+	return true;
+}
+
+static void test_enet_batching() {
+
+	const int ticks = 20;
+	const int messages = 2000;
+
+	if (!ClassDB::class_exists("NetworkedMultiplayerENet")) {
+		OS::get_singleton()->print("ENet batching: module not available, skipped\n");
+		return;
+	}
+
+	OS::get_singleton()->print("ENet batching: %d ticks of %d messages\n", ticks, messages);
+
+	for (int i = 0; i < 2; i++) {
+
+		ENetRun run;
+		if (!enet_run(24510 + i, i == 1, ticks, messages, run)) {
+			OS::get_singleton()->print("\tcould not connect on the loopback, skipped\n");
+			return;
+		}
+
+		OS::get_singleton()->print("\t%s %8.3f msec per tick, %6d packets, %8d bytes sent, %d received %s\n",
+				i ? "batched:  " : "unbatched:", run.usec / 1000.0 / ticks, int(run.packets), int(run.bytes), run.received, run.ok ? "OK" : "FAIL");
+	}
+}
+
+// Keeps thousands of idle loopback TCP connections next to a few active ones
+// and compares asking every connection for data against a TCP_Poller.
+
+static int tcp_read_all(StreamPeerTCP *p_peer, uint8_t *p_buffer) {
+
+	int total = 0;
+	int received;
+	while (p_peer->get_partial_data(p_buffer, 64, received) == OK && received > 0) {
+		total += received;
+	}
+	return total;
+}
+
+static void test_tcp_poller() {
+
+	const int idle = 5000;
+	const int active = 100;
+	const int ticks = 200;
+	const uint16_t port = 24520;
+
+	Ref<TCP_Poller> poller = TCP_Poller::create_ref();
+	Ref<TCP_Server> server = TCP_Server::create_ref();
+	if (poller.is_null() || server.is_null() || server->listen(port, IP_Address("127.0.0.1")) != OK) {
+		OS::get_singleton()->print("TCP poller: not available, skipped\n");
+		return;
+	}
+
+	Vector<Ref<StreamPeerTCP> > clients;
+	Vector<Ref<StreamPeerTCP> > peers;
+
+	for (int i = 0; i < idle + active; i++) {
+
+		Ref<StreamPeerTCP> client = StreamPeerTCP::create_ref();
+		if (client->connect_to_host(IP_Address("127.0.0.1"), port) != OK)
+			break;
+
+		uint64_t timeout = OS::get_singleton()->get_ticks_msec() + 1000;
+		while (!server->is_connection_available() && OS::get_singleton()->get_ticks_msec() < timeout) {
+			OS::get_singleton()->delay_usec(100);
+		}
+		if (!server->is_connection_available())
+			break;
+
+		Ref<StreamPeerTCP> peer = server->take_connection();
+		peer->get_status(); //finish connecting
+		client->get_status();
+		clients.push_back(client);
+		peers.push_back(peer);
+	}
+
+	if (peers.size() < idle + active) {
+		OS::get_singleton()->print("TCP poller: only %d connections could be made, skipped\n", peers.size());
+		return;
+	}
+
+	for (int i = 0; i < peers.size(); i++) {
+		poller->add_peer(peers[i]);
+	}
+
+	OS::get_singleton()->print("TCP poller: %d idle and %d active connections, %d ticks\n", idle, active, ticks);
+
+	uint8_t message[16] = {};
+	uint8_t buffer[64];
+
+	for (int mode = 0; mode < 2; mode++) {
+
+		uint64_t usec = 0;
+		int received = 0;
+
+		for (int t = 0; t < ticks; t++) {
+
+			for (int i = 0; i < active; i++) {
+				clients[(t * 37 + i * (idle / active)) % clients.size()]->put_data(message, sizeof(message));
+			}
+
+			uint64_t from = OS::get_singleton()->get_ticks_usec();
+
+			if (mode == 0) {
+				for (int i = 0; i < peers.size(); i++) {
+					if (peers[i]->get_available_bytes() > 0)
+						received += tcp_read_all(peers[i].ptr(), buffer);
+				}
+			} else {
+				int ready = poller->wait(0);
+				for (int i = 0; i < ready; i++) {
+					Ref<StreamPeerTCP> peer = poller->get_ready(i);
+					received += tcp_read_all(peer.ptr(), buffer);
+				}
+			}
+
+			usec += OS::get_singleton()->get_ticks_usec() - from;
+		}
+
+		bool ok = received == ticks * active * int(sizeof(message));
+		OS::get_singleton()->print("\t%s %8.3f msec per tick, %d bytes received %s\n",
+				mode ? "poller:     " : "every peer: ", usec / 1000.0 / ticks, received, ok ? "OK" : "FAIL");
+	}
+
+	poller->clear();
+}
+
+// A polled client is closed and then connects again, usually getting the same
+// descriptor back. The poller must report both changes and keep watching the
+// new connection.
+
+static Ref<StreamPeerTCP> tcp_accept(TCP_Server *p_server) {
+
+	uint64_t timeout = OS::get_singleton()->get_ticks_msec() + 1000;
+	while (!p_server->is_connection_available() && OS::get_singleton()->get_ticks_msec() < timeout) {
+		OS::get_singleton()->delay_usec(100);
+	}
+	if (!p_server->is_connection_available())
+		return Ref<StreamPeerTCP>();
+
+	Ref<StreamPeerTCP> peer = p_server->take_connection();
+	peer->get_status();
+	return peer;
+}
+
+static void test_tcp_poller_reconnect() {
+
+	const uint16_t port = 24521;
+
+	Ref<TCP_Poller> poller = TCP_Poller::create_ref();
+	Ref<TCP_Server> server = TCP_Server::create_ref();
+	if (poller.is_null() || server.is_null() || server->listen(port, IP_Address("127.0.0.1")) != OK) {
+		OS::get_singleton()->print("TCP poller reconnect: not available, skipped\n");
+		return;
+	}
+
+	Ref<StreamPeerTCP> client = StreamPeerTCP::create_ref();
+	client->connect_to_host(IP_Address("127.0.0.1"), port);
+	Ref<StreamPeerTCP> peer = tcp_accept(server.ptr());
+	if (peer.is_null()) {
+		OS::get_singleton()->print("TCP poller reconnect: could not connect, skipped\n");
+		return;
+	}
+	client->get_status();
+	poller->add_peer(client);
+
+	bool ok = poller->wait(0) == 0;
+
+	// closed, reported once
+	client->disconnect_from_host();
+	ok = ok && poller->wait(0) == 1 && poller->get_ready(0).ptr() == client.ptr();
+	ok = ok && poller->wait(0) == 0;
+
+	// connected again, reported once and then watched for data
+	client->connect_to_host(IP_Address("127.0.0.1"), port);
+	Ref<StreamPeerTCP> new_peer = tcp_accept(server.ptr());
+	client->get_status();
+	ok = ok && new_peer.is_valid() && poller->wait(0) == 1 && poller->get_ready(0).ptr() == client.ptr();
+
+	uint8_t message[4] = { 1, 2, 3, 4 };
+	new_peer->put_data(message, sizeof(message));
+	ok = ok && poller->wait(1000) == 1 && poller->get_ready(0).ptr() == client.ptr();
+
+	uint8_t buffer[64];
+	ok = ok && tcp_read_all(client.ptr(), buffer) == int(sizeof(message)) && poller->wait(0) == 0;
+
+	OS::get_singleton()->print("TCP poller reconnect: %s\n", ok ? "OK" : "FAIL");
+
+	poller->clear();
+}
+
+MainLoop *test() {
+
+	const int players = 64;
+	const int records = 200000;
+
+	Vector<RPCRecord> stream = make_stream(players, records);
+
+	uint64_t name_bytes, name_usec, id_bytes, id_usec;
+	bool name_ok, id_ok;
+
+	replay(stream, false, name_bytes, name_usec, name_ok);
+	replay(stream, true, id_bytes, id_usec, id_ok);
+
+	OS::get_singleton()->print("RPC stream: %d calls from %d players\n", records, players);
+	OS::get_singleton()->print("\tname strings: %8d bytes (%.1f per call), %8.2f msec encode+decode %s\n",
+			int(name_bytes), name_bytes / double(records), name_usec / 1000.0, name_ok ? "OK" : "FAIL");
+	OS::get_singleton()->print("\tname ids:     %8d bytes (%.1f per call), %8.2f msec encode+decode %s\n",
+			int(id_bytes), id_bytes / double(records), id_usec / 1000.0, id_ok ? "OK" : "FAIL");
+	OS::get_singleton()->print("\tbandwidth saved: %.1f%%\n", name_bytes ? 100.0 * (name_bytes - id_bytes) / double(name_bytes) : 0.0);
+
+	test_enet_batching();
+	test_tcp_poller();
+	test_tcp_poller_reconnect();
+
+	return NULL;
+}
+} // namespace TestNetwork
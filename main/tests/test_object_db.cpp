@@ -0,0 +1,188 @@
+/*************************************************************************/
+/*  test_object_db.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "test_object_db.h"
+
+#include "hash_map.h"
+#include "object.h"
+#include "os/os.h"
+#include "os/thread.h"
+
+namespace TestObjectDB {
+
+// Creates and frees objects from several threads, like bullets spawned and
+// destroyed every frame, while other objects are looked up by ID. The same
+// lookups are also timed against a HashMap behind a RWLock, which is how
+// ObjectDB used to store instances.
+
+static const int live_count = 4096;
+static const int churn_per_thread = 100000;
+static const int lookups_per_thread = 1000000;
+
+struct Context {
+
+	Vector<ObjectID> live;
+	HashMap<ObjectID, Object *> map;
+	RWLock *map_lock;
+	bool failed;
+};
+
+struct Worker {
+
+	Context *context;
+	int index;
+	Thread *thread;
+};
+
+static void churn(void *p_userdata) {
+
+	Worker *w = (Worker *)p_userdata;
+
+	for (int i = 0; i < churn_per_thread; i++) {
+
+		Object *obj = memnew(Object);
+		ObjectID id = obj->get_instance_id();
+		if (ObjectDB::get_instance(id) != obj) {
+			w->context->failed = true;
+		}
+		memdelete(obj);
+		if (ObjectDB::get_instance(id)) {
+			w->context->failed = true; // IDs of freed objects never match
+		}
+	}
+}
+
+static void lookup(void *p_userdata) {
+
+	Worker *w = (Worker *)p_userdata;
+	Context *c = w->context;
+	uint32_t seed = w->index * 7919 + 1;
+
+	for (int i = 0; i < lookups_per_thread; i++) {
+
+		seed = seed * 1664525 + 1013904223;
+		if (!ObjectDB::get_instance(c->live[(seed >> 8) % live_count])) {
+			c->failed = true;
+		}
+	}
+}
+
+static void lookup_map(void *p_userdata) {
+
+	Worker *w = (Worker *)p_userdata;
+	Context *c = w->context;
+	uint32_t seed = w->index * 7919 + 1;
+
+	for (int i = 0; i < lookups_per_thread; i++) {
+
+		seed = seed * 1664525 + 1013904223;
+		c->map_lock->read_lock();
+		Object **obj = c->map.getptr(c->live[(seed >> 8) % live_count]);
+		c->map_lock->read_unlock();
+		if (!obj) {
+			c->failed = true;
+		}
+	}
+}
+
+static uint64_t run(Context &p_context, int p_threads, void (*p_func)(void *)) {
+
+	Vector<Worker> workers;
+	workers.resize(p_threads);
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < p_threads; i++) {
+		Worker &w = workers.ptrw()[i];
+		w.context = &p_context;
+		w.index = i;
+		w.thread = Thread::create(p_func, &w);
+	}
+
+	for (int i = 0; i < p_threads; i++) {
+		Thread::wait_to_finish(workers[i].thread);
+		memdelete(workers[i].thread);
+	}
+
+	return OS::get_singleton()->get_ticks_usec() - from;
+}
+
+MainLoop *test() {
+
+	Context context;
+	context.failed = false;
+	context.map_lock = RWLock::create();
+
+	Vector<Object *> objects;
+	for (int i = 0; i < live_count; i++) {
+		Object *obj = memnew(Object);
+		objects.push_back(obj);
+		context.live.push_back(obj->get_instance_id());
+		context.map[obj->get_instance_id()] = obj;
+	}
+
+	for (int threads = 1; threads <= 8; threads *= 2) {
+
+		uint64_t churn_usec = run(context, threads, churn);
+		uint64_t map_usec = run(context, threads, lookup_map);
+		uint64_t lookup_usec = run(context, threads, lookup);
+
+		OS::get_singleton()->print("%d threads: churn %.2f M objects/s, lookups: locked map %.1f M/s, slots %.1f M/s\n",
+				threads,
+				double(threads) * churn_per_thread / churn_usec,
+				double(threads) * lookups_per_thread / map_usec,
+				double(threads) * lookups_per_thread / lookup_usec);
+	}
+
+	// a freed object's ID stays dead while its slot is reused
+	ObjectID old_id = objects[0]->get_instance_id();
+	memdelete(objects[0]);
+	bool reused = true;
+	for (int i = 0; i < churn_per_thread; i++) {
+		Object *obj = memnew(Object);
+		ObjectID id = obj->get_instance_id();
+		if (id == old_id || ObjectDB::get_instance(old_id)) {
+			reused = false;
+		}
+		memdelete(obj);
+	}
+	objects.set(0, memnew(Object));
+
+	for (int i = 0; i < objects.size(); i++) {
+		memdelete(objects[i]);
+	}
+	memdelete(context.map_lock);
+
+	OS::get_singleton()->print("Instance IDs: %s\n", !context.failed && reused ? "OK" : "FAIL");
+
+	return NULL;
+}
+} // namespace TestObjectDB
@@ -0,0 +1,391 @@
+/*************************************************************************/
+/*  test_pack.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_pack.h"
+
+#include "io/file_access_pack.h"
+#include "io/pck_packer.h"
+#include "os/dir_access.h"
+#include "os/os.h"
+#include "os/threaded_array_processor.h"
+
+namespace TestPack {
+
+// Loads every file of a large pack: streamed through a FileAccess on the
+// pack like before packs were mapped, copied out of the mapping with
+// get_buffer() and read in place with get_buffer_ptr(), from one and several
+// threads. The pack was just written, so all passes read from a warm cache.
+
+static const int file_count = 256;
+static const int file_size = 256 * 1024;
+
+static String file_path(int p_index) {
+
+	return "res://test_pack/" + itos(p_index) + ".bin";
+}
+
+static uint8_t file_byte(int p_index, int p_offset) {
+
+	return (p_index * 31 + p_offset * 7 + (p_offset >> 12)) & 0xFF;
+}
+
+static bool check_file(int p_index, const uint8_t *p_data, int p_len) {
+
+	if (p_len != file_size)
+		return false;
+
+	for (int i = 0; i < file_size; i += 4093) {
+		if (p_data[i] != file_byte(p_index, i))
+			return false;
+	}
+
+	return p_data[file_size - 1] == file_byte(p_index, file_size - 1);
+}
+
+static bool load_file(int p_index, bool p_in_place, Vector<uint8_t> &r_buffer) {
+
+	FileAccess *f = FileAccess::open(file_path(p_index), FileAccess::READ);
+	if (!f)
+		return false;
+
+	int len = f->get_len();
+	const uint8_t *data = p_in_place ? f->get_buffer_ptr(len) : NULL;
+	if (!data) {
+		r_buffer.resize(len);
+		f->get_buffer(r_buffer.ptrw(), len);
+		data = r_buffer.ptr();
+	}
+
+	bool ok = check_file(p_index, data, len);
+	memdelete(f);
+
+	return ok;
+}
+
+// The file list as stored in the pack, to open files the way unmapped packs do.
+static bool read_file_list(const String &p_pack, Vector<PackedData::PackedFile> &r_files) {
+
+	FileAccess *f = FileAccess::open(p_pack, FileAccess::READ);
+	if (!f)
+		return false;
+
+	f->seek(4 * 5 + 4 * 16); //magic, versions, reserved
+	int count = f->get_32();
+	bool ok = count == file_count;
+
+	r_files.resize(count);
+	for (int i = 0; i < count && ok; i++) {
+
+		uint32_t sl = f->get_32();
+		CharString cs;
+		cs.resize(sl + 1);
+		f->get_buffer((uint8_t *)cs.ptrw(), sl);
+		cs.ptrw()[sl] = 0;
+
+		PackedData::PackedFile &pf = r_files.ptrw()[i];
+		pf.pack = p_pack;
+		pf.offset = f->get_64();
+		pf.size = f->get_64();
+		f->get_buffer(pf.md5, 16);
+		pf.src = NULL;
+
+		ok = String::utf8(cs.ptr()) == file_path(i);
+	}
+
+	memdelete(f);
+	return ok;
+}
+
+static bool streamed_load_pass(const Vector<PackedData::PackedFile> &p_files, uint64_t &r_usec) {
+
+	Vector<uint8_t> buffer;
+	bool ok = true;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < file_count; i++) {
+
+		FileAccess *f = memnew(FileAccessPack(file_path(i), p_files[i]));
+		int len = f->get_len();
+		buffer.resize(len);
+		f->get_buffer(buffer.ptrw(), len);
+		ok = check_file(i, buffer.ptr(), len) && ok;
+		memdelete(f);
+	}
+	r_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	return ok;
+}
+
+static bool load_pass(bool p_in_place, uint64_t &r_usec) {
+
+	Vector<uint8_t> buffer;
+	bool ok = true;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < file_count; i++) {
+		ok = load_file(i, p_in_place, buffer) && ok;
+	}
+	r_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	return ok;
+}
+
+struct ThreadedLoad {
+
+	Vector<uint8_t> failed;
+
+	void load(uint32_t p_index, bool p_in_place) {
+
+		Vector<uint8_t> buffer;
+		failed[p_index] = !load_file(p_index, p_in_place, buffer);
+	}
+};
+
+static bool threaded_load_pass(bool p_in_place, uint64_t &r_usec) {
+
+	ThreadedLoad loader;
+	loader.failed.resize(file_count);
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	thread_process_array(file_count, &loader, &ThreadedLoad::load, p_in_place);
+	r_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	for (int i = 0; i < file_count; i++) {
+		if (loader.failed[i])
+			return false;
+	}
+	return true;
+}
+
+static Error make_pack(const String &p_dir, const String &p_pack) {
+
+	Vector<uint8_t> data;
+	data.resize(file_size);
+
+	PCKPacker packer;
+	Error err = packer.pck_start(p_pack, 0);
+	if (err != OK)
+		return err;
+
+	for (int i = 0; i < file_count; i++) {
+
+		uint8_t *w = data.ptrw();
+		for (int j = 0; j < file_size; j++) {
+			w[j] = file_byte(i, j);
+		}
+
+		String src = p_dir.plus_file(itos(i) + ".bin");
+		FileAccess *f = FileAccess::open(src, FileAccess::WRITE);
+		if (!f)
+			return ERR_CANT_CREATE;
+		f->store_buffer(data.ptr(), file_size);
+		memdelete(f);
+
+		packer.add_file(file_path(i), src);
+	}
+
+	err = packer.flush();
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	for (int i = 0; i < file_count; i++) {
+		da->remove(p_dir.plus_file(itos(i) + ".bin"));
+	}
+	memdelete(da);
+
+	return err;
+}
+
+// Mounts a pack of many small files through its prebuilt index and, for
+// comparison, a pack with the index flag cleared, read like an old pack. The
+// two packs use different roots, so each one is checked on its own.
+
+static const int index_file_count = 20000;
+static const int index_dir_count = 100;
+
+static String index_path(const String &p_root, int p_index) {
+
+	return p_root + "/" + itos(p_index % index_dir_count) + "/" + itos(p_index) + ".txt";
+}
+
+static Error make_index_pack(const String &p_dir, const String &p_pack, const String &p_root, bool p_clear_flags) {
+
+	String src = p_dir.plus_file("index.txt");
+	FileAccess *f = FileAccess::open(src, FileAccess::WRITE);
+	if (!f)
+		return ERR_CANT_CREATE;
+	f->store_string("index test");
+	memdelete(f);
+
+	PCKPacker packer;
+	Error err = packer.pck_start(p_pack, 0);
+	if (err != OK)
+		return err;
+	for (int i = 0; i < index_file_count; i++) {
+		packer.add_file(index_path(p_root, i), src);
+	}
+	err = packer.flush();
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(src);
+	memdelete(da);
+
+	if (err != OK || !p_clear_flags)
+		return err;
+
+	f = FileAccess::open(p_pack, FileAccess::READ_WRITE);
+	if (!f)
+		return ERR_CANT_OPEN;
+	f->seek(PACK_HEADER_FLAGS_OFFSET);
+	f->store_32(0);
+	memdelete(f);
+
+	return OK;
+}
+
+static bool check_index_paths(const String &p_root) {
+
+	for (int i = 0; i < index_file_count; i++) {
+		if (!PackedData::get_singleton()->has_path(index_path(p_root, i)))
+			return false;
+	}
+
+	if (PackedData::get_singleton()->has_path(p_root + "/missing.txt"))
+		return false;
+
+	FileAccess *f = FileAccess::open(index_path(p_root, index_file_count / 2), FileAccess::READ);
+	if (!f)
+		return false;
+	String text = f->get_line();
+	memdelete(f);
+
+	return text == "index test";
+}
+
+static bool check_index_dir() {
+
+	DirAccess *da = memnew(DirAccessPack);
+	int found = 0;
+
+	if (da->change_dir("res://test_index/7") == OK && da->list_dir_begin() == OK) {
+		String name = da->get_next();
+		while (name != String()) {
+			found++;
+			name = da->get_next();
+		}
+		da->list_dir_end();
+	}
+	memdelete(da);
+
+	return found == index_file_count / index_dir_count;
+}
+
+static void test_index(const String &p_dir) {
+
+	String pack = p_dir.plus_file("index.pck");
+	String old_pack = p_dir.plus_file("index_old.pck");
+
+	if (make_index_pack(p_dir, pack, "res://test_index", false) != OK || make_index_pack(p_dir, old_pack, "res://test_index_old", true) != OK) {
+		OS::get_singleton()->print("Could not create the index test packs in %s\n", p_dir.utf8().get_data());
+		return;
+	}
+
+	OS::get_singleton()->print("Index: %d files in %d dirs\n", index_file_count, index_dir_count);
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	bool ok = PackedData::get_singleton()->add_pack(old_pack) == OK;
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - from;
+	ok = ok && check_index_paths("res://test_index_old") && !PackedData::get_singleton()->has_path(index_path("res://test_index", 0));
+	OS::get_singleton()->print("\t%-28s %8.2f msec %s\n", "mount, file list:", usec / 1000.0, ok ? "OK" : "FAIL");
+
+	from = OS::get_singleton()->get_ticks_usec();
+	ok = PackedData::get_singleton()->add_pack(pack) == OK;
+	usec = OS::get_singleton()->get_ticks_usec() - from;
+	ok = ok && check_index_paths("res://test_index");
+	OS::get_singleton()->print("\t%-28s %8.2f msec %s\n", "mount, index:", usec / 1000.0, ok ? "OK" : "FAIL");
+
+	from = OS::get_singleton()->get_ticks_usec();
+	ok = check_index_dir();
+	usec = OS::get_singleton()->get_ticks_usec() - from;
+	OS::get_singleton()->print("\t%-28s %8.2f msec %s\n", "first directory listing:", usec / 1000.0, ok ? "OK" : "FAIL");
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(pack);
+	da->remove(old_pack);
+	memdelete(da);
+}
+
+static void print_pass(const char *p_name, bool p_ok, uint64_t p_usec) {
+
+	double mb = double(file_count) * file_size / (1024 * 1024);
+	OS::get_singleton()->print("\t%-28s %8.2f msec, %8.1f MiB/s %s\n", p_name, p_usec / 1000.0, mb / (p_usec / 1000000.0), p_ok ? "OK" : "FAIL");
+}
+
+MainLoop *test() {
+
+	String dir = OS::get_singleton()->get_user_data_dir().plus_file("test_pack");
+	String pack = dir.plus_file("test.pck");
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->make_dir_recursive(dir);
+	memdelete(da);
+
+	if (make_pack(dir, pack) != OK || !PackedData::get_singleton() || PackedData::get_singleton()->add_pack(pack) != OK) {
+		OS::get_singleton()->print("Could not create the test pack in %s\n", dir.utf8().get_data());
+		return NULL;
+	}
+
+	OS::get_singleton()->print("Pack: %d files of %d KiB\n", file_count, file_size / 1024);
+
+	uint64_t usec;
+	bool ok;
+
+	Vector<PackedData::PackedFile> files;
+	ok = read_file_list(pack, files) && streamed_load_pass(files, usec);
+	print_pass("streamed:", ok, usec);
+	ok = load_pass(false, usec);
+	print_pass("copied from the mapping:", ok, usec);
+	ok = load_pass(true, usec);
+	print_pass("in place:", ok, usec);
+	ok = threaded_load_pass(false, usec);
+	print_pass("copied, threaded:", ok, usec);
+	ok = threaded_load_pass(true, usec);
+	print_pass("in place, threaded:", ok, usec);
+
+	test_index(dir);
+
+	//the mapping, if any, stays valid after the file is gone
+	da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(pack);
+	da->remove(dir);
+	memdelete(da);
+
+	return NULL;
+}
+} // namespace TestPack
@@ -36,6 +36,10 @@
 #include "os/os.h"
 #include "print_string.h"
 #include "quick_hull.h"
+#include "servers/physics/body_sw.h"
+#include "servers/physics/broad_phase_basic.h"
+#include "servers/physics/broad_phase_bvh.h"
+#include "servers/physics/broad_phase_octree.h"
 #include "servers/physics_server.h"
 #include "servers/visual_server.h"
 
@@ -436,4 +440,134 @@ MainLoop *test() {
 
 	return memnew(TestPhysicsMainLoop);
 }
+
+struct BroadPhaseBenchmark {
+
+	uint32_t pair_events;
+
+	static void *_pair_callback(CollisionObjectSW *p_object_A, int p_subindex_A, CollisionObjectSW *p_object_B, int p_subindex_B, void *p_userdata) {
+
+		((BroadPhaseBenchmark *)p_userdata)->pair_events++;
+		return NULL;
+	}
+
+	static void _unpair_callback(CollisionObjectSW *p_object_A, int p_subindex_A, CollisionObjectSW *p_object_B, int p_subindex_B, void *p_data, void *p_userdata) {
+
+		((BroadPhaseBenchmark *)p_userdata)->pair_events++;
+	}
+
+	// Boxes of one to two units moving through a cube sized to keep a few overlaps each, p_static_ratio of them never move.
+	void run(const char *p_name, BroadPhaseSW::CreateFunction p_create, int p_bodies, real_t p_static_ratio, int p_frames) {
+
+		BroadPhaseSW *bp = p_create();
+		bp->set_pair_callback(_pair_callback, this);
+		bp->set_unpair_callback(_unpair_callback, this);
+		pair_events = 0;
+
+		Math::seed(1234);
+
+		real_t size = Math::pow((real_t)p_bodies, (real_t)(1.0 / 3.0)) * 4;
+		Vector<BodySW *> bodies;
+		Vector<BroadPhaseSW::ID> ids;
+		Vector<AABB> aabbs;
+		Vector<Vector3> velocities;
+		Vector<bool> statics;
+		bodies.resize(p_bodies);
+		ids.resize(p_bodies);
+		aabbs.resize(p_bodies);
+		velocities.resize(p_bodies);
+		statics.resize(p_bodies);
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < p_bodies; i++) {
+
+			bodies[i] = memnew(BodySW);
+			ids[i] = bp->create(bodies[i]);
+			statics[i] = Math::randf() < p_static_ratio;
+			aabbs[i] = AABB(Vector3(Math::randf(), Math::randf(), Math::randf()) * size, Vector3(1, 1, 1) * (1 + Math::randf()));
+			velocities[i] = Vector3(Math::randf() - 0.5, Math::randf() - 0.5, Math::randf() - 0.5) * 0.2;
+			bp->set_static(ids[i], statics[i]);
+			bp->move(ids[i], aabbs[i]);
+		}
+		bp->update();
+
+		uint64_t insert_time = OS::get_singleton()->get_ticks_usec() - from;
+		uint32_t moves = 0;
+
+		from = OS::get_singleton()->get_ticks_usec();
+
+		for (int f = 0; f < p_frames; f++) {
+
+			for (int i = 0; i < p_bodies; i++) {
+
+				if (statics[i])
+					continue;
+
+				AABB &aabb = aabbs[i];
+				aabb.position += velocities[i];
+				for (int j = 0; j < 3; j++) {
+					if (aabb.position[j] < 0 || aabb.position[j] > size)
+						velocities[i][j] = -velocities[i][j];
+				}
+				bp->move(ids[i], aabb);
+				moves++;
+			}
+
+			bp->update();
+		}
+
+		uint64_t move_time = OS::get_singleton()->get_ticks_usec() - from;
+
+		CollisionObjectSW *results[256];
+		int result_indices[256];
+		const int queries = 10000;
+		int hits = 0;
+
+		from = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < queries; i++) {
+
+			Vector3 pos = Vector3(Math::randf(), Math::randf(), Math::randf()) * size;
+			hits += bp->cull_point(pos, results, 256, result_indices);
+			hits += bp->cull_segment(pos, pos + Vector3(4, -2, 3), results, 256, result_indices);
+			hits += bp->cull_aabb(AABB(pos, Vector3(2, 2, 2)), results, 256, result_indices);
+		}
+
+		uint64_t query_time = OS::get_singleton()->get_ticks_usec() - from;
+
+		for (int i = 0; i < p_bodies; i++) {
+			bp->remove(ids[i]);
+			memdelete(bodies[i]);
+		}
+
+		memdelete(bp);
+
+		OS::get_singleton()->print("%-7s %6d bodies, %3d%% static: insert %8.3f usec/body, step %10.2f usec (%7.3f usec/move, %d pair events), query %7.3f usec (%d hits)\n",
+				p_name, p_bodies, int(p_static_ratio * 100), insert_time / (double)p_bodies, move_time / (double)MAX(p_frames, 1),
+				move_time / (double)MAX(moves, 1u), pair_events, query_time / (double)(queries * 3), hits);
+	}
+
+	void compare(int p_bodies, real_t p_static_ratio, int p_frames, bool p_include_basic) {
+
+		if (p_include_basic) {
+			run("Basic", BroadPhaseBasic::_create, p_bodies, p_static_ratio, p_frames);
+		}
+		run("Octree", BroadPhaseOctree::_create, p_bodies, p_static_ratio, p_frames);
+		run("BVH", BroadPhaseBVH::_create, p_bodies, p_static_ratio, p_frames);
+	}
+};
+
+MainLoop *test_broad_phase() {
+
+	BroadPhaseBenchmark benchmark;
+
+	// BroadPhaseBasic pairs everything against everything on update, only try it on small scenes.
+	benchmark.compare(1000, 0.1, 50, true);
+	benchmark.compare(1000, 0.9, 50, true);
+	benchmark.compare(20000, 0.1, 50, false);
+	benchmark.compare(20000, 0.9, 50, false);
+
+	return NULL;
+}
 } // namespace TestPhysics
@@ -40,6 +40,7 @@
 namespace TestPhysics {
 
 MainLoop *test();
-}
+MainLoop *test_broad_phase();
+} // namespace TestPhysics
 
 #endif
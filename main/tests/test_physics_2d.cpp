@@ -35,6 +35,8 @@
 #include "os/os.h"
 #include "print_string.h"
 #include "scene/resources/texture.h"
+#include "servers/physics_2d/broad_phase_2d_basic.h"
+#include "servers/physics_2d/broad_phase_2d_hash_grid.h"
 #include "servers/physics_2d_server.h"
 #include "servers/visual_server.h"
 
@@ -432,4 +434,213 @@ MainLoop *test() {
 
 	return memnew(TestPhysics2DMainLoop);
 }
+
+struct BroadPhaseBenchmark {
+
+	uint32_t pair_events;
+	uint32_t colliding;
+
+	static void *_pair_callback(CollisionObject2DSW *p_object_A, int p_subindex_A, CollisionObject2DSW *p_object_B, int p_subindex_B, void *p_userdata) {
+
+		BroadPhaseBenchmark *self = (BroadPhaseBenchmark *)p_userdata;
+		self->pair_events++;
+		self->colliding++;
+		return NULL;
+	}
+
+	static void _unpair_callback(CollisionObject2DSW *p_object_A, int p_subindex_A, CollisionObject2DSW *p_object_B, int p_subindex_B, void *p_data, void *p_userdata) {
+
+		BroadPhaseBenchmark *self = (BroadPhaseBenchmark *)p_userdata;
+		self->pair_events++;
+		self->colliding--;
+	}
+
+	void run(const char *p_name, BroadPhase2DSW *(*p_create)(), int p_bodies, int p_frames, real_t p_spacing = 40) {
+
+		pair_events = 0;
+		colliding = 0;
+
+		BroadPhase2DSW *bp = p_create();
+		Math::seed(0x8a5cd789); // the same scene for every broad phase compared
+		bp->set_pair_callback(_pair_callback, this);
+		bp->set_unpair_callback(_unpair_callback, this);
+
+		// Small bodies moving around an area sized by their spacing, one in eight static.
+		real_t area = Math::sqrt((real_t)p_bodies) * p_spacing;
+		Vector<BroadPhase2DSW::ID> ids;
+		Vector<Rect2> rects;
+		Vector<Vector2> velocities;
+		ids.resize(p_bodies);
+		rects.resize(p_bodies);
+		velocities.resize(p_bodies);
+
+		// The broad phase only compares owners, never dereferences them.
+		Vector<int> owners;
+		owners.resize(p_bodies);
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < p_bodies; i++) {
+
+			ids[i] = bp->create((CollisionObject2DSW *)&owners[i]);
+			rects[i] = Rect2(Math::randf() * area, Math::randf() * area, Math::random(16, 32), Math::random(16, 32));
+			velocities[i] = Vector2(Math::random(-10, 10), Math::random(-10, 10));
+			if ((i & 7) == 0)
+				bp->set_static(ids[i], true);
+			bp->move(ids[i], rects[i]);
+		}
+
+		uint64_t insert_time = OS::get_singleton()->get_ticks_usec() - from;
+		uint32_t moves = 0;
+		pair_events = 0;
+
+		from = OS::get_singleton()->get_ticks_usec();
+
+		for (int f = 0; f < p_frames; f++) {
+
+			for (int i = 0; i < p_bodies; i++) {
+
+				if ((i & 7) == 0)
+					continue;
+
+				Rect2 &r = rects[i];
+				r.position += velocities[i];
+				if (r.position.x < 0 || r.position.x > area)
+					velocities[i].x = -velocities[i].x;
+				if (r.position.y < 0 || r.position.y > area)
+					velocities[i].y = -velocities[i].y;
+				bp->move(ids[i], r);
+				moves++;
+			}
+
+			bp->update(); // pairs are only found here by BroadPhase2DBasic
+		}
+
+		uint64_t move_time = OS::get_singleton()->get_ticks_usec() - from;
+
+		CollisionObject2DSW *results[256];
+		int result_indices[256];
+		int culled = 0;
+
+		from = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < 10000; i++) {
+			Vector2 pos(Math::randf() * area, Math::randf() * area);
+			culled += bp->cull_aabb(Rect2(pos, Vector2(200, 200)), results, 256, result_indices);
+		}
+
+		uint64_t cull_time = OS::get_singleton()->get_ticks_usec() - from;
+
+		from = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < p_bodies; i++) {
+			bp->remove(ids[i]);
+		}
+
+		uint64_t remove_time = OS::get_singleton()->get_ticks_usec() - from;
+
+		memdelete(bp);
+
+		OS::get_singleton()->print("%-9s %6d bodies: insert %8.3f usec/body, move %6.3f usec/move (%d pair events, %d colliding at end), cull %7.3f usec/query (%d hits), remove %6.3f usec/body\n",
+				p_name, p_bodies, insert_time / (double)p_bodies, move_time / (double)MAX(moves, 1u), pair_events, colliding,
+				cull_time / 10000.0, culled, remove_time / (double)p_bodies);
+	}
+};
+
+// Receives area monitor events, which pass the body's instance ID.
+class AreaMonitor : public Object {
+
+	GDCLASS(AreaMonitor, Object);
+
+public:
+	ObjectID entered;
+
+	void _body_inout(int p_status, const RID &p_body, ObjectID p_instance, int p_body_shape, int p_area_shape) {
+
+		if (p_status == Physics2DServer::AREA_BODY_ADDED)
+			entered = p_instance;
+	}
+
+	static void _bind_methods() {
+
+		ClassDB::bind_method(D_METHOD("_body_inout"), &AreaMonitor::_body_inout);
+	}
+
+	AreaMonitor() { entered = 0; }
+};
+
+MainLoop *test_instance_ids() {
+
+	ClassDB::register_class<AreaMonitor>();
+
+	// Enough objects that instance IDs, and their slots, no longer fit in a byte.
+	Vector<Object *> filler;
+	for (int i = 0; i < 300; i++) {
+		filler.push_back(memnew(Object));
+	}
+
+	Object *body_owner = memnew(Object);
+	Object *area_owner = memnew(Object);
+	AreaMonitor *monitor = memnew(AreaMonitor);
+
+	Physics2DServer *ps = Physics2DServer::get_singleton();
+
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	RID shape = ps->circle_shape_create();
+	ps->shape_set_data(shape, 16);
+
+	RID area = ps->area_create();
+	ps->area_add_shape(area, shape);
+	ps->area_attach_object_instance_id(area, area_owner->get_instance_id());
+	ps->area_set_monitor_callback(area, monitor, "_body_inout");
+	ps->area_set_space(area, space);
+
+	RID body = ps->body_create();
+	ps->body_set_mode(body, Physics2DServer::BODY_MODE_KINEMATIC);
+	ps->body_attach_object_instance_id(body, body_owner->get_instance_id());
+	ps->body_set_space(body, space);
+	ps->body_add_shape(body, shape);
+
+	ps->step(0.016);
+	ps->flush_queries();
+
+	bool attached = ps->body_get_object_instance_id(body) == body_owner->get_instance_id();
+	bool overlap = monitor->entered == body_owner->get_instance_id() && ObjectDB::get_instance(monitor->entered) == body_owner;
+
+	Physics2DDirectSpaceState::RayResult ray;
+	bool hit = ps->space_get_direct_state(space)->intersect_ray(Vector2(-100, 0), Vector2(100, 0), ray);
+	bool collider = hit && ray.collider_id == body_owner->get_instance_id() && ray.collider == body_owner;
+
+	ps->free(body);
+	ps->free(area);
+	ps->free(shape);
+	ps->free(space);
+
+	memdelete(monitor);
+	memdelete(area_owner);
+	memdelete(body_owner);
+	for (int i = 0; i < filler.size(); i++) {
+		memdelete(filler[i]);
+	}
+
+	OS::get_singleton()->print("Body instance ID: %s, area overlap: %s, ray collider: %s\n",
+			attached ? "OK" : "FAIL", overlap ? "OK" : "FAIL", collider ? "OK" : "FAIL");
+
+	return NULL;
+}
+
+MainLoop *test_broad_phase() {
+
+	BroadPhaseBenchmark benchmark;
+	// BroadPhase2DBasic checks every pair on update, so it is only compared on the smallest scene.
+	benchmark.run("basic", BroadPhase2DBasic::_create, 1000, 200);
+	benchmark.run("hash grid", BroadPhase2DHashGrid::_create, 1000, 200);
+	benchmark.run("hash grid", BroadPhase2DHashGrid::_create, 10000, 100);
+	benchmark.run("hash grid", BroadPhase2DHashGrid::_create, 50000, 20);
+	// Many bodies sharing each cell.
+	benchmark.run("crowded", BroadPhase2DHashGrid::_create, 5000, 20, 4);
+
+	return NULL;
+}
 } // namespace TestPhysics2D
@@ -36,6 +36,8 @@
 namespace TestPhysics2D {
 
 MainLoop *test();
-}
+MainLoop *test_broad_phase();
+MainLoop *test_instance_ids();
+} // namespace TestPhysics2D
 
 #endif // TEST_PHYSICS_2D_H
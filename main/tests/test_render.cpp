@@ -30,12 +30,15 @@
 
 #include "test_render.h"
 
+#include "camera_matrix.h"
 #include "math_funcs.h"
 #include "os/keyboard.h"
 #include "os/main_loop.h"
 #include "os/os.h"
 #include "print_string.h"
 #include "quick_hull.h"
+#include "servers/visual/scenario_index_bvh.h"
+#include "servers/visual/scenario_index_octree.h"
 #include "servers/visual_server.h"
 
 #define OBJECT_COUNT 50
@@ -242,4 +245,123 @@ MainLoop *test() {
 
 	return memnew(TestMainLoop);
 }
+
+struct ScenarioIndexBenchmark {
+
+	uint32_t pair_events;
+
+	static void *_pair_callback(void *p_userdata, VisualServerScene::Instance *p_A, VisualServerScene::Instance *p_B) {
+
+		((ScenarioIndexBenchmark *)p_userdata)->pair_events++;
+		return NULL;
+	}
+
+	static void _unpair_callback(void *p_userdata, VisualServerScene::Instance *p_A, VisualServerScene::Instance *p_B, void *p_pair_data) {
+
+		((ScenarioIndexBenchmark *)p_userdata)->pair_events++;
+	}
+
+	// Meshes of one to three units with an omni light every hundred instances, p_moving of them move every frame.
+	void run(const char *p_name, ScenarioIndex::CreateFunction p_create, int p_instances, int p_moving, int p_frames) {
+
+		ScenarioIndex *index = p_create();
+		index->set_pair_callback(_pair_callback, this);
+		index->set_unpair_callback(_unpair_callback, this);
+		pair_events = 0;
+
+		Math::seed(1234);
+
+		real_t size = Math::pow((real_t)p_instances, (real_t)(1.0 / 3.0)) * 6;
+		Vector<VisualServerScene::Instance *> instances;
+		Vector<ScenarioIndex::ID> ids;
+		Vector<AABB> aabbs;
+		Vector<Vector3> velocities;
+		instances.resize(p_instances);
+		ids.resize(p_instances);
+		aabbs.resize(p_instances);
+		velocities.resize(p_instances);
+
+		for (int i = 0; i < p_instances; i++) {
+
+			VisualServerScene::Instance *instance = memnew(VisualServerScene::Instance);
+			bool light = i % 100 == 0;
+			instance->base_type = light ? VS::INSTANCE_LIGHT : VS::INSTANCE_MESH;
+			instances[i] = instance;
+
+			real_t extent = light ? 8 : 1 + Math::randf() * 2;
+			aabbs[i] = AABB(Vector3(Math::randf(), Math::randf(), Math::randf()) * size, Vector3(1, 1, 1) * extent);
+			velocities[i] = Vector3(Math::randf() - 0.5, Math::randf() - 0.5, Math::randf() - 0.5) * 0.4;
+			ids[i] = index->create(instance, aabbs[i], light, 1 << instance->base_type, light ? VS::INSTANCE_GEOMETRY_MASK : 0);
+		}
+		index->update();
+
+		CameraMatrix projection;
+		projection.set_perspective(70, 16.0 / 9.0, 0.05, size / 2);
+
+		uint64_t move_time = 0;
+		uint64_t pair_time = 0;
+		uint64_t cull_time = 0;
+		uint32_t culled = 0;
+		LocalVector<VisualServerScene::Instance *> cull_result;
+
+		for (int f = 0; f < p_frames; f++) {
+
+			uint64_t from = OS::get_singleton()->get_ticks_usec();
+
+			for (int i = 0; i < p_moving && i < p_instances; i++) {
+
+				AABB &aabb = aabbs[i];
+				aabb.position += velocities[i];
+				for (int j = 0; j < 3; j++) {
+					if (aabb.position[j] < 0 || aabb.position[j] > size)
+						velocities[i][j] = -velocities[i][j];
+				}
+				index->move(ids[i], aabb);
+			}
+
+			uint64_t moved = OS::get_singleton()->get_ticks_usec();
+			index->update();
+			uint64_t paired = OS::get_singleton()->get_ticks_usec();
+
+			Transform camera;
+			camera.origin = Vector3(1, 1, 1) * (size / 2);
+			camera.basis.rotate(Vector3(0, 1, 0), Math_PI * 2 * f / p_frames);
+			index->cull_convex_threadsafe(projection.get_projection_planes(camera), cull_result, VisualServerScene::MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+			culled += cull_result.size();
+
+			move_time += moved - from;
+			pair_time += paired - moved;
+			cull_time += OS::get_singleton()->get_ticks_usec() - paired;
+		}
+
+		for (int i = 0; i < p_instances; i++) {
+			index->erase(ids[i]);
+			memdelete(instances[i]);
+		}
+
+		memdelete(index);
+
+		OS::get_singleton()->print("%-7s %6d instances, %6d moving: move %9.2f usec, pair %9.2f usec (%d pair events), cull %9.2f usec (%d culled) per frame\n",
+				p_name, p_instances, MIN(p_moving, p_instances), move_time / (double)p_frames, pair_time / (double)p_frames,
+				pair_events, cull_time / (double)p_frames, culled / MAX(p_frames, 1));
+	}
+
+	void compare(int p_instances, int p_moving, int p_frames) {
+
+		run("Octree", ScenarioIndexOctree::_create, p_instances, p_moving, p_frames);
+		run("BVH", ScenarioIndexBVH::_create, p_instances, p_moving, p_frames);
+	}
+};
+
+MainLoop *test_scenario_index() {
+
+	ScenarioIndexBenchmark benchmark;
+
+	benchmark.compare(10000, 100, 100);
+	benchmark.compare(10000, 2000, 100);
+	benchmark.compare(50000, 5000, 50);
+	benchmark.compare(50000, 50000, 20);
+
+	return NULL;
+}
 } // namespace TestRender
@@ -40,6 +40,7 @@
 namespace TestRender {
 
 MainLoop *test();
-}
+MainLoop *test_scenario_index();
+} // namespace TestRender
 
 #endif
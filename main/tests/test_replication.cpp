@@ -0,0 +1,369 @@
+/*************************************************************************/
+/*  test_replication.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+
+#include "test_replication.h"
+
+#include "os/os.h"
+#include "io/marshalls.h"
+#include "scene/3d/spatial.h"
+#include "scene/main/scene_replicator.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/viewport.h"
+
+namespace TestReplication {
+
+// An authoritative server moves a few thousand entities and replicates their
+// transform and health to clients connected through ENet on the loopback
+// interface, then compares the traffic against sending every value with
+// rset_unreliable() each snapshot.
+
+class ReplicatedEntity : public Spatial {
+
+	GDCLASS(ReplicatedEntity, Spatial);
+
+	int health;
+
+protected:
+	static void _bind_methods() {
+
+		ClassDB::bind_method(D_METHOD("set_health", "health"), &ReplicatedEntity::set_health);
+		ClassDB::bind_method(D_METHOD("get_health"), &ReplicatedEntity::get_health);
+
+		ADD_PROPERTY(PropertyInfo(Variant::INT, "health"), "set_health", "get_health");
+	}
+
+public:
+	void set_health(int p_health) { health = p_health; }
+	int get_health() const { return health; }
+
+	ReplicatedEntity() { health = 100; }
+};
+
+enum {
+	ENTITIES = 2000,
+	CLIENTS = 16,
+	PORT = 27850,
+	SEND_RATE = 30,
+	TICKS = 150,
+	SETTLE_TICKS = 60,
+	LATE_SPAWN_TICK = 10,
+};
+
+struct Endpoint {
+
+	Ref<NetworkedMultiplayerPeer> peer;
+	Ref<SceneReplicator> replicator;
+	Node *root;
+	Vector<ReplicatedEntity *> entities;
+};
+
+struct Scenario {
+
+	const char *name;
+	float interest_radius;
+	int bandwidth_limit;
+};
+
+static Ref<NetworkedMultiplayerPeer> create_enet() {
+
+	Object *obj = ClassDB::instance("NetworkedMultiplayerENet");
+	Ref<NetworkedMultiplayerPeer> peer = Object::cast_to<NetworkedMultiplayerPeer>(obj);
+	return peer;
+}
+
+static void pump(Endpoint &p_endpoint) {
+
+	p_endpoint.peer->poll();
+
+	while (p_endpoint.peer->get_available_packet_count()) {
+
+		int from = p_endpoint.peer->get_packet_peer();
+		const uint8_t *packet;
+		int len;
+		if (p_endpoint.peer->get_packet(&packet, len) != OK)
+			break;
+		p_endpoint.replicator->process_packet(from, packet, len);
+	}
+}
+
+static Vector3 home_position(int p_entity) {
+
+	int side = Math::sqrt(float(ENTITIES));
+	return Vector3(p_entity % side, 0, p_entity / side) * 10.0;
+}
+
+static Node *create_world(Vector<ReplicatedEntity *> &r_entities) {
+
+	Spatial *world = memnew(Spatial);
+	world->set_name("World");
+
+	r_entities.resize(ENTITIES);
+	for (int i = 0; i < ENTITIES; i++) {
+		ReplicatedEntity *e = memnew(ReplicatedEntity);
+		e->set_name("Entity" + itos(i));
+		e->set_transform(Transform(Basis(), home_position(i)));
+		world->add_child(e);
+		r_entities[i] = e;
+	}
+
+	return world;
+}
+
+static void simulate(const Vector<ReplicatedEntity *> &p_entities, int p_tick) {
+
+	//a quarter of the entities walk in circles, some of them take damage now and then
+	for (int i = 0; i < p_entities.size(); i++) {
+
+		ReplicatedEntity *e = p_entities[i];
+
+		if (i % 4 == 0) {
+			float angle = (p_tick + i) * 0.05;
+			Transform xform;
+			xform.basis.rotate(Vector3(0, 1, 0), angle);
+			xform.origin = home_position(i) + Vector3(Math::cos(angle), 0, Math::sin(angle)) * 3.0;
+			e->set_transform(xform);
+		}
+
+		if ((i * 7 + p_tick) % 97 == 0) {
+			e->set_health(e->get_health() > 10 ? e->get_health() - 10 : 100);
+		}
+	}
+}
+
+static int rset_bytes(const Vector<ReplicatedEntity *> &p_entities) {
+
+	//what rset_unreliable("transform") and rset_unreliable("health") send for all
+	//entities in one snapshot, with cached paths and names: command, path id, name id, value
+	int bytes = 0;
+	for (int i = 0; i < p_entities.size(); i++) {
+		int len;
+		encode_variant(p_entities[i]->get_transform(), NULL, len);
+		bytes += 1 + 4 + 1 + len;
+		encode_variant(p_entities[i]->get_health(), NULL, len);
+		bytes += 1 + 4 + 1 + len;
+	}
+	return bytes;
+}
+
+static bool run(const Scenario &p_scenario, SceneTree *p_tree) {
+
+	OS::get_singleton()->print("%s: %d entities, %d clients, %d snapshots/s\n", p_scenario.name, ENTITIES, CLIENTS, SEND_RATE);
+
+	Endpoint server;
+	server.peer = create_enet();
+	server.replicator.instance();
+	server.replicator->set_network_peer(server.peer);
+	server.replicator->set_root_node(p_tree->get_root());
+	server.replicator->set_send_rate(SEND_RATE);
+	server.replicator->set_interest_radius(p_scenario.interest_radius);
+	server.replicator->set_bandwidth_limit(p_scenario.bandwidth_limit);
+	server.root = create_world(server.entities);
+	p_tree->get_root()->add_child(server.root);
+
+	Error err = Error(int(server.peer->call("create_server", PORT, CLIENTS)));
+	if (err != OK) {
+		OS::get_singleton()->print("\tcan't listen on port %d, skipped\n", PORT);
+		memdelete(server.root);
+		return true;
+	}
+
+	Vector<Endpoint> clients;
+	clients.resize(CLIENTS);
+	for (int i = 0; i < CLIENTS; i++) {
+
+		Endpoint &c = clients[i];
+		c.peer = create_enet();
+		c.replicator.instance();
+		c.replicator->set_network_peer(c.peer);
+		c.root = memnew(Node);
+		c.root->add_child(create_world(c.entities));
+		c.replicator->set_root_node(c.root);
+		c.peer->call("create_client", "127.0.0.1", PORT);
+	}
+
+	Vector<int> client_ids;
+	uint64_t timeout = OS::get_singleton()->get_ticks_msec() + 5000;
+
+	while (client_ids.size() < CLIENTS && OS::get_singleton()->get_ticks_msec() < timeout) {
+
+		pump(server);
+		for (int i = 0; i < CLIENTS; i++) {
+			pump(clients[i]);
+			int id = clients[i].peer->get_unique_id();
+			if (clients[i].peer->get_connection_status() == NetworkedMultiplayerPeer::CONNECTION_CONNECTED && client_ids.find(id) == -1) {
+				client_ids.push_back(id);
+			}
+		}
+		OS::get_singleton()->delay_usec(1000);
+	}
+
+	//the server sees the connections a little after the clients do
+	timeout = OS::get_singleton()->get_ticks_msec() + 250;
+	while (OS::get_singleton()->get_ticks_msec() < timeout) {
+
+		pump(server);
+		for (int i = 0; i < CLIENTS; i++) {
+			pump(clients[i]);
+		}
+		OS::get_singleton()->delay_usec(1000);
+	}
+
+	bool ok = client_ids.size() == CLIENTS;
+
+	if (ok) {
+
+		//every client watches from its own corner of the map
+		for (int i = 0; i < CLIENTS; i++) {
+			Spatial *observer = memnew(Spatial);
+			observer->set_name("Observer" + itos(i));
+			server.root->add_child(observer);
+			observer->set_transform(Transform(Basis(), home_position((i * 131) % ENTITIES)));
+			server.replicator->set_peer_observer(client_ids[i], observer);
+		}
+
+		//one client spawns an entity late, refusing its config until then
+		ReplicatedEntity *late = NULL;
+		Node *late_parent = NULL;
+		if (p_scenario.interest_radius == 0) {
+			late = clients[0].entities[ENTITIES - 1];
+			late_parent = late->get_parent();
+			late_parent->remove_child(late);
+		}
+
+		for (int i = 0; i < ENTITIES; i++) {
+			PoolStringArray properties;
+			properties.push_back("transform");
+			properties.push_back("health");
+			server.replicator->add_node(server.entities[i], properties, i % 10 == 0 ? 4.0 : 1.0);
+		}
+
+		uint64_t full_bytes = 0;
+		uint64_t server_usec = 0;
+		uint64_t bytes_from = server.replicator->get_bytes_sent();
+
+		for (int tick = 0; tick < TICKS + SETTLE_TICKS; tick++) {
+
+			if (late && tick == LATE_SPAWN_TICK) {
+				late_parent->add_child(late);
+			}
+
+			if (tick < TICKS) {
+				simulate(server.entities, tick);
+				full_bytes += uint64_t(rset_bytes(server.entities)) * CLIENTS;
+			}
+
+			uint64_t from = OS::get_singleton()->get_ticks_usec();
+			pump(server);
+			server.replicator->poll(1.0 / SEND_RATE);
+			server.peer->poll();
+			server_usec += OS::get_singleton()->get_ticks_usec() - from;
+
+			for (int i = 0; i < CLIENTS; i++) {
+				pump(clients[i]);
+				clients[i].replicator->poll(1.0 / SEND_RATE); //sends the acknowledgements
+			}
+		}
+
+		uint64_t bytes = server.replicator->get_bytes_sent() - bytes_from;
+		float seconds = float(TICKS + SETTLE_TICKS) / SEND_RATE;
+
+		OS::get_singleton()->print("\trset_unreliable, all values: %10.1f KiB/s per client\n", full_bytes / (float(TICKS) / SEND_RATE) / CLIENTS / 1024.0);
+		OS::get_singleton()->print("\treplicated deltas:           %10.1f KiB/s per client (%.1f%% of the above)\n", bytes / seconds / CLIENTS / 1024.0, 100.0 * bytes / double(full_bytes));
+		OS::get_singleton()->print("\tserver time:                 %10.3f msec per snapshot\n", server_usec / 1000.0 / (TICKS + SETTLE_TICKS));
+
+		if (p_scenario.bandwidth_limit > 0) {
+			//the budget of one snapshot can carry over to the next
+			bool capped = bytes / seconds / CLIENTS <= p_scenario.bandwidth_limit * 1.05 + p_scenario.bandwidth_limit / float(SEND_RATE);
+			OS::get_singleton()->print("\tbandwidth limit:             %10.1f KiB/s %s\n", p_scenario.bandwidth_limit / 1024.0, capped ? "OK" : "FAIL");
+			ok = ok && capped;
+		}
+
+		if (p_scenario.interest_radius == 0) {
+			//with nothing filtered, every client must end up with the server state
+			int mismatches = 0;
+			for (int i = 0; i < CLIENTS; i++) {
+				for (int j = 0; j < ENTITIES; j++) {
+					if (clients[i].entities[j]->get_transform() != server.entities[j]->get_transform() || clients[i].entities[j]->get_health() != server.entities[j]->get_health())
+						mismatches++;
+				}
+			}
+			OS::get_singleton()->print("\tclients converged: %s\n", mismatches ? "FAIL" : "OK");
+			ok = ok && mismatches == 0;
+		}
+	} else {
+		OS::get_singleton()->print("\tonly %d of %d clients connected: FAIL\n", client_ids.size(), CLIENTS);
+	}
+
+	for (int i = 0; i < CLIENTS; i++) {
+		clients[i].peer->call("close_connection");
+		clients[i].replicator->set_network_peer(Ref<NetworkedMultiplayerPeer>());
+		memdelete(clients[i].root);
+	}
+	server.peer->call("close_connection");
+	server.replicator->set_network_peer(Ref<NetworkedMultiplayerPeer>());
+	memdelete(server.root);
+
+	return ok;
+}
+
+MainLoop *test() {
+
+	if (!ClassDB::class_exists("NetworkedMultiplayerENet")) {
+		OS::get_singleton()->print("ENet module not available, replication test skipped\n");
+		return NULL;
+	}
+
+	ClassDB::register_class<ReplicatedEntity>();
+
+	//only the server needs a tree, for the global transforms used by the interest radius
+	SceneTree *tree = memnew(SceneTree);
+	tree->init();
+
+	Scenario scenarios[] = {
+		{ "full world", 0, 0 },
+		{ "interest radius 100", 100, 0 },
+		{ "interest radius 100, 64 KiB/s", 100, 64 * 1024 },
+	};
+
+	bool ok = true;
+	for (int i = 0; i < 3; i++) {
+		ok = run(scenarios[i], tree) && ok;
+	}
+
+	OS::get_singleton()->print("replication: %s\n", ok ? "OK" : "FAIL");
+
+	tree->finish();
+	memdelete(tree);
+
+	return NULL;
+}
+} // namespace TestReplication
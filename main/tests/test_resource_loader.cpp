@@ -0,0 +1,290 @@
+/*************************************************************************/
+/*  test_resource_loader.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_resource_loader.h"
+
+#include "image.h"
+#include "io/resource_loader.h"
+#include "io/resource_saver.h"
+#include "os/dir_access.h"
+#include "os/os.h"
+#include "os/thread_pool.h"
+#include "os/threaded_array_processor.h"
+
+namespace TestResourceLoader {
+
+// A level resource depending on groups of images, some images shared by
+// several groups, loaded with load() and in the background, with and
+// without sub threads.
+
+static const int leaf_count = 64;
+static const int leaf_size = 256;
+static const int group_count = 8;
+static const int group_leaves = 16;
+
+static String dir() {
+
+	return "user://test_resource_loader";
+}
+
+static String leaf_path(int p_index) {
+
+	return dir().plus_file("leaf_" + itos(p_index) + ".res");
+}
+
+static String group_path(int p_index) {
+
+	return dir().plus_file("group_" + itos(p_index) + ".res");
+}
+
+static String level_path() {
+
+	return dir().plus_file("level.res");
+}
+
+static int group_leaf(int p_group, int p_index) {
+
+	return (p_group * group_leaves / 2 + p_index) % leaf_count;
+}
+
+static uint8_t leaf_byte(int p_leaf, int p_offset) {
+
+	return (p_leaf * 13 + p_offset) & 0xFF;
+}
+
+static Error make_resources() {
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	da->make_dir_recursive(dir());
+	memdelete(da);
+
+	Vector<Ref<Image> > leaves;
+	for (int i = 0; i < leaf_count; i++) {
+
+		PoolVector<uint8_t> data;
+		data.resize(leaf_size * leaf_size * 4);
+		{
+			PoolVector<uint8_t>::Write w = data.write();
+			for (int j = 0; j < data.size(); j++) {
+				w[j] = leaf_byte(i, j);
+			}
+		}
+
+		Ref<Image> leaf = memnew(Image(leaf_size, leaf_size, false, Image::FORMAT_RGBA8, data));
+		leaf->set_path(leaf_path(i));
+		Error err = ResourceSaver::save(leaf_path(i), leaf);
+		if (err != OK)
+			return err;
+		leaves.push_back(leaf);
+	}
+
+	Vector<Ref<Resource> > groups;
+	for (int i = 0; i < group_count; i++) {
+
+		Array group_leaves_array;
+		for (int j = 0; j < group_leaves; j++) {
+			group_leaves_array.push_back(leaves[group_leaf(i, j)]);
+		}
+
+		Ref<Resource> group = memnew(Resource);
+		group->set_meta("leaves", group_leaves_array);
+		group->set_path(group_path(i));
+		Error err = ResourceSaver::save(group_path(i), group);
+		if (err != OK)
+			return err;
+		groups.push_back(group);
+	}
+
+	Array level_groups;
+	for (int i = 0; i < group_count; i++) {
+		level_groups.push_back(groups[i]);
+	}
+
+	Ref<Resource> level = memnew(Resource);
+	level->set_meta("groups", level_groups);
+	return ResourceSaver::save(level_path(), level);
+}
+
+static void remove_resources() {
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	for (int i = 0; i < leaf_count; i++) {
+		da->remove(leaf_path(i));
+	}
+	for (int i = 0; i < group_count; i++) {
+		da->remove(group_path(i));
+	}
+	da->remove(level_path());
+	da->remove(dir());
+	memdelete(da);
+}
+
+static bool check_level(const Ref<Resource> &p_level) {
+
+	if (p_level.is_null() || !p_level->has_meta("groups"))
+		return false;
+
+	Array groups = p_level->get_meta("groups");
+	if (groups.size() != group_count)
+		return false;
+
+	// a leaf shared by several groups must be loaded once
+	Map<int, Object *> leaves;
+
+	for (int i = 0; i < group_count; i++) {
+
+		Ref<Resource> group = groups[i];
+		if (group.is_null() || group->get_path() != group_path(i))
+			return false;
+
+		Array group_leaves_array = group->get_meta("leaves");
+		if (group_leaves_array.size() != group_leaves)
+			return false;
+
+		for (int j = 0; j < group_leaves; j++) {
+
+			int index = group_leaf(i, j);
+			Ref<Image> leaf = group_leaves_array[j];
+			if (leaf.is_null() || leaf->get_width() != leaf_size)
+				return false;
+
+			if (leaves.has(index) && leaves[index] != leaf.ptr())
+				return false;
+			leaves[index] = leaf.ptr();
+
+			PoolVector<uint8_t> data = leaf->get_data();
+			int last = data.size() - 1;
+			if (data[0] != leaf_byte(index, 0) || data[last] != leaf_byte(index, last))
+				return false;
+		}
+	}
+
+	return leaves.size() == leaf_count;
+}
+
+static bool threaded_load(bool p_use_sub_threads, Ref<Resource> &r_level) {
+
+	if (ResourceLoader::load_threaded_request(level_path(), "", p_use_sub_threads) != OK)
+		return false;
+
+	// also requesting it again shares the load
+	ResourceLoader::load_threaded_request(level_path());
+
+	float progress = 0;
+	float last_progress = 0;
+	bool monotonic = true;
+
+	while (ResourceLoader::load_threaded_get_status(level_path(), &progress) == ResourceLoader::THREAD_LOAD_IN_PROGRESS) {
+		monotonic = monotonic && progress >= last_progress;
+		last_progress = progress;
+		OS::get_singleton()->delay_usec(100);
+	}
+
+	ResourceLoader::load_threaded_get_status(level_path(), &progress);
+
+	r_level = ResourceLoader::load_threaded_get(level_path());
+	Ref<Resource> again = ResourceLoader::load_threaded_get(level_path());
+
+	return monotonic && progress == 1 && again == r_level && ResourceLoader::load_threaded_get_status(level_path()) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE;
+}
+
+struct ConcurrentLoad {
+
+	Vector<Ref<Resource> > levels;
+
+	void load(uint32_t p_index, int p_unused) {
+
+		levels[p_index] = ResourceLoader::load(level_path());
+	}
+};
+
+static bool concurrent_load(Ref<Resource> &r_level) {
+
+	ConcurrentLoad loads;
+	loads.levels.resize(8);
+
+	thread_process_array(loads.levels.size(), &loads, &ConcurrentLoad::load, 0);
+
+	r_level = loads.levels[0];
+	for (int i = 1; i < loads.levels.size(); i++) {
+		if (loads.levels[i] != r_level)
+			return false;
+	}
+	return true;
+}
+
+static void print_pass(const char *p_name, bool p_ok, uint64_t p_usec) {
+
+	OS::get_singleton()->print("\t%-28s %8.2f msec %s\n", p_name, p_usec / 1000.0, p_ok ? "OK" : "FAIL");
+}
+
+MainLoop *test() {
+
+	if (make_resources() != OK) {
+		OS::get_singleton()->print("Could not save the test resources in %s\n", dir().utf8().get_data());
+		remove_resources();
+		return NULL;
+	}
+
+	OS::get_singleton()->print("Level: %d groups of %d images out of %d, %d worker threads\n", group_count, group_leaves, leaf_count, ThreadPool::get_singleton()->get_thread_count());
+
+	for (int pass = 0; pass < 4; pass++) {
+
+		Ref<Resource> level;
+		bool ok = !ResourceCache::has(level_path()) && !ResourceCache::has(leaf_path(0));
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		switch (pass) {
+			case 0: level = ResourceLoader::load(level_path()); break;
+			case 1: ok = threaded_load(false, level) && ok; break;
+			case 2: ok = threaded_load(true, level) && ok; break;
+			case 3: ok = concurrent_load(level) && ok; break;
+		}
+		uint64_t usec = OS::get_singleton()->get_ticks_usec() - from;
+
+		ok = check_level(level) && ok;
+
+		static const char *names[] = { "load():", "threaded:", "threaded, sub threads:", "load() from 8 threads:" };
+		print_pass(names[pass], ok, usec);
+	}
+
+	// what Main::cleanup() does with loads still in flight at exit
+	ResourceLoader::load_threaded_request(level_path(), "", true);
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	ResourceLoader::finish_threaded_loads();
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - from;
+	bool ok = ResourceLoader::load_threaded_get_status(level_path()) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE && !ResourceCache::has(level_path());
+	print_pass("uncollected, finished:", ok, usec);
+
+	remove_resources();
+
+	return NULL;
+}
+} // namespace TestResourceLoader
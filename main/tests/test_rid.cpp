@@ -0,0 +1,176 @@
+/*************************************************************************/
+/*  test_rid.cpp                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "test_rid.h"
+
+#include "os/os.h"
+#include "rid.h"
+
+namespace TestRID {
+
+// Compares RID_Owner, which allocates every object on its own and checks
+// RIDs against a set in debug builds, with RID_SlabOwner, then checks that
+// freed and reused slots reject stale RIDs.
+
+struct Object64 : public RID_Data {
+
+	uint8_t payload[64];
+	uint32_t value;
+
+	Object64() { value = 0; }
+};
+
+static const int object_count = 100000;
+static const int lookup_rounds = 10;
+
+template <class O>
+static void touch_all(O &p_owner, const Vector<RID> &p_rids, uint64_t &r_sum) {
+
+	for (int r = 0; r < lookup_rounds; r++) {
+		for (int i = 0; i < p_rids.size(); i++) {
+			r_sum += p_owner.getornull(p_rids[i])->value;
+		}
+	}
+}
+
+static void benchmark() {
+
+	Vector<RID> rids;
+	rids.resize(object_count);
+	uint64_t sum_list = 0;
+	uint64_t sum_slab = 0;
+
+	RID_Owner<Object64> list_owner;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < object_count; i++) {
+		Object64 *obj = memnew(Object64);
+		obj->value = i;
+		rids.ptrw()[i] = list_owner.make_rid(obj);
+	}
+	uint64_t list_make = OS::get_singleton()->get_ticks_usec() - from;
+
+	from = OS::get_singleton()->get_ticks_usec();
+	touch_all(list_owner, rids, sum_list);
+	uint64_t list_get = OS::get_singleton()->get_ticks_usec() - from;
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < object_count; i++) {
+		Object64 *obj = list_owner.get(rids[i]);
+		list_owner.free(rids[i]);
+		memdelete(obj);
+	}
+	uint64_t list_free = OS::get_singleton()->get_ticks_usec() - from;
+
+	RID_SlabOwner<Object64> slab_owner;
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < object_count; i++) {
+		rids.ptrw()[i] = slab_owner.make_rid();
+		slab_owner.get(rids[i])->value = i;
+	}
+	uint64_t slab_make = OS::get_singleton()->get_ticks_usec() - from;
+
+	from = OS::get_singleton()->get_ticks_usec();
+	touch_all(slab_owner, rids, sum_slab);
+	uint64_t slab_get = OS::get_singleton()->get_ticks_usec() - from;
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < object_count; i++) {
+		slab_owner.free(rids[i]);
+	}
+	uint64_t slab_free = OS::get_singleton()->get_ticks_usec() - from;
+
+	OS::get_singleton()->print("%d objects, %d lookup rounds (usec): make %lld -> %lld, lookup %lld -> %lld, free %lld -> %lld%s\n",
+			object_count, lookup_rounds,
+			(long long)list_make, (long long)slab_make,
+			(long long)list_get, (long long)slab_get,
+			(long long)list_free, (long long)slab_free,
+			sum_list == sum_slab ? "" : " CHECKSUM MISMATCH");
+}
+
+static bool check_slots() {
+
+	RID_SlabOwner<Object64> owner;
+	bool ok = true;
+
+	RID a = owner.make_rid();
+	RID b = owner.make_rid();
+	ok = ok && a.is_valid() && a != b && owner.owns(a) && owner.owns(b);
+	ok = ok && a.get_id() != b.get_id() && owner.get_rid_count() == 2;
+
+	owner.free(a);
+	ok = ok && !owner.owns(a) && owner.getptr(a) == NULL;
+
+	// the slot of a is reused, but a must stay invalid
+	RID c = owner.make_rid();
+	ok = ok && c != a && owner.owns(c) && !owner.owns(a);
+	ok = ok && owner.getptr(c)->value == 0;
+
+	// RIDs of other owners are not mistaken for slots
+	RID_Owner<Object64> list_owner;
+	Object64 *obj = memnew(Object64);
+	RID d = list_owner.make_rid(obj);
+	ok = ok && !owner.owns(d) && !list_owner.owns(c);
+	list_owner.free(d);
+	memdelete(obj);
+
+	// enough objects to grow the chunk table several times
+	Vector<RID> rids;
+	for (int i = 0; i < 20000; i++) {
+		RID r = owner.make_rid();
+		owner.get(r)->value = i;
+		rids.push_back(r);
+	}
+	for (int i = 0; i < rids.size(); i++) {
+		ok = ok && owner.get(rids[i])->value == uint32_t(i);
+	}
+
+	List<RID> owned;
+	owner.get_owned_list(&owned);
+	ok = ok && owned.size() == rids.size() + 2 && int(owner.get_rid_count()) == rids.size() + 2;
+
+	for (List<RID>::Element *E = owned.front(); E; E = E->next()) {
+		owner.free(E->get());
+	}
+	ok = ok && owner.get_rid_count() == 0 && !owner.owns(b) && !owner.owns(rids[0]);
+
+	return ok;
+}
+
+MainLoop *test() {
+
+	benchmark();
+	OS::get_singleton()->print("Slot reuse and stale RIDs: %s\n", check_slots() ? "OK" : "FAIL");
+
+	return NULL;
+}
+} // namespace TestRID
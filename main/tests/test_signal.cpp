@@ -0,0 +1,129 @@
+/*************************************************************************/
+/*  test_signal.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "test_signal.h"
+
+#include "object.h"
+#include "os/os.h"
+
+namespace TestSignal {
+
+// Emits a signal connected to 1, 10 and 100 objects, to a method without
+// binds and to one with a bound argument, then checks that binds reach the
+// targets and that one-shot connections are only called once.
+
+static const int emit_budget = 2000000; // calls per measurement
+
+static void benchmark(int p_connections, bool p_binds) {
+
+	Object *source = memnew(Object);
+	source->add_user_signal(MethodInfo("hit"));
+
+	Vector<Object *> targets;
+	for (int i = 0; i < p_connections; i++) {
+		Object *target = memnew(Object);
+		if (p_binds) {
+			source->connect("hit", target, "set_block_signals", varray(false));
+		} else {
+			source->connect("hit", target, "get_instance_id");
+		}
+		targets.push_back(target);
+	}
+
+	StringName hit = "hit";
+	int emits = emit_budget / p_connections;
+	source->emit_signal(hit);
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < emits; i++) {
+		source->emit_signal(hit);
+	}
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	OS::get_singleton()->print("%3d connections%s: %9.0f emits/s, %6.1f nsec/call\n",
+			p_connections, p_binds ? ", 1 bind " : ", no binds",
+			emits * 1000000.0 / usec, usec * 1000.0 / (double(emits) * p_connections));
+
+	memdelete(source);
+	for (int i = 0; i < targets.size(); i++) {
+		memdelete(targets[i]);
+	}
+}
+
+static bool check_connections() {
+
+	bool ok = true;
+
+	Object *source = memnew(Object);
+	source->add_user_signal(MethodInfo("hit"));
+	Object *a = memnew(Object);
+	Object *b = memnew(Object);
+
+	source->connect("hit", a, "set_block_signals", varray(true));
+	source->emit_signal("hit");
+	ok = ok && a->is_blocking_signals();
+
+	// connections added after emitting are seen by the next emission
+	source->connect("hit", b, "set_block_signals", varray(true), Object::CONNECT_ONESHOT);
+	source->emit_signal("hit");
+	ok = ok && b->is_blocking_signals() && !source->is_connected("hit", b, "set_block_signals");
+
+	b->set_block_signals(false);
+	source->emit_signal("hit");
+	ok = ok && !b->is_blocking_signals();
+
+	// freeing a target disconnects it
+	memdelete(a);
+	source->emit_signal("hit");
+	List<Object::Connection> connections;
+	source->get_signal_connection_list("hit", &connections);
+	ok = ok && connections.size() == 0;
+
+	memdelete(b);
+	memdelete(source);
+
+	return ok;
+}
+
+MainLoop *test() {
+
+	benchmark(1, false);
+	benchmark(10, false);
+	benchmark(100, false);
+	benchmark(1, true);
+	benchmark(10, true);
+	benchmark(100, true);
+
+	OS::get_singleton()->print("Connections: %s\n", check_connections() ? "OK" : "FAIL");
+
+	return NULL;
+}
+} // namespace TestSignal
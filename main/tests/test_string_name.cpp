@@ -0,0 +1,160 @@
+/*************************************************************************/
+/*  test_string_name.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "test_string_name.h"
+
+#include "os/mutex.h"
+#include "os/os.h"
+#include "os/thread.h"
+#include "string_db.h"
+
+namespace TestStringName {
+
+// Several threads intern a mix of names that already exist and names that
+// do not, keep some of them alive and drop the others, like background
+// loaders do. Runs once as is and once with every operation behind a
+// single global mutex, which is how the interning table used to work.
+
+static const int shared_count = 2048;
+static const int ops_per_thread = 200000;
+
+struct Context {
+
+	Vector<String> shared_names;
+	Vector<StringName> shared;
+	Mutex *global_lock;
+	int threads;
+	bool failed;
+};
+
+struct Worker {
+
+	Context *context;
+	int index;
+	Thread *thread;
+};
+
+static void work(void *p_userdata) {
+
+	Worker *w = (Worker *)p_userdata;
+	Context *c = w->context;
+	const String prefix = "worker_" + itos(w->index) + "_";
+
+	Vector<StringName> kept;
+	uint32_t seed = w->index * 7919 + 1;
+
+	for (int i = 0; i < ops_per_thread; i++) {
+
+		seed = seed * 1664525 + 1013904223;
+		int pick = (seed >> 8) % c->shared_names.size();
+
+		if (c->global_lock)
+			c->global_lock->lock();
+
+		if (i % 8 == 0) {
+			// one in eight names is new, and half of those stay alive
+			StringName name = prefix + itos(i);
+			if (i % 16 == 0) {
+				kept.push_back(name);
+			}
+		} else {
+			StringName name = c->shared_names[pick];
+			if (name != c->shared[pick]) {
+				c->failed = true;
+			}
+		}
+
+		if (c->global_lock)
+			c->global_lock->unlock();
+	}
+
+	for (int i = 0; i < kept.size(); i++) {
+		if (StringName::search(prefix + itos(i * 16)) != kept[i]) {
+			c->failed = true;
+		}
+	}
+}
+
+static uint64_t run(Context &p_context, int p_threads) {
+
+	Vector<Worker> workers;
+	workers.resize(p_threads);
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < p_threads; i++) {
+		Worker &w = workers.ptrw()[i];
+		w.context = &p_context;
+		w.index = i;
+		w.thread = Thread::create(work, &w);
+	}
+
+	for (int i = 0; i < p_threads; i++) {
+		Thread::wait_to_finish(workers[i].thread);
+		memdelete(workers[i].thread);
+	}
+
+	return OS::get_singleton()->get_ticks_usec() - from;
+}
+
+MainLoop *test() {
+
+	Context context;
+	context.failed = false;
+	for (int i = 0; i < shared_count; i++) {
+		String name = "shared_name_" + itos(i);
+		context.shared_names.push_back(name);
+		context.shared.push_back(name);
+	}
+
+	Mutex *global_lock = Mutex::create();
+
+	for (int threads = 1; threads <= 8; threads *= 2) {
+
+		context.global_lock = global_lock;
+		uint64_t locked = run(context, threads);
+		context.global_lock = NULL;
+		uint64_t sharded = run(context, threads);
+
+		double total = double(threads) * ops_per_thread;
+		OS::get_singleton()->print("%d threads: global lock %.2f Mops/s, sharded %.2f Mops/s\n",
+				threads, total / locked, total / sharded);
+	}
+
+	memdelete(global_lock);
+
+	// names dropped by every thread must be gone, kept ones were released too
+	bool gone = StringName::search("worker_0_8") == StringName() && StringName::search("worker_0_0") == StringName();
+	OS::get_singleton()->print("Interned names: %s\n", !context.failed && gone ? "OK" : "FAIL");
+
+	return NULL;
+}
+} // namespace TestStringName
@@ -0,0 +1,164 @@
+/*************************************************************************/
+/*  test_thread_pool.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_thread_pool.h"
+
+#include "os/os.h"
+#include "os/thread_pool.h"
+#include "os/threaded_array_processor.h"
+
+namespace TestThreadPool {
+
+struct Workload {
+
+	Vector<uint32_t> results;
+
+	void process(uint32_t p_index, uint32_t p_iterations) {
+
+		uint32_t hash = p_index;
+		for (uint32_t i = 0; i < p_iterations; i++) {
+			hash = hash * 1664525 + 1013904223;
+		}
+		results[p_index] = hash;
+	}
+};
+
+// The implementation thread_process_array used before the pool existed: spawn and join threads on every call.
+template <class C, class M, class U>
+void spawn_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
+
+	ThreadArrayProcessData<C, U> data;
+	data.method = p_method;
+	data.instance = p_instance;
+	data.userdata = p_userdata;
+	data.index = 0;
+	data.elements = p_elements;
+	data.process(data.index);
+
+	struct Runner {
+		static void run(void *ud) {
+			ThreadArrayProcessData<C, U> &d = *(ThreadArrayProcessData<C, U> *)ud;
+			while (true) {
+				uint32_t index = atomic_increment(&d.index);
+				if (index >= d.elements)
+					break;
+				d.process(index);
+			}
+		}
+	};
+
+	Vector<Thread *> threads;
+	threads.resize(OS::get_singleton()->get_processor_count());
+
+	for (int i = 0; i < threads.size(); i++) {
+		threads[i] = Thread::create(Runner::run, &data);
+	}
+
+	for (int i = 0; i < threads.size(); i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+}
+
+static uint32_t checksum(const Workload &p_workload) {
+
+	uint32_t sum = 0;
+	for (int i = 0; i < p_workload.results.size(); i++) {
+		sum ^= p_workload.results[i] + i;
+	}
+	return sum;
+}
+
+static void benchmark(uint32_t p_calls, uint32_t p_elements, uint32_t p_iterations) {
+
+	Workload workload;
+	workload.results.resize(p_elements);
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < p_calls; i++) {
+		spawn_process_array(p_elements, &workload, &Workload::process, p_iterations);
+	}
+	uint64_t spawn_time = OS::get_singleton()->get_ticks_usec() - from;
+	uint32_t spawn_checksum = checksum(workload);
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < p_calls; i++) {
+		thread_process_array(p_elements, &workload, &Workload::process, p_iterations);
+	}
+	uint64_t pool_time = OS::get_singleton()->get_ticks_usec() - from;
+	uint32_t pool_checksum = checksum(workload);
+
+	OS::get_singleton()->print("%6d calls x %6d elements x %5d iterations: spawn %8.2f usec/call, pool %8.2f usec/call (%.1fx)%s\n",
+			p_calls, p_elements, p_iterations,
+			spawn_time / (double)p_calls, pool_time / (double)p_calls,
+			pool_time ? spawn_time / (double)pool_time : 0.0,
+			spawn_checksum == pool_checksum ? "" : " CHECKSUM MISMATCH");
+}
+
+struct NestedWorkload {
+
+	uint32_t count;
+
+	void inner(uint32_t p_index, uint32_t *p_counter) {
+		atomic_increment(p_counter);
+	}
+
+	void outer(uint32_t p_index, uint32_t p_inner_elements) {
+
+		uint32_t counter = 0;
+		ThreadPool *pool = ThreadPool::get_singleton();
+		ThreadPool::GroupID group = pool->add_template_group_task(this, &NestedWorkload::inner, &counter, p_inner_elements);
+		pool->wait_for_group(group);
+		atomic_add(&count, counter);
+	}
+};
+
+MainLoop *test() {
+
+	ThreadPool *pool = ThreadPool::get_singleton();
+	OS::get_singleton()->print("Thread pool: %d worker threads, %d processors\n", pool->get_thread_count(), OS::get_singleton()->get_processor_count());
+
+	// Dispatch overhead dominates with small workloads, actual work with larger ones.
+	benchmark(1000, 16, 1);
+	benchmark(1000, 256, 1);
+	benchmark(1000, 256, 1000);
+	benchmark(100, 65536, 10);
+	benchmark(10, 1024, 100000);
+
+	// Waiting from inside a task must help instead of blocking the worker.
+	NestedWorkload nested;
+	nested.count = 0;
+	ThreadPool::GroupID group = pool->add_template_group_task(&nested, &NestedWorkload::outer, 100u, 64);
+	pool->wait_for_group(group);
+	OS::get_singleton()->print("Nested groups: %d == %d %s\n", nested.count, 64 * 100, nested.count == 64 * 100 ? "OK" : "FAIL");
+
+	return NULL;
+}
+} // namespace TestThreadPool
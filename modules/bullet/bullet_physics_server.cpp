@@ -561,7 +561,7 @@ void BulletPhysicsServer::body_clear_shapes(RID p_body) {
 	body->remove_all_shapes();
 }
 
-void BulletPhysicsServer::body_attach_object_instance_id(RID p_body, uint32_t p_ID) {
+void BulletPhysicsServer::body_attach_object_instance_id(RID p_body, ObjectID p_ID) {
 	CollisionObjectBullet *body = get_collisin_object(p_body);
 	if (!body) {
 		body = soft_body_owner.get(p_body);
@@ -571,7 +571,7 @@ void BulletPhysicsServer::body_attach_object_instance_id(RID p_body, uint32_t p_
 	body->set_instance_id(p_ID);
 }
 
-uint32_t BulletPhysicsServer::body_get_object_instance_id(RID p_body) const {
+ObjectID BulletPhysicsServer::body_get_object_instance_id(RID p_body) const {
 	CollisionObjectBullet *body = get_collisin_object(p_body);
 	ERR_FAIL_COND_V(!body, 0);
 
@@ -144,14 +144,17 @@ void NetworkedMultiplayerENet::poll() {
 
 	_pop_current_packet();
 
+	//what was batched since the last poll goes out with this service
+	_flush_batches();
+
 	ENetEvent event;
-	/* Wait up to 1000 milliseconds for an event. */
+	/* Drain every pending event, without waiting for more. */
 	while (true) {
 
 		if (!host || !active) //might have been disconnected while emitting a notification
 			return;
 
-		int ret = enet_host_service(host, &event, 1);
+		int ret = enet_host_service(host, &event, 0);
 
 		if (ret < 0) {
 			//error, do something?
@@ -169,14 +172,19 @@ void NetworkedMultiplayerENet::poll() {
 					break;
 				}
 
-				int *new_id = memnew(int);
-				*new_id = event.data;
+				PeerData *peer_data = memnew(PeerData);
+				peer_data->id = event.data;
+				for (int i = 0; i < PEER_STAT_SEND_QUEUE; i++) {
+					peer_data->stats[i] = 0;
+				}
 
-				if (*new_id == 0) { //data zero is sent by server (enet won't let you configure this). Server is always 1
-					*new_id = 1;
+				if (peer_data->id == 0) { //data zero is sent by server (enet won't let you configure this). Server is always 1
+					peer_data->id = 1;
 				}
 
-				event.peer->data = new_id;
+				int *new_id = &peer_data->id;
+
+				event.peer->data = peer_data;
 
 				peer_map[*new_id] = event.peer;
 
@@ -211,7 +219,8 @@ void NetworkedMultiplayerENet::poll() {
 
 				/* Reset the peer's client information. */
 
-				int *id = (int *)event.peer->data;
+				PeerData *peer_data = (PeerData *)event.peer->data;
+				int *id = peer_data ? &peer_data->id : NULL;
 
 				if (!id) {
 					if (!server) {
@@ -239,7 +248,7 @@ void NetworkedMultiplayerENet::poll() {
 
 					emit_signal("peer_disconnected", *id);
 					peer_map.erase(*id);
-					memdelete(id);
+					memdelete(peer_data);
 				}
 
 			} break;
@@ -275,16 +284,27 @@ void NetworkedMultiplayerENet::poll() {
 					Packet packet;
 					packet.packet = event.packet;
 
-					uint32_t *id = (uint32_t *)event.peer->data;
+					PeerData *peer_data = (PeerData *)event.peer->data;
+					uint32_t *id = (uint32_t *)&peer_data->id;
 
-					ERR_CONTINUE(event.packet->dataLength < 12)
+					ERR_CONTINUE(event.packet->dataLength < PACKET_HEADER_SIZE)
+
+					if (!_is_batch_valid(event.packet)) {
+						//neither relayed nor delivered
+						enet_packet_destroy(event.packet);
+						ERR_EXPLAIN("Malformed batch of messages, dropped.");
+						ERR_CONTINUE(true);
+					}
 
 					uint32_t source = decode_uint32(&event.packet->data[0]);
 					int target = decode_uint32(&event.packet->data[4]);
-					uint32_t flags = decode_uint32(&event.packet->data[8]);
+					uint32_t flags = decode_uint32(&event.packet->data[8]) & ~uint32_t(PACKET_FLAG_BATCH);
 
 					packet.from = source;
 
+					peer_data->stats[PEER_STAT_PACKETS_RECEIVED]++;
+					peer_data->stats[PEER_STAT_BYTES_RECEIVED] += event.packet->dataLength;
+
 					if (server) {
 						// Someone is cheating and trying to fake the source!
 						ERR_CONTINUE(source != *id);
@@ -294,8 +314,7 @@ void NetworkedMultiplayerENet::poll() {
 						if (target == 0) {
 							//re-send the everyone but sender :|
 
-							incoming_packets.push_back(packet);
-							//and make copies for sending
+							//make copies for sending first, the packet belongs to the incoming queue once pushed
 							for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
 
 								if (uint32_t(E->key()) == source) //do not resend to self
@@ -304,8 +323,11 @@ void NetworkedMultiplayerENet::poll() {
 								ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, flags);
 
 								enet_peer_send(E->get(), event.channelID, packet2);
+								_count_sent(E->get(), 0, packet2->dataLength);
 							}
 
+							peer_data->stats[PEER_STAT_MESSAGES_RECEIVED] += _push_incoming(packet.packet, packet.from);
+
 						} else if (target < 0) {
 							//to all but one
 
@@ -318,11 +340,12 @@ void NetworkedMultiplayerENet::poll() {
 								ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, flags);
 
 								enet_peer_send(E->get(), event.channelID, packet2);
+								_count_sent(E->get(), 0, packet2->dataLength);
 							}
 
 							if (-target != 1) {
 								//server is not excluded
-								incoming_packets.push_back(packet);
+								peer_data->stats[PEER_STAT_MESSAGES_RECEIVED] += _push_incoming(packet.packet, packet.from);
 							} else {
 								//server is excluded, erase packet
 								enet_packet_destroy(packet.packet);
@@ -330,15 +353,16 @@ void NetworkedMultiplayerENet::poll() {
 
 						} else if (target == 1) {
 							//to myself and only myself
-							incoming_packets.push_back(packet);
+							peer_data->stats[PEER_STAT_MESSAGES_RECEIVED] += _push_incoming(packet.packet, packet.from);
 						} else {
 							//to someone else, specifically
 							ERR_CONTINUE(!peer_map.has(target));
 							enet_peer_send(peer_map[target], event.channelID, packet.packet);
+							_count_sent(peer_map[target], 0, packet.packet->dataLength);
 						}
 					} else {
 
-						incoming_packets.push_back(packet);
+						peer_data->stats[PEER_STAT_MESSAGES_RECEIVED] += _push_incoming(packet.packet, packet.from);
 					}
 
 					//destroy packet later..
@@ -383,6 +407,9 @@ void NetworkedMultiplayerENet::close_connection() {
 	enet_host_destroy(host);
 	active = false;
 	incoming_packets.clear();
+	for (int i = 0; i < SYSCH_MAX; i++) {
+		batches[i].count = 0;
+	}
 	unique_id = 1; //server is 1
 	connection_status = CONNECTION_DISCONNECTED;
 }
@@ -400,8 +427,8 @@ Error NetworkedMultiplayerENet::get_packet(const uint8_t **r_buffer, int &r_buff
 	current_packet = incoming_packets.front()->get();
 	incoming_packets.pop_front();
 
-	*r_buffer = (const uint8_t *)(&current_packet.packet->data[12]);
-	r_buffer_size = current_packet.packet->dataLength - 12;
+	*r_buffer = (const uint8_t *)(&current_packet.packet->data[current_packet.offset]);
+	r_buffer_size = current_packet.size;
 
 	return OK;
 }
@@ -439,45 +466,218 @@ Error NetworkedMultiplayerENet::put_packet(const uint8_t *p_buffer, int p_buffer
 		}
 	}
 
-	ENetPacket *packet = enet_packet_create(NULL, p_buffer_size + 12, packet_flags);
+	ERR_FAIL_COND_V(!server && !peer_map.has(1), ERR_BUG);
+
+	if (batching) {
+
+		Batch &batch = batches[channel];
+
+		//messages are only batched with the ones right before them, so each channel keeps its order
+		if (batch.count && (batch.target != target_peer || batch.flags != packet_flags)) {
+			_flush_batch(channel);
+		}
+
+		int len = encode_varint(p_buffer_size, NULL) + p_buffer_size;
+		int limit = MAX(int(host->mtu) - BATCH_OVERHEAD, PACKET_HEADER_SIZE + 1);
+
+		if (batch.count && batch.size + len > limit) {
+			_flush_batch(channel);
+		}
+
+		if (!batch.count) {
+			batch.size = PACKET_HEADER_SIZE;
+			batch.target = target_peer;
+			batch.flags = packet_flags;
+		}
+
+		if (batch.data.size() < batch.size + len) {
+			batch.data.resize(MAX(batch.size + len, limit));
+		}
+
+		uint8_t *w = batch.data.ptrw();
+		batch.size += encode_varint(p_buffer_size, &w[batch.size]);
+		copymem(&w[batch.size], p_buffer, p_buffer_size);
+		batch.size += p_buffer_size;
+		batch.count++;
+
+		if (batch.size >= limit) {
+			_flush_batch(channel);
+		}
+
+		return OK;
+	}
+
+	ENetPacket *packet = enet_packet_create(NULL, p_buffer_size + PACKET_HEADER_SIZE, packet_flags);
 	encode_uint32(unique_id, &packet->data[0]); //source ID
 	encode_uint32(target_peer, &packet->data[4]); //dest ID
 	encode_uint32(packet_flags, &packet->data[8]); //dest ID
-	copymem(&packet->data[12], p_buffer, p_buffer_size);
+	copymem(&packet->data[PACKET_HEADER_SIZE], p_buffer, p_buffer_size);
+
+	_send_packet(target_peer, channel, packet);
+
+	enet_host_flush(host);
+
+	return OK;
+}
+
+void NetworkedMultiplayerENet::_send_packet(int p_target, int p_channel, ENetPacket *p_packet) {
+
+	int messages = 1;
+	if (decode_uint32(&p_packet->data[8]) & PACKET_FLAG_BATCH) {
+		messages = batches[p_channel].count;
+	}
+	int bytes = p_packet->dataLength; //ENet may free the packet once sent
 
 	if (server) {
 
-		if (target_peer == 0) {
-			enet_host_broadcast(host, channel, packet);
-		} else if (target_peer < 0) {
+		if (p_target == 0) {
+			enet_host_broadcast(host, p_channel, p_packet);
+		} else if (p_target < 0) {
 			//send to all but one
 			//and make copies for sending
 
-			int exclude = -target_peer;
+			int exclude = -p_target;
 
 			for (Map<int, ENetPeer *>::Element *F = peer_map.front(); F; F = F->next()) {
 
 				if (F->key() == exclude) // exclude packet
 					continue;
 
-				ENetPacket *packet2 = enet_packet_create(packet->data, packet->dataLength, packet_flags);
+				ENetPacket *packet2 = enet_packet_create(p_packet->data, p_packet->dataLength, p_packet->flags);
 
-				enet_peer_send(F->get(), channel, packet2);
+				enet_peer_send(F->get(), p_channel, packet2);
 			}
-
-			enet_packet_destroy(packet); //original packet no longer needed
 		} else {
-			enet_peer_send(E->get(), channel, packet);
+			enet_peer_send(peer_map[p_target], p_channel, p_packet);
+		}
+
+		for (Map<int, ENetPeer *>::Element *F = peer_map.front(); F; F = F->next()) {
+
+			if (p_target == 0 || (p_target < 0 && F->key() != -p_target) || F->key() == p_target) {
+				_count_sent(F->get(), messages, bytes);
+			}
+		}
+
+		if (p_target < 0) {
+			enet_packet_destroy(p_packet); //original packet no longer needed
 		}
 	} else {
 
-		ERR_FAIL_COND_V(!peer_map.has(1), ERR_BUG);
-		enet_peer_send(peer_map[1], channel, packet); //send to server for broadcast..
+		if (!peer_map.has(1)) {
+			enet_packet_destroy(p_packet);
+			ERR_FAIL();
+		}
+
+		enet_peer_send(peer_map[1], p_channel, p_packet); //send to server for broadcast..
+		_count_sent(peer_map[1], messages, bytes);
 	}
+}
 
-	enet_host_flush(host);
+void NetworkedMultiplayerENet::_count_sent(ENetPeer *p_peer, int p_messages, int p_bytes) {
 
-	return OK;
+	PeerData *peer_data = (PeerData *)p_peer->data;
+	peer_data->stats[PEER_STAT_MESSAGES_SENT] += p_messages;
+	peer_data->stats[PEER_STAT_PACKETS_SENT]++;
+	peer_data->stats[PEER_STAT_BYTES_SENT] += p_bytes;
+}
+
+void NetworkedMultiplayerENet::_flush_batch(int p_channel) {
+
+	Batch &batch = batches[p_channel];
+	if (!batch.count)
+		return;
+
+	ENetPacket *packet = enet_packet_create(batch.data.ptr(), batch.size, batch.flags);
+	encode_uint32(unique_id, &packet->data[0]); //source ID
+	encode_uint32(batch.target, &packet->data[4]); //dest ID
+	encode_uint32(batch.flags | PACKET_FLAG_BATCH, &packet->data[8]);
+
+	if (server && batch.target > 0 && !peer_map.has(batch.target)) {
+		//the target left since the messages were queued
+		enet_packet_destroy(packet);
+	} else {
+		_send_packet(batch.target, p_channel, packet);
+	}
+
+	batch.count = 0;
+}
+
+void NetworkedMultiplayerENet::_flush_batches() {
+
+	for (int i = 0; i < SYSCH_MAX; i++) {
+		_flush_batch(i);
+	}
+}
+
+bool NetworkedMultiplayerENet::_is_batch_valid(const ENetPacket *p_packet) const {
+
+	if (!(decode_uint32(&p_packet->data[8]) & PACKET_FLAG_BATCH))
+		return true;
+
+	//at least one message, and the sizes must add up to the packet
+	int ofs = PACKET_HEADER_SIZE;
+	int len = p_packet->dataLength;
+
+	if (ofs == len)
+		return false;
+
+	while (ofs < len) {
+
+		uint64_t size;
+		int size_len = decode_varint(&p_packet->data[ofs], len - ofs, size);
+		if (size_len == 0 || size > uint64_t(len - ofs - size_len))
+			return false;
+		ofs += size_len + size;
+	}
+
+	return true;
+}
+
+int NetworkedMultiplayerENet::_push_incoming(ENetPacket *p_packet, int p_from) {
+
+	Packet packet;
+	packet.packet = p_packet;
+	packet.from = p_from;
+	packet.owner = true;
+
+	if (!(decode_uint32(&p_packet->data[8]) & PACKET_FLAG_BATCH)) {
+		packet.offset = PACKET_HEADER_SIZE;
+		packet.size = p_packet->dataLength - PACKET_HEADER_SIZE;
+		incoming_packets.push_back(packet);
+		return 1;
+	}
+
+	//one entry per message, all sharing the ENet packet
+	List<Packet>::Element *last = NULL;
+	int count = 0;
+	int ofs = PACKET_HEADER_SIZE;
+	int len = p_packet->dataLength;
+
+	while (ofs < len) {
+
+		uint64_t size;
+		int size_len = decode_varint(&p_packet->data[ofs], len - ofs, size);
+		if (size_len == 0 || size > uint64_t(len - ofs - size_len)) {
+			ERR_PRINT("Malformed batch of messages, the rest is dropped.");
+			break;
+		}
+		ofs += size_len;
+
+		packet.offset = ofs;
+		packet.size = size;
+		packet.owner = false;
+		last = incoming_packets.push_back(packet);
+		ofs += size;
+		count++;
+	}
+
+	if (last) {
+		last->get().owner = true;
+	} else {
+		enet_packet_destroy(p_packet);
+	}
+
+	return count;
 }
 
 int NetworkedMultiplayerENet::get_max_packet_size() const {
@@ -488,7 +688,9 @@ int NetworkedMultiplayerENet::get_max_packet_size() const {
 void NetworkedMultiplayerENet::_pop_current_packet() {
 
 	if (current_packet.packet) {
-		enet_packet_destroy(current_packet.packet);
+		if (current_packet.owner) {
+			enet_packet_destroy(current_packet.packet);
+		}
 		current_packet.packet = NULL;
 		current_packet.from = 0;
 	}
@@ -649,6 +851,55 @@ void NetworkedMultiplayerENet::_setup_compressor() {
 	}
 }
 
+void NetworkedMultiplayerENet::set_batching_enabled(bool p_enabled) {
+
+	if (batching && !p_enabled && active) {
+		_flush_batches(); //the next messages must not overtake them
+	}
+	batching = p_enabled;
+}
+
+bool NetworkedMultiplayerENet::is_batching_enabled() const {
+
+	return batching;
+}
+
+uint64_t NetworkedMultiplayerENet::get_peer_statistic(int p_id, PeerStatistic p_statistic) const {
+
+	ERR_FAIL_INDEX_V(p_statistic, PEER_STAT_MAX, 0);
+	ERR_FAIL_COND_V(!active, 0);
+
+	const Map<int, ENetPeer *>::Element *E = peer_map.find(p_id);
+	ERR_FAIL_COND_V(!E, 0);
+	if (!E->get())
+		return 0; //only known through the server, no direct connection
+
+	ENetPeer *peer = E->get();
+
+	switch (p_statistic) {
+		case PEER_STAT_SEND_QUEUE: {
+
+			//messages waiting in the batches for this peer, and commands waiting in ENet
+			uint64_t queued = enet_list_size(&peer->outgoingReliableCommands) + enet_list_size(&peer->outgoingUnreliableCommands);
+			for (int i = 0; i < SYSCH_MAX; i++) {
+				const Batch &batch = batches[i];
+				if (!server || batch.target == 0 || (batch.target < 0 && -batch.target != p_id) || batch.target == p_id) {
+					queued += batch.count;
+				}
+			}
+			return queued;
+		} break;
+		case PEER_STAT_ROUND_TRIP_TIME: {
+
+			return peer->roundTripTime;
+		} break;
+		default: {
+
+			return ((const PeerData *)peer->data)->stats[p_statistic];
+		}
+	}
+}
+
 void NetworkedMultiplayerENet::enet_compressor_destroy(void *context) {
 
 	//do none
@@ -662,14 +913,28 @@ void NetworkedMultiplayerENet::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_compression_mode", "mode"), &NetworkedMultiplayerENet::set_compression_mode);
 	ClassDB::bind_method(D_METHOD("get_compression_mode"), &NetworkedMultiplayerENet::get_compression_mode);
 	ClassDB::bind_method(D_METHOD("set_bind_ip", "ip"), &NetworkedMultiplayerENet::set_bind_ip);
+	ClassDB::bind_method(D_METHOD("set_batching_enabled", "enabled"), &NetworkedMultiplayerENet::set_batching_enabled);
+	ClassDB::bind_method(D_METHOD("is_batching_enabled"), &NetworkedMultiplayerENet::is_batching_enabled);
+	ClassDB::bind_method(D_METHOD("get_peer_statistic", "id", "statistic"), &NetworkedMultiplayerENet::get_peer_statistic);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "compression_mode", PROPERTY_HINT_ENUM, "None,Range Coder,FastLZ,ZLib,ZStd"), "set_compression_mode", "get_compression_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "batching"), "set_batching_enabled", "is_batching_enabled");
 
 	BIND_ENUM_CONSTANT(COMPRESS_NONE);
 	BIND_ENUM_CONSTANT(COMPRESS_RANGE_CODER);
 	BIND_ENUM_CONSTANT(COMPRESS_FASTLZ);
 	BIND_ENUM_CONSTANT(COMPRESS_ZLIB);
 	BIND_ENUM_CONSTANT(COMPRESS_ZSTD);
+
+	BIND_ENUM_CONSTANT(PEER_STAT_MESSAGES_SENT);
+	BIND_ENUM_CONSTANT(PEER_STAT_PACKETS_SENT);
+	BIND_ENUM_CONSTANT(PEER_STAT_BYTES_SENT);
+	BIND_ENUM_CONSTANT(PEER_STAT_MESSAGES_RECEIVED);
+	BIND_ENUM_CONSTANT(PEER_STAT_PACKETS_RECEIVED);
+	BIND_ENUM_CONSTANT(PEER_STAT_BYTES_RECEIVED);
+	BIND_ENUM_CONSTANT(PEER_STAT_SEND_QUEUE);
+	BIND_ENUM_CONSTANT(PEER_STAT_ROUND_TRIP_TIME);
+	BIND_ENUM_CONSTANT(PEER_STAT_MAX);
 }
 
 NetworkedMultiplayerENet::NetworkedMultiplayerENet() {
@@ -680,6 +945,14 @@ NetworkedMultiplayerENet::NetworkedMultiplayerENet() {
 	unique_id = 0;
 	target_peer = 0;
 	current_packet.packet = NULL;
+	current_packet.owner = false;
+	batching = false;
+	for (int i = 0; i < SYSCH_MAX; i++) {
+		batches[i].size = 0;
+		batches[i].count = 0;
+		batches[i].target = 0;
+		batches[i].flags = 0;
+	}
 	transfer_mode = TRANSFER_MODE_RELIABLE;
 	connection_status = CONNECTION_DISCONNECTED;
 	compression_mode = COMPRESS_NONE;
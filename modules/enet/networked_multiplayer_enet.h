@@ -48,6 +48,18 @@ public:
 		COMPRESS_ZSTD
 	};
 
+	enum PeerStatistic {
+		PEER_STAT_MESSAGES_SENT,
+		PEER_STAT_PACKETS_SENT,
+		PEER_STAT_BYTES_SENT,
+		PEER_STAT_MESSAGES_RECEIVED,
+		PEER_STAT_PACKETS_RECEIVED,
+		PEER_STAT_BYTES_RECEIVED,
+		PEER_STAT_SEND_QUEUE,
+		PEER_STAT_ROUND_TRIP_TIME,
+		PEER_STAT_MAX
+	};
+
 private:
 	enum {
 		SYSMSG_ADD_PEER,
@@ -61,6 +73,25 @@ private:
 		SYSCH_MAX
 	};
 
+	enum {
+		PACKET_HEADER_SIZE = 12, //source, target, flags
+		PACKET_FLAG_BATCH = 1 << 30, //in the flags of the header, the payload is a sequence of [varint size][message]
+		BATCH_OVERHEAD = 32, //ENet protocol and command headers, kept out of the MTU
+	};
+
+	struct PeerData {
+		int id;
+		uint64_t stats[PEER_STAT_SEND_QUEUE]; //the counters, the rest is read from ENet
+	};
+
+	struct Batch {
+		Vector<uint8_t> data;
+		int size;
+		int count;
+		int target;
+		int flags;
+	};
+
 	bool active;
 	bool server;
 
@@ -83,6 +114,9 @@ private:
 
 		ENetPacket *packet;
 		int from;
+		int offset;
+		int size;
+		bool owner; //the last message of a batch frees the ENet packet
 	};
 
 	CompressionMode compression_mode;
@@ -91,8 +125,17 @@ private:
 
 	Packet current_packet;
 
+	bool batching;
+	Batch batches[SYSCH_MAX];
+
 	uint32_t _gen_unique_id() const;
 	void _pop_current_packet();
+	bool _is_batch_valid(const ENetPacket *p_packet) const;
+	int _push_incoming(ENetPacket *p_packet, int p_from);
+	void _send_packet(int p_target, int p_channel, ENetPacket *p_packet);
+	void _count_sent(ENetPeer *p_peer, int p_messages, int p_bytes);
+	void _flush_batch(int p_channel);
+	void _flush_batches();
 
 	Vector<uint8_t> src_compressor_mem;
 	Vector<uint8_t> dst_compressor_mem;
@@ -140,6 +183,11 @@ public:
 	void set_compression_mode(CompressionMode p_mode);
 	CompressionMode get_compression_mode() const;
 
+	void set_batching_enabled(bool p_enabled);
+	bool is_batching_enabled() const;
+
+	uint64_t get_peer_statistic(int p_id, PeerStatistic p_statistic) const;
+
 	NetworkedMultiplayerENet();
 	~NetworkedMultiplayerENet();
 
@@ -147,5 +195,6 @@ public:
 };
 
 VARIANT_ENUM_CAST(NetworkedMultiplayerENet::CompressionMode);
+VARIANT_ENUM_CAST(NetworkedMultiplayerENet::PeerStatistic);
 
 #endif // NETWORKED_MULTIPLAYER_ENET_H
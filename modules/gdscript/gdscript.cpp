@@ -904,6 +904,7 @@ GDScript::GDScript() :
 }
 
 GDScript::~GDScript() {
+	MethodCallCache::invalidate_all(); //call sites may still point to the functions or reuse this address as key
 	for (Map<StringName, GDScriptFunction *>::Element *E = member_functions.front(); E; E = E->next()) {
 		memdelete(E->get());
 	}
@@ -1156,6 +1157,29 @@ Variant GDScriptInstance::call(const StringName &p_method, const Variant **p_arg
 	return Variant();
 }
 
+const void *GDScriptInstance::get_method_cache_key() const {
+
+	return script.ptr();
+}
+
+const void *GDScriptInstance::get_method_handle(const StringName &p_method) const {
+
+	const GDScript *sptr = script.ptr();
+	while (sptr) {
+		const Map<StringName, GDScriptFunction *>::Element *E = sptr->member_functions.find(p_method);
+		if (E) {
+			return E->get();
+		}
+		sptr = sptr->_base;
+	}
+	return NULL;
+}
+
+Variant GDScriptInstance::call_method_handle(const void *p_handle, const Variant **p_args, int p_argcount, Variant::CallError &r_error) {
+
+	return ((GDScriptFunction *)p_handle)->call(this, p_args, p_argcount, r_error);
+}
+
 void GDScriptInstance::call_multilevel(const StringName &p_method, const Variant **p_args, int p_argcount) {
 
 	GDScript *sptr = script.ptr();
@@ -135,6 +135,7 @@ protected:
 	void _get_property_list(List<PropertyInfo> *p_properties) const;
 
 	Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error);
+	virtual bool _has_call_override() const { return true; }
 	//void call_multilevel(const StringName& p_method,const Variant** p_args,int p_argcount);
 
 	static void _bind_methods();
@@ -233,6 +234,9 @@ public:
 	virtual void get_method_list(List<MethodInfo> *p_list) const;
 	virtual bool has_method(const StringName &p_method) const;
 	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error);
+	virtual const void *get_method_cache_key() const;
+	virtual const void *get_method_handle(const StringName &p_method) const;
+	virtual Variant call_method_handle(const void *p_handle, const Variant **p_args, int p_argcount, Variant::CallError &r_error);
 	virtual void call_multilevel(const StringName &p_method, const Variant **p_args, int p_argcount);
 	virtual void call_multilevel_reversed(const StringName &p_method, const Variant **p_args, int p_argcount);
 
@@ -111,6 +111,48 @@ bool GDScriptCompiler::_create_binary_operator(CodeGen &codegen, const GDScriptP
 	return true;
 }
 
+int GDScriptCompiler::_create_jump_if_not(CodeGen &codegen, const GDScriptParser::Node *p_condition, int p_stack_level) {
+
+	//comparisons used as conditions are fused with the jump, so no temporary is written and booleanized
+	if (p_condition->type == GDScriptParser::Node::TYPE_OPERATOR) {
+
+		const GDScriptParser::OperatorNode *on = static_cast<const GDScriptParser::OperatorNode *>(p_condition);
+		Variant::Operator op = Variant::OP_MAX;
+
+		switch (on->op) {
+			case GDScriptParser::OperatorNode::OP_EQUAL: op = Variant::OP_EQUAL; break;
+			case GDScriptParser::OperatorNode::OP_NOT_EQUAL: op = Variant::OP_NOT_EQUAL; break;
+			case GDScriptParser::OperatorNode::OP_LESS: op = Variant::OP_LESS; break;
+			case GDScriptParser::OperatorNode::OP_LESS_EQUAL: op = Variant::OP_LESS_EQUAL; break;
+			case GDScriptParser::OperatorNode::OP_GREATER: op = Variant::OP_GREATER; break;
+			case GDScriptParser::OperatorNode::OP_GREATER_EQUAL: op = Variant::OP_GREATER_EQUAL; break;
+			default: {
+			}
+		}
+
+		if (op != Variant::OP_MAX) {
+
+			if (!_create_binary_operator(codegen, on, op, p_stack_level))
+				return -1;
+
+			codegen.opcodes[codegen.opcodes.size() - 4] = GDScriptFunction::OPCODE_JUMP_IF_NOT_COMPARE;
+			int jump_addr = codegen.opcodes.size();
+			codegen.opcodes.push_back(0); //temporary
+			return jump_addr;
+		}
+	}
+
+	int ret = _parse_expression(codegen, p_condition, p_stack_level, false);
+	if (ret < 0)
+		return -1;
+
+	codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT);
+	codegen.opcodes.push_back(ret);
+	int jump_addr = codegen.opcodes.size();
+	codegen.opcodes.push_back(0); //temporary
+	return jump_addr;
+}
+
 /*
 int GDScriptCompiler::_parse_subexpression(CodeGen& codegen,const GDScriptParser::Node *p_expression) {
 
@@ -524,7 +566,10 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
 						codegen.opcodes.push_back(on->arguments.size() - 2);
 						codegen.alloc_call(on->arguments.size() - 2);
-						for (int i = 0; i < arguments.size(); i++)
+						codegen.opcodes.push_back(arguments[0]); // base
+						codegen.opcodes.push_back(arguments[1]); // method name
+						codegen.opcodes.push_back(codegen.alloc_call_cache()); // builtin method cache slot
+						for (int i = 2; i < arguments.size(); i++)
 							codegen.opcodes.push_back(arguments[i]);
 					}
 				} break;
@@ -830,6 +875,28 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						}
 #endif
 
+						if (static_cast<GDScriptParser::OperatorNode *>(on->arguments[0])->op == GDScriptParser::OperatorNode::OP_INDEX_NAMED) {
+							const GDScriptParser::OperatorNode *inon = static_cast<GDScriptParser::OperatorNode *>(on->arguments[0]);
+
+							if (inon->arguments[0]->type == GDScriptParser::Node::TYPE_SELF && codegen.script && codegen.function_node && !codegen.function_node->_static) {
+
+								const Map<StringName, GDScript::MemberInfo>::Element *MI = codegen.script->member_indices.find(static_cast<GDScriptParser::IdentifierNode *>(inon->arguments[1])->name);
+								if (MI && MI->get().setter == "") {
+									// Without a setter, assigning 'self.member' is a plain store to the member slot
+									int dst_address = (MI->get().index) | (GDScriptFunction::ADDR_TYPE_MEMBER << GDScriptFunction::ADDR_BITS);
+
+									int src_address = _parse_assign_right_expression(codegen, on, p_stack_level);
+									if (src_address < 0)
+										return -1;
+
+									codegen.opcodes.push_back(GDScriptFunction::OPCODE_ASSIGN);
+									codegen.opcodes.push_back(dst_address);
+									codegen.opcodes.push_back(src_address);
+									return dst_address;
+								}
+							}
+						}
+
 						int slevel = p_stack_level;
 
 						GDScriptParser::OperatorNode *op = static_cast<GDScriptParser::OperatorNode *>(on->arguments[0]);
@@ -1163,15 +1230,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 						codegen.opcodes.push_back(cf->line);
 						codegen.current_line = cf->line;
 #endif
-						int ret = _parse_expression(codegen, cf->arguments[0], p_stack_level, false);
-						if (ret < 0)
+						int else_addr = _create_jump_if_not(codegen, cf->arguments[0], p_stack_level);
+						if (else_addr < 0)
 							return ERR_PARSE_ERROR;
 
-						codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-						codegen.opcodes.push_back(ret);
-						int else_addr = codegen.opcodes.size();
-						codegen.opcodes.push_back(0); //temporary
-
 						Error err = _parse_block(codegen, cf->body, p_stack_level, p_break_addr, p_continue_addr);
 						if (err)
 							return err;
@@ -1255,12 +1317,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 						codegen.opcodes.push_back(0);
 						int continue_addr = codegen.opcodes.size();
 
-						int ret = _parse_expression(codegen, cf->arguments[0], p_stack_level, false);
-						if (ret < 0)
+						int exit_addr = _create_jump_if_not(codegen, cf->arguments[0], p_stack_level);
+						if (exit_addr < 0)
 							return ERR_PARSE_ERROR;
-						codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-						codegen.opcodes.push_back(ret);
-						codegen.opcodes.push_back(break_addr);
+						codegen.opcodes[exit_addr] = break_addr;
 						Error err = _parse_block(codegen, cf->body, p_stack_level, break_addr, continue_addr);
 						if (err)
 							return err;
@@ -1376,6 +1436,7 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	codegen.stack_max = 0;
 	codegen.current_line = 0;
 	codegen.call_max = 0;
+	codegen.call_cache_count = 0;
 	codegen.debug_stack = ScriptDebugger::get_singleton() != NULL;
 	Vector<StringName> argnames;
 
@@ -1523,6 +1584,21 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 		gdfunc->_code_size = 0;
 	}
 
+	if (codegen.call_cache_count) {
+
+		gdfunc->call_cache.resize(codegen.call_cache_count);
+		gdfunc->_call_cache_ptr = gdfunc->call_cache.ptrw();
+		for (int i = 0; i < codegen.call_cache_count; i++) {
+			gdfunc->_call_cache_ptr[i].builtin = NULL;
+			gdfunc->_call_cache_ptr[i].method.clear();
+		}
+		gdfunc->_call_cache_count = codegen.call_cache_count;
+	} else {
+
+		gdfunc->_call_cache_ptr = NULL;
+		gdfunc->_call_cache_count = 0;
+	}
+
 	if (defarg_addr.size()) {
 
 		gdfunc->default_arguments = defarg_addr;
@@ -1604,6 +1680,7 @@ Error GDScriptCompiler::_parse_class(GDScript *p_script, GDScript *p_owner, cons
 	p_script->_base = NULL;
 	p_script->members.clear();
 	p_script->constants.clear();
+	MethodCallCache::invalidate_all(); //before the functions call sites may point to are gone
 	for (Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
 		memdelete(E->get());
 	}
@@ -121,10 +121,14 @@ class GDScriptCompiler {
 		void alloc_call(int p_params) {
 			if (p_params >= call_max) call_max = p_params;
 		}
+		int alloc_call_cache() {
+			return call_cache_count++;
+		}
 
 		int current_line;
 		int stack_max;
 		int call_max;
+		int call_cache_count;
 	};
 
 	bool _is_class_member_property(CodeGen &codegen, const StringName &p_name);
@@ -135,6 +139,8 @@ class GDScriptCompiler {
 	bool _create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level);
 	bool _create_binary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level, bool p_initializer = false);
 
+	int _create_jump_if_not(CodeGen &codegen, const GDScriptParser::Node *p_condition, int p_stack_level);
+
 	int _parse_assign_right_expression(CodeGen &codegen, const GDScriptParser::OperatorNode *p_expression, int p_stack_level);
 	int _parse_expression(CodeGen &codegen, const GDScriptParser::Node *p_expression, int p_stack_level, bool p_root = false, bool p_initializer = false);
 	Error _parse_block(CodeGen &codegen, const GDScriptParser::BlockNode *p_block, int p_stack_level = 0, int p_break_addr = -1, int p_continue_addr = -1);
@@ -33,6 +33,8 @@
 #include "gdscript.h"
 #include "gdscript_functions.h"
 #include "os/os.h"
+#include "safe_refcount.h"
+#include "variant_internal.h"
 
 Variant *GDScriptFunction::_get_variant(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant *p_stack, String &r_error) const {
 
@@ -171,10 +173,181 @@ static String _get_var_type(const Variant *p_type) {
 	return basestr;
 }
 
+// Typed operator fast paths. Each returns false when the operands or the
+// operator are not covered, so the caller falls back to Variant::evaluate().
+
+static _FORCE_INLINE_ bool _evaluate_int_operator(Variant::Operator p_op, const Variant *p_a, const Variant *p_b, Variant *r_dst) {
+
+	if (unlikely(p_a->get_type() != Variant::INT || p_b->get_type() != Variant::INT))
+		return false;
+
+	int64_t a = VariantInternal::get_int(p_a);
+	int64_t b = VariantInternal::get_int(p_b);
+
+	switch (p_op) {
+		case Variant::OP_EQUAL: VariantInternal::set_bool(r_dst, a == b); return true;
+		case Variant::OP_NOT_EQUAL: VariantInternal::set_bool(r_dst, a != b); return true;
+		case Variant::OP_LESS: VariantInternal::set_bool(r_dst, a < b); return true;
+		case Variant::OP_LESS_EQUAL: VariantInternal::set_bool(r_dst, a <= b); return true;
+		case Variant::OP_GREATER: VariantInternal::set_bool(r_dst, a > b); return true;
+		case Variant::OP_GREATER_EQUAL: VariantInternal::set_bool(r_dst, a >= b); return true;
+		case Variant::OP_ADD: VariantInternal::set_int(r_dst, a + b); return true;
+		case Variant::OP_SUBTRACT: VariantInternal::set_int(r_dst, a - b); return true;
+		case Variant::OP_MULTIPLY: VariantInternal::set_int(r_dst, a * b); return true;
+		case Variant::OP_DIVIDE: {
+			if (b == 0)
+				return false; //let the generic path report it
+			VariantInternal::set_int(r_dst, a / b);
+			return true;
+		}
+		case Variant::OP_MODULE: {
+			if (b == 0)
+				return false;
+			VariantInternal::set_int(r_dst, a % b);
+			return true;
+		}
+		case Variant::OP_NEGATE: VariantInternal::set_int(r_dst, -a); return true;
+		case Variant::OP_POSITIVE: VariantInternal::set_int(r_dst, a); return true;
+		case Variant::OP_SHIFT_LEFT: VariantInternal::set_int(r_dst, a << b); return true;
+		case Variant::OP_SHIFT_RIGHT: VariantInternal::set_int(r_dst, a >> b); return true;
+		case Variant::OP_BIT_AND: VariantInternal::set_int(r_dst, a & b); return true;
+		case Variant::OP_BIT_OR: VariantInternal::set_int(r_dst, a | b); return true;
+		case Variant::OP_BIT_XOR: VariantInternal::set_int(r_dst, a ^ b); return true;
+		case Variant::OP_BIT_NEGATE: VariantInternal::set_int(r_dst, ~a); return true;
+		default: return false;
+	}
+}
+
+static _FORCE_INLINE_ bool _evaluate_real_operator(Variant::Operator p_op, const Variant *p_a, const Variant *p_b, Variant *r_dst) {
+
+	//at least one real, otherwise the result type is int
+	if (unlikely(!p_a->is_num() || !p_b->is_num() || (p_a->get_type() != Variant::REAL && p_b->get_type() != Variant::REAL)))
+		return false;
+
+	double a = VariantInternal::get_number(p_a);
+	double b = VariantInternal::get_number(p_b);
+
+	switch (p_op) {
+		case Variant::OP_EQUAL: VariantInternal::set_bool(r_dst, a == b); return true;
+		case Variant::OP_NOT_EQUAL: VariantInternal::set_bool(r_dst, a != b); return true;
+		case Variant::OP_LESS: VariantInternal::set_bool(r_dst, a < b); return true;
+		case Variant::OP_LESS_EQUAL: VariantInternal::set_bool(r_dst, a <= b); return true;
+		case Variant::OP_GREATER: VariantInternal::set_bool(r_dst, a > b); return true;
+		case Variant::OP_GREATER_EQUAL: VariantInternal::set_bool(r_dst, a >= b); return true;
+		case Variant::OP_ADD: VariantInternal::set_real(r_dst, a + b); return true;
+		case Variant::OP_SUBTRACT: VariantInternal::set_real(r_dst, a - b); return true;
+		case Variant::OP_MULTIPLY: VariantInternal::set_real(r_dst, a * b); return true;
+		case Variant::OP_DIVIDE: {
+			if (b == 0)
+				return false;
+			VariantInternal::set_real(r_dst, a / b);
+			return true;
+		}
+		case Variant::OP_NEGATE: VariantInternal::set_real(r_dst, -a); return true;
+		case Variant::OP_POSITIVE: VariantInternal::set_real(r_dst, a); return true;
+		default: return false;
+	}
+}
+
+#define VECTOR_OPERATOR_FUNC(m_func, m_type, m_vtype, m_get, m_set)                                                     \
+	static _FORCE_INLINE_ bool m_func(Variant::Operator p_op, const Variant *p_a, const Variant *p_b, Variant *r_dst) { \
+                                                                                                                        \
+		Variant::Type ta = p_a->get_type();                                                                             \
+		Variant::Type tb = p_b->get_type();                                                                             \
+                                                                                                                        \
+		if (ta == m_vtype && tb == m_vtype) {                                                                           \
+			const m_type &a = *VariantInternal::m_get(p_a);                                                             \
+			const m_type &b = *VariantInternal::m_get(p_b);                                                             \
+			switch (p_op) {                                                                                             \
+				case Variant::OP_EQUAL: VariantInternal::set_bool(r_dst, a == b); return true;                          \
+				case Variant::OP_NOT_EQUAL: VariantInternal::set_bool(r_dst, a != b); return true;                      \
+				case Variant::OP_ADD: VariantInternal::m_set(r_dst, a + b); return true;                                \
+				case Variant::OP_SUBTRACT: VariantInternal::m_set(r_dst, a - b); return true;                           \
+				case Variant::OP_MULTIPLY: VariantInternal::m_set(r_dst, a * b); return true;                           \
+				case Variant::OP_DIVIDE: VariantInternal::m_set(r_dst, a / b); return true;                             \
+				case Variant::OP_NEGATE: VariantInternal::m_set(r_dst, -a); return true;                                \
+				case Variant::OP_POSITIVE: VariantInternal::m_set(r_dst, a); return true;                               \
+				default: return false;                                                                                  \
+			}                                                                                                           \
+		}                                                                                                               \
+                                                                                                                        \
+		if (ta == m_vtype && p_b->is_num()) {                                                                           \
+			const m_type &a = *VariantInternal::m_get(p_a);                                                             \
+			real_t b = VariantInternal::get_number(p_b);                                                                \
+			switch (p_op) {                                                                                             \
+				case Variant::OP_MULTIPLY: VariantInternal::m_set(r_dst, a * b); return true;                           \
+				case Variant::OP_DIVIDE: VariantInternal::m_set(r_dst, a / b); return true;                             \
+				default: return false;                                                                                  \
+			}                                                                                                           \
+		}                                                                                                               \
+                                                                                                                        \
+		if (p_a->is_num() && tb == m_vtype && p_op == Variant::OP_MULTIPLY) {                                           \
+			VariantInternal::m_set(r_dst, *VariantInternal::m_get(p_b) * real_t(VariantInternal::get_number(p_a)));     \
+			return true;                                                                                                \
+		}                                                                                                               \
+                                                                                                                        \
+		return false;                                                                                                   \
+	}
+
+VECTOR_OPERATOR_FUNC(_evaluate_vector2_operator, Vector2, Variant::VECTOR2, get_vector2, set_vector2)
+VECTOR_OPERATOR_FUNC(_evaluate_vector3_operator, Vector3, Variant::VECTOR3, get_vector3, set_vector3)
+
+#undef VECTOR_OPERATOR_FUNC
+
+template <class T>
+static _FORCE_INLINE_ bool _compare(Variant::Operator p_op, T a, T b) {
+
+	switch (p_op) {
+		case Variant::OP_EQUAL: return a == b;
+		case Variant::OP_NOT_EQUAL: return a != b;
+		case Variant::OP_LESS: return a < b;
+		case Variant::OP_LESS_EQUAL: return a <= b;
+		case Variant::OP_GREATER: return a > b;
+		default: return a >= b;
+	}
+}
+
+// Comparison fast path for OPCODE_JUMP_IF_NOT_COMPARE, returns false unless both operands are numbers.
+static _FORCE_INLINE_ bool _compare_numbers(Variant::Operator p_op, const Variant *p_a, const Variant *p_b, bool &r_result) {
+
+	if (p_a->get_type() == Variant::INT && p_b->get_type() == Variant::INT) {
+		r_result = _compare(p_op, VariantInternal::get_int(p_a), VariantInternal::get_int(p_b));
+		return true;
+	}
+	if (p_a->is_num() && p_b->is_num()) {
+		r_result = _compare(p_op, VariantInternal::get_number(p_a), VariantInternal::get_number(p_b));
+		return true;
+	}
+	return false;
+}
+
+// Picks the typed opcode an OPCODE_OPERATOR is rewritten to, given the operands it just saw.
+static _FORCE_INLINE_ int _get_typed_operator_opcode(const Variant *p_a, const Variant *p_b) {
+
+	Variant::Type ta = p_a->get_type();
+	Variant::Type tb = p_b->get_type();
+
+	if (ta == Variant::INT && tb == Variant::INT)
+		return GDScriptFunction::OPCODE_OPERATOR_INT;
+	if (p_a->is_num() && p_b->is_num())
+		return GDScriptFunction::OPCODE_OPERATOR_REAL;
+	if (ta == Variant::VECTOR2 || tb == Variant::VECTOR2)
+		return GDScriptFunction::OPCODE_OPERATOR_VECTOR2;
+	if (ta == Variant::VECTOR3 || tb == Variant::VECTOR3)
+		return GDScriptFunction::OPCODE_OPERATOR_VECTOR3;
+
+	return GDScriptFunction::OPCODE_OPERATOR;
+}
+
 #if defined(__GNUC__)
 #define OPCODES_TABLE                         \
 	static const void *switch_table_ops[] = { \
 		&&OPCODE_OPERATOR,                    \
+		&&OPCODE_OPERATOR_GENERIC,            \
+		&&OPCODE_OPERATOR_INT,                \
+		&&OPCODE_OPERATOR_REAL,               \
+		&&OPCODE_OPERATOR_VECTOR2,            \
+		&&OPCODE_OPERATOR_VECTOR3,            \
 		&&OPCODE_EXTENDS_TEST,                \
 		&&OPCODE_SET,                         \
 		&&OPCODE_GET,                         \
@@ -199,6 +372,7 @@ static String _get_var_type(const Variant *p_type) {
 		&&OPCODE_JUMP,                        \
 		&&OPCODE_JUMP_IF,                     \
 		&&OPCODE_JUMP_IF_NOT,                 \
+		&&OPCODE_JUMP_IF_NOT_COMPARE,         \
 		&&OPCODE_JUMP_TO_DEF_ARGUMENT,        \
 		&&OPCODE_RETURN,                      \
 		&&OPCODE_ITERATE_BEGIN,               \
@@ -216,7 +390,7 @@ static String _get_var_type(const Variant *p_type) {
 	OPSEXIT:
 #define OPCODES_OUT \
 	OPSOUT:
-#define DISPATCH_OPCODE goto *switch_table_ops[_code_ptr[ip]]
+#define DISPATCH_OPCODE goto *switch_table_ops[atomic_load_relaxed(&_code_ptr[ip])]
 #define OPCODE_SWITCH(m_test) DISPATCH_OPCODE;
 #define OPCODE_BREAK goto OPSEXIT
 #define OPCODE_OUT goto OPSOUT
@@ -339,6 +513,20 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	String err_text;
 
+	// Base pointers for the addressing modes that resolve with a plain offset,
+	// so most operands decode without going through _get_variant().
+	// NULL entries (and missing instance) take the slow path, which also reports errors.
+	Variant *address_bases[ADDR_TYPE_NIL + 1];
+	address_bases[ADDR_TYPE_SELF] = p_instance ? &self : NULL;
+	address_bases[ADDR_TYPE_CLASS] = &_class->_static_ref;
+	address_bases[ADDR_TYPE_MEMBER] = p_instance ? p_instance->members.ptrw() : NULL;
+	address_bases[ADDR_TYPE_CLASS_CONSTANT] = NULL;
+	address_bases[ADDR_TYPE_LOCAL_CONSTANT] = _constants_ptr;
+	address_bases[ADDR_TYPE_STACK] = stack;
+	address_bases[ADDR_TYPE_STACK_VARIABLE] = stack;
+	address_bases[ADDR_TYPE_GLOBAL] = NULL; //global array may grow
+	address_bases[ADDR_TYPE_NIL] = &nil;
+
 #ifdef DEBUG_ENABLED
 
 	if (ScriptDebugger::get_singleton())
@@ -356,18 +544,33 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #define CHECK_SPACE(m_space) \
 	GD_ERR_BREAK((ip + m_space) > _code_size)
 
-#define GET_VARIANT_PTR(m_v, m_code_ofs)                                                       \
-	Variant *m_v;                                                                              \
-	m_v = _get_variant(_code_ptr[ip + m_code_ofs], p_instance, _class, self, stack, err_text); \
-	if (unlikely(!m_v))                                                                        \
+#define GET_VARIANT_PTR(m_v, m_code_ofs)                                                      \
+	Variant *m_v;                                                                             \
+	{                                                                                         \
+		int _addr = _code_ptr[ip + m_code_ofs];                                               \
+		int _addr_type = (_addr & ADDR_TYPE_MASK) >> ADDR_BITS;                               \
+		Variant *_addr_base = _addr_type <= ADDR_TYPE_NIL ? address_bases[_addr_type] : NULL; \
+		if (likely(_addr_base))                                                               \
+			m_v = _addr_base + (_addr & ADDR_MASK);                                           \
+		else                                                                                  \
+			m_v = _get_variant(_addr, p_instance, _class, self, stack, err_text);             \
+	}                                                                                         \
+	if (unlikely(!m_v))                                                                       \
 		OPCODE_BREAK;
 
 #else
 #define GD_ERR_BREAK(m_cond)
 #define CHECK_SPACE(m_space)
-#define GET_VARIANT_PTR(m_v, m_code_ofs) \
-	Variant *m_v;                        \
-	m_v = _get_variant(_code_ptr[ip + m_code_ofs], p_instance, _class, self, stack, err_text);
+#define GET_VARIANT_PTR(m_v, m_code_ofs)                                            \
+	Variant *m_v;                                                                   \
+	{                                                                               \
+		int _addr = _code_ptr[ip + m_code_ofs];                                     \
+		Variant *_addr_base = address_bases[(_addr & ADDR_TYPE_MASK) >> ADDR_BITS]; \
+		if (likely(_addr_base))                                                     \
+			m_v = _addr_base + (_addr & ADDR_MASK);                                 \
+		else                                                                        \
+			m_v = _get_variant(_addr, p_instance, _class, self, stack, err_text);   \
+	}
 
 #endif
 
@@ -387,14 +590,15 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 #ifdef DEBUG_ENABLED
 	OPCODE_WHILE(ip < _code_size) {
-		int last_opcode = _code_ptr[ip];
+		int last_opcode = atomic_load_relaxed(&_code_ptr[ip]);
 #else
 	OPCODE_WHILE(true) {
 #endif
 
-		OPCODE_SWITCH(_code_ptr[ip]) {
+		OPCODE_SWITCH(atomic_load_relaxed(&_code_ptr[ip])) {
 
-			OPCODE(OPCODE_OPERATOR) {
+			OPCODE(OPCODE_OPERATOR)
+			OPCODE(OPCODE_OPERATOR_GENERIC) {
 
 				CHECK_SPACE(5);
 
@@ -406,6 +610,15 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GET_VARIANT_PTR(b, 3);
 				GET_VARIANT_PTR(dst, 4);
 
+				if (atomic_load_relaxed(&_code_ptr[ip]) == OPCODE_OPERATOR) {
+					//specialize for the operand types seen here and run it again
+					int typed = _get_typed_operator_opcode(a, b);
+					if (typed != OPCODE_OPERATOR) {
+						atomic_store_relaxed(&_code_ptr[ip], typed);
+						DISPATCH_OPCODE;
+					}
+				}
+
 #ifdef DEBUG_ENABLED
 
 				Variant ret;
@@ -431,6 +644,31 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+#define OPCODE_TYPED_OPERATOR(m_opcode, m_func)                                          \
+	OPCODE(m_opcode) {                                                                   \
+                                                                                         \
+		CHECK_SPACE(5);                                                                  \
+                                                                                         \
+		GET_VARIANT_PTR(a, 2);                                                           \
+		GET_VARIANT_PTR(b, 3);                                                           \
+		GET_VARIANT_PTR(dst, 4);                                                         \
+                                                                                         \
+		if (unlikely(!m_func((Variant::Operator)_code_ptr[ip + 1], a, b, dst))) {        \
+			/* types changed (or an error must be reported), stay generic from now on */ \
+			atomic_store_relaxed(&_code_ptr[ip], OPCODE_OPERATOR_GENERIC);               \
+			DISPATCH_OPCODE;                                                             \
+		}                                                                                \
+		ip += 5;                                                                         \
+	}                                                                                    \
+	DISPATCH_OPCODE;
+
+			OPCODE_TYPED_OPERATOR(OPCODE_OPERATOR_INT, _evaluate_int_operator);
+			OPCODE_TYPED_OPERATOR(OPCODE_OPERATOR_REAL, _evaluate_real_operator);
+			OPCODE_TYPED_OPERATOR(OPCODE_OPERATOR_VECTOR2, _evaluate_vector2_operator);
+			OPCODE_TYPED_OPERATOR(OPCODE_OPERATOR_VECTOR3, _evaluate_vector3_operator);
+
+#undef OPCODE_TYPED_OPERATOR
+
 			OPCODE(OPCODE_EXTENDS_TEST) {
 
 				CHECK_SPACE(4);
@@ -780,8 +1018,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[nameg];
 
+				int cache_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _call_cache_count);
+
 				GD_ERR_BREAK(argc < 0);
-				ip += 4;
+				ip += 5;
 				CHECK_SPACE(argc + 1);
 				Variant **argptrs = call_args;
 
@@ -799,13 +1040,32 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 #endif
 				Variant::CallError err;
+				Variant *ret = NULL;
 				if (call_ret) {
 
-					GET_VARIANT_PTR(ret, argc);
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
+					GET_VARIANT_PTR(dst, argc);
+					ret = dst;
+				}
+
+				if (base->get_type() == Variant::OBJECT) {
+
+					//objects resolve per (class, script) pair, the cache validates itself
+					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err, &_call_cache_ptr[cache_idx].method);
 				} else {
 
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, NULL, err);
+					//builtin types resolve the method once per call site, the cache
+					//is a single pointer that threads running this function may rewrite
+					Variant::BuiltinMethod method = atomic_load_relaxed(&_call_cache_ptr[cache_idx].builtin);
+					if (!base->call_builtin(method, (const Variant **)argptrs, argc, ret, err)) {
+
+						method = Variant::get_builtin_method(base->get_type(), *methodname);
+						if (method) {
+							atomic_store_relaxed(&_call_cache_ptr[cache_idx].builtin, method);
+							base->call_builtin(method, (const Variant **)argptrs, argc, ret, err);
+						} else {
+							err.error = Variant::CallError::CALL_ERROR_INVALID_METHOD;
+						}
+					}
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -1113,6 +1373,49 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_JUMP_IF_NOT_COMPARE) {
+
+				CHECK_SPACE(5);
+
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
+				GD_ERR_BREAK(op < Variant::OP_EQUAL || op > Variant::OP_GREATER_EQUAL);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				bool result;
+
+				if (!_compare_numbers(op, a, b, result)) {
+
+					bool valid;
+					Variant ret;
+					Variant::evaluate(op, *a, *b, ret, valid);
+#ifdef DEBUG_ENABLED
+					if (!valid) {
+
+						if (ret.get_type() == Variant::STRING) {
+							//return a string when invalid with the error
+							err_text = ret;
+							err_text += " in operator '" + Variant::get_operator_name(op) + "'.";
+						} else {
+							err_text = "Invalid operands '" + Variant::get_type_name(a->get_type()) + "' and '" + Variant::get_type_name(b->get_type()) + "' in operator '" + Variant::get_operator_name(op) + "'.";
+						}
+						OPCODE_BREAK;
+					}
+#endif
+					result = ret.booleanize();
+				}
+
+				if (!result) {
+					int to = _code_ptr[ip + 4];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 5;
+				}
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_JUMP_TO_DEF_ARGUMENT) {
 
 				CHECK_SPACE(2);
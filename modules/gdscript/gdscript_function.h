@@ -46,6 +46,11 @@ class GDScriptFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
+		OPCODE_OPERATOR_GENERIC,
+		OPCODE_OPERATOR_INT,
+		OPCODE_OPERATOR_REAL,
+		OPCODE_OPERATOR_VECTOR2,
+		OPCODE_OPERATOR_VECTOR3,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_SET,
 		OPCODE_GET,
@@ -70,6 +75,7 @@ public:
 		OPCODE_JUMP,
 		OPCODE_JUMP_IF,
 		OPCODE_JUMP_IF_NOT,
+		OPCODE_JUMP_IF_NOT_COMPARE,
 		OPCODE_JUMP_TO_DEF_ARGUMENT,
 		OPCODE_RETURN,
 		OPCODE_ITERATE_BEGIN,
@@ -111,6 +117,13 @@ public:
 		StringName identifier;
 	};
 
+	//one per OPCODE_CALL site, builtin is used when the base is not an object
+	struct CallCache {
+
+		Variant::BuiltinMethod builtin;
+		MethodCallCache method;
+	};
+
 private:
 	friend class GDScriptCompiler;
 
@@ -123,8 +136,10 @@ private:
 	int _global_names_count;
 	const int *_default_arg_ptr;
 	int _default_arg_count;
-	const int *_code_ptr;
+	int *_code_ptr; //writable, operators are specialized in place while running, opcodes are accessed atomically
 	int _code_size;
+	CallCache *_call_cache_ptr;
+	int _call_cache_count;
 	int _argument_count;
 	int _stack_size;
 	int _call_size;
@@ -139,6 +154,7 @@ private:
 	Vector<StringName> global_names;
 	Vector<int> default_arguments;
 	Vector<int> code;
+	Vector<CallCache> call_cache;
 
 #ifdef TOOLS_ENABLED
 	Vector<StringName> arg_names;
@@ -95,6 +95,15 @@ Error ImageLoaderJPG::load_image(Ref<Image> p_image, FileAccess *f, bool p_force
 	PoolVector<uint8_t> src_image;
 	int src_image_len = f->get_len();
 	ERR_FAIL_COND_V(src_image_len == 0, ERR_FILE_CORRUPT);
+
+	const uint8_t *src = f->get_buffer_ptr(src_image_len);
+	if (src) {
+		//decode in place
+		Error err = jpeg_load_image_from_buffer(p_image.ptr(), src, src_image_len);
+		f->close();
+		return err;
+	}
+
 	src_image.resize(src_image_len);
 
 	PoolVector<uint8_t>::Write w = src_image.write();
@@ -103,7 +103,7 @@
 #define C_METHOD_MANAGED_TO_DICT C_NS_MONOMARSHAL "::mono_object_to_Dictionary"
 #define C_METHOD_MANAGED_FROM_DICT C_NS_MONOMARSHAL "::Dictionary_to_mono_object"
 
-#define BINDINGS_GENERATOR_VERSION UINT32_C(2)
+#define BINDINGS_GENERATOR_VERSION UINT32_C(3)
 
 const char *BindingsGenerator::TypeInterface::DEFAULT_VARARG_C_IN = "\t%0 %1_in = %1;\n";
 
@@ -225,7 +225,7 @@ void BindingsGenerator::_generate_header_icalls() {
 	core_custom_icalls.push_back(InternalCall(ICALL_PREFIX "Godot_bytes2var", "object", "byte[] bytes"));
 	core_custom_icalls.push_back(InternalCall(ICALL_PREFIX "Godot_convert", "object", "object what, int type"));
 	core_custom_icalls.push_back(InternalCall(ICALL_PREFIX "Godot_hash", "int", "object var"));
-	core_custom_icalls.push_back(InternalCall(ICALL_PREFIX "Godot_instance_from_id", "Object", "int instance_id"));
+	core_custom_icalls.push_back(InternalCall(ICALL_PREFIX "Godot_instance_from_id", "Object", "ulong instance_id"));
 	core_custom_icalls.push_back(InternalCall(ICALL_PREFIX "Godot_print", "void", "object[] what"));
 	core_custom_icalls.push_back(InternalCall(ICALL_PREFIX "Godot_printerr", "void", "object[] what"));
 	core_custom_icalls.push_back(InternalCall(ICALL_PREFIX "Godot_printraw", "void", "object[] what"));
@@ -1735,6 +1735,12 @@ const BindingsGenerator::TypeInterface *BindingsGenerator::_get_type_by_name_or_
 	return &placeholder_types.insert(placeholder.cname, placeholder)->get();
 }
 
+static bool _is_object_id_method(const String &p_method) {
+
+	// get_instance_id(), get_collider_id(), body_attach_object_instance_id()...
+	return p_method.ends_with("instance_id") || p_method.ends_with("collider_id");
+}
+
 static void _create_constant_interface_from(const StringName &p_constant, const DocData::ClassDoc &p_classdoc) {
 }
 
@@ -1899,6 +1905,8 @@ void BindingsGenerator::_populate_object_type_interfaces() {
 				imethod.return_type = name_cache.type_Variant;
 			} else if (return_info.type == Variant::NIL) {
 				imethod.return_type = name_cache.type_void;
+			} else if (return_info.type == Variant::INT && _is_object_id_method(imethod.name)) {
+				imethod.return_type = name_cache.type_ulong;
 			} else {
 				imethod.return_type = Variant::get_type_name(return_info.type);
 			}
@@ -1920,6 +1928,8 @@ void BindingsGenerator::_populate_object_type_interfaces() {
 					iarg.type = arginfo.hint_string;
 				} else if (arginfo.type == Variant::NIL) {
 					iarg.type = name_cache.type_Variant;
+				} else if (arginfo.type == Variant::INT && arginfo.name == "id" && _is_object_id_method(imethod.name)) {
+					iarg.type = name_cache.type_ulong;
 				} else {
 					iarg.type = Variant::get_type_name(arginfo.type);
 				}
@@ -2207,6 +2217,22 @@ void BindingsGenerator::_populate_builtin_type_interfaces() {
 	itype.im_type_out = itype.name;
 	builtin_types.insert(itype.cname, itype);
 
+	// ulong, only for instance IDs, which don't fit in int
+	itype = TypeInterface();
+	itype.name = "ulong";
+	itype.cname = itype.name;
+	itype.proxy_name = itype.name;
+	itype.c_arg_in = "&%s_in";
+	itype.c_in = "\t%0 %1_in = (%0)%1;\n";
+	itype.c_out = "\treturn (%0)%1;\n";
+	itype.c_type = "uint64_t";
+	itype.c_type_in = itype.c_type;
+	itype.c_type_out = itype.c_type;
+	itype.cs_type = itype.proxy_name;
+	itype.im_type_in = itype.proxy_name;
+	itype.im_type_out = itype.proxy_name;
+	builtin_types.insert(itype.cname, itype);
+
 	// real_t
 	itype = TypeInterface();
 #ifdef REAL_T_IS_DOUBLE
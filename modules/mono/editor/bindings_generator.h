@@ -452,6 +452,7 @@ class BindingsGenerator {
 	struct NameCache {
 		StringName type_void;
 		StringName type_int;
+		StringName type_ulong;
 		StringName type_Array;
 		StringName type_Dictionary;
 		StringName type_Variant;
@@ -463,6 +464,7 @@ class BindingsGenerator {
 		NameCache() {
 			type_void = StaticCString::create("void");
 			type_int = StaticCString::create("int");
+			type_ulong = StaticCString::create("ulong");
 			type_Array = StaticCString::create("Array");
 			type_Dictionary = StaticCString::create("Dictionary");
 			type_Variant = StaticCString::create("Variant");
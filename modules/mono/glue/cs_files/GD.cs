@@ -44,7 +44,7 @@ namespace Godot
             return NativeCalls.godot_icall_Godot_hash(var);
         }
 
-        public static Object InstanceFromId(int instanceId)
+        public static Object InstanceFromId(ulong instanceId)
         {
             return NativeCalls.godot_icall_Godot_instance_from_id(instanceId);
         }
@@ -168,7 +168,7 @@ int godot_icall_Godot_hash(MonoObject *p_var) {
 	return GDMonoMarshal::mono_object_to_variant(p_var).hash();
 }
 
-MonoObject *godot_icall_Godot_instance_from_id(int p_instance_id) {
+MonoObject *godot_icall_Godot_instance_from_id(uint64_t p_instance_id) {
 	return GDMonoUtils::unmanaged_get_managed(ObjectDB::get_instance(p_instance_id));
 }
 
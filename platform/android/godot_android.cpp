@@ -71,6 +71,9 @@ class JNISingleton : public Object {
 	Map<StringName, MethodData> method_map;
 	JNIEnv *env;
 
+protected:
+	virtual bool _has_call_override() const { return true; }
+
 public:
 	void update_env(JNIEnv *p_env) { env = p_env; }
 
@@ -160,6 +160,9 @@ class JavaClass : public Reference {
 	Map<StringName, List<MethodInfo> > methods;
 	jclass _class;
 
+protected:
+	virtual bool _has_call_override() const { return true; }
+
 public:
 	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error);
 
@@ -175,6 +178,9 @@ class JavaObject : public Reference {
 
 	jobject instance;
 
+protected:
+	virtual bool _has_call_override() const { return true; }
+
 public:
 	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error);
 
@@ -405,6 +405,9 @@ class JNISingleton : public Object {
 	jobject instance;
 	Map<StringName, MethodData> method_map;
 
+protected:
+	virtual bool _has_call_override() const { return true; }
+
 public:
 	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error) {
 
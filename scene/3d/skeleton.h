@@ -60,7 +60,7 @@ class Skeleton : public Spatial {
 
 		Transform transform_final;
 
-		List<uint32_t> nodes_bound;
+		List<ObjectID> nodes_bound;
 
 		Bone() {
 			parent = -1;
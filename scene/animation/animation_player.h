@@ -84,7 +84,7 @@ private:
 	struct TrackNodeCache {
 
 		NodePath path;
-		uint32_t id;
+		ObjectID id;
 		RES resource;
 		Node *node;
 		Spatial *spatial;
@@ -126,7 +126,7 @@ private:
 
 	struct TrackNodeCacheKey {
 
-		uint32_t id;
+		ObjectID id;
 		int bone_idx;
 
 		inline bool operator<(const TrackNodeCacheKey &p_right) const {
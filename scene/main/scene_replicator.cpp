@@ -0,0 +1,917 @@
+/*************************************************************************/
+/*  scene_replicator.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "scene_replicator.h"
+
+#include "io/marshalls.h"
+#include "os/os.h"
+#include "scene/2d/node_2d.h"
+#include "scene/3d/spatial.h"
+#include "scene/main/scene_tree.h"
+#include "sort.h"
+
+static bool _get_node_position(Node *p_node, Vector3 &r_position) {
+
+	Spatial *spatial = Object::cast_to<Spatial>(p_node);
+	if (spatial && spatial->is_inside_tree()) {
+		r_position = spatial->get_global_transform().origin;
+		return true;
+	}
+
+	Node2D *node_2d = Object::cast_to<Node2D>(p_node);
+	if (node_2d && node_2d->is_inside_tree()) {
+		Vector2 pos = node_2d->get_global_position();
+		r_position = Vector3(pos.x, pos.y, 0);
+		return true;
+	}
+
+	return false;
+}
+
+void SceneReplicator::_peer_connected(int p_id) {
+
+	peers.insert(p_id, Peer());
+}
+
+void SceneReplicator::_peer_disconnected(int p_id) {
+
+	peers.erase(p_id);
+}
+
+void SceneReplicator::set_network_peer(const Ref<NetworkedMultiplayerPeer> &p_network_peer) {
+
+	if (network_peer.is_valid()) {
+		network_peer->disconnect("peer_connected", this, "_peer_connected");
+		network_peer->disconnect("peer_disconnected", this, "_peer_disconnected");
+		peers.clear();
+	}
+
+	network_peer = p_network_peer;
+
+	if (network_peer.is_valid()) {
+		network_peer->connect("peer_connected", this, "_peer_connected");
+		network_peer->connect("peer_disconnected", this, "_peer_disconnected");
+	}
+}
+
+Ref<NetworkedMultiplayerPeer> SceneReplicator::get_network_peer() const {
+
+	return network_peer;
+}
+
+void SceneReplicator::set_root_node(Node *p_node) {
+
+	root_node = p_node;
+}
+
+Node *SceneReplicator::get_root_node() const {
+
+	return root_node;
+}
+
+void SceneReplicator::add_node(Node *p_node, const PoolStringArray &p_properties, float p_priority) {
+
+	ERR_FAIL_NULL(p_node);
+	ERR_EXPLAIN("A replicated node needs between 1 and " + itos(MAX_PROPERTIES) + " properties.");
+	ERR_FAIL_COND(p_properties.size() == 0 || p_properties.size() > MAX_PROPERTIES);
+	ERR_EXPLAIN("Node is already replicated: " + String(p_node->get_name()));
+	ERR_FAIL_COND(entity_ids.has(p_node->get_instance_id()));
+
+	Entity e;
+	e.instance = p_node->get_instance_id();
+	e.node = NULL;
+	e.priority = p_priority;
+	e.has_position = false;
+	for (int i = 0; i < p_properties.size(); i++) {
+		e.properties.push_back(p_properties[i]);
+	}
+
+	int id = last_entity_id++;
+	entities[id] = e;
+	entity_ids[e.instance] = id;
+}
+
+void SceneReplicator::remove_node(Node *p_node) {
+
+	ERR_FAIL_NULL(p_node);
+
+	Map<ObjectID, int>::Element *E = entity_ids.find(p_node->get_instance_id());
+	ERR_FAIL_COND(!E);
+
+	int id = E->get();
+	entities.erase(id);
+	entity_ids.erase(E);
+
+	for (Map<int, Peer>::Element *F = peers.front(); F; F = F->next()) {
+		F->get().entities.erase(id);
+	}
+}
+
+bool SceneReplicator::has_node(Node *p_node) const {
+
+	ERR_FAIL_NULL_V(p_node, false);
+	return entity_ids.has(p_node->get_instance_id());
+}
+
+void SceneReplicator::set_node_priority(Node *p_node, float p_priority) {
+
+	ERR_FAIL_NULL(p_node);
+
+	const Map<ObjectID, int>::Element *E = entity_ids.find(p_node->get_instance_id());
+	ERR_FAIL_COND(!E);
+
+	entities[E->get()].priority = p_priority;
+}
+
+float SceneReplicator::get_node_priority(Node *p_node) const {
+
+	ERR_FAIL_NULL_V(p_node, 0);
+
+	const Map<ObjectID, int>::Element *E = entity_ids.find(p_node->get_instance_id());
+	ERR_FAIL_COND_V(!E, 0);
+
+	return entities[E->get()].priority;
+}
+
+void SceneReplicator::set_peer_observer(int p_peer, Node *p_observer) {
+
+	Map<int, Peer>::Element *E = peers.find(p_peer);
+	ERR_FAIL_COND(!E);
+
+	E->get().observer = p_observer ? p_observer->get_instance_id() : 0;
+}
+
+Node *SceneReplicator::get_peer_observer(int p_peer) const {
+
+	const Map<int, Peer>::Element *E = peers.find(p_peer);
+	ERR_FAIL_COND_V(!E, NULL);
+
+	return Object::cast_to<Node>(ObjectDB::get_instance(E->get().observer));
+}
+
+void SceneReplicator::set_peer_interest_groups(int p_peer, const PoolStringArray &p_groups) {
+
+	Map<int, Peer>::Element *E = peers.find(p_peer);
+	ERR_FAIL_COND(!E);
+
+	Vector<StringName> &groups = E->get().interest_groups;
+	groups.resize(p_groups.size());
+	for (int i = 0; i < p_groups.size(); i++) {
+		groups[i] = p_groups[i];
+	}
+}
+
+PoolStringArray SceneReplicator::get_peer_interest_groups(int p_peer) const {
+
+	const Map<int, Peer>::Element *E = peers.find(p_peer);
+	ERR_FAIL_COND_V(!E, PoolStringArray());
+
+	PoolStringArray groups;
+	for (int i = 0; i < E->get().interest_groups.size(); i++) {
+		groups.push_back(E->get().interest_groups[i]);
+	}
+	return groups;
+}
+
+void SceneReplicator::set_send_rate(float p_rate) {
+
+	ERR_FAIL_COND(p_rate <= 0);
+	send_rate = p_rate;
+}
+
+float SceneReplicator::get_send_rate() const {
+
+	return send_rate;
+}
+
+void SceneReplicator::set_bandwidth_limit(int p_bytes_per_second) {
+
+	ERR_FAIL_COND(p_bytes_per_second < 0);
+	bandwidth_limit = p_bytes_per_second;
+}
+
+int SceneReplicator::get_bandwidth_limit() const {
+
+	return bandwidth_limit;
+}
+
+void SceneReplicator::set_interest_radius(float p_radius) {
+
+	ERR_FAIL_COND(p_radius < 0);
+	interest_radius = p_radius;
+}
+
+float SceneReplicator::get_interest_radius() const {
+
+	return interest_radius;
+}
+
+void SceneReplicator::set_max_packet_size(int p_size) {
+
+	ERR_FAIL_COND(p_size < 64);
+	max_packet_size = p_size;
+}
+
+int SceneReplicator::get_max_packet_size() const {
+
+	return max_packet_size;
+}
+
+uint64_t SceneReplicator::get_bytes_sent() const {
+
+	return bytes_sent;
+}
+
+void SceneReplicator::_update_entities() {
+
+	uint32_t flags = network_peer->get_compact_encoding_flags();
+
+	Map<int, Entity>::Element *E = entities.front();
+	while (E) {
+
+		Map<int, Entity>::Element *N = E->next();
+		Entity &e = E->get();
+
+		e.node = Object::cast_to<Node>(ObjectDB::get_instance(e.instance));
+		if (!e.node) {
+			//freed without being removed
+			for (Map<int, Peer>::Element *F = peers.front(); F; F = F->next()) {
+				F->get().entities.erase(E->key());
+			}
+			entity_ids.erase(e.instance);
+			entities.erase(E);
+			E = N;
+			continue;
+		}
+
+		int count = e.properties.size();
+		e.values.resize(count);
+		e.encoded_ofs.resize(count + 1);
+
+		Variant *values = e.values.ptrw();
+		int *ofs = e.encoded_ofs.ptrw();
+		int len = 0;
+
+		for (int i = 0; i < count; i++) {
+			values[i] = e.node->get(e.properties[i]);
+			int vlen;
+			encode_variant_compact(values[i], NULL, vlen, flags);
+			ofs[i] = len;
+			len += vlen;
+		}
+		ofs[count] = len;
+
+		e.encoded.resize(len);
+		uint8_t *w = e.encoded.ptrw();
+		for (int i = 0; i < count; i++) {
+			int vlen;
+			encode_variant_compact(values[i], &w[ofs[i]], vlen, flags);
+		}
+
+		e.has_position = interest_radius > 0 && _get_node_position(e.node, e.position);
+
+		E = N;
+	}
+}
+
+void SceneReplicator::_send_config(int p_peer, int p_entity, const Entity &p_e) {
+
+	ERR_FAIL_NULL(root_node);
+
+	CharString path = String(root_node->get_path_to(p_e.node)).utf8();
+
+	Vector<CharString> names;
+	int len = encode_varint(p_entity, NULL) + encode_cstring(path.get_data(), NULL) + encode_varint(p_e.properties.size(), NULL);
+	for (int i = 0; i < p_e.properties.size(); i++) {
+		names.push_back(String(p_e.properties[i]).utf8());
+		len += encode_cstring(names[i].get_data(), NULL);
+	}
+
+	//configs are batched, one reliable packet per node would crawl through the reliable window
+	if (config_len > 1 && config_len + len > max_packet_size) {
+		_flush_config(p_peer);
+	}
+
+	if (config_cache.size() < config_len + len) {
+		config_cache.resize(MAX(config_len + len, max_packet_size));
+	}
+
+	uint8_t *w = config_cache.ptrw();
+	w[0] = SceneTree::NETWORK_COMMAND_REPLICATE_CONFIG;
+
+	int ofs = config_len;
+	ofs += encode_varint(p_entity, &w[ofs]);
+	ofs += encode_cstring(path.get_data(), &w[ofs]);
+	ofs += encode_varint(names.size(), &w[ofs]);
+	for (int i = 0; i < names.size(); i++) {
+		ofs += encode_cstring(names[i].get_data(), &w[ofs]);
+	}
+	config_len = ofs;
+}
+
+void SceneReplicator::_flush_config(int p_peer) {
+
+	if (config_len > 1) {
+		network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+		network_peer->set_target_peer(p_peer);
+		network_peer->put_packet(config_cache.ptr(), config_len);
+		bytes_sent += config_len;
+	}
+
+	config_len = 1;
+}
+
+void SceneReplicator::_flush_state(int p_peer, Peer &p_peer_data, SentPacket &p_sent, int p_len) {
+
+	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE);
+	network_peer->set_target_peer(p_peer);
+	network_peer->put_packet(packet_cache.ptr(), p_len);
+	bytes_sent += p_len;
+
+	if (bandwidth_limit > 0) {
+		p_peer_data.budget -= p_len;
+	}
+}
+
+void SceneReplicator::_replicate_to_peer(int p_peer, Peer &p_peer_data, uint64_t p_usec) {
+
+	if (bandwidth_limit > 0) {
+		//allow the budget of one extra snapshot to accumulate, so priorities can catch up
+		float per_snapshot = bandwidth_limit / send_rate;
+		p_peer_data.budget = MIN(p_peer_data.budget + per_snapshot, per_snapshot * 2);
+	}
+
+	Vector3 observer_pos;
+	bool has_observer = false;
+	if (interest_radius > 0 && p_peer_data.observer) {
+		Node *observer = Object::cast_to<Node>(ObjectDB::get_instance(p_peer_data.observer));
+		has_observer = observer && _get_node_position(observer, observer_pos);
+	}
+
+	//values still in flight are only sent again once they should have been acknowledged
+	uint64_t resend_usec = p_peer_data.rtt_usec + uint64_t(1000000 / send_rate);
+
+	if (candidates.size() < entities.size()) {
+		candidates.resize(entities.size());
+	}
+	Candidate *c = candidates.ptrw();
+	int candidate_count = 0;
+
+	for (Map<int, Entity>::Element *E = entities.front(); E; E = E->next()) {
+
+		Entity &e = E->get();
+
+		if (p_peer_data.interest_groups.size()) {
+			bool interested = false;
+			for (int i = 0; i < p_peer_data.interest_groups.size(); i++) {
+				if (e.node->is_in_group(p_peer_data.interest_groups[i])) {
+					interested = true;
+					break;
+				}
+			}
+			if (!interested)
+				continue;
+		}
+
+		float scale = 1.0;
+		if (has_observer && e.has_position) {
+			float distance = e.position.distance_to(observer_pos);
+			if (distance > interest_radius)
+				continue;
+			//closer nodes gain priority up to twice as fast
+			scale = 2.0 - distance / interest_radius;
+		}
+
+		EntityState &state = p_peer_data.entities[E->key()];
+
+		if (!state.confirmed) {
+			//a peer refuses configs for nodes it has not spawned yet, so unconfirmed ones are sent again, backing off
+			if (!state.config_sent || p_usec - state.config_usec >= state.config_retry_usec) {
+				_send_config(p_peer, E->key(), e);
+				state.config_retry_usec = state.config_sent ? MIN(state.config_retry_usec * 2, uint64_t(CONFIG_RETRY_MAX_USEC)) : resend_usec;
+				state.config_usec = p_usec;
+				state.config_sent = true;
+			}
+			continue;
+		}
+
+		uint32_t mask = 0;
+		const Variant *values = e.values.ptr();
+		for (int i = 0; i < e.values.size(); i++) {
+
+			if (state.acked_seq[i] && state.acked[i] == values[i])
+				continue;
+			if (state.sent_usec[i] && p_usec - state.sent_usec[i] < resend_usec && state.sent[i] == values[i])
+				continue;
+			mask |= 1U << i;
+		}
+
+		if (!mask) {
+			state.accumulator = 0;
+			continue;
+		}
+
+		state.accumulator += e.priority * scale;
+
+		c[candidate_count].entity = E->key();
+		c[candidate_count].mask = mask;
+		c[candidate_count].accumulator = state.accumulator;
+		c[candidate_count].e = &e;
+		c[candidate_count].state = &state;
+		candidate_count++;
+	}
+
+	_flush_config(p_peer);
+
+	if (candidate_count == 0)
+		return;
+
+	if (bandwidth_limit > 0) {
+		SortArray<Candidate> sorter;
+		sorter.sort(c, candidate_count);
+	}
+
+	SentPacket *sent = NULL;
+	int len = 0;
+
+	for (int i = 0; i < candidate_count; i++) {
+
+		const Entity &e = *c[i].e;
+		EntityState &state = *c[i].state;
+		uint32_t mask = c[i].mask;
+
+		int entry_len = encode_varint(c[i].entity, NULL) + encode_varint(mask, NULL);
+		for (int j = 0; j < e.properties.size(); j++) {
+			if (mask & (1U << j))
+				entry_len += e.encoded_ofs[j + 1] - e.encoded_ofs[j];
+		}
+
+		if (bandwidth_limit > 0 && entry_len > p_peer_data.budget - len) {
+			//a node larger than the budget would never fit, so the first entry goes out anyway and the debt is paid on the next snapshots
+			if (i > 0 || p_peer_data.budget <= 0)
+				break; //the rest waits, with more priority next time
+		}
+
+		if (sent && len + entry_len > max_packet_size) {
+			_flush_state(p_peer, p_peer_data, *sent, len);
+			sent = NULL;
+		}
+
+		if (!sent) {
+			uint32_t seq = ++p_peer_data.last_seq;
+			sent = &p_peer_data.history[seq % HISTORY_SIZE];
+			sent->seq = seq;
+			sent->acked = false;
+			sent->usec = p_usec;
+			sent->entry_count = 0;
+			sent->value_count = 0;
+
+			if (packet_cache.size() < max_packet_size) {
+				packet_cache.resize(max_packet_size);
+			}
+			packet_cache[0] = SceneTree::NETWORK_COMMAND_REPLICATE_STATE;
+			len = 1 + encode_varint(seq, &packet_cache[1]);
+		}
+
+		if (packet_cache.size() < len + entry_len) {
+			//a single node larger than a packet, send it whole
+			packet_cache.resize(len + entry_len);
+		}
+
+		uint8_t *w = packet_cache.ptrw();
+		len += encode_varint(c[i].entity, &w[len]);
+		len += encode_varint(mask, &w[len]);
+
+		if (sent->entries.size() <= sent->entry_count) {
+			sent->entries.resize(sent->entry_count + 1);
+		}
+		SentEntry &entry = sent->entries[sent->entry_count++];
+		entry.entity = c[i].entity;
+		entry.mask = mask;
+		entry.value_ofs = sent->value_count;
+
+		for (int j = 0; j < e.properties.size(); j++) {
+
+			if (!(mask & (1U << j)))
+				continue;
+
+			int from = e.encoded_ofs[j];
+			int vlen = e.encoded_ofs[j + 1] - from;
+			copymem(&w[len], &e.encoded[from], vlen);
+			len += vlen;
+
+			if (sent->values.size() <= sent->value_count) {
+				sent->values.resize(sent->value_count + 1);
+			}
+			sent->values[sent->value_count++] = e.values[j];
+			state.sent[j] = e.values[j];
+			state.sent_usec[j] = p_usec;
+		}
+
+		state.accumulator = 0;
+	}
+
+	if (sent) {
+		_flush_state(p_peer, p_peer_data, *sent, len);
+	}
+}
+
+void SceneReplicator::poll(float p_time) {
+
+	if (network_peer.is_null() || network_peer->get_connection_status() != NetworkedMultiplayerPeer::CONNECTION_CONNECTED)
+		return;
+
+	for (Map<int, Peer>::Element *E = peers.front(); E; E = E->next()) {
+		if (E->get().unacked) {
+			_send_state_ack(E->key(), E->get());
+		}
+	}
+
+	time_to_send -= p_time;
+	if (time_to_send > 0)
+		return;
+
+	time_to_send += 1.0 / send_rate;
+	if (time_to_send < 0)
+		time_to_send = 0; //don't try to catch up after a hitch
+
+	if (entities.empty() || peers.empty())
+		return;
+
+	_update_entities();
+
+	uint64_t usec = OS::get_singleton()->get_ticks_usec();
+
+	for (Map<int, Peer>::Element *E = peers.front(); E; E = E->next()) {
+		_replicate_to_peer(E->key(), E->get(), usec);
+	}
+}
+
+void SceneReplicator::_process_config(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	Map<int, Peer>::Element *P = peers.find(p_from);
+	ERR_FAIL_COND(!P);
+	ERR_FAIL_NULL(root_node);
+
+	//the accepted ids are confirmed in one packet, never longer than this one
+	Vector<uint8_t> confirm;
+	confirm.resize(p_packet_len);
+	uint8_t *cw = confirm.ptrw();
+	cw[0] = SceneTree::NETWORK_COMMAND_CONFIRM_REPLICATE_CONFIG;
+	int confirm_len = 1;
+
+	int ofs = 1;
+	while (ofs < p_packet_len) {
+
+		uint64_t id;
+		int len = decode_varint(&p_packet[ofs], p_packet_len - ofs, id);
+		ERR_BREAK(len == 0);
+		ofs += len;
+
+		Vector<String> strings;
+		uint64_t count = 0;
+		bool valid = true;
+
+		//path, then the property count, then the property names
+		for (int i = 0; i < int(count) + 1; i++) {
+
+			int len_end = ofs;
+			while (len_end < p_packet_len && p_packet[len_end])
+				len_end++;
+			if (len_end >= p_packet_len) {
+				valid = false;
+				break;
+			}
+
+			String s;
+			s.parse_utf8((const char *)&p_packet[ofs], len_end - ofs);
+			strings.push_back(s);
+			ofs = len_end + 1;
+
+			if (i == 0) {
+				len = decode_varint(&p_packet[ofs], p_packet_len - ofs, count);
+				if (len == 0 || count == 0 || count > MAX_PROPERTIES) {
+					valid = false;
+					break;
+				}
+				ofs += len;
+			}
+		}
+
+		ERR_BREAK(!valid);
+
+		NodePath path = strings[0];
+		if (!root_node->has_node(path))
+			continue; //not spawned here yet, left unconfirmed so the sender tries again later
+
+		Node *node = root_node->get_node(path);
+
+		if (node->get_network_master() != p_from) {
+			ERR_PRINTS("Replication from peer " + itos(p_from) + " refused, node is not mastered by it: " + String(path));
+			continue;
+		}
+
+		ReceivedEntity re;
+		re.path = path;
+		re.instance = node->get_instance_id();
+		for (int i = 1; i < strings.size(); i++) {
+			re.properties.push_back(strings[i]);
+		}
+		re.seq.resize(re.properties.size());
+		for (int i = 0; i < re.seq.size(); i++) {
+			re.seq[i] = 0;
+		}
+
+		P->get().received[id] = re;
+		confirm_len += encode_varint(id, &cw[confirm_len]);
+	}
+
+	if (confirm_len > 1) {
+		network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+		network_peer->set_target_peer(p_from);
+		network_peer->put_packet(confirm.ptr(), confirm_len);
+	}
+}
+
+void SceneReplicator::_process_confirm_config(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	Map<int, Peer>::Element *P = peers.find(p_from);
+	ERR_FAIL_COND(!P);
+
+	int ofs = 1;
+	while (ofs < p_packet_len) {
+
+		uint64_t id;
+		int len = decode_varint(&p_packet[ofs], p_packet_len - ofs, id);
+		ERR_FAIL_COND(len == 0);
+		ofs += len;
+
+		const Map<int, Entity>::Element *E = entities.find(id);
+		if (!E)
+			continue; //removed meanwhile
+
+		Map<int, EntityState>::Element *S = P->get().entities.find(id);
+		ERR_CONTINUE(!S || !S->get().config_sent);
+
+		EntityState &state = S->get();
+		if (state.confirmed)
+			continue; //config was sent again before the first confirmation arrived
+
+		int count = E->get().properties.size();
+
+		state.confirmed = true;
+		state.acked.resize(count);
+		state.acked_seq.resize(count);
+		state.sent.resize(count);
+		state.sent_usec.resize(count);
+		for (int i = 0; i < count; i++) {
+			state.acked_seq[i] = 0;
+			state.sent_usec[i] = 0;
+		}
+	}
+}
+
+void SceneReplicator::_send_state_ack(int p_peer, Peer &p_peer_data) {
+
+	uint8_t packet[16];
+	packet[0] = SceneTree::NETWORK_COMMAND_CONFIRM_REPLICATE_STATE;
+	int len = 1 + encode_varint(p_peer_data.last_received_seq, &packet[1]);
+	len += encode_uint32(p_peer_data.received_bits, &packet[len]);
+
+	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE);
+	network_peer->set_target_peer(p_peer);
+	network_peer->put_packet(packet, len);
+
+	p_peer_data.unacked = 0;
+}
+
+void SceneReplicator::_process_state(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	Map<int, Peer>::Element *P = peers.find(p_from);
+	ERR_FAIL_COND(!P);
+	Peer &peer = P->get();
+
+	uint64_t seq;
+	int ofs = 1;
+	int len = decode_varint(&p_packet[ofs], p_packet_len - ofs, seq);
+	ERR_FAIL_COND(len == 0 || seq == 0 || seq > 0xFFFFFFFF);
+	ofs += len;
+
+	//remember what was received, so it can be acknowledged a few times over
+	if (seq > peer.last_received_seq) {
+		uint32_t shift = seq - peer.last_received_seq;
+		if (peer.last_received_seq && shift <= ACK_BITS) {
+			peer.received_bits = (shift < ACK_BITS ? peer.received_bits << shift : 0) | (1U << (shift - 1));
+		} else {
+			peer.received_bits = 0;
+		}
+		peer.last_received_seq = seq;
+	} else if (seq < peer.last_received_seq) {
+		uint32_t age = peer.last_received_seq - seq;
+		if (age <= ACK_BITS) {
+			peer.received_bits |= 1U << (age - 1);
+		}
+	}
+
+	//acknowledged once per poll, unless the older packets are about to leave the window
+	if (++peer.unacked >= ACK_BITS) {
+		_send_state_ack(p_from, peer);
+	}
+
+	while (ofs < p_packet_len) {
+
+		uint64_t id, mask;
+		len = decode_varint(&p_packet[ofs], p_packet_len - ofs, id);
+		ERR_FAIL_COND(len == 0);
+		ofs += len;
+		len = decode_varint(&p_packet[ofs], p_packet_len - ofs, mask);
+		ERR_FAIL_COND(len == 0 || mask == 0);
+		ofs += len;
+
+		Map<int, ReceivedEntity>::Element *E = peer.received.find(id);
+		ERR_FAIL_COND(!E);
+		ReceivedEntity &re = E->get();
+		ERR_FAIL_COND(mask >> re.properties.size());
+
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(re.instance));
+
+		for (int i = 0; i < re.properties.size(); i++) {
+
+			if (!(mask & (1U << i)))
+				continue;
+
+			Variant value;
+			Error err = decode_variant_compact(value, &p_packet[ofs], p_packet_len - ofs, &len);
+			ERR_FAIL_COND(err != OK);
+			ofs += len;
+
+			if (!node || seq <= re.seq[i])
+				continue; //gone, or a newer value was already applied
+
+			re.seq[i] = seq;
+
+			bool valid;
+			node->set(re.properties[i], value, &valid);
+			if (!valid) {
+				String error = "Error setting replicated property '" + String(re.properties[i]) + "', not found in object of type " + node->get_class();
+				ERR_PRINTS(error);
+			}
+		}
+	}
+}
+
+void SceneReplicator::_process_confirm_state(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	Map<int, Peer>::Element *P = peers.find(p_from);
+	ERR_FAIL_COND(!P);
+	Peer &peer = P->get();
+
+	uint64_t last;
+	int len = decode_varint(&p_packet[1], p_packet_len - 1, last);
+	ERR_FAIL_COND(len == 0 || 1 + len + 4 > p_packet_len);
+	ERR_FAIL_COND(last == 0 || last > peer.last_seq);
+	uint32_t bits = decode_uint32(&p_packet[1 + len]);
+
+	uint64_t usec = OS::get_singleton()->get_ticks_usec();
+
+	for (uint32_t i = 0; i <= ACK_BITS && i < last; i++) {
+
+		if (i > 0 && !(bits & (1U << (i - 1))))
+			continue;
+
+		uint32_t seq = last - i;
+		SentPacket &sent = peer.history[seq % HISTORY_SIZE];
+		if (sent.seq != seq || sent.acked)
+			continue; //too old, or already seen
+
+		sent.acked = true;
+
+		if (i == 0) {
+			peer.rtt_usec = (peer.rtt_usec * 7 + (usec - sent.usec)) / 8;
+		}
+
+		for (int j = 0; j < sent.entry_count; j++) {
+
+			const SentEntry &entry = sent.entries[j];
+			Map<int, EntityState>::Element *S = peer.entities.find(entry.entity);
+			if (!S)
+				continue;
+
+			EntityState &state = S->get();
+			int value_ofs = entry.value_ofs;
+
+			for (int k = 0; k < state.acked.size(); k++) {
+
+				if (!(entry.mask & (1U << k)))
+					continue;
+
+				if (seq > state.acked_seq[k]) {
+					state.acked[k] = sent.values[value_ofs];
+					state.acked_seq[k] = seq;
+				}
+				value_ofs++;
+			}
+		}
+	}
+}
+
+void SceneReplicator::process_packet(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	ERR_FAIL_COND(p_packet_len < 2);
+
+	switch (p_packet[0]) {
+
+		case SceneTree::NETWORK_COMMAND_REPLICATE_CONFIG: {
+			_process_config(p_from, p_packet, p_packet_len);
+		} break;
+		case SceneTree::NETWORK_COMMAND_CONFIRM_REPLICATE_CONFIG: {
+			_process_confirm_config(p_from, p_packet, p_packet_len);
+		} break;
+		case SceneTree::NETWORK_COMMAND_REPLICATE_STATE: {
+			_process_state(p_from, p_packet, p_packet_len);
+		} break;
+		case SceneTree::NETWORK_COMMAND_CONFIRM_REPLICATE_STATE: {
+			_process_confirm_state(p_from, p_packet, p_packet_len);
+		} break;
+		default: {
+			ERR_FAIL();
+		}
+	}
+}
+
+void SceneReplicator::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("add_node", "node", "properties", "priority"), &SceneReplicator::add_node, DEFVAL(1.0));
+	ClassDB::bind_method(D_METHOD("remove_node", "node"), &SceneReplicator::remove_node);
+	ClassDB::bind_method(D_METHOD("has_node", "node"), &SceneReplicator::has_node);
+	ClassDB::bind_method(D_METHOD("set_node_priority", "node", "priority"), &SceneReplicator::set_node_priority);
+	ClassDB::bind_method(D_METHOD("get_node_priority", "node"), &SceneReplicator::get_node_priority);
+
+	ClassDB::bind_method(D_METHOD("set_peer_observer", "id", "observer"), &SceneReplicator::set_peer_observer);
+	ClassDB::bind_method(D_METHOD("get_peer_observer", "id"), &SceneReplicator::get_peer_observer);
+	ClassDB::bind_method(D_METHOD("set_peer_interest_groups", "id", "groups"), &SceneReplicator::set_peer_interest_groups);
+	ClassDB::bind_method(D_METHOD("get_peer_interest_groups", "id"), &SceneReplicator::get_peer_interest_groups);
+
+	ClassDB::bind_method(D_METHOD("set_send_rate", "rate"), &SceneReplicator::set_send_rate);
+	ClassDB::bind_method(D_METHOD("get_send_rate"), &SceneReplicator::get_send_rate);
+	ClassDB::bind_method(D_METHOD("set_bandwidth_limit", "bytes_per_second"), &SceneReplicator::set_bandwidth_limit);
+	ClassDB::bind_method(D_METHOD("get_bandwidth_limit"), &SceneReplicator::get_bandwidth_limit);
+	ClassDB::bind_method(D_METHOD("set_interest_radius", "radius"), &SceneReplicator::set_interest_radius);
+	ClassDB::bind_method(D_METHOD("get_interest_radius"), &SceneReplicator::get_interest_radius);
+	ClassDB::bind_method(D_METHOD("set_max_packet_size", "size"), &SceneReplicator::set_max_packet_size);
+	ClassDB::bind_method(D_METHOD("get_max_packet_size"), &SceneReplicator::get_max_packet_size);
+
+	ClassDB::bind_method(D_METHOD("_peer_connected"), &SceneReplicator::_peer_connected);
+	ClassDB::bind_method(D_METHOD("_peer_disconnected"), &SceneReplicator::_peer_disconnected);
+
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "send_rate", PROPERTY_HINT_RANGE, "1,120,1"), "set_send_rate", "get_send_rate");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "bandwidth_limit"), "set_bandwidth_limit", "get_bandwidth_limit");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "interest_radius"), "set_interest_radius", "get_interest_radius");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_packet_size", PROPERTY_HINT_RANGE, "64,65536,1"), "set_max_packet_size", "get_max_packet_size");
+}
+
+SceneReplicator::SceneReplicator() {
+
+	root_node = NULL;
+	last_entity_id = 1;
+	send_rate = 20;
+	bandwidth_limit = 0;
+	interest_radius = 0;
+	max_packet_size = 1200;
+	time_to_send = 0;
+	config_len = 1;
+	bytes_sent = 0;
+}
+
+SceneReplicator::~SceneReplicator() {
+
+	set_network_peer(Ref<NetworkedMultiplayerPeer>());
+}
@@ -0,0 +1,248 @@
+/*************************************************************************/
+/*  scene_replicator.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef SCENE_REPLICATOR_H
+#define SCENE_REPLICATOR_H
+
+#include "io/networked_multiplayer_peer.h"
+#include "reference.h"
+
+class Node;
+
+/**
+	Replicates node properties from the local peer to every connected peer.
+
+	Each peer acknowledges the state packets it receives, and only the
+	properties that differ from what the peer acknowledged are sent again.
+	Nodes can be filtered per peer by distance to an observer node or by
+	group, and a per peer bandwidth limit sends the nodes that waited the
+	longest (scaled by their priority) first.
+*/
+
+class SceneReplicator : public Reference {
+
+	GDCLASS(SceneReplicator, Reference);
+
+	enum {
+		MAX_PROPERTIES = 32, //one bit per property in the change mask
+		HISTORY_SIZE = 64, //unacknowledged state packets kept per peer
+		ACK_BITS = 32,
+		CONFIG_RETRY_MAX_USEC = 2000000, //refused configs are sent again at least this often
+	};
+
+	struct Entity {
+		ObjectID instance;
+		NodePath path;
+		Vector<StringName> properties;
+		float priority;
+
+		//filled once per snapshot, shared by all peers
+		Node *node;
+		Vector<Variant> values;
+		Vector<uint8_t> encoded;
+		Vector<int> encoded_ofs;
+		bool has_position;
+		Vector3 position;
+	};
+
+	struct EntityState {
+		bool config_sent;
+		bool confirmed;
+		uint64_t config_usec;
+		uint64_t config_retry_usec;
+		float accumulator;
+
+		Vector<Variant> acked;
+		Vector<uint32_t> acked_seq; //0 if never acknowledged
+		Vector<Variant> sent;
+		Vector<uint64_t> sent_usec;
+
+		EntityState() {
+			config_sent = false;
+			confirmed = false;
+			config_usec = 0;
+			config_retry_usec = 0;
+			accumulator = 0;
+		}
+	};
+
+	struct SentEntry {
+		int entity;
+		uint32_t mask;
+		int value_ofs;
+	};
+
+	struct SentPacket {
+		uint32_t seq;
+		bool acked;
+		uint64_t usec;
+		//kept allocated between uses, only the counts are reset
+		Vector<SentEntry> entries;
+		int entry_count;
+		Vector<Variant> values;
+		int value_count;
+
+		SentPacket() {
+			seq = 0;
+			acked = false;
+			usec = 0;
+			entry_count = 0;
+			value_count = 0;
+		}
+	};
+
+	struct ReceivedEntity {
+		NodePath path;
+		ObjectID instance;
+		Vector<StringName> properties;
+		Vector<uint32_t> seq; //last state packet applied, per property
+	};
+
+	struct Peer {
+		//sending
+		Map<int, EntityState> entities;
+		SentPacket history[HISTORY_SIZE];
+		uint32_t last_seq;
+		uint64_t rtt_usec;
+		float budget;
+		ObjectID observer;
+		Vector<StringName> interest_groups;
+
+		//receiving
+		Map<int, ReceivedEntity> received;
+		uint32_t last_received_seq;
+		uint32_t received_bits;
+		int unacked; //state packets received since the last acknowledgement
+
+		Peer() {
+			last_seq = 0;
+			rtt_usec = 200000;
+			budget = 0;
+			observer = 0;
+			last_received_seq = 0;
+			received_bits = 0;
+			unacked = 0;
+		}
+	};
+
+	struct Candidate {
+		int entity;
+		uint32_t mask;
+		float accumulator;
+		Entity *e;
+		EntityState *state;
+
+		_FORCE_INLINE_ bool operator<(const Candidate &p_candidate) const { return accumulator > p_candidate.accumulator; }
+	};
+
+	Ref<NetworkedMultiplayerPeer> network_peer;
+	Node *root_node;
+
+	Map<int, Entity> entities;
+	Map<ObjectID, int> entity_ids;
+	int last_entity_id;
+
+	Map<int, Peer> peers;
+
+	float send_rate;
+	int bandwidth_limit;
+	float interest_radius;
+	int max_packet_size;
+
+	float time_to_send;
+
+	Vector<Candidate> candidates;
+	Vector<uint8_t> packet_cache;
+	Vector<uint8_t> config_cache;
+	int config_len;
+	uint64_t bytes_sent;
+
+	void _peer_connected(int p_id);
+	void _peer_disconnected(int p_id);
+
+	void _update_entities();
+	void _send_config(int p_peer, int p_entity, const Entity &p_e);
+	void _flush_config(int p_peer);
+	void _flush_state(int p_peer, Peer &p_peer_data, SentPacket &p_sent, int p_len);
+	void _replicate_to_peer(int p_peer, Peer &p_peer_data, uint64_t p_usec);
+
+	void _send_state_ack(int p_peer, Peer &p_peer_data);
+
+	void _process_config(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_confirm_config(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_state(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_confirm_state(int p_from, const uint8_t *p_packet, int p_packet_len);
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_network_peer(const Ref<NetworkedMultiplayerPeer> &p_network_peer);
+	Ref<NetworkedMultiplayerPeer> get_network_peer() const;
+
+	void set_root_node(Node *p_node);
+	Node *get_root_node() const;
+
+	void add_node(Node *p_node, const PoolStringArray &p_properties, float p_priority = 1.0);
+	void remove_node(Node *p_node);
+	bool has_node(Node *p_node) const;
+	void set_node_priority(Node *p_node, float p_priority);
+	float get_node_priority(Node *p_node) const;
+
+	void set_peer_observer(int p_peer, Node *p_observer);
+	Node *get_peer_observer(int p_peer) const;
+
+	void set_peer_interest_groups(int p_peer, const PoolStringArray &p_groups);
+	PoolStringArray get_peer_interest_groups(int p_peer) const;
+
+	void set_send_rate(float p_rate);
+	float get_send_rate() const;
+
+	void set_bandwidth_limit(int p_bytes_per_second);
+	int get_bandwidth_limit() const;
+
+	void set_interest_radius(float p_radius);
+	float get_interest_radius() const;
+
+	void set_max_packet_size(int p_size);
+	int get_max_packet_size() const;
+
+	uint64_t get_bytes_sent() const;
+
+	//called by SceneTree with the packets of the replication commands
+	void process_packet(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void poll(float p_time);
+
+	SceneReplicator();
+	~SceneReplicator();
+};
+
+#endif // SCENE_REPLICATOR_H
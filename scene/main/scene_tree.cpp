@@ -485,6 +485,7 @@ bool SceneTree::idle(float p_time) {
 	idle_process_time = p_time;
 
 	_network_poll();
+	replicator->poll(p_time);
 
 	emit_signal("idle_frame");
 
@@ -1678,6 +1679,7 @@ void SceneTree::set_network_peer(const Ref<NetworkedMultiplayerPeer> &p_network_
 	ERR_FAIL_COND(p_network_peer.is_valid() && p_network_peer->get_connection_status() == NetworkedMultiplayerPeer::CONNECTION_DISCONNECTED);
 
 	network_peer = p_network_peer;
+	replicator->set_network_peer(network_peer);
 
 	if (network_peer.is_valid()) {
 		network_peer->connect("peer_connected", this, "_network_peer_connected");
@@ -1724,6 +1726,11 @@ int SceneTree::get_rpc_sender_id() const {
 	return rpc_sender_id;
 }
 
+Ref<SceneReplicator> SceneTree::get_replicator() const {
+
+	return replicator;
+}
+
 void SceneTree::set_refuse_new_network_connections(bool p_refuse) {
 	ERR_FAIL_COND(!network_peer.is_valid());
 	network_peer->set_refuse_new_connections(p_refuse);
@@ -1736,6 +1743,23 @@ bool SceneTree::is_refusing_new_network_connections() const {
 	return network_peer->is_refusing_new_connections();
 }
 
+//arguments use the variant encoding selected in the network peer, both ends must agree on it
+static Error _encode_rpc_argument(const Ref<NetworkedMultiplayerPeer> &p_peer, const Variant &p_value, uint8_t *r_buffer, int &r_len) {
+
+	if (p_peer->is_compact_encoding_enabled())
+		return encode_variant_compact(p_value, r_buffer, r_len, p_peer->get_compact_encoding_flags());
+
+	return encode_variant(p_value, r_buffer, r_len);
+}
+
+static Error _decode_rpc_argument(const Ref<NetworkedMultiplayerPeer> &p_peer, Variant &r_value, const uint8_t *p_buffer, int p_len, int *r_len = NULL) {
+
+	if (p_peer->is_compact_encoding_enabled())
+		return decode_variant_compact(r_value, p_buffer, p_len, r_len);
+
+	return decode_variant(r_value, p_buffer, p_len, r_len);
+}
+
 void SceneTree::_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, const StringName &p_name, const Variant **p_arg, int p_argcount) {
 
 	if (network_peer.is_null()) {
@@ -1780,6 +1804,15 @@ void SceneTree::_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, cons
 		psc->id = last_send_cache_id++;
 	}
 
+	//see if the name is cached for this path
+	Map<StringName, NameSentCache>::Element *N = psc->names.find(p_name);
+	if (!N) {
+		//name is not cached, create
+		N = psc->names.insert(p_name, NameSentCache());
+		N->get().id = psc->last_name_id++;
+	}
+	NameSentCache *nsc = &N->get();
+
 	//create base packet, lots of hardcode because it must be tight
 
 	int ofs = 0;
@@ -1797,19 +1830,19 @@ void SceneTree::_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, cons
 	encode_uint32(psc->id, &packet_cache[ofs]);
 	ofs += 4;
 
-	//encode function name
-	CharString name = String(p_name).utf8();
-	int len = encode_cstring(name.get_data(), NULL);
-	MAKE_ROOM(ofs + len);
-	encode_cstring(name.get_data(), &packet_cache[ofs]);
-	ofs += len;
+	//encode function name id
+	MAKE_ROOM(ofs + 5);
+	ofs += encode_varint(nsc->id, &packet_cache[ofs]);
+
+	int args_ofs = ofs;
+	int len;
 
 	if (p_set) {
 		//set argument
-		Error err = encode_variant(*p_arg[0], NULL, len);
+		Error err = _encode_rpc_argument(network_peer, *p_arg[0], NULL, len);
 		ERR_FAIL_COND(err != OK);
 		MAKE_ROOM(ofs + len);
-		encode_variant(*p_arg[0], &packet_cache[ofs], len);
+		_encode_rpc_argument(network_peer, *p_arg[0], &packet_cache[ofs], len);
 		ofs += len;
 
 	} else {
@@ -1818,18 +1851,19 @@ void SceneTree::_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, cons
 		packet_cache[ofs] = p_argcount;
 		ofs += 1;
 		for (int i = 0; i < p_argcount; i++) {
-			Error err = encode_variant(*p_arg[i], NULL, len);
+			Error err = _encode_rpc_argument(network_peer, *p_arg[i], NULL, len);
 			ERR_FAIL_COND(err != OK);
 			MAKE_ROOM(ofs + len);
-			encode_variant(*p_arg[i], &packet_cache[ofs], len);
+			_encode_rpc_argument(network_peer, *p_arg[i], &packet_cache[ofs], len);
 			ofs += len;
 		}
 	}
 
-	//see if all peers have cached path (is so, call can be fast)
+	//see if all peers have cached path and name (is so, call can be fast)
 	bool has_all_peers = true;
 
 	List<int> peers_to_add; //if one is missing, take note to add it
+	List<int> names_to_add;
 
 	for (Set<int>::Element *E = connected_peers.front(); E; E = E->next()) {
 
@@ -1850,6 +1884,17 @@ void SceneTree::_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, cons
 
 			has_all_peers = false;
 		}
+
+		Map<int, bool>::Element *G = nsc->confirmed_peers.find(E->get());
+
+		if (!G || G->get() == false) {
+			//same for the name
+			if (!G) {
+				names_to_add.push_back(E->get());
+			}
+
+			has_all_peers = false;
+		}
 	}
 
 	//those that need to be added, send a message for this
@@ -1874,12 +1919,35 @@ void SceneTree::_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, cons
 		psc->confirmed_peers.insert(E->get(), false); //insert into confirmed, but as false since it was not confirmed
 	}
 
+	//names go after the path, through the same reliable channel, so the path is always known when they arrive
+
+	for (List<int>::Element *E = names_to_add.front(); E; E = E->next()) {
+
+		CharString name = String(p_name).utf8();
+		int id_len = encode_varint(nsc->id, NULL);
+		int len = encode_cstring(name.get_data(), NULL);
+
+		Vector<uint8_t> packet;
+
+		packet.resize(1 + 4 + id_len + len);
+		packet[0] = NETWORK_COMMAND_SIMPLIFY_NAME;
+		encode_uint32(psc->id, &packet[1]);
+		encode_varint(nsc->id, &packet[5]);
+		encode_cstring(name.get_data(), &packet[5 + id_len]);
+
+		network_peer->set_target_peer(E->get());
+		network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+		network_peer->put_packet(packet.ptr(), packet.size());
+
+		nsc->confirmed_peers.insert(E->get(), false);
+	}
+
 	//take chance and set transfer mode, since all send methods will use it
 	network_peer->set_transfer_mode(p_unreliable ? NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE : NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
 
 	if (has_all_peers) {
 
-		//they all have verified paths, so send fast
+		//they all have verified paths and names, so send fast
 		network_peer->set_target_peer(p_to); //to all of you
 		network_peer->put_packet(packet_cache.ptr(), ofs); //a message with love
 	} else {
@@ -1891,6 +1959,10 @@ void SceneTree::_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, cons
 		MAKE_ROOM(ofs + path_len);
 		encode_cstring(pname.get_data(), &packet_cache[ofs]);
 
+		//same packet with the full name instead of its id, only built if some peer needs it
+		Vector<uint8_t> named_packet;
+		int named_ofs = 0;
+
 		for (Set<int>::Element *E = connected_peers.front(); E; E = E->next()) {
 
 			if (p_to < 0 && E->get() == -p_to)
@@ -1901,17 +1973,47 @@ void SceneTree::_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, cons
 
 			Map<int, bool>::Element *F = psc->confirmed_peers.find(E->get());
 			ERR_CONTINUE(!F); //should never happen
+			Map<int, bool>::Element *G = nsc->confirmed_peers.find(E->get());
+			ERR_CONTINUE(!G); //should never happen
 
 			network_peer->set_target_peer(E->get()); //to this one specifically
 
+			uint8_t *packet;
+			int packet_ofs;
+
+			if (F->get() == true && G->get() == true) {
+				//name ids are only valid along with a cached path
+				packet = packet_cache.ptrw();
+				packet_ofs = ofs;
+			} else {
+
+				if (named_packet.empty()) {
+
+					CharString name = String(p_name).utf8();
+					int name_len = encode_cstring(name.get_data(), NULL);
+					int args_len = ofs - args_ofs;
+
+					named_ofs = 5 + 1 + name_len + args_len;
+					named_packet.resize(named_ofs + path_len);
+					uint8_t *w = named_packet.ptrw();
+					w[0] = packet_cache[0];
+					w[5] = 0; //name id 0, full name follows
+					encode_cstring(name.get_data(), &w[6]);
+					copymem(&w[6 + name_len], &packet_cache[args_ofs], args_len + path_len);
+				}
+
+				packet = named_packet.ptrw();
+				packet_ofs = named_ofs;
+			}
+
 			if (F->get() == true) {
 				//this one confirmed path, so use id
-				encode_uint32(psc->id, &packet_cache[1]);
-				network_peer->put_packet(packet_cache.ptr(), ofs);
+				encode_uint32(psc->id, &packet[1]);
+				network_peer->put_packet(packet, packet_ofs);
 			} else {
 				//this one did not confirm path yet, so use entire path (sorry!)
-				encode_uint32(0x80000000 | ofs, &packet_cache[1]); //offset to path and flag
-				network_peer->put_packet(packet_cache.ptr(), ofs + path_len);
+				encode_uint32(0x80000000 | packet_ofs, &packet[1]); //offset to path and flag
+				network_peer->put_packet(packet, packet_ofs + path_len);
 			}
 		}
 	}
@@ -1919,7 +2021,7 @@ void SceneTree::_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, cons
 
 void SceneTree::_network_process_packet(int p_from, const uint8_t *p_packet, int p_packet_len) {
 
-	ERR_FAIL_COND(p_packet_len < 5);
+	ERR_FAIL_COND(p_packet_len < 1);
 
 	uint8_t packet_type = p_packet[0];
 
@@ -1932,6 +2034,7 @@ void SceneTree::_network_process_packet(int p_from, const uint8_t *p_packet, int
 			uint32_t target = decode_uint32(&p_packet[1]);
 
 			Node *node = NULL;
+			PathGetCache::NodeInfo *ni = NULL;
 
 			if (target & 0x80000000) {
 				//use full path (not cached yet)
@@ -1959,7 +2062,7 @@ void SceneTree::_network_process_packet(int p_from, const uint8_t *p_packet, int
 				Map<int, PathGetCache::NodeInfo>::Element *F = E->get().nodes.find(id);
 				ERR_FAIL_COND(!F);
 
-				PathGetCache::NodeInfo *ni = &F->get();
+				ni = &F->get();
 				//do proper caching later
 
 				node = get_root()->get_node(ni->path);
@@ -1971,25 +2074,44 @@ void SceneTree::_network_process_packet(int p_from, const uint8_t *p_packet, int
 
 			ERR_FAIL_COND(p_packet_len < 6);
 
-			//detect cstring end
-			int len_end = 5;
-			for (; len_end < p_packet_len; len_end++) {
-				if (p_packet[len_end] == 0) {
-					break;
+			uint64_t name_id;
+			int ofs = 5;
+			int id_len = decode_varint(&p_packet[ofs], p_packet_len - ofs, name_id);
+			ERR_FAIL_COND(id_len == 0);
+			ofs += id_len;
+
+			StringName name;
+
+			if (name_id == 0) {
+				//full name follows (not cached yet)
+
+				//detect cstring end
+				int len_end = ofs;
+				for (; len_end < p_packet_len; len_end++) {
+					if (p_packet[len_end] == 0) {
+						break;
+					}
 				}
-			}
 
-			ERR_FAIL_COND(len_end >= p_packet_len);
+				ERR_FAIL_COND(len_end >= p_packet_len);
 
-			StringName name = String::utf8((const char *)&p_packet[5]);
+				name = String::utf8((const char *)&p_packet[ofs]);
+				ofs = len_end + 1;
+			} else {
+				//use cached name, only sent along with a cached path
+				ERR_FAIL_COND(!ni);
+
+				Map<int, StringName>::Element *N = ni->names.find(name_id);
+				ERR_FAIL_COND(!N);
+
+				name = N->get();
+			}
 
 			if (packet_type == NETWORK_COMMAND_REMOTE_CALL) {
 
 				if (!node->can_call_rpc(name, p_from))
 					return;
 
-				int ofs = len_end + 1;
-
 				ERR_FAIL_COND(ofs >= p_packet_len);
 
 				int argc = p_packet[ofs];
@@ -2004,7 +2126,7 @@ void SceneTree::_network_process_packet(int p_from, const uint8_t *p_packet, int
 
 					ERR_FAIL_COND(ofs >= p_packet_len);
 					int vlen;
-					Error err = decode_variant(args[i], &p_packet[ofs], p_packet_len - ofs, &vlen);
+					Error err = _decode_rpc_argument(network_peer, args[i], &p_packet[ofs], p_packet_len - ofs, &vlen);
 					ERR_FAIL_COND(err != OK);
 					//args[i]=p_packet[3+i];
 					argp[i] = &args[i];
@@ -2025,12 +2147,10 @@ void SceneTree::_network_process_packet(int p_from, const uint8_t *p_packet, int
 				if (!node->can_call_rset(name, p_from))
 					return;
 
-				int ofs = len_end + 1;
-
 				ERR_FAIL_COND(ofs >= p_packet_len);
 
 				Variant value;
-				decode_variant(value, &p_packet[ofs], p_packet_len - ofs);
+				_decode_rpc_argument(network_peer, value, &p_packet[ofs], p_packet_len - ofs);
 
 				bool valid;
 
@@ -2094,6 +2214,84 @@ void SceneTree::_network_process_packet(int p_from, const uint8_t *p_packet, int
 			ERR_FAIL_COND(!E);
 			E->get() = true;
 		} break;
+		case NETWORK_COMMAND_SIMPLIFY_NAME: {
+
+			ERR_FAIL_COND(p_packet_len < 7);
+			int id = decode_uint32(&p_packet[1]);
+
+			uint64_t name_id;
+			int id_len = decode_varint(&p_packet[5], p_packet_len - 5, name_id);
+			ERR_FAIL_COND(id_len == 0 || name_id == 0);
+			int ofs = 5 + id_len;
+			ERR_FAIL_COND(ofs >= p_packet_len);
+
+			String names;
+			names.parse_utf8((const char *)&p_packet[ofs], p_packet_len - ofs);
+
+			Map<int, PathGetCache>::Element *E = path_get_cache.find(p_from);
+			ERR_FAIL_COND(!E);
+
+			Map<int, PathGetCache::NodeInfo>::Element *F = E->get().nodes.find(id);
+			ERR_FAIL_COND(!F);
+
+			F->get().names[name_id] = names;
+
+			{
+				//send ack, with the path and name it refers to
+
+				CharString pname = String(F->get().path).utf8();
+				int path_len = encode_cstring(pname.get_data(), NULL);
+				CharString name = names.utf8();
+				int len = encode_cstring(name.get_data(), NULL);
+
+				Vector<uint8_t> packet;
+
+				packet.resize(1 + path_len + len);
+				packet[0] = NETWORK_COMMAND_CONFIRM_NAME;
+				encode_cstring(pname.get_data(), &packet[1]);
+				encode_cstring(name.get_data(), &packet[1 + path_len]);
+
+				network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+				network_peer->set_target_peer(p_from);
+				network_peer->put_packet(packet.ptr(), packet.size());
+			}
+		} break;
+		case NETWORK_COMMAND_CONFIRM_NAME: {
+
+			//detect cstring end
+			int len_end = 1;
+			for (; len_end < p_packet_len; len_end++) {
+				if (p_packet[len_end] == 0) {
+					break;
+				}
+			}
+
+			ERR_FAIL_COND(len_end + 1 >= p_packet_len);
+
+			String paths;
+			paths.parse_utf8((const char *)&p_packet[1], len_end - 1);
+			String names;
+			names.parse_utf8((const char *)&p_packet[len_end + 1], p_packet_len - len_end - 1);
+
+			NodePath path = paths;
+
+			PathSentCache *psc = path_send_cache.getptr(path);
+			ERR_FAIL_COND(!psc);
+
+			Map<StringName, NameSentCache>::Element *N = psc->names.find(names);
+			ERR_FAIL_COND(!N);
+
+			Map<int, bool>::Element *E = N->get().confirmed_peers.find(p_from);
+			ERR_FAIL_COND(!E);
+			E->get() = true;
+		} break;
+		case NETWORK_COMMAND_REPLICATE_CONFIG:
+		case NETWORK_COMMAND_CONFIRM_REPLICATE_CONFIG:
+		case NETWORK_COMMAND_REPLICATE_STATE:
+		case NETWORK_COMMAND_CONFIRM_REPLICATE_STATE: {
+
+			replicator->process_packet(p_from, p_packet, p_packet_len);
+		} break;
 	}
 }
 
@@ -2203,6 +2401,7 @@ void SceneTree::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_network_connected_peers"), &SceneTree::get_network_connected_peers);
 	ClassDB::bind_method(D_METHOD("get_network_unique_id"), &SceneTree::get_network_unique_id);
 	ClassDB::bind_method(D_METHOD("get_rpc_sender_id"), &SceneTree::get_rpc_sender_id);
+	ClassDB::bind_method(D_METHOD("get_replicator"), &SceneTree::get_replicator);
 	ClassDB::bind_method(D_METHOD("set_refuse_new_network_connections", "refuse"), &SceneTree::set_refuse_new_network_connections);
 	ClassDB::bind_method(D_METHOD("is_refusing_new_network_connections"), &SceneTree::is_refusing_new_network_connections);
 	ClassDB::bind_method(D_METHOD("_network_peer_connected"), &SceneTree::_network_peer_connected);
@@ -2224,6 +2423,7 @@ void SceneTree::_bind_methods() {
 #endif
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "current_scene", PROPERTY_HINT_RESOURCE_TYPE, "Node", 0), "set_current_scene", "get_current_scene");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "network_peer", PROPERTY_HINT_RESOURCE_TYPE, "NetworkedMultiplayerPeer", 0), "set_network_peer", "get_network_peer");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "replicator", PROPERTY_HINT_RESOURCE_TYPE, "SceneReplicator", 0), "", "get_replicator");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "root", PROPERTY_HINT_RESOURCE_TYPE, "Node", 0), "", "get_root");
 
 	ADD_SIGNAL(MethodInfo("tree_changed"));
@@ -2329,6 +2529,9 @@ SceneTree::SceneTree() {
 	if (!root->get_world().is_valid())
 		root->set_world(Ref<World>(memnew(World)));
 
+	replicator.instance();
+	replicator->set_root_node(root);
+
 	//root->set_world_2d( Ref<World2D>( memnew( World2D )));
 	root->set_as_audio_listener(true);
 	root->set_as_audio_listener_2d(true);
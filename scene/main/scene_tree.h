@@ -36,6 +36,7 @@
 #include "os/thread_safe.h"
 #include "scene/resources/mesh.h"
 #include "scene/resources/world.h"
+#include "scene/main/scene_replicator.h"
 #include "scene/resources/world_2d.h"
 #include "self_list.h"
 
@@ -190,9 +191,16 @@ private:
 		NETWORK_COMMAND_REMOTE_SET,
 		NETWORK_COMMAND_SIMPLIFY_PATH,
 		NETWORK_COMMAND_CONFIRM_PATH,
+		NETWORK_COMMAND_SIMPLIFY_NAME,
+		NETWORK_COMMAND_CONFIRM_NAME,
+		NETWORK_COMMAND_REPLICATE_CONFIG,
+		NETWORK_COMMAND_CONFIRM_REPLICATE_CONFIG,
+		NETWORK_COMMAND_REPLICATE_STATE,
+		NETWORK_COMMAND_CONFIRM_REPLICATE_STATE,
 	};
 
 	Ref<NetworkedMultiplayerPeer> network_peer;
+	Ref<SceneReplicator> replicator;
 
 	Set<int> connected_peers;
 	void _network_peer_connected(int p_id);
@@ -205,9 +213,22 @@ private:
 	int rpc_sender_id;
 
 	//path sent caches
+	struct NameSentCache {
+		Map<int, bool> confirmed_peers;
+		int id;
+	};
+
 	struct PathSentCache {
 		Map<int, bool> confirmed_peers;
 		int id;
+		//method and property names, sent as ids once confirmed
+		Map<StringName, NameSentCache> names;
+		int last_name_id;
+
+		PathSentCache() {
+			id = 0;
+			last_name_id = 1; //0 means the name is sent in full
+		}
 	};
 
 	HashMap<NodePath, PathSentCache> path_send_cache;
@@ -218,6 +239,7 @@ private:
 		struct NodeInfo {
 			NodePath path;
 			ObjectID instance;
+			Map<int, StringName> names;
 		};
 
 		Map<int, NodeInfo> nodes;
@@ -232,6 +254,7 @@ private:
 
 	static SceneTree *singleton;
 	friend class Node;
+	friend class SceneReplicator;
 
 	void _rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, const StringName &p_name, const Variant **p_arg, int p_argcount);
 
@@ -457,6 +480,7 @@ public:
 	int get_network_unique_id() const;
 	Vector<int> get_network_connected_peers() const;
 	int get_rpc_sender_id() const;
+	Ref<SceneReplicator> get_replicator() const;
 
 	void set_refuse_new_network_connections(bool p_refuse);
 	bool is_refusing_new_network_connections() const;
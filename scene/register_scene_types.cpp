@@ -588,6 +588,7 @@ void register_scene_types() {
 
 	ClassDB::register_class<SceneTree>();
 	ClassDB::register_virtual_class<SceneTreeTimer>(); //sorry, you can't create it
+	ClassDB::register_virtual_class<SceneReplicator>();
 
 #ifndef DISABLE_DEPRECATED
 	ClassDB::add_compatibility_class("ImageSkyBox", "PanoramaSky");
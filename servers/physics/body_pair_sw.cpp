@@ -465,6 +465,18 @@ void BodyPairSW::solve(real_t p_step) {
 	}
 }
 
+bool BodyPairSW::is_island_local() const {
+
+	// Static and kinematic bodies are shared between islands, only contact reporting on them writes to them,
+	// as impulses skip them.
+	if (A->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && A->can_report_contacts())
+		return false;
+	if (B->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && B->can_report_contacts())
+		return false;
+
+	return true;
+}
+
 BodyPairSW::BodyPairSW(BodySW *p_A, int p_shape_A, BodySW *p_B, int p_shape_B) :
 		ConstraintSW(_arr, 2) {
 
@@ -0,0 +1,406 @@
+/*************************************************************************/
+/*  broad_phase_bvh.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "broad_phase_bvh.h"
+#include "collision_object_sw.h"
+#include "project_settings.h"
+
+bool BroadPhaseBVH::_is_paired(const Element *p_A, const Element *p_B) const {
+
+	// scan the shorter list, static geometry can pair with a lot of bodies
+	if (p_A->pairs.size() > p_B->pairs.size()) {
+		SWAP(p_A, p_B);
+	}
+
+	for (uint32_t i = 0; i < p_A->pairs.size(); i++) {
+		const PairData &pd = pair_data[p_A->pairs[i]];
+		if (pd.a == p_B->self || pd.b == p_B->self)
+			return true;
+	}
+
+	return false;
+}
+
+void BroadPhaseBVH::_pair(Element *p_A, Element *p_B) {
+
+	uint32_t idx;
+	if (free_pair != INVALID_INDEX) {
+		idx = free_pair;
+		free_pair = pair_data[idx].next_free;
+	} else {
+		idx = pair_data.size();
+		pair_data.resize(idx + 1);
+	}
+
+	PairData &pd = pair_data[idx];
+	pd.a = p_A->self;
+	pd.b = p_B->self;
+	pd.colliding = false;
+	pd.ud = NULL;
+
+	p_A->pairs.push_back(idx);
+	p_B->pairs.push_back(idx);
+}
+
+void BroadPhaseBVH::_unpair(uint32_t p_pair) {
+
+	PairData &pd = pair_data[p_pair];
+	Element *a = &elements[pd.a - 1];
+	Element *b = &elements[pd.b - 1];
+
+	if (pd.colliding && unpair_callback) {
+		unpair_callback(a->owner, a->subindex, b->owner, b->subindex, pd.ud, unpair_userdata);
+	}
+
+	a->pairs.erase_unordered(p_pair);
+	b->pairs.erase_unordered(p_pair);
+
+	pd.next_free = free_pair;
+	free_pair = p_pair;
+}
+
+struct BroadPhaseBVH::_FindPairs {
+
+	BroadPhaseBVH *self;
+	Element *elem;
+	AABB fat;
+
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return p_aabb.intersects_inclusive(fat); }
+
+	_FORCE_INLINE_ bool operator()(uint32_t p_item) {
+
+		Element *other = &self->elements[p_item];
+		if (self->_can_pair(elem, other) && !self->_is_paired(elem, other)) {
+			self->_pair(elem, other);
+		}
+		return true;
+	}
+};
+
+// Adds pairs with all the leaves overlapping the fat bounds of p_elem.
+void BroadPhaseBVH::_find_pairs(Element *p_elem) {
+
+	_FindPairs find;
+	find.self = this;
+	find.elem = p_elem;
+	find.fat = tree.get_aabb(p_elem->leaf);
+	tree.query(find, find);
+}
+
+// Reports the pairs of p_elem whose real bounds started or stopped overlapping.
+void BroadPhaseBVH::_check_pairs(Element *p_elem) {
+
+	for (uint32_t i = 0; i < p_elem->pairs.size(); i++) {
+
+		PairData &pd = pair_data[p_elem->pairs[i]];
+		const Element *a = &elements[pd.a - 1];
+		const Element *b = &elements[pd.b - 1];
+
+		bool colliding = a->aabb.intersects_inclusive(b->aabb);
+
+		if (colliding == pd.colliding)
+			continue;
+
+		if (colliding) {
+			if (pair_callback) {
+				pd.ud = pair_callback(a->owner, a->subindex, b->owner, b->subindex, pair_userdata);
+			}
+		} else {
+			if (unpair_callback) {
+				unpair_callback(a->owner, a->subindex, b->owner, b->subindex, pd.ud, unpair_userdata);
+			}
+			pd.ud = NULL;
+		}
+
+		pd.colliding = colliding;
+	}
+}
+
+BroadPhaseSW::ID BroadPhaseBVH::create(CollisionObjectSW *p_object, int p_subindex) {
+
+	ERR_FAIL_COND_V(!p_object, 0);
+
+	uint32_t idx;
+	if (free_element != INVALID_INDEX) {
+		idx = free_element;
+		free_element = elements[idx].next_free;
+	} else {
+		idx = elements.size();
+		elements.resize(idx + 1);
+	}
+
+	Element &e = elements[idx];
+	e.self = idx + 1;
+	e.owner = p_object;
+	e._static = false;
+	e.aabb = AABB();
+	e.subindex = p_subindex;
+	e.leaf = INVALID_INDEX;
+
+	return e.self;
+}
+
+void BroadPhaseBVH::move(ID p_id, const AABB &p_aabb) {
+
+	Element *e = _get_element(p_id);
+	ERR_FAIL_COND(!e);
+
+	if (e->leaf == INVALID_INDEX) {
+
+		e->aabb = p_aabb;
+		e->leaf = tree.create(p_aabb.grow(margin), p_id - 1);
+		_find_pairs(e);
+
+	} else {
+
+		if (e->aabb == p_aabb)
+			return;
+
+		AABB from = e->aabb;
+		e->aabb = p_aabb;
+
+		if (!tree.get_aabb(e->leaf).encloses(p_aabb)) {
+
+			// left the fat bounds, re-insert them enlarged towards where it is heading
+			AABB fat = p_aabb.grow(margin);
+			Vector3 displacement = (p_aabb.position - from.position) * displacement_multiplier;
+			for (int i = 0; i < 3; i++) {
+				if (displacement[i] < 0) {
+					fat.position[i] += displacement[i];
+					fat.size[i] -= displacement[i];
+				} else {
+					fat.size[i] += displacement[i];
+				}
+			}
+
+			tree.move(e->leaf, fat);
+
+			// walk backwards, as unpairing swaps the last pair into the removed slot
+			for (int i = int(e->pairs.size()) - 1; i >= 0; i--) {
+
+				const PairData &pd = pair_data[e->pairs[i]];
+				const Element *other = &elements[(pd.a == e->self ? pd.b : pd.a) - 1];
+
+				if (!fat.intersects_inclusive(tree.get_aabb(other->leaf))) {
+					_unpair(e->pairs[i]);
+				}
+			}
+
+			_find_pairs(e);
+		}
+	}
+
+	_check_pairs(e);
+}
+
+void BroadPhaseBVH::set_static(ID p_id, bool p_static) {
+
+	Element *e = _get_element(p_id);
+	ERR_FAIL_COND(!e);
+
+	if (e->_static == p_static)
+		return;
+
+	e->_static = p_static;
+
+	if (e->leaf == INVALID_INDEX)
+		return;
+
+	if (p_static) {
+
+		for (int i = int(e->pairs.size()) - 1; i >= 0; i--) {
+
+			const PairData &pd = pair_data[e->pairs[i]];
+			if (elements[(pd.a == e->self ? pd.b : pd.a) - 1]._static) {
+				_unpair(e->pairs[i]);
+			}
+		}
+	} else {
+
+		_find_pairs(e);
+		_check_pairs(e);
+	}
+}
+
+void BroadPhaseBVH::remove(ID p_id) {
+
+	Element *e = _get_element(p_id);
+	ERR_FAIL_COND(!e);
+
+	while (e->pairs.size()) {
+		_unpair(e->pairs[e->pairs.size() - 1]);
+	}
+
+	if (e->leaf != INVALID_INDEX) {
+		tree.erase(e->leaf);
+		e->leaf = INVALID_INDEX;
+	}
+
+	e->owner = NULL;
+	e->next_free = free_element;
+	free_element = p_id - 1;
+}
+
+CollisionObjectSW *BroadPhaseBVH::get_object(ID p_id) const {
+
+	const Element *e = _get_element(p_id);
+	ERR_FAIL_COND_V(!e, NULL);
+	return e->owner;
+}
+
+bool BroadPhaseBVH::is_static(ID p_id) const {
+
+	const Element *e = _get_element(p_id);
+	ERR_FAIL_COND_V(!e, false);
+	return e->_static;
+}
+
+int BroadPhaseBVH::get_subindex(ID p_id) const {
+
+	const Element *e = _get_element(p_id);
+	ERR_FAIL_COND_V(!e, -1);
+	return e->subindex;
+}
+
+template <class T>
+int BroadPhaseBVH::_cull(const T &p_test, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices) {
+
+	if (p_max_results <= 0)
+		return 0;
+
+	struct Collect {
+
+		const T *test;
+		const LocalVector<Element> *elements;
+		CollisionObjectSW **results;
+		int *result_indices;
+		int max_results;
+		int count;
+
+		_FORCE_INLINE_ bool operator()(uint32_t p_item) {
+
+			const Element &e = (*elements)[p_item];
+			if (!(*test)(e.aabb))
+				return true;
+
+			results[count] = e.owner;
+			if (result_indices)
+				result_indices[count] = e.subindex;
+			return ++count < max_results;
+		}
+	};
+
+	Collect collect;
+	collect.test = &p_test;
+	collect.elements = &elements;
+	collect.results = p_results;
+	collect.result_indices = p_result_indices;
+	collect.max_results = p_max_results;
+	collect.count = 0;
+	tree.query(p_test, collect);
+
+	return collect.count;
+}
+
+struct _BVHCullPoint {
+
+	Vector3 point;
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return p_aabb.has_point(point); }
+};
+
+struct _BVHCullSegment {
+
+	Vector3 from;
+	Vector3 to;
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return p_aabb.intersects_segment(from, to); }
+};
+
+struct _BVHCullAABB {
+
+	AABB aabb;
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return p_aabb.intersects_inclusive(aabb); }
+};
+
+int BroadPhaseBVH::cull_point(const Vector3 &p_point, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices) {
+
+	_BVHCullPoint test;
+	test.point = p_point;
+	return _cull(test, p_results, p_max_results, p_result_indices);
+}
+
+int BroadPhaseBVH::cull_segment(const Vector3 &p_from, const Vector3 &p_to, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices) {
+
+	_BVHCullSegment test;
+	test.from = p_from;
+	test.to = p_to;
+	return _cull(test, p_results, p_max_results, p_result_indices);
+}
+
+int BroadPhaseBVH::cull_aabb(const AABB &p_aabb, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices) {
+
+	_BVHCullAABB test;
+	test.aabb = p_aabb;
+	return _cull(test, p_results, p_max_results, p_result_indices);
+}
+
+void BroadPhaseBVH::set_pair_callback(PairCallback p_pair_callback, void *p_userdata) {
+
+	pair_callback = p_pair_callback;
+	pair_userdata = p_userdata;
+}
+
+void BroadPhaseBVH::set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) {
+
+	unpair_callback = p_unpair_callback;
+	unpair_userdata = p_userdata;
+}
+
+void BroadPhaseBVH::update() {
+	// pairs are reported as soon as objects move, like the octree
+}
+
+BroadPhaseSW *BroadPhaseBVH::_create() {
+
+	return memnew(BroadPhaseBVH);
+}
+
+BroadPhaseBVH::BroadPhaseBVH() {
+
+	free_element = INVALID_INDEX;
+	free_pair = INVALID_INDEX;
+
+	margin = GLOBAL_DEF("physics/3d/bvh_fat_margin", 0.25);
+	displacement_multiplier = 4.0;
+
+	pair_callback = NULL;
+	pair_userdata = NULL;
+	unpair_callback = NULL;
+	unpair_userdata = NULL;
+}
@@ -0,0 +1,141 @@
+/*************************************************************************/
+/*  broad_phase_bvh.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BROAD_PHASE_BVH_H
+#define BROAD_PHASE_BVH_H
+
+#include "aabb_tree.h"
+#include "broad_phase_sw.h"
+#include "local_vector.h"
+
+/* Dynamic AABB tree. Leaves store enlarged ("fat") bounds and pairs are kept
+ * while fat bounds overlap, so an object moving inside its fat bounds only has
+ * its current pairs checked against the real bounds. It is re-inserted, and
+ * the tree queried for new pairs, only once it leaves them. Insertion picks
+ * the sibling with the lowest surface area cost and rotations keep the tree
+ * balanced. */
+
+class BroadPhaseBVH : public BroadPhaseSW {
+
+	enum {
+		INVALID_INDEX = 0xFFFFFFFF
+	};
+
+	struct PairData {
+
+		ID a;
+		ID b;
+		bool colliding; // real bounds overlap, callbacks were called
+		void *ud;
+		uint32_t next_free;
+	};
+
+	struct Element {
+
+		ID self;
+		CollisionObjectSW *owner; // NULL while the slot is free
+		bool _static;
+		AABB aabb;
+		int subindex;
+		uint32_t leaf; // holds the fat bounds, INVALID_INDEX until it gets an aabb
+		LocalVector<uint32_t> pairs; // indices into pair_data
+		uint32_t next_free;
+	};
+
+	// IDs handed out are element indices plus one, so 0 stays invalid.
+	LocalVector<Element> elements;
+	uint32_t free_element;
+
+	AABBTree tree;
+
+	LocalVector<PairData> pair_data;
+	uint32_t free_pair;
+
+	real_t margin;
+	real_t displacement_multiplier;
+
+	PairCallback pair_callback;
+	void *pair_userdata;
+	UnpairCallback unpair_callback;
+	void *unpair_userdata;
+
+	_FORCE_INLINE_ Element *_get_element(ID p_id) {
+		if (p_id == 0 || p_id > elements.size())
+			return NULL;
+		Element *e = &elements[p_id - 1];
+		return e->owner ? e : NULL;
+	}
+	_FORCE_INLINE_ const Element *_get_element(ID p_id) const {
+		if (p_id == 0 || p_id > elements.size())
+			return NULL;
+		const Element *e = &elements[p_id - 1];
+		return e->owner ? e : NULL;
+	}
+
+	_FORCE_INLINE_ bool _can_pair(const Element *p_A, const Element *p_B) const {
+		return p_A != p_B && p_A->owner != p_B->owner && !(p_A->_static && p_B->_static);
+	}
+
+	template <class T>
+	int _cull(const T &p_test, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices);
+
+	struct _FindPairs;
+
+	bool _is_paired(const Element *p_A, const Element *p_B) const;
+	void _pair(Element *p_A, Element *p_B);
+	void _unpair(uint32_t p_pair);
+	void _find_pairs(Element *p_elem);
+	void _check_pairs(Element *p_elem);
+
+public:
+	virtual ID create(CollisionObjectSW *p_object, int p_subindex = 0);
+	virtual void move(ID p_id, const AABB &p_aabb);
+	virtual void set_static(ID p_id, bool p_static);
+	virtual void remove(ID p_id);
+
+	virtual CollisionObjectSW *get_object(ID p_id) const;
+	virtual bool is_static(ID p_id) const;
+	virtual int get_subindex(ID p_id) const;
+
+	virtual int cull_point(const Vector3 &p_point, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices = NULL);
+	virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices = NULL);
+	virtual int cull_aabb(const AABB &p_aabb, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices = NULL);
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata);
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata);
+
+	virtual void update();
+
+	static BroadPhaseSW *_create();
+
+	BroadPhaseBVH();
+};
+
+#endif // BROAD_PHASE_BVH_H
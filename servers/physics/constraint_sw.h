@@ -79,6 +79,9 @@ public:
 	virtual bool setup(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
 
+	// False if setup() writes to state shared with other islands (areas, the space, non rigid bodies).
+	virtual bool is_island_local() const { return true; }
+
 	virtual ~ConstraintSW() {}
 };
 
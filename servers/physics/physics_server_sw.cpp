@@ -31,6 +31,7 @@
 #include "physics_server_sw.h"
 
 #include "broad_phase_basic.h"
+#include "broad_phase_bvh.h"
 #include "broad_phase_octree.h"
 #include "joints/cone_twist_joint_sw.h"
 #include "joints/generic_6dof_joint_sw.h"
@@ -38,6 +39,7 @@
 #include "joints/pin_joint_sw.h"
 #include "joints/slider_joint_sw.h"
 #include "os/os.h"
+#include "project_settings.h"
 #include "script_language.h"
 
 RID PhysicsServerSW::shape_create(ShapeType p_shape) {
@@ -128,8 +130,8 @@ real_t PhysicsServerSW::shape_get_custom_solver_bias(RID p_shape) const {
 
 RID PhysicsServerSW::space_create() {
 
-	SpaceSW *space = memnew(SpaceSW);
-	RID id = space_owner.make_rid(space);
+	RID id = space_owner.make_rid();
+	SpaceSW *space = space_owner.get(id);
 	space->set_self(id);
 	RID area_id = area_create();
 	AreaSW *area = area_owner.get(area_id);
@@ -214,8 +216,8 @@ int PhysicsServerSW::space_get_contact_count(RID p_space) const {
 
 RID PhysicsServerSW::area_create() {
 
-	AreaSW *area = memnew(AreaSW);
-	RID rid = area_owner.make_rid(area);
+	RID rid = area_owner.make_rid();
+	AreaSW *area = area_owner.get(rid);
 	area->set_self(rid);
 	return rid;
 };
@@ -464,12 +466,12 @@ void PhysicsServerSW::area_set_area_monitor_callback(RID p_area, Object *p_recei
 
 RID PhysicsServerSW::body_create(BodyMode p_mode, bool p_init_sleeping) {
 
-	BodySW *body = memnew(BodySW);
+	RID rid = body_owner.make_rid();
+	BodySW *body = body_owner.get(rid);
 	if (p_mode != BODY_MODE_RIGID)
 		body->set_mode(p_mode);
 	if (p_init_sleeping)
 		body->set_state(BODY_STATE_SLEEPING, p_init_sleeping);
-	RID rid = body_owner.make_rid(body);
 	body->set_self(rid);
 	return rid;
 };
@@ -650,7 +652,7 @@ uint32_t PhysicsServerSW::body_get_collision_mask(RID p_body) const {
 	return body->get_collision_mask();
 }
 
-void PhysicsServerSW::body_attach_object_instance_id(RID p_body, uint32_t p_ID) {
+void PhysicsServerSW::body_attach_object_instance_id(RID p_body, ObjectID p_ID) {
 
 	BodySW *body = body_owner.get(p_body);
 	ERR_FAIL_COND(!body);
@@ -658,7 +660,7 @@ void PhysicsServerSW::body_attach_object_instance_id(RID p_body, uint32_t p_ID)
 	body->set_instance_id(p_ID);
 };
 
-uint32_t PhysicsServerSW::body_get_object_instance_id(RID p_body) const {
+ObjectID PhysicsServerSW::body_get_object_instance_id(RID p_body) const {
 
 	BodySW *body = body_owner.get(p_body);
 	ERR_FAIL_COND_V(!body, 0);
@@ -1293,7 +1295,6 @@ void PhysicsServerSW::free(RID p_rid) {
 		}
 
 		body_owner.free(p_rid);
-		memdelete(body);
 
 	} else if (area_owner.owns(p_rid)) {
 
@@ -1312,7 +1313,6 @@ void PhysicsServerSW::free(RID p_rid) {
 		}
 
 		area_owner.free(p_rid);
-		memdelete(area);
 	} else if (space_owner.owns(p_rid)) {
 
 		SpaceSW *space = space_owner.get(p_rid);
@@ -1327,7 +1327,6 @@ void PhysicsServerSW::free(RID p_rid) {
 		free(space->get_static_global_body());
 
 		space_owner.free(p_rid);
-		memdelete(space);
 	} else if (joint_owner.owns(p_rid)) {
 
 		JointSW *joint = joint_owner.get(p_rid);
@@ -1356,7 +1355,17 @@ void PhysicsServerSW::init() {
 	doing_sync = true;
 	last_step = 0.001;
 	iterations = 8; // 8?
+	String broad_phase = GLOBAL_DEF("physics/3d/broad_phase", "Octree");
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/broad_phase", PropertyInfo(Variant::STRING, "physics/3d/broad_phase", PROPERTY_HINT_ENUM, "Octree,BVH"));
+	if (broad_phase == "BVH") {
+		BroadPhaseSW::create_func = BroadPhaseBVH::_create;
+	} else {
+		BroadPhaseSW::create_func = BroadPhaseOctree::_create;
+	}
+
 	stepper = memnew(StepSW);
+	stepper->set_thread_count(GLOBAL_DEF("physics/3d/solver_thread_count", 1));
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/solver_thread_count", PropertyInfo(Variant::INT, "physics/3d/solver_thread_count", PROPERTY_HINT_RANGE, "0,64,1"));
 	direct_state = memnew(PhysicsDirectBodyStateSW);
 };
 
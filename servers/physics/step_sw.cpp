@@ -32,6 +32,7 @@
 #include "joints_sw.h"
 
 #include "os/os.h"
+#include "os/thread_pool.h"
 
 void StepSW::_populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island) {
 
@@ -107,6 +108,21 @@ void StepSW::_solve_island(ConstraintSW *p_island, int p_iterations, real_t p_de
 	}
 }
 
+void StepSW::_setup_island_local(uint32_t p_island, real_t p_delta) {
+
+	ConstraintSW *ci = constraint_islands[p_island];
+	while (ci) {
+		if (ci->is_island_local())
+			ci->setup(p_delta);
+		ci = ci->get_island_next();
+	}
+}
+
+void StepSW::_solve_island_task(uint32_t p_island, real_t p_delta) {
+
+	_solve_island(constraint_islands[p_island], iterations, p_delta);
+}
+
 void StepSW::_check_suspend(BodySW *p_island, real_t p_delta) {
 
 	bool can_sleep = true;
@@ -231,7 +247,39 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 	//print_line("island count: "+itos(island_count)+" active count: "+itos(active_count));
 	/* SETUP CONSTRAINT ISLANDS */
 
-	{
+	ThreadPool *pool = ThreadPool::get_singleton();
+	bool threaded = thread_count != 1 && pool && !p_space->is_debugging_contacts();
+	int tasks = thread_count > 1 ? thread_count : -1;
+	uint32_t constraint_island_count = 0;
+
+	if (threaded) {
+
+		// Islands share no rigid bodies, so each one can be set up and solved on its own thread.
+		// Constraints that also write outside of their island are set up here first, always in the same order.
+		ConstraintSW *ci = constraint_island_list;
+		while (ci) {
+			constraint_island_count++;
+			ci = ci->get_island_list_next();
+		}
+
+		if ((uint32_t)constraint_islands.size() < constraint_island_count)
+			constraint_islands.resize(constraint_island_count);
+		ConstraintSW **islands = constraint_islands.ptrw();
+
+		ci = constraint_island_list;
+		for (uint32_t i = 0; i < constraint_island_count; i++) {
+			islands[i] = ci;
+			for (ConstraintSW *c = ci; c; c = c->get_island_next()) {
+				if (!c->is_island_local())
+					c->setup(p_delta);
+			}
+			ci = ci->get_island_list_next();
+		}
+
+		ThreadPool::GroupID group = pool->add_template_group_task(this, &StepSW::_setup_island_local, p_delta, constraint_island_count, tasks);
+		pool->wait_for_group(group);
+
+	} else {
 		ConstraintSW *ci = constraint_island_list;
 		while (ci) {
 
@@ -248,7 +296,13 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
+	if (threaded) {
+
+		iterations = p_iterations;
+		ThreadPool::GroupID group = pool->add_template_group_task(this, &StepSW::_solve_island_task, p_delta, constraint_island_count, tasks);
+		pool->wait_for_group(group);
+
+	} else {
 		ConstraintSW *ci = constraint_island_list;
 		while (ci) {
 			//iterating each island separatedly improves cache efficiency
@@ -294,7 +348,15 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 	_step++;
 }
 
+void StepSW::set_thread_count(int p_thread_count) {
+
+	ERR_FAIL_COND(p_thread_count < 0);
+	thread_count = p_thread_count;
+}
+
 StepSW::StepSW() {
 
 	_step = 1;
+	thread_count = 1;
+	iterations = 0;
 }
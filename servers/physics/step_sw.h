@@ -37,12 +37,22 @@ class StepSW {
 
 	uint64_t _step;
 
+	int thread_count;
+	int iterations;
+	Vector<ConstraintSW *> constraint_islands;
+
 	void _populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island);
 	void _setup_island(ConstraintSW *p_island, real_t p_delta);
 	void _solve_island(ConstraintSW *p_island, int p_iterations, real_t p_delta);
 	void _check_suspend(BodySW *p_island, real_t p_delta);
 
+	void _setup_island_local(uint32_t p_island, real_t p_delta);
+	void _solve_island_task(uint32_t p_island, real_t p_delta);
+
 public:
+	void set_thread_count(int p_thread_count);
+	int get_thread_count() const { return thread_count; }
+
 	void step(SpaceSW *p_space, real_t p_delta, int p_iterations);
 	StepSW();
 };
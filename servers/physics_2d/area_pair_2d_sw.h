@@ -42,8 +42,10 @@ class AreaPair2DSW : public Constraint2DSW {
 	int body_shape;
 	int area_shape;
 	bool colliding;
+	bool narrow_phase_result;
 
 public:
+	void narrow_phase(real_t p_step);
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
@@ -58,8 +60,10 @@ class Area2Pair2DSW : public Constraint2DSW {
 	int shape_a;
 	int shape_b;
 	bool colliding;
+	bool narrow_phase_result;
 
 public:
+	void narrow_phase(real_t p_step);
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
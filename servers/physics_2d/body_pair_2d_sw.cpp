@@ -218,17 +218,19 @@ bool BodyPair2DSW::_test_ccd(real_t p_step, Body2DSW *p_A, int p_shape_A, const
 	return true;
 }
 
-bool BodyPair2DSW::setup(real_t p_step) {
+void BodyPair2DSW::narrow_phase(real_t p_step) {
+
+	narrow_phase_result = false;
 
 	//cannot collide
 	if (!A->test_collision_mask(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self()) || (A->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && B->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && A->get_max_contacts_reported() == 0 && B->get_max_contacts_reported() == 0)) {
 		collided = false;
-		return false;
+		return;
 	}
 
 	if (A->is_shape_set_as_disabled(shape_A) || B->is_shape_set_as_disabled(shape_B)) {
 		collided = false;
-		return false;
+		return;
 	}
 
 	//use local A coordinates to avoid numerical issues on collision detection
@@ -236,7 +238,6 @@ bool BodyPair2DSW::setup(real_t p_step) {
 
 	_validate_contacts();
 
-	Vector2 offset_A = A->get_transform().get_origin();
 	Transform2D xform_Au = A->get_transform().untranslated();
 	Transform2D xform_A = xform_Au * A->get_shape_transform(shape_A);
 
@@ -276,12 +277,12 @@ bool BodyPair2DSW::setup(real_t p_step) {
 
 		if (!collided) {
 			oneway_disabled = false;
-			return false;
+			return;
 		}
 	}
 
 	if (oneway_disabled)
-		return false;
+		return;
 
 	//if (!prev_collided) {
 	{
@@ -305,7 +306,7 @@ bool BodyPair2DSW::setup(real_t p_step) {
 			if (!valid) {
 				collided = false;
 				oneway_disabled = true;
-				return false;
+				return;
 			}
 		}
 
@@ -327,11 +328,28 @@ bool BodyPair2DSW::setup(real_t p_step) {
 			if (!valid) {
 				collided = false;
 				oneway_disabled = true;
-				return false;
+				return;
 			}
 		}
 	}
 
+	narrow_phase_result = true;
+}
+
+bool BodyPair2DSW::setup(real_t p_step) {
+
+	if (!narrow_phase_result)
+		return false;
+
+	Vector2 offset_A = A->get_transform().get_origin();
+	Transform2D xform_Au = A->get_transform().untranslated();
+
+	Transform2D xform_Bu = B->get_transform();
+	xform_Bu.elements[2] -= A->get_transform().get_origin();
+
+	Shape2DSW *shape_A_ptr = A->get_shape(shape_A);
+	Shape2DSW *shape_B_ptr = B->get_shape(shape_B);
+
 	real_t max_penetration = space->get_contact_max_allowed_penetration();
 
 	real_t bias = 0.3;
@@ -514,6 +532,7 @@ BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_sh
 	contact_count = 0;
 	collided = false;
 	oneway_disabled = false;
+	narrow_phase_result = false;
 }
 
 BodyPair2DSW::~BodyPair2DSW() {
@@ -78,6 +78,7 @@ class BodyPair2DSW : public Constraint2DSW {
 	int contact_count;
 	bool collided;
 	bool oneway_disabled;
+	bool narrow_phase_result;
 	int cc;
 
 	bool _test_ccd(real_t p_step, Body2DSW *p_A, int p_shape_A, const Transform2D &p_xform_A, Body2DSW *p_B, int p_shape_B, const Transform2D &p_xform_B, bool p_swap_result = false);
@@ -86,6 +87,7 @@ class BodyPair2DSW : public Constraint2DSW {
 	_FORCE_INLINE_ void _contact_added_callback(const Vector2 &p_point_A, const Vector2 &p_point_B);
 
 public:
+	void narrow_phase(real_t p_step);
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
@@ -33,66 +33,227 @@
 
 #define LARGE_ELEMENT_FI 1.01239812
 
-void BroadPhase2DHashGrid::_pair_attempt(Element *p_elem, Element *p_with) {
+void BroadPhase2DHashGrid::IndexTable::init(uint32_t p_capacity) {
+
+	capacity = next_power_of_2(MAX(p_capacity, 16));
+	count = 0;
+	keys = (uint64_t *)memalloc(sizeof(uint64_t) * capacity);
+	values = (uint32_t *)memalloc(sizeof(uint32_t) * capacity);
+	memset(values, 0xFF, sizeof(uint32_t) * capacity); // all INVALID_INDEX
+}
+
+void BroadPhase2DHashGrid::IndexTable::finish() {
+
+	memfree(keys);
+	memfree(values);
+	keys = NULL;
+	values = NULL;
+	capacity = 0;
+	count = 0;
+}
+
+void BroadPhase2DHashGrid::IndexTable::set(uint64_t p_key, uint32_t p_value) {
+
+	if ((count + 1) * 2 > capacity) {
+		//keep load under half, so probe sequences stay short
+		uint64_t *old_keys = keys;
+		uint32_t *old_values = values;
+		uint32_t old_capacity = capacity;
+
+		init(capacity * 2);
+
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_values[i] != INVALID_INDEX)
+				set(old_keys[i], old_values[i]);
+		}
+
+		memfree(old_keys);
+		memfree(old_values);
+	}
+
+	uint32_t mask = capacity - 1;
+	uint32_t pos = hash(p_key) & mask;
+
+	while (values[pos] != INVALID_INDEX) {
+		if (keys[pos] == p_key) {
+			values[pos] = p_value;
+			return;
+		}
+		pos = (pos + 1) & mask;
+	}
+
+	keys[pos] = p_key;
+	values[pos] = p_value;
+	count++;
+}
+
+void BroadPhase2DHashGrid::IndexTable::erase(uint64_t p_key) {
+
+	uint32_t mask = capacity - 1;
+	uint32_t hole = hash(p_key) & mask;
+
+	while (true) {
+		if (values[hole] == INVALID_INDEX)
+			return; //not here
+		if (keys[hole] == p_key)
+			break;
+		hole = (hole + 1) & mask;
+	}
+
+	//shift back the entries of the run that can fill the hole
+	uint32_t pos = (hole + 1) & mask;
+
+	while (values[pos] != INVALID_INDEX) {
+
+		uint32_t home = hash(keys[pos]) & mask;
+		if (((pos - home) & mask) >= ((pos - hole) & mask)) {
+			keys[hole] = keys[pos];
+			values[hole] = values[pos];
+			hole = pos;
+		}
+		pos = (pos + 1) & mask;
+	}
+
+	values[hole] = INVALID_INDEX;
+	count--;
+}
+
+uint32_t BroadPhase2DHashGrid::_find_cell_entry(uint32_t p_bin, const LocalVector<CellEntry> &p_set, bool p_indexed, ID p_id) const {
+
+	if (p_indexed)
+		return entry_table.get(_cell_entry_key(p_bin, p_id));
+
+	for (uint32_t i = 0; i < p_set.size(); i++) {
+		if (p_set[i].element == p_id)
+			return i;
+	}
+	return INVALID_INDEX;
+}
+
+void BroadPhase2DHashGrid::_add_cell_entry(uint32_t p_bin, LocalVector<CellEntry> &p_set, bool &r_indexed, ID p_id) {
+
+	CellEntry ce;
+	ce.element = p_id;
+	ce.rc = 1;
+	p_set.push_back(ce);
+
+	if (r_indexed) {
+		entry_table.set(_cell_entry_key(p_bin, p_id), p_set.size() - 1);
+	} else if (p_set.size() > CELL_INDEX_MIN) {
+		//crowded, stop scanning it
+		for (uint32_t i = 0; i < p_set.size(); i++) {
+			entry_table.set(_cell_entry_key(p_bin, p_set[i].element), i);
+		}
+		r_indexed = true;
+	}
+}
+
+void BroadPhase2DHashGrid::_remove_cell_entry(uint32_t p_bin, LocalVector<CellEntry> &p_set, bool &r_indexed, uint32_t p_entry) {
+
+	if (r_indexed) {
+		entry_table.erase(_cell_entry_key(p_bin, p_set[p_entry].element));
+	}
+
+	p_set.remove_unordered(p_entry);
+
+	if (!r_indexed)
+		return;
 
-	Map<Element *, PairData *>::Element *E = p_elem->paired.find(p_with);
+	if (p_set.size() <= CELL_INDEX_MIN / 2) {
+		//scanning is cheaper again, the gap keeps a set from switching back and forth
+		for (uint32_t i = 0; i < p_set.size(); i++) {
+			entry_table.erase(_cell_entry_key(p_bin, p_set[i].element));
+		}
+		r_indexed = false;
+	} else if (p_entry < p_set.size()) {
+		//the last entry took its place
+		entry_table.set(_cell_entry_key(p_bin, p_set[p_entry].element), p_entry);
+	}
+}
+
+void BroadPhase2DHashGrid::_pair_attempt(Element *p_elem, Element *p_with) {
 
 	ERR_FAIL_COND(p_elem->_static && p_with->_static);
 
-	if (!E) {
+	PairKey pk(p_elem->self, p_with->self);
+	uint32_t idx = pair_table.get(pk.key);
+
+	if (idx == INVALID_INDEX) {
 
-		PairData *pd = memnew(PairData);
-		p_elem->paired[p_with] = pd;
-		p_with->paired[p_elem] = pd;
+		if (free_pair != INVALID_INDEX) {
+			idx = free_pair;
+			free_pair = pair_data[idx].next_free;
+		} else {
+			idx = pair_data.size();
+			pair_data.resize(idx + 1);
+		}
+
+		PairData &pd = pair_data[idx];
+		pd.a = pk.a;
+		pd.b = pk.b;
+		pd.colliding = false;
+		pd.rc = 1;
+		pd.ud = NULL;
+
+		pair_table.set(pk.key, idx);
+		p_elem->pairs.push_back(idx);
+		p_with->pairs.push_back(idx);
 	} else {
-		E->get()->rc++;
+		pair_data[idx].rc++;
 	}
 }
 
 void BroadPhase2DHashGrid::_unpair_attempt(Element *p_elem, Element *p_with) {
 
-	Map<Element *, PairData *>::Element *E = p_elem->paired.find(p_with);
+	PairKey pk(p_elem->self, p_with->self);
+	uint32_t idx = pair_table.get(pk.key);
 
-	ERR_FAIL_COND(!E); //this should really be paired..
+	ERR_FAIL_COND(idx == INVALID_INDEX); //this should really be paired..
 
-	E->get()->rc--;
+	PairData &pd = pair_data[idx];
+	pd.rc--;
 
-	if (E->get()->rc == 0) {
+	if (pd.rc == 0) {
 
-		if (E->get()->colliding) {
+		if (pd.colliding) {
 			//uncollide
 			if (unpair_callback) {
-				unpair_callback(p_elem->owner, p_elem->subindex, p_with->owner, p_with->subindex, E->get()->ud, unpair_userdata);
+				unpair_callback(p_elem->owner, p_elem->subindex, p_with->owner, p_with->subindex, pd.ud, unpair_userdata);
 			}
 		}
 
-		memdelete(E->get());
-		p_elem->paired.erase(E);
-		p_with->paired.erase(p_elem);
+		pair_table.erase(pk.key);
+		p_elem->pairs.erase_unordered(idx);
+		p_with->pairs.erase_unordered(idx);
+		pd.next_free = free_pair;
+		free_pair = idx;
 	}
 }
 
 void BroadPhase2DHashGrid::_check_motion(Element *p_elem) {
 
-	for (Map<Element *, PairData *>::Element *E = p_elem->paired.front(); E; E = E->next()) {
+	for (uint32_t i = 0; i < p_elem->pairs.size(); i++) {
+
+		PairData &pd = pair_data[p_elem->pairs[i]];
+		Element *other = &elements[(pd.a == p_elem->self ? pd.b : pd.a) - 1];
 
-		bool pairing = p_elem->aabb.intersects(E->key()->aabb);
+		bool pairing = p_elem->aabb.intersects(other->aabb);
 
-		if (pairing != E->get()->colliding) {
+		if (pairing != pd.colliding) {
 
 			if (pairing) {
 
 				if (pair_callback) {
-					E->get()->ud = pair_callback(p_elem->owner, p_elem->subindex, E->key()->owner, E->key()->subindex, pair_userdata);
+					pd.ud = pair_callback(p_elem->owner, p_elem->subindex, other->owner, other->subindex, pair_userdata);
 				}
 			} else {
 
 				if (unpair_callback) {
-					unpair_callback(p_elem->owner, p_elem->subindex, E->key()->owner, E->key()->subindex, E->get()->ud, unpair_userdata);
+					unpair_callback(p_elem->owner, p_elem->subindex, other->owner, other->subindex, pd.ud, unpair_userdata);
 				}
 			}
 
-			E->get()->colliding = pairing;
+			pd.colliding = pairing;
 		}
 	}
 }
@@ -102,18 +263,23 @@ void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, boo
 	Vector2 sz = (p_rect.size / cell_size * LARGE_ELEMENT_FI); //use magic number to avoid floating point issues
 	if (sz.width * sz.height > large_object_min_surface) {
 		//large object, do not use grid, must check against all elements
-		for (Map<ID, Element>::Element *E = element_map.front(); E; E = E->next()) {
-			if (E->key() == p_elem->self)
+		for (uint32_t i = 0; i < elements.size(); i++) {
+			Element *e = &elements[i];
+			if (!e->owner)
+				continue; // free slot
+			if (e == p_elem)
 				continue; // do not pair against itself
-			if (E->get().owner == p_elem->owner)
+			if (e->owner == p_elem->owner)
 				continue;
-			if (E->get()._static && p_static)
+			if (e->_static && p_static)
 				continue;
 
-			_pair_attempt(p_elem, &E->get());
+			_pair_attempt(p_elem, e);
 		}
 
-		large_elements[p_elem].inc();
+		if (p_elem->large_rc++ == 0) {
+			large_elements.push_back(p_elem->self);
+		}
 		return;
 	}
 
@@ -128,55 +294,56 @@ void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, boo
 			pk.x = i;
 			pk.y = j;
 
-			uint32_t idx = pk.hash() % hash_table_size;
-			PosBin *pb = hash_table[idx];
-
-			while (pb) {
+			uint32_t bin_idx = cell_table.get(pk.key);
 
-				if (pb->key == pk) {
-					break;
+			if (bin_idx == INVALID_INDEX) {
+				//does not exist, create!
+				if (free_bin != INVALID_INDEX) {
+					bin_idx = free_bin;
+					free_bin = bins[bin_idx].next_free;
+				} else {
+					bin_idx = bins.size();
+					bins.resize(bin_idx + 1);
 				}
-
-				pb = pb->next;
+				bins[bin_idx].key = pk;
+				bins[bin_idx].object_set_indexed = false;
+				bins[bin_idx].static_object_set_indexed = false;
+				cell_table.set(pk.key, bin_idx);
 			}
 
+			PosBin &pb = bins[bin_idx];
+			LocalVector<CellEntry> &set = p_static ? pb.static_object_set : pb.object_set;
+
 			bool entered = false;
 
-			if (!pb) {
-				//does not exist, create!
-				pb = memnew(PosBin);
-				pb->key = pk;
-				pb->next = hash_table[idx];
-				hash_table[idx] = pb;
-			}
+			bool &indexed = p_static ? pb.static_object_set_indexed : pb.object_set_indexed;
 
-			if (p_static) {
-				if (pb->static_object_set[p_elem].inc() == 1) {
-					entered = true;
-				}
+			uint32_t entry = _find_cell_entry(bin_idx, set, indexed, p_elem->self);
+			if (entry != INVALID_INDEX) {
+				set[entry].rc++;
 			} else {
-				if (pb->object_set[p_elem].inc() == 1) {
-
-					entered = true;
-				}
+				_add_cell_entry(bin_idx, set, indexed, p_elem->self);
+				entered = true;
 			}
 
 			if (entered) {
 
-				for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
+				for (uint32_t k = 0; k < pb.object_set.size(); k++) {
 
-					if (E->key()->owner == p_elem->owner)
+					Element *e = &elements[pb.object_set[k].element - 1];
+					if (e->owner == p_elem->owner)
 						continue;
-					_pair_attempt(p_elem, E->key());
+					_pair_attempt(p_elem, e);
 				}
 
 				if (!p_static) {
 
-					for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+					for (uint32_t k = 0; k < pb.static_object_set.size(); k++) {
 
-						if (E->key()->owner == p_elem->owner)
+						Element *e = &elements[pb.static_object_set[k].element - 1];
+						if (e->owner == p_elem->owner)
 							continue;
-						_pair_attempt(p_elem, E->key());
+						_pair_attempt(p_elem, e);
 					}
 				}
 			}
@@ -185,16 +352,17 @@ void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, boo
 
 	//pair separatedly with large elements
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
+	for (uint32_t i = 0; i < large_elements.size(); i++) {
 
-		if (E->key() == p_elem)
+		Element *e = &elements[large_elements[i] - 1];
+		if (e == p_elem)
 			continue; // do not pair against itself
-		if (E->key()->owner == p_elem->owner)
+		if (e->owner == p_elem->owner)
 			continue;
-		if (E->key()->_static && p_static)
+		if (e->_static && p_static)
 			continue;
 
-		_pair_attempt(E->key(), p_elem);
+		_pair_attempt(e, p_elem);
 	}
 }
 
@@ -204,15 +372,15 @@ void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool
 	if (sz.width * sz.height > large_object_min_surface) {
 
 		//unpair all elements, instead of checking all, just check what is already paired, so we at least save from checking static vs static
-		Map<Element *, PairData *>::Element *E = p_elem->paired.front();
-		while (E) {
-			Map<Element *, PairData *>::Element *next = E->next();
-			_unpair_attempt(p_elem, E->key());
-			E = next;
+		//walk backwards, as unpairing swaps the last pair into the removed slot
+		for (int i = int(p_elem->pairs.size()) - 1; i >= 0; i--) {
+
+			const PairData &pd = pair_data[p_elem->pairs[i]];
+			_unpair_attempt(p_elem, &elements[(pd.a == p_elem->self ? pd.b : pd.a) - 1]);
 		}
 
-		if (large_elements[p_elem].dec() == 0) {
-			large_elements.erase(p_elem);
+		if (--p_elem->large_rc == 0) {
+			large_elements.erase_unordered(p_elem->self);
 		}
 		return;
 	}
@@ -228,186 +396,175 @@ void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool
 			pk.x = i;
 			pk.y = j;
 
-			uint32_t idx = pk.hash() % hash_table_size;
-			PosBin *pb = hash_table[idx];
+			uint32_t bin_idx = cell_table.get(pk.key);
 
-			while (pb) {
+			ERR_CONTINUE(bin_idx == INVALID_INDEX); //should exist!!
 
-				if (pb->key == pk) {
-					break;
-				}
-
-				pb = pb->next;
-			}
-
-			ERR_CONTINUE(!pb); //should exist!!
+			PosBin &pb = bins[bin_idx];
+			LocalVector<CellEntry> &set = p_static ? pb.static_object_set : pb.object_set;
 
 			bool exited = false;
 
-			if (p_static) {
-				if (pb->static_object_set[p_elem].dec() == 0) {
+			bool &indexed = p_static ? pb.static_object_set_indexed : pb.object_set_indexed;
 
-					pb->static_object_set.erase(p_elem);
-					exited = true;
-				}
-			} else {
-				if (pb->object_set[p_elem].dec() == 0) {
+			uint32_t entry = _find_cell_entry(bin_idx, set, indexed, p_elem->self);
+			ERR_CONTINUE(entry == INVALID_INDEX);
 
-					pb->object_set.erase(p_elem);
-					exited = true;
-				}
+			if (--set[entry].rc == 0) {
+
+				_remove_cell_entry(bin_idx, set, indexed, entry);
+				exited = true;
 			}
 
 			if (exited) {
 
-				for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
+				for (uint32_t k = 0; k < pb.object_set.size(); k++) {
 
-					if (E->key()->owner == p_elem->owner)
+					Element *e = &elements[pb.object_set[k].element - 1];
+					if (e->owner == p_elem->owner)
 						continue;
-					_unpair_attempt(p_elem, E->key());
+					_unpair_attempt(p_elem, e);
 				}
 
 				if (!p_static) {
 
-					for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+					for (uint32_t k = 0; k < pb.static_object_set.size(); k++) {
 
-						if (E->key()->owner == p_elem->owner)
+						Element *e = &elements[pb.static_object_set[k].element - 1];
+						if (e->owner == p_elem->owner)
 							continue;
-						_unpair_attempt(p_elem, E->key());
+						_unpair_attempt(p_elem, e);
 					}
 				}
 			}
 
-			if (pb->object_set.empty() && pb->static_object_set.empty()) {
-
-				if (hash_table[idx] == pb) {
-					hash_table[idx] = pb->next;
-				} else {
-
-					PosBin *px = hash_table[idx];
-
-					while (px) {
+			if (pb.object_set.empty() && pb.static_object_set.empty()) {
 
-						if (px->next == pb) {
-							px->next = pb->next;
-							break;
-						}
-
-						px = px->next;
-					}
-
-					ERR_CONTINUE(!px);
-				}
-
-				memdelete(pb);
+				//keep the bin storage around for the next cell that gets occupied
+				cell_table.erase(pk.key);
+				pb.next_free = free_bin;
+				free_bin = bin_idx;
 			}
 		}
 	}
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
-		if (E->key() == p_elem)
+	for (uint32_t i = 0; i < large_elements.size(); i++) {
+
+		Element *e = &elements[large_elements[i] - 1];
+		if (e == p_elem)
 			continue; // do not pair against itself
-		if (E->key()->owner == p_elem->owner)
+		if (e->owner == p_elem->owner)
 			continue;
-		if (E->key()->_static && p_static)
+		if (e->_static && p_static)
 			continue;
 
 		//unpair from large elements
-		_unpair_attempt(p_elem, E->key());
+		_unpair_attempt(p_elem, e);
 	}
 }
 
 BroadPhase2DHashGrid::ID BroadPhase2DHashGrid::create(CollisionObject2DSW *p_object, int p_subindex) {
 
-	current++;
+	ERR_FAIL_COND_V(!p_object, 0);
+
+	uint32_t idx;
+	if (free_element != INVALID_INDEX) {
+		idx = free_element;
+		free_element = elements[idx].next_free;
+	} else {
+		idx = elements.size();
+		elements.resize(idx + 1);
+	}
 
-	Element e;
+	Element &e = elements[idx];
 	e.owner = p_object;
 	e._static = false;
 	e.subindex = p_subindex;
-	e.self = current;
+	e.self = idx + 1;
+	e.aabb = Rect2();
 	e.pass = 0;
+	e.large_rc = 0;
 
-	element_map[current] = e;
-	return current;
+	return e.self;
 }
 
 void BroadPhase2DHashGrid::move(ID p_id, const Rect2 &p_aabb) {
 
-	Map<ID, Element>::Element *E = element_map.find(p_id);
-	ERR_FAIL_COND(!E);
+	Element *e = _get_element(p_id);
+	ERR_FAIL_COND(!e);
 
-	Element &e = E->get();
-
-	if (p_aabb == e.aabb)
+	if (p_aabb == e->aabb)
 		return;
 
 	if (p_aabb != Rect2()) {
 
-		_enter_grid(&e, p_aabb, e._static);
+		_enter_grid(e, p_aabb, e->_static);
 	}
 
-	if (e.aabb != Rect2()) {
+	if (e->aabb != Rect2()) {
 
-		_exit_grid(&e, e.aabb, e._static);
+		_exit_grid(e, e->aabb, e->_static);
 	}
 
-	e.aabb = p_aabb;
-
-	_check_motion(&e);
+	e->aabb = p_aabb;
 
-	e.aabb = p_aabb;
+	_check_motion(e);
 }
 void BroadPhase2DHashGrid::set_static(ID p_id, bool p_static) {
 
-	Map<ID, Element>::Element *E = element_map.find(p_id);
-	ERR_FAIL_COND(!E);
+	Element *e = _get_element(p_id);
+	ERR_FAIL_COND(!e);
 
-	Element &e = E->get();
-
-	if (e._static == p_static)
+	if (e->_static == p_static)
 		return;
 
-	if (e.aabb != Rect2())
-		_exit_grid(&e, e.aabb, e._static);
+	if (e->aabb != Rect2())
+		_exit_grid(e, e->aabb, e->_static);
 
-	e._static = p_static;
+	e->_static = p_static;
 
-	if (e.aabb != Rect2()) {
-		_enter_grid(&e, e.aabb, e._static);
-		_check_motion(&e);
+	if (e->aabb != Rect2()) {
+		_enter_grid(e, e->aabb, e->_static);
+		_check_motion(e);
 	}
 }
 void BroadPhase2DHashGrid::remove(ID p_id) {
 
-	Map<ID, Element>::Element *E = element_map.find(p_id);
-	ERR_FAIL_COND(!E);
+	Element *e = _get_element(p_id);
+	ERR_FAIL_COND(!e);
 
-	Element &e = E->get();
+	if (e->aabb != Rect2())
+		_exit_grid(e, e->aabb, e->_static);
 
-	if (e.aabb != Rect2())
-		_exit_grid(&e, e.aabb, e._static);
+	//pairs made by large elements while this one had no aabb are not tracked by the grid, drop them too
+	while (e->pairs.size()) {
+		PairData &pd = pair_data[e->pairs[e->pairs.size() - 1]];
+		pd.rc = 1;
+		_unpair_attempt(e, &elements[(pd.a == e->self ? pd.b : pd.a) - 1]);
+	}
 
-	element_map.erase(p_id);
+	e->owner = NULL;
+	e->next_free = free_element;
+	free_element = p_id - 1;
 }
 
 CollisionObject2DSW *BroadPhase2DHashGrid::get_object(ID p_id) const {
 
-	const Map<ID, Element>::Element *E = element_map.find(p_id);
-	ERR_FAIL_COND_V(!E, NULL);
-	return E->get().owner;
+	const Element *e = _get_element(p_id);
+	ERR_FAIL_COND_V(!e, NULL);
+	return e->owner;
 }
 bool BroadPhase2DHashGrid::is_static(ID p_id) const {
 
-	const Map<ID, Element>::Element *E = element_map.find(p_id);
-	ERR_FAIL_COND_V(!E, false);
-	return E->get()._static;
+	const Element *e = _get_element(p_id);
+	ERR_FAIL_COND_V(!e, false);
+	return e->_static;
 }
 int BroadPhase2DHashGrid::get_subindex(ID p_id) const {
 
-	const Map<ID, Element>::Element *E = element_map.find(p_id);
-	ERR_FAIL_COND_V(!E, -1);
-	return E->get().subindex;
+	const Element *e = _get_element(p_id);
+	ERR_FAIL_COND_V(!e, -1);
+	return e->subindex;
 }
 
 template <bool use_aabb, bool use_segment>
@@ -417,58 +574,54 @@ void BroadPhase2DHashGrid::_cull(const Point2i p_cell, const Rect2 &p_aabb, cons
 	pk.x = p_cell.x;
 	pk.y = p_cell.y;
 
-	uint32_t idx = pk.hash() % hash_table_size;
-	PosBin *pb = hash_table[idx];
-
-	while (pb) {
+	uint32_t bin_idx = cell_table.get(pk.key);
 
-		if (pb->key == pk) {
-			break;
-		}
-
-		pb = pb->next;
-	}
-
-	if (!pb)
+	if (bin_idx == INVALID_INDEX)
 		return;
 
-	for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
+	const PosBin &pb = bins[bin_idx];
+
+	for (uint32_t i = 0; i < pb.object_set.size(); i++) {
 
 		if (index >= p_max_results)
 			break;
-		if (E->key()->pass == pass)
+
+		Element *e = &elements[pb.object_set[i].element - 1];
+		if (e->pass == pass)
 			continue;
 
-		E->key()->pass = pass;
+		e->pass = pass;
 
-		if (use_aabb && !p_aabb.intersects(E->key()->aabb))
+		if (use_aabb && !p_aabb.intersects(e->aabb))
 			continue;
 
-		if (use_segment && !E->key()->aabb.intersects_segment(p_from, p_to))
+		if (use_segment && !e->aabb.intersects_segment(p_from, p_to))
 			continue;
 
-		p_results[index] = E->key()->owner;
-		p_result_indices[index] = E->key()->subindex;
+		p_results[index] = e->owner;
+		p_result_indices[index] = e->subindex;
 		index++;
 	}
 
-	for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+	for (uint32_t i = 0; i < pb.static_object_set.size(); i++) {
 
 		if (index >= p_max_results)
 			break;
-		if (E->key()->pass == pass)
+
+		Element *e = &elements[pb.static_object_set[i].element - 1];
+		if (e->pass == pass)
 			continue;
 
-		if (use_aabb && !p_aabb.intersects(E->key()->aabb)) {
+		if (use_aabb && !p_aabb.intersects(e->aabb)) {
 			continue;
 		}
 
-		if (use_segment && !E->key()->aabb.intersects_segment(p_from, p_to))
+		if (use_segment && !e->aabb.intersects_segment(p_from, p_to))
 			continue;
 
-		E->key()->pass = pass;
-		p_results[index] = E->key()->owner;
-		p_result_indices[index] = E->key()->subindex;
+		e->pass = pass;
+		p_results[index] = e->owner;
+		p_result_indices[index] = e->subindex;
 		index++;
 	}
 }
@@ -548,25 +701,27 @@ int BroadPhase2DHashGrid::cull_segment(const Vector2 &p_from, const Vector2 &p_t
 			break;
 	}
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
+	for (uint32_t i = 0; i < large_elements.size(); i++) {
 
 		if (cullcount >= p_max_results)
 			break;
-		if (E->key()->pass == pass)
+
+		Element *e = &elements[large_elements[i] - 1];
+		if (e->pass == pass)
 			continue;
 
-		E->key()->pass = pass;
+		e->pass = pass;
 
 		/*
-		if (use_aabb && !p_aabb.intersects(E->key()->aabb))
+		if (use_aabb && !p_aabb.intersects(e->aabb))
 			continue;
 		*/
 
-		if (!E->key()->aabb.intersects_segment(p_from, p_to))
+		if (!e->aabb.intersects_segment(p_from, p_to))
 			continue;
 
-		p_results[cullcount] = E->key()->owner;
-		p_result_indices[cullcount] = E->key()->subindex;
+		p_results[cullcount] = e->owner;
+		p_result_indices[cullcount] = e->subindex;
 		cullcount++;
 	}
 
@@ -589,25 +744,27 @@ int BroadPhase2DHashGrid::cull_aabb(const Rect2 &p_aabb, CollisionObject2DSW **p
 		}
 	}
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
+	for (uint32_t i = 0; i < large_elements.size(); i++) {
 
 		if (cullcount >= p_max_results)
 			break;
-		if (E->key()->pass == pass)
+
+		Element *e = &elements[large_elements[i] - 1];
+		if (e->pass == pass)
 			continue;
 
-		E->key()->pass = pass;
+		e->pass = pass;
 
-		if (!p_aabb.intersects(E->key()->aabb))
+		if (!p_aabb.intersects(e->aabb))
 			continue;
 
 		/*
-		if (!E->key()->aabb.intersects_segment(p_from,p_to))
+		if (!e->aabb.intersects_segment(p_from,p_to))
 			continue;
 		*/
 
-		p_results[cullcount] = E->key()->owner;
-		p_result_indices[cullcount] = E->key()->subindex;
+		p_results[cullcount] = e->owner;
+		p_result_indices[cullcount] = e->subindex;
 		cullcount++;
 	}
 	return cullcount;
@@ -634,31 +791,31 @@ BroadPhase2DSW *BroadPhase2DHashGrid::_create() {
 
 BroadPhase2DHashGrid::BroadPhase2DHashGrid() {
 
-	hash_table_size = GLOBAL_DEF("physics/2d/bp_hash_table_size", 4096);
-	hash_table_size = Math::larger_prime(hash_table_size);
-	hash_table = memnew_arr(PosBin *, hash_table_size);
+	//initial amount of cells, the table grows as needed
+	uint32_t hash_table_size = GLOBAL_DEF("physics/2d/bp_hash_table_size", 4096);
+	cell_table.init(hash_table_size);
+	pair_table.init(hash_table_size);
+	entry_table.init(hash_table_size);
 
 	cell_size = GLOBAL_DEF("physics/2d/cell_size", 128);
 	large_object_min_surface = GLOBAL_DEF("physics/2d/large_object_surface_threshold_in_cells", 512);
 
-	for (uint32_t i = 0; i < hash_table_size; i++)
-		hash_table[i] = NULL;
+	free_element = INVALID_INDEX;
+	free_pair = INVALID_INDEX;
+	free_bin = INVALID_INDEX;
 	pass = 1;
 
-	current = 0;
+	pair_callback = NULL;
+	pair_userdata = NULL;
+	unpair_callback = NULL;
+	unpair_userdata = NULL;
 }
 
 BroadPhase2DHashGrid::~BroadPhase2DHashGrid() {
 
-	for (uint32_t i = 0; i < hash_table_size; i++) {
-		while (hash_table[i]) {
-			PosBin *pb = hash_table[i];
-			hash_table[i] = pb->next;
-			memdelete(pb);
-		}
-	}
-
-	memdelete_arr(hash_table);
+	cell_table.finish();
+	pair_table.finish();
+	entry_table.finish();
 }
 
 /* 3D version of voxel traversal:
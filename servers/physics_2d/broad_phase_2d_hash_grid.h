@@ -32,55 +32,87 @@
 #define BROAD_PHASE_2D_HASH_GRID_H
 
 #include "broad_phase_2d_sw.h"
-#include "map.h"
+#include "local_vector.h"
 
 class BroadPhase2DHashGrid : public BroadPhase2DSW {
 
+	enum {
+		INVALID_INDEX = 0xFFFFFFFF,
+		CELL_INDEX_MIN = 16 // cell sets larger than this are indexed instead of scanned
+	};
+
+	/* Open addressing table from 64 bits keys to indices, using linear probing
+	 * and backward shift deletion so no tombstones pile up while bodies keep
+	 * entering and leaving cells. */
+
+	struct IndexTable {
+
+		uint64_t *keys;
+		uint32_t *values;
+		uint32_t capacity; // always a power of two
+		uint32_t count;
+
+		static _FORCE_INLINE_ uint32_t hash(uint64_t p_key) {
+			uint64_t k = p_key;
+			k = (~k) + (k << 18); // k = (k << 18) - k - 1;
+			k = k ^ (k >> 31);
+			k = k * 21; // k = (k + (k << 2)) + (k << 4);
+			k = k ^ (k >> 11);
+			k = k + (k << 6);
+			k = k ^ (k >> 22);
+			return k;
+		}
+
+		_FORCE_INLINE_ uint32_t get(uint64_t p_key) const {
+
+			uint32_t mask = capacity - 1;
+			uint32_t pos = hash(p_key) & mask;
+			while (values[pos] != INVALID_INDEX) {
+				if (keys[pos] == p_key)
+					return values[pos];
+				pos = (pos + 1) & mask;
+			}
+			return INVALID_INDEX;
+		}
+
+		void set(uint64_t p_key, uint32_t p_value);
+		void erase(uint64_t p_key);
+		void init(uint32_t p_capacity);
+		void finish();
+	};
+
 	struct PairData {
 
+		ID a; // IDs of the paired elements
+		ID b;
 		bool colliding;
 		int rc;
 		void *ud;
-		PairData() {
-			colliding = false;
-			rc = 1;
-			ud = NULL;
-		}
+		uint32_t next_free;
 	};
 
 	struct Element {
 
 		ID self;
-		CollisionObject2DSW *owner;
+		CollisionObject2DSW *owner; // NULL while the slot is free
 		bool _static;
 		Rect2 aabb;
 		int subindex;
 		uint64_t pass;
-		Map<Element *, PairData *> paired;
+		int large_rc;
+		LocalVector<uint32_t> pairs; // indices into pair_data
+		uint32_t next_free;
 	};
 
-	struct RC {
+	// IDs handed out are element indices plus one, so 0 stays invalid.
+	LocalVector<Element> elements;
+	uint32_t free_element;
 
-		int ref;
+	LocalVector<uint32_t> large_elements;
 
-		_FORCE_INLINE_ int inc() {
-			ref++;
-			return ref;
-		}
-		_FORCE_INLINE_ int dec() {
-			ref--;
-			return ref;
-		}
-
-		_FORCE_INLINE_ RC() {
-			ref = 0;
-		}
-	};
-
-	Map<ID, Element> element_map;
-	Map<Element *, RC> large_elements;
-
-	ID current;
+	LocalVector<PairData> pair_data;
+	uint32_t free_pair;
+	IndexTable pair_table;
 
 	uint64_t pass;
 
@@ -110,8 +142,6 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 		}
 	};
 
-	Map<PairKey, PairData> pair_map;
-
 	int cell_size;
 	int large_object_min_surface;
 
@@ -135,33 +165,57 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 			uint64_t key;
 		};
 
-		_FORCE_INLINE_ uint32_t hash() const {
-			uint64_t k = key;
-			k = (~k) + (k << 18); // k = (k << 18) - k - 1;
-			k = k ^ (k >> 31);
-			k = k * 21; // k = (k + (k << 2)) + (k << 4);
-			k = k ^ (k >> 11);
-			k = k + (k << 6);
-			k = k ^ (k >> 22);
-			return k;
-		}
-
 		bool operator==(const PosKey &p_key) const { return key == p_key.key; }
 		_FORCE_INLINE_ bool operator<(const PosKey &p_key) const {
 			return key < p_key.key;
 		}
 	};
 
+	struct CellEntry {
+
+		uint32_t element;
+		int rc;
+	};
+
 	struct PosBin {
 
 		PosKey key;
-		Map<Element *, RC> object_set;
-		Map<Element *, RC> static_object_set;
-		PosBin *next;
+		LocalVector<CellEntry> object_set;
+		LocalVector<CellEntry> static_object_set;
+		bool object_set_indexed;
+		bool static_object_set_indexed;
+		uint32_t next_free;
 	};
 
-	uint32_t hash_table_size;
-	PosBin **hash_table;
+	// Bins are recycled through a free list, keeping their storage.
+	LocalVector<PosBin> bins;
+	uint32_t free_bin;
+	IndexTable cell_table;
+
+	// Where each element sits in the crowded sets, so they are not scanned
+	// when entering or leaving them. Small sets are faster to scan.
+	IndexTable entry_table;
+
+	static _FORCE_INLINE_ uint64_t _cell_entry_key(uint32_t p_bin, ID p_id) {
+		return (uint64_t(p_bin) << 32) | p_id;
+	}
+
+	uint32_t _find_cell_entry(uint32_t p_bin, const LocalVector<CellEntry> &p_set, bool p_indexed, ID p_id) const;
+	void _add_cell_entry(uint32_t p_bin, LocalVector<CellEntry> &p_set, bool &r_indexed, ID p_id);
+	void _remove_cell_entry(uint32_t p_bin, LocalVector<CellEntry> &p_set, bool &r_indexed, uint32_t p_entry);
+
+	_FORCE_INLINE_ Element *_get_element(ID p_id) {
+		if (p_id == 0 || p_id > elements.size())
+			return NULL;
+		Element *e = &elements[p_id - 1];
+		return e->owner ? e : NULL;
+	}
+	_FORCE_INLINE_ const Element *_get_element(ID p_id) const {
+		if (p_id == 0 || p_id > elements.size())
+			return NULL;
+		const Element *e = &elements[p_id - 1];
+		return e->owner ? e : NULL;
+	}
 
 	void _pair_attempt(Element *p_elem, Element *p_with);
 	void _unpair_attempt(Element *p_elem, Element *p_with);
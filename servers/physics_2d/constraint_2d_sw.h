@@ -71,6 +71,9 @@ public:
 	_FORCE_INLINE_ void disable_collisions_between_bodies(const bool p_disabled) { disabled_collisions_between_bodies = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled_collisions_between_bodies() const { return disabled_collisions_between_bodies; }
 
+	// Collision detection part of the setup, called before setup() every step, right before it unless threaded.
+	// It must only write to the constraint itself, as it may run on worker threads for many constraints at once.
+	virtual void narrow_phase(real_t p_step) {}
 	virtual bool setup(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
 
@@ -233,8 +233,8 @@ bool Physics2DServerSW::shape_collide(RID p_shape_A, const Transform2D &p_xform_
 
 RID Physics2DServerSW::space_create() {
 
-	Space2DSW *space = memnew(Space2DSW);
-	RID id = space_owner.make_rid(space);
+	RID id = space_owner.make_rid();
+	Space2DSW *space = space_owner.get(id);
 	space->set_self(id);
 	RID area_id = area_create();
 	Area2DSW *area = area_owner.get(area_id);
@@ -315,8 +315,8 @@ Physics2DDirectSpaceState *Physics2DServerSW::space_get_direct_state(RID p_space
 
 RID Physics2DServerSW::area_create() {
 
-	Area2DSW *area = memnew(Area2DSW);
-	RID rid = area_owner.make_rid(area);
+	RID rid = area_owner.make_rid();
+	Area2DSW *area = area_owner.get(rid);
 	area->set_self(rid);
 	return rid;
 };
@@ -557,8 +557,8 @@ void Physics2DServerSW::area_set_area_monitor_callback(RID p_area, Object *p_rec
 
 RID Physics2DServerSW::body_create() {
 
-	Body2DSW *body = memnew(Body2DSW);
-	RID rid = body_owner.make_rid(body);
+	RID rid = body_owner.make_rid();
+	Body2DSW *body = body_owner.get(rid);
 	body->set_self(rid);
 	return rid;
 }
@@ -727,7 +727,7 @@ Physics2DServerSW::CCDMode Physics2DServerSW::body_get_continuous_collision_dete
 	return body->get_continuous_collision_detection_mode();
 }
 
-void Physics2DServerSW::body_attach_object_instance_id(RID p_body, uint32_t p_ID) {
+void Physics2DServerSW::body_attach_object_instance_id(RID p_body, ObjectID p_ID) {
 
 	Body2DSW *body = body_owner.get(p_body);
 	ERR_FAIL_COND(!body);
@@ -735,7 +735,7 @@ void Physics2DServerSW::body_attach_object_instance_id(RID p_body, uint32_t p_ID
 	body->set_instance_id(p_ID);
 };
 
-uint32_t Physics2DServerSW::body_get_object_instance_id(RID p_body) const {
+ObjectID Physics2DServerSW::body_get_object_instance_id(RID p_body) const {
 
 	Body2DSW *body = body_owner.get(p_body);
 	ERR_FAIL_COND_V(!body, 0);
@@ -1167,7 +1167,6 @@ void Physics2DServerSW::free(RID p_rid) {
 		}
 
 		body_owner.free(p_rid);
-		memdelete(body);
 
 	} else if (area_owner.owns(p_rid)) {
 
@@ -1186,7 +1185,6 @@ void Physics2DServerSW::free(RID p_rid) {
 		}
 
 		area_owner.free(p_rid);
-		memdelete(area);
 	} else if (space_owner.owns(p_rid)) {
 
 		Space2DSW *space = space_owner.get(p_rid);
@@ -1199,7 +1197,6 @@ void Physics2DServerSW::free(RID p_rid) {
 		active_spaces.erase(space);
 		free(space->get_default_area()->get_self());
 		space_owner.free(p_rid);
-		memdelete(space);
 	} else if (joint_owner.owns(p_rid)) {
 
 		Joint2DSW *joint = joint_owner.get(p_rid);
@@ -1225,6 +1222,8 @@ void Physics2DServerSW::init() {
 	last_step = 0.001;
 	iterations = 8; // 8?
 	stepper = memnew(Step2DSW);
+	stepper->set_thread_count(GLOBAL_DEF("physics/2d/narrow_phase_thread_count", 1));
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/narrow_phase_thread_count", PropertyInfo(Variant::INT, "physics/2d/narrow_phase_thread_count", PROPERTY_HINT_RANGE, "0,64,1"));
 	direct_state = memnew(Physics2DDirectBodyStateSW);
 };
 
@@ -1240,12 +1239,14 @@ void Physics2DServerSW::step(real_t p_step) {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	narrow_phase_time = 0;
 	for (Set<const Space2DSW *>::Element *E = active_spaces.front(); E; E = E->next()) {
 
 		stepper->step((Space2DSW *)E->get(), p_step, iterations);
 		island_count += E->get()->get_island_count();
 		active_objects += E->get()->get_active_objects();
 		collision_pairs += E->get()->get_collision_pairs();
+		narrow_phase_time += E->get()->get_elapsed_time(Space2DSW::ELAPSED_TIME_NARROW_PHASE);
 	}
 };
 
@@ -1273,6 +1274,7 @@ void Physics2DServerSW::flush_queries() {
 		static const char *time_name[Space2DSW::ELAPSED_TIME_MAX] = {
 			"integrate_forces",
 			"generate_islands",
+			"narrow_phase",
 			"setup_constraints",
 			"solve_constraints",
 			"integrate_velocities"
@@ -1327,6 +1329,11 @@ int Physics2DServerSW::get_process_info(ProcessInfo p_info) {
 
 			return island_count;
 		} break;
+		case INFO_NARROW_PHASE_TIME: {
+
+			return narrow_phase_time;
+		} break;
+		default: {}
 	}
 
 	return 0;
@@ -1344,6 +1351,7 @@ Physics2DServerSW::Physics2DServerSW() {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	narrow_phase_time = 0;
 	using_threads = int(ProjectSettings::get_singleton()->get("physics/2d/thread_model")) == 2;
 };
 
@@ -51,6 +51,7 @@ class Physics2DServerSW : public Physics2DServer {
 	int island_count;
 	int active_objects;
 	int collision_pairs;
+	int narrow_phase_time;
 
 	bool using_threads;
 
@@ -60,9 +61,9 @@ class Physics2DServerSW : public Physics2DServer {
 	Physics2DDirectBodyStateSW *direct_state;
 
 	mutable RID_Owner<Shape2DSW> shape_owner;
-	mutable RID_Owner<Space2DSW> space_owner;
-	mutable RID_Owner<Area2DSW> area_owner;
-	mutable RID_Owner<Body2DSW> body_owner;
+	mutable RID_SlabOwner<Space2DSW> space_owner;
+	mutable RID_SlabOwner<Area2DSW> area_owner;
+	mutable RID_SlabOwner<Body2DSW> body_owner;
 	mutable RID_Owner<Joint2DSW> joint_owner;
 
 	static Physics2DServerSW *singletonsw;
@@ -185,8 +186,8 @@ public:
 	virtual void body_set_shape_disabled(RID p_body, int p_shape_idx, bool p_disabled);
 	virtual void body_set_shape_as_one_way_collision(RID p_body, int p_shape_idx, bool p_enable);
 
-	virtual void body_attach_object_instance_id(RID p_body, uint32_t p_ID);
-	virtual uint32_t body_get_object_instance_id(RID p_body) const;
+	virtual void body_attach_object_instance_id(RID p_body, ObjectID p_ID);
+	virtual ObjectID body_get_object_instance_id(RID p_body) const;
 
 	virtual void body_set_continuous_collision_detection_mode(RID p_body, CCDMode p_mode);
 	virtual CCDMode body_get_continuous_collision_detection_mode(RID p_body) const;
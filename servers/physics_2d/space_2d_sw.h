@@ -64,6 +64,7 @@ public:
 	enum ElapsedTime {
 		ELAPSED_TIME_INTEGRATE_FORCES,
 		ELAPSED_TIME_GENERATE_ISLANDS,
+		ELAPSED_TIME_NARROW_PHASE,
 		ELAPSED_TIME_SETUP_CONSTRAINTS,
 		ELAPSED_TIME_SOLVE_CONSTRAINTS,
 		ELAPSED_TIME_INTEGRATE_VELOCITIES,
@@ -30,6 +30,7 @@
 
 #include "step_2d_sw.h"
 #include "os/os.h"
+#include "os/thread_pool.h"
 
 void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island) {
 
@@ -57,12 +58,14 @@ void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constrain
 	}
 }
 
-bool Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta) {
+bool Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta, bool p_narrow_phase) {
 
 	Constraint2DSW *ci = p_island;
 	Constraint2DSW *prev_ci = NULL;
 	bool removed_root = false;
 	while (ci) {
+		if (p_narrow_phase)
+			ci->narrow_phase(p_delta);
 		bool process = ci->setup(p_delta);
 
 		if (!process) {
@@ -131,6 +134,17 @@ void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
 	}
 }
 
+void Step2DSW::_narrow_phase_batch(uint32_t p_batch, real_t p_delta) {
+
+	uint32_t from = p_batch * NARROW_PHASE_BATCH_SIZE;
+	uint32_t to = MIN(from + NARROW_PHASE_BATCH_SIZE, constraint_count);
+	Constraint2DSW **c = constraints.ptrw();
+
+	for (uint32_t i = from; i < to; i++) {
+		c[i]->narrow_phase(p_delta);
+	}
+}
+
 void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	p_space->lock(); // can't access space during this
@@ -217,6 +231,51 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 		profile_begtime = profile_endtime;
 	}
 
+	/* NARROW PHASE */
+
+	// Without threads each pair detects collisions right before its setup, which warm starts the bodies, as it always did.
+	ThreadPool *pool = ThreadPool::get_singleton();
+	bool threaded = thread_count != 1 && pool;
+
+	if (threaded) {
+		// Collision detection of every pair only writes to the pair itself, so it runs in batches on worker threads.
+		// The contacts found are merged into the bodies afterwards, by setting the islands up on this thread.
+		constraint_count = 0;
+		for (Constraint2DSW *ci = constraint_island_list; ci; ci = ci->get_island_list_next()) {
+			for (Constraint2DSW *c = ci; c; c = c->get_island_next()) {
+				constraint_count++;
+			}
+		}
+
+		if ((uint32_t)constraints.size() < constraint_count)
+			constraints.resize(constraint_count);
+		Constraint2DSW **cptr = constraints.ptrw();
+
+		uint32_t idx = 0;
+		for (Constraint2DSW *ci = constraint_island_list; ci; ci = ci->get_island_list_next()) {
+			for (Constraint2DSW *c = ci; c; c = c->get_island_next()) {
+				cptr[idx++] = c;
+			}
+		}
+
+		uint32_t batch_count = (constraint_count + NARROW_PHASE_BATCH_SIZE - 1) / NARROW_PHASE_BATCH_SIZE;
+
+		if (batch_count > 1) {
+			ThreadPool::GroupID group = pool->add_template_group_task(this, &Step2DSW::_narrow_phase_batch, p_delta, batch_count, thread_count > 1 ? thread_count : -1);
+			pool->wait_for_group(group);
+		} else {
+			for (uint32_t i = 0; i < batch_count; i++) {
+				_narrow_phase_batch(i, p_delta);
+			}
+		}
+	}
+
+	{ //profile
+		profile_endtime = OS::get_singleton()->get_ticks_usec();
+		p_space->set_elapsed_time(Space2DSW::ELAPSED_TIME_NARROW_PHASE, profile_endtime - profile_begtime);
+		profile_begtime = profile_endtime;
+	}
+
 	/* SETUP CONSTRAINT ISLANDS */
 
 	{
@@ -224,7 +283,7 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 		Constraint2DSW *prev_ci = NULL;
 		while (ci) {
 
-			if (_setup_island(ci, p_delta) == true) {
+			if (_setup_island(ci, p_delta, !threaded) == true) {
 
 				//removed the root from the island graph because it is not to be processed
 
@@ -312,7 +371,15 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 	_step++;
 }
 
+void Step2DSW::set_thread_count(int p_thread_count) {
+
+	ERR_FAIL_COND(p_thread_count < 0);
+	thread_count = p_thread_count;
+}
+
 Step2DSW::Step2DSW() {
 
 	_step = 1;
+	thread_count = 1;
+	constraint_count = 0;
 }
@@ -35,14 +35,27 @@
 
 class Step2DSW {
 
+	enum {
+		NARROW_PHASE_BATCH_SIZE = 64
+	};
+
 	uint64_t _step;
 
+	int thread_count;
+	Vector<Constraint2DSW *> constraints;
+	uint32_t constraint_count;
+
 	void _populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island);
-	bool _setup_island(Constraint2DSW *p_island, real_t p_delta);
+	bool _setup_island(Constraint2DSW *p_island, real_t p_delta, bool p_narrow_phase);
 	void _solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta);
 	void _check_suspend(Body2DSW *p_island, real_t p_delta);
 
+	void _narrow_phase_batch(uint32_t p_batch, real_t p_delta);
+
 public:
+	void set_thread_count(int p_thread_count);
+	int get_thread_count() const { return thread_count; }
+
 	void step(Space2DSW *p_space, real_t p_delta, int p_iterations);
 	Step2DSW();
 };
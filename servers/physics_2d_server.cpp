@@ -706,6 +706,7 @@ void Physics2DServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_ACTIVE_OBJECTS);
 	BIND_ENUM_CONSTANT(INFO_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(INFO_ISLAND_COUNT);
+	BIND_ENUM_CONSTANT(INFO_NARROW_PHASE_TIME);
 }
 
 Physics2DServer::Physics2DServer() {
@@ -0,0 +1,75 @@
+/*************************************************************************/
+/*  scenario_index.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef SCENARIO_INDEX_H
+#define SCENARIO_INDEX_H
+
+#include "visual_server_scene.h"
+
+/* Spatial index of the instances in a scenario. Used to cull them and to pair
+ * geometry with the lights, probes and captures that affect it. */
+
+class ScenarioIndex {
+
+public:
+	typedef VisualServerScene::Instance Instance;
+
+	typedef ScenarioIndex *(*CreateFunction)();
+
+	static CreateFunction create_func;
+
+	typedef uint32_t ID;
+
+	typedef void *(*PairCallback)(void *p_userdata, Instance *p_A, Instance *p_B);
+	typedef void (*UnpairCallback)(void *p_userdata, Instance *p_A, Instance *p_B, void *p_pair_data);
+
+	// 0 is an invalid ID
+	virtual ID create(Instance *p_instance, const AABB &p_aabb, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) = 0;
+	virtual void move(ID p_id, const AABB &p_aabb) = 0;
+	virtual void set_pairable(ID p_id, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) = 0;
+	virtual void erase(ID p_id) = 0;
+
+	virtual int cull_convex(const Vector<Plane> &p_convex, Instance **p_results, int p_max_results, uint32_t p_mask = 0xFFFFFFFF) = 0;
+	// Can run from several threads at once, as long as the index is not modified meanwhile.
+	virtual void cull_convex_threadsafe(const Vector<Plane> &p_convex, LocalVector<Instance *> &r_results, uint32_t p_max_results, uint32_t p_mask = 0xFFFFFFFF) const = 0;
+	virtual int cull_aabb(const AABB &p_aabb, Instance **p_results, int p_max_results, uint32_t p_mask = 0xFFFFFFFF) = 0;
+	virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_results, int p_max_results, uint32_t p_mask = 0xFFFFFFFF) = 0;
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) = 0;
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) = 0;
+
+	// Indices may defer pairing moved instances until this is called, unpairing is never deferred.
+	virtual void update() = 0;
+
+	virtual ~ScenarioIndex();
+};
+
+#endif // SCENARIO_INDEX_H
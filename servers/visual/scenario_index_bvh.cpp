@@ -0,0 +1,524 @@
+/*************************************************************************/
+/*  scenario_index_bvh.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "scenario_index_bvh.h"
+#include "project_settings.h"
+
+void ScenarioIndexBVH::_tree_insert(uint32_t p_item, TreeType p_tree) {
+
+	Item &item = items[p_item];
+	item.tree = p_tree;
+	item.refits = 0;
+	item.leaf = trees[p_tree].create(p_tree == TREE_STATIC ? item.aabb : _get_fat_aabb(item.aabb), p_item);
+
+	if (p_tree == TREE_DYNAMIC && !item.in_dynamic_list) {
+		item.in_dynamic_list = true;
+		dynamic_items.push_back(p_item);
+	}
+}
+
+void ScenarioIndexBVH::_tree_remove(uint32_t p_item) {
+
+	Item &item = items[p_item];
+	if (item.tree == TREE_MAX)
+		return;
+
+	trees[item.tree].erase(item.leaf);
+	item.tree = TREE_MAX;
+	item.leaf = INVALID_INDEX;
+}
+
+void ScenarioIndexBVH::_mark_dirty(uint32_t p_item) {
+
+	Item &item = items[p_item];
+	if (item.dirty)
+		return;
+
+	item.dirty = true;
+	dirty_items.push_back(p_item);
+}
+
+uint32_t ScenarioIndexBVH::_find_pair(uint32_t p_A, uint32_t p_B) const {
+
+	// scan the shorter list, a light can pair with a lot of geometry
+	if (items[p_A].pairs.size() > items[p_B].pairs.size()) {
+		SWAP(p_A, p_B);
+	}
+
+	const LocalVector<uint32_t> &pairs = items[p_A].pairs;
+	for (uint32_t i = 0; i < pairs.size(); i++) {
+		const PairData &pd = pair_data[pairs[i]];
+		if (pd.items[0] == p_B || pd.items[1] == p_B)
+			return pairs[i];
+	}
+
+	return INVALID_INDEX;
+}
+
+void ScenarioIndexBVH::_pair(uint32_t p_A, uint32_t p_B) {
+
+	uint32_t idx;
+	if (free_pair != INVALID_INDEX) {
+		idx = free_pair;
+		free_pair = pair_data[idx].next_free;
+	} else {
+		idx = pair_data.size();
+		pair_data.resize(idx + 1);
+	}
+
+	PairData &pd = pair_data[idx];
+	pd.items[0] = p_A;
+	pd.items[1] = p_B;
+	pd.list_pos[0] = items[p_A].pairs.size();
+	pd.list_pos[1] = items[p_B].pairs.size();
+	pd.ud = NULL;
+	pd.pass = pair_pass;
+
+	items[p_A].pairs.push_back(idx);
+	items[p_B].pairs.push_back(idx);
+
+	if (pair_callback) {
+		pd.ud = pair_callback(pair_userdata, items[p_A].instance, items[p_B].instance);
+	}
+}
+
+void ScenarioIndexBVH::_unpair(uint32_t p_pair) {
+
+	PairData &pd = pair_data[p_pair];
+
+	if (unpair_callback) {
+		unpair_callback(unpair_userdata, items[pd.items[0]].instance, items[pd.items[1]].instance, pd.ud);
+	}
+
+	for (int i = 0; i < 2; i++) {
+
+		// move the last pair of the list into the slot of this one
+		LocalVector<uint32_t> &pairs = items[pd.items[i]].pairs;
+		uint32_t pos = pd.list_pos[i];
+		uint32_t last = pairs[pairs.size() - 1];
+
+		PairData &lpd = pair_data[last];
+		lpd.list_pos[lpd.items[0] == pd.items[i] ? 0 : 1] = pos;
+		pairs.remove_unordered(pos);
+	}
+
+	pd.next_free = free_pair;
+	free_pair = p_pair;
+}
+
+void ScenarioIndexBVH::_unpair_all(uint32_t p_item) {
+
+	LocalVector<uint32_t> &pairs = items[p_item].pairs;
+	while (pairs.size()) {
+		_unpair(pairs[pairs.size() - 1]);
+	}
+}
+
+struct ScenarioIndexBVH::_FindPairs {
+
+	ScenarioIndexBVH *self;
+	uint32_t item;
+	AABB aabb;
+
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return p_aabb.intersects_inclusive(aabb); }
+
+	_FORCE_INLINE_ bool operator()(uint32_t p_other) {
+
+		const Item &other = self->items[p_other];
+		if (!_can_pair(&self->items[item], &other) || !other.aabb.intersects_inclusive(aabb))
+			return true;
+
+		uint32_t pair = self->_find_pair(item, p_other);
+		if (pair == INVALID_INDEX) {
+			self->_pair(item, p_other);
+		} else {
+			self->pair_data[pair].pass = self->pair_pass;
+		}
+		return true;
+	}
+};
+
+// Pairs p_item with everything it overlaps now, and unpairs it from everything else.
+void ScenarioIndexBVH::_update_pairs(uint32_t p_item) {
+
+	const Item &item = items[p_item];
+	if (item.tree == TREE_MAX)
+		return;
+
+	pair_pass++;
+
+	_FindPairs find;
+	find.self = this;
+	find.item = p_item;
+	find.aabb = item.aabb;
+
+	// pairs need at least one pairable side, and all of those are in their own tree
+	trees[TREE_PAIRABLE].query(find, find);
+	if (item.pairable) {
+		trees[TREE_STATIC].query(find, find);
+		trees[TREE_DYNAMIC].query(find, find);
+	}
+
+	// walk backwards, as unpairing moves the last pair into the removed slot
+	for (int i = int(item.pairs.size()) - 1; i >= 0; i--) {
+		if (pair_data[item.pairs[i]].pass != pair_pass) {
+			_unpair(item.pairs[i]);
+		}
+	}
+}
+
+ScenarioIndex::ID ScenarioIndexBVH::create(Instance *p_instance, const AABB &p_aabb, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
+
+	ERR_FAIL_COND_V(!p_instance, 0);
+
+	uint32_t idx;
+	if (free_item != INVALID_INDEX) {
+		idx = free_item;
+		free_item = items[idx].next_free;
+	} else {
+		idx = items.size();
+		items.resize(idx + 1);
+		items[idx].dirty = false;
+		items[idx].in_dynamic_list = false;
+	}
+
+	Item &item = items[idx];
+	item.instance = p_instance;
+	item.aabb = p_aabb;
+	item.pairable = p_pairable;
+	item.pairable_type = p_pairable_type;
+	item.pairable_mask = p_pairable_mask;
+	item.tree = TREE_MAX;
+	item.leaf = INVALID_INDEX;
+	item.refits = 0;
+	item.last_move = update_pass;
+
+	// most instances never move, start in the static tree
+	if (!p_aabb.has_no_surface()) {
+		_tree_insert(idx, p_pairable ? TREE_PAIRABLE : TREE_STATIC);
+		_mark_dirty(idx);
+	}
+
+	return idx + 1;
+}
+
+void ScenarioIndexBVH::move(ID p_id, const AABB &p_aabb) {
+
+	Item *item = _get_item(p_id);
+	ERR_FAIL_COND(!item);
+
+	if (item->aabb == p_aabb)
+		return;
+
+	uint32_t idx = p_id - 1;
+	item->aabb = p_aabb;
+
+	if (p_aabb.has_no_surface()) {
+		_unpair_all(idx);
+		_tree_remove(idx);
+		return;
+	}
+
+	if (item->tree == TREE_MAX) {
+
+		_tree_insert(idx, item->pairable ? TREE_PAIRABLE : TREE_DYNAMIC);
+
+	} else if (item->tree == TREE_STATIC) {
+
+		_tree_remove(idx);
+		_tree_insert(idx, TREE_DYNAMIC);
+
+	} else {
+
+		AABBTree &tree = trees[item->tree];
+		AABB fat = tree.get_aabb(item->leaf);
+
+		if (!fat.encloses(p_aabb)) {
+
+			AABB new_fat = _get_fat_aabb(p_aabb);
+
+			// moving a short way only needs the ancestors enlarged, teleports are reinserted
+			if (item->refits < MAX_REFITS && new_fat.intersects(fat)) {
+				tree.refit(item->leaf, new_fat);
+				item->refits++;
+			} else {
+				tree.move(item->leaf, new_fat);
+				item->refits = 0;
+			}
+		}
+	}
+
+	item->last_move = update_pass;
+	_mark_dirty(idx);
+}
+
+void ScenarioIndexBVH::set_pairable(ID p_id, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
+
+	Item *item = _get_item(p_id);
+	ERR_FAIL_COND(!item);
+
+	if (item->pairable == p_pairable && item->pairable_type == p_pairable_type && item->pairable_mask == p_pairable_mask)
+		return;
+
+	uint32_t idx = p_id - 1;
+	bool was_pairable = item->pairable;
+
+	item->pairable = p_pairable;
+	item->pairable_type = p_pairable_type;
+	item->pairable_mask = p_pairable_mask;
+
+	for (int i = int(item->pairs.size()) - 1; i >= 0; i--) {
+
+		const PairData &pd = pair_data[item->pairs[i]];
+		if (!_can_pair(item, &items[pd.items[0] == idx ? pd.items[1] : pd.items[0]])) {
+			_unpair(item->pairs[i]);
+		}
+	}
+
+	if (item->tree == TREE_MAX)
+		return;
+
+	if (was_pairable != p_pairable) {
+		_tree_remove(idx);
+		_tree_insert(idx, p_pairable ? TREE_PAIRABLE : TREE_DYNAMIC);
+		item->last_move = update_pass;
+	}
+
+	_mark_dirty(idx);
+}
+
+void ScenarioIndexBVH::erase(ID p_id) {
+
+	Item *item = _get_item(p_id);
+	ERR_FAIL_COND(!item);
+
+	uint32_t idx = p_id - 1;
+	_unpair_all(idx);
+	_tree_remove(idx);
+
+	// still listed as dirty or dynamic maybe, update() skips it
+	item->instance = NULL;
+	item->next_free = free_item;
+	free_item = idx;
+}
+
+template <class T>
+struct ScenarioIndexBVH::_Cull {
+
+	const T *test;
+	const ScenarioIndexBVH *self;
+	uint32_t mask;
+
+	Instance **results;
+	LocalVector<Instance *> *result_vector;
+	uint32_t max_results;
+	uint32_t count;
+
+	_FORCE_INLINE_ bool operator()(uint32_t p_item) {
+
+		const Item &item = self->items[p_item];
+		if (!(item.pairable_type & mask) || !(*test)(item.aabb))
+			return true;
+
+		if (result_vector) {
+			result_vector->push_back(item.instance);
+		} else {
+			results[count] = item.instance;
+		}
+		return ++count < max_results;
+	}
+
+	void query(const T &p_test) {
+
+		test = &p_test;
+		for (int i = 0; i < TREE_MAX && count < max_results; i++) {
+			self->trees[i].query(p_test, *this);
+		}
+	}
+};
+
+struct _ScenarioBVHCullConvex {
+
+	const Plane *planes;
+	int plane_count;
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return p_aabb.intersects_convex_shape(planes, plane_count); }
+};
+
+struct _ScenarioBVHCullSegment {
+
+	Vector3 from;
+	Vector3 to;
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return p_aabb.intersects_segment(from, to); }
+};
+
+struct _ScenarioBVHCullAABB {
+
+	AABB aabb;
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return p_aabb.intersects_inclusive(aabb); }
+};
+
+template <class T>
+int ScenarioIndexBVH::_cull(const T &p_test, Instance **p_results, int p_max_results, uint32_t p_mask) const {
+
+	if (p_max_results <= 0)
+		return 0;
+
+	_Cull<T> cull;
+	cull.self = this;
+	cull.mask = p_mask;
+	cull.results = p_results;
+	cull.result_vector = NULL;
+	cull.max_results = p_max_results;
+	cull.count = 0;
+	cull.query(p_test);
+
+	return cull.count;
+}
+
+int ScenarioIndexBVH::cull_convex(const Vector<Plane> &p_convex, Instance **p_results, int p_max_results, uint32_t p_mask) {
+
+	if (p_convex.empty())
+		return 0;
+
+	_ScenarioBVHCullConvex test;
+	test.planes = &p_convex[0];
+	test.plane_count = p_convex.size();
+	return _cull(test, p_results, p_max_results, p_mask);
+}
+
+void ScenarioIndexBVH::cull_convex_threadsafe(const Vector<Plane> &p_convex, LocalVector<Instance *> &r_results, uint32_t p_max_results, uint32_t p_mask) const {
+
+	r_results.clear();
+
+	if (p_convex.empty() || p_max_results == 0)
+		return;
+
+	_ScenarioBVHCullConvex test;
+	test.planes = &p_convex[0];
+	test.plane_count = p_convex.size();
+
+	_Cull<_ScenarioBVHCullConvex> cull;
+	cull.self = this;
+	cull.mask = p_mask;
+	cull.results = NULL;
+	cull.result_vector = &r_results;
+	cull.max_results = p_max_results;
+	cull.count = 0;
+	cull.query(test);
+}
+
+int ScenarioIndexBVH::cull_aabb(const AABB &p_aabb, Instance **p_results, int p_max_results, uint32_t p_mask) {
+
+	_ScenarioBVHCullAABB test;
+	test.aabb = p_aabb;
+	return _cull(test, p_results, p_max_results, p_mask);
+}
+
+int ScenarioIndexBVH::cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_results, int p_max_results, uint32_t p_mask) {
+
+	_ScenarioBVHCullSegment test;
+	test.from = p_from;
+	test.to = p_to;
+	return _cull(test, p_results, p_max_results, p_mask);
+}
+
+void ScenarioIndexBVH::set_pair_callback(PairCallback p_pair_callback, void *p_userdata) {
+
+	pair_callback = p_pair_callback;
+	pair_userdata = p_userdata;
+}
+
+void ScenarioIndexBVH::set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) {
+
+	unpair_callback = p_unpair_callback;
+	unpair_userdata = p_userdata;
+}
+
+void ScenarioIndexBVH::update() {
+
+	update_pass++;
+
+	for (uint32_t i = 0; i < dirty_items.size(); i++) {
+
+		uint32_t idx = dirty_items[i];
+		Item &item = items[idx];
+		if (!item.dirty)
+			continue; // listed twice, erased and created again
+
+		item.dirty = false;
+		if (item.instance) {
+			_update_pairs(idx);
+		}
+	}
+
+	dirty_items.clear();
+
+	// dynamic instances that stopped moving go back to tight bounds
+	for (uint32_t i = 0; i < dynamic_items.size();) {
+
+		uint32_t idx = dynamic_items[i];
+		Item &item = items[idx];
+		bool dynamic = item.instance && item.tree == TREE_DYNAMIC;
+
+		if (dynamic && update_pass - item.last_move <= STATIC_UPDATES) {
+			i++;
+			continue;
+		}
+
+		if (dynamic) {
+			_tree_remove(idx);
+			_tree_insert(idx, TREE_STATIC);
+		}
+
+		item.in_dynamic_list = false;
+		dynamic_items.remove_unordered(i);
+	}
+}
+
+ScenarioIndex *ScenarioIndexBVH::_create() {
+
+	return memnew(ScenarioIndexBVH);
+}
+
+ScenarioIndexBVH::ScenarioIndexBVH() {
+
+	free_item = INVALID_INDEX;
+	free_pair = INVALID_INDEX;
+	update_pass = 0;
+	pair_pass = 0;
+
+	margin = GLOBAL_DEF("rendering/quality/spatial_partitioning/bvh_fat_margin", 0.5);
+
+	pair_callback = NULL;
+	pair_userdata = NULL;
+	unpair_callback = NULL;
+	unpair_userdata = NULL;
+}
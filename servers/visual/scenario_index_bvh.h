@@ -0,0 +1,163 @@
+/*************************************************************************/
+/*  scenario_index_bvh.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef SCENARIO_INDEX_BVH_H
+#define SCENARIO_INDEX_BVH_H
+
+#include "aabb_tree.h"
+#include "scenario_index.h"
+
+/* Dynamic AABB trees, one per kind of instance:
+ *
+ * - Static: instances that have not moved for a while, with tight bounds.
+ * - Dynamic: moving instances, with fat bounds. Moving inside them costs
+ *   nothing, leaving them refits the ancestors for short displacements and
+ *   reinserts the leaf otherwise.
+ * - Pairable: lights, probes and captures, with fat bounds. Kept apart so that
+ *   moving geometry only has to look for pairs in this small tree.
+ *
+ * Moved instances are only checked for pairs in update(), once per batch of
+ * moves. Unpairing because of erase() or set_pairable() happens right away. */
+
+class ScenarioIndexBVH : public ScenarioIndex {
+
+	enum {
+		INVALID_INDEX = 0xFFFFFFFF,
+		MAX_REFITS = 8, // reinsert after this many refits in a row, to keep the tree in shape
+		STATIC_UPDATES = 60 // dynamic instances not moved during this many updates become static
+	};
+
+	enum TreeType {
+		TREE_STATIC,
+		TREE_DYNAMIC,
+		TREE_PAIRABLE,
+		TREE_MAX // not in any tree, the AABB has no surface
+	};
+
+	struct Item {
+
+		Instance *instance; // NULL while the slot is free
+		AABB aabb;
+		bool pairable;
+		uint32_t pairable_type;
+		uint32_t pairable_mask;
+		TreeType tree;
+		uint32_t leaf;
+		uint32_t refits;
+		uint64_t last_move;
+		LocalVector<uint32_t> pairs; // indices into pair_data
+		bool dirty; // in dirty_items, may outlive the instance
+		bool in_dynamic_list; // in dynamic_items, may outlive the instance
+		uint32_t next_free;
+	};
+
+	struct PairData {
+
+		uint32_t items[2];
+		uint32_t list_pos[2]; // position in the pair list of each item
+		void *ud;
+		uint64_t pass;
+		uint32_t next_free;
+	};
+
+	// IDs handed out are item indices plus one, so 0 stays invalid.
+	LocalVector<Item> items;
+	uint32_t free_item;
+
+	LocalVector<PairData> pair_data;
+	uint32_t free_pair;
+
+	AABBTree trees[TREE_MAX];
+
+	LocalVector<uint32_t> dirty_items;
+	LocalVector<uint32_t> dynamic_items;
+
+	uint64_t update_pass;
+	uint64_t pair_pass;
+	real_t margin;
+
+	PairCallback pair_callback;
+	void *pair_userdata;
+	UnpairCallback unpair_callback;
+	void *unpair_userdata;
+
+	_FORCE_INLINE_ Item *_get_item(ID p_id) {
+		if (p_id == 0 || p_id > items.size())
+			return NULL;
+		Item *item = &items[p_id - 1];
+		return item->instance ? item : NULL;
+	}
+
+	_FORCE_INLINE_ static bool _can_pair(const Item *p_A, const Item *p_B) {
+		return p_A != p_B && p_A->instance != p_B->instance && (p_A->pairable || p_B->pairable) &&
+				((p_A->pairable_type & p_B->pairable_mask) || (p_B->pairable_type & p_A->pairable_mask));
+	}
+
+	_FORCE_INLINE_ AABB _get_fat_aabb(const AABB &p_aabb) const { return p_aabb.grow(margin); }
+
+	void _tree_insert(uint32_t p_item, TreeType p_tree);
+	void _tree_remove(uint32_t p_item);
+	void _mark_dirty(uint32_t p_item);
+
+	struct _FindPairs;
+	template <class T>
+	struct _Cull;
+
+	uint32_t _find_pair(uint32_t p_A, uint32_t p_B) const;
+	void _pair(uint32_t p_A, uint32_t p_B);
+	void _unpair(uint32_t p_pair);
+	void _unpair_all(uint32_t p_item);
+	void _update_pairs(uint32_t p_item);
+
+	template <class T>
+	int _cull(const T &p_test, Instance **p_results, int p_max_results, uint32_t p_mask) const;
+
+public:
+	virtual ID create(Instance *p_instance, const AABB &p_aabb, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask);
+	virtual void move(ID p_id, const AABB &p_aabb);
+	virtual void set_pairable(ID p_id, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask);
+	virtual void erase(ID p_id);
+
+	virtual int cull_convex(const Vector<Plane> &p_convex, Instance **p_results, int p_max_results, uint32_t p_mask = 0xFFFFFFFF);
+	virtual void cull_convex_threadsafe(const Vector<Plane> &p_convex, LocalVector<Instance *> &r_results, uint32_t p_max_results, uint32_t p_mask = 0xFFFFFFFF) const;
+	virtual int cull_aabb(const AABB &p_aabb, Instance **p_results, int p_max_results, uint32_t p_mask = 0xFFFFFFFF);
+	virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_results, int p_max_results, uint32_t p_mask = 0xFFFFFFFF);
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata);
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata);
+
+	virtual void update();
+
+	static ScenarioIndex *_create();
+	ScenarioIndexBVH();
+};
+
+#endif // SCENARIO_INDEX_BVH_H
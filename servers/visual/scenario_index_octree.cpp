@@ -0,0 +1,121 @@
+/*************************************************************************/
+/*  scenario_index_octree.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "scenario_index_octree.h"
+
+ScenarioIndex::ID ScenarioIndexOctree::create(Instance *p_instance, const AABB &p_aabb, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
+
+	return octree.create(p_instance, p_aabb, 0, p_pairable, p_pairable_type, p_pairable_mask);
+}
+
+void ScenarioIndexOctree::move(ID p_id, const AABB &p_aabb) {
+
+	octree.move(p_id, p_aabb);
+}
+
+void ScenarioIndexOctree::set_pairable(ID p_id, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
+
+	octree.set_pairable(p_id, p_pairable, p_pairable_type, p_pairable_mask);
+}
+
+void ScenarioIndexOctree::erase(ID p_id) {
+
+	octree.erase(p_id);
+}
+
+int ScenarioIndexOctree::cull_convex(const Vector<Plane> &p_convex, Instance **p_results, int p_max_results, uint32_t p_mask) {
+
+	return octree.cull_convex(p_convex, p_results, p_max_results, p_mask);
+}
+
+void ScenarioIndexOctree::cull_convex_threadsafe(const Vector<Plane> &p_convex, LocalVector<Instance *> &r_results, uint32_t p_max_results, uint32_t p_mask) const {
+
+	octree.cull_convex_threadsafe(p_convex, r_results, p_max_results, p_mask);
+}
+
+int ScenarioIndexOctree::cull_aabb(const AABB &p_aabb, Instance **p_results, int p_max_results, uint32_t p_mask) {
+
+	return octree.cull_aabb(p_aabb, p_results, p_max_results, NULL, p_mask);
+}
+
+int ScenarioIndexOctree::cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_results, int p_max_results, uint32_t p_mask) {
+
+	return octree.cull_segment(p_from, p_to, p_results, p_max_results, NULL, p_mask);
+}
+
+void *ScenarioIndexOctree::_pair_callback(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int) {
+
+	ScenarioIndexOctree *self = (ScenarioIndexOctree *)p_self;
+	if (!self->pair_callback)
+		return NULL;
+
+	return self->pair_callback(self->pair_userdata, p_A, p_B);
+}
+
+void ScenarioIndexOctree::_unpair_callback(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int, void *p_pair_data) {
+
+	ScenarioIndexOctree *self = (ScenarioIndexOctree *)p_self;
+	if (!self->unpair_callback)
+		return;
+
+	self->unpair_callback(self->unpair_userdata, p_A, p_B, p_pair_data);
+}
+
+void ScenarioIndexOctree::set_pair_callback(PairCallback p_pair_callback, void *p_userdata) {
+
+	pair_callback = p_pair_callback;
+	pair_userdata = p_userdata;
+}
+
+void ScenarioIndexOctree::set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) {
+
+	unpair_callback = p_unpair_callback;
+	unpair_userdata = p_userdata;
+}
+
+void ScenarioIndexOctree::update() {
+	// pairs are reported as soon as instances move
+}
+
+ScenarioIndex *ScenarioIndexOctree::_create() {
+
+	return memnew(ScenarioIndexOctree);
+}
+
+ScenarioIndexOctree::ScenarioIndexOctree() {
+
+	octree.set_pair_callback(_pair_callback, this);
+	octree.set_unpair_callback(_unpair_callback, this);
+	pair_callback = NULL;
+	pair_userdata = NULL;
+	unpair_callback = NULL;
+	unpair_userdata = NULL;
+}
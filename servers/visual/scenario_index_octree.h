@@ -0,0 +1,70 @@
+/*************************************************************************/
+/*  scenario_index_octree.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef SCENARIO_INDEX_OCTREE_H
+#define SCENARIO_INDEX_OCTREE_H
+
+#include "octree.h"
+#include "scenario_index.h"
+
+class ScenarioIndexOctree : public ScenarioIndex {
+
+	Octree<Instance, true> octree;
+
+	static void *_pair_callback(void *, OctreeElementID, Instance *, int, OctreeElementID, Instance *, int);
+	static void _unpair_callback(void *, OctreeElementID, Instance *, int, OctreeElementID, Instance *, int, void *);
+
+	PairCallback pair_callback;
+	void *pair_userdata;
+	UnpairCallback unpair_callback;
+	void *unpair_userdata;
+
+public:
+	virtual ID create(Instance *p_instance, const AABB &p_aabb, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask);
+	virtual void move(ID p_id, const AABB &p_aabb);
+	virtual void set_pairable(ID p_id, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask);
+	virtual void erase(ID p_id);
+
+	virtual int cull_convex(const Vector<Plane> &p_convex, Instance **p_results, int p_max_results, uint32_t p_mask = 0xFFFFFFFF);
+	virtual void cull_convex_threadsafe(const Vector<Plane> &p_convex, LocalVector<Instance *> &r_results, uint32_t p_max_results, uint32_t p_mask = 0xFFFFFFFF) const;
+	virtual int cull_aabb(const AABB &p_aabb, Instance **p_results, int p_max_results, uint32_t p_mask = 0xFFFFFFFF);
+	virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_results, int p_max_results, uint32_t p_mask = 0xFFFFFFFF);
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata);
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata);
+
+	virtual void update();
+
+	static ScenarioIndex *_create();
+	ScenarioIndexOctree();
+};
+
+#endif // SCENARIO_INDEX_OCTREE_H
@@ -247,11 +247,7 @@ void VisualServerCanvas::render_canvas(Canvas *p_canvas, const Transform2D &p_tr
 
 RID VisualServerCanvas::canvas_create() {
 
-	Canvas *canvas = memnew(Canvas);
-	ERR_FAIL_COND_V(!canvas, RID());
-	RID rid = canvas_owner.make_rid(canvas);
-
-	return rid;
+	return canvas_owner.make_rid();
 }
 
 void VisualServerCanvas::canvas_set_item_mirroring(RID p_canvas, RID p_item, const Point2 &p_mirroring) {
@@ -274,10 +270,7 @@ void VisualServerCanvas::canvas_set_modulate(RID p_canvas, const Color &p_color)
 
 RID VisualServerCanvas::canvas_item_create() {
 
-	Item *canvas_item = memnew(Item);
-	ERR_FAIL_COND_V(!canvas_item, RID());
-
-	return canvas_item_owner.make_rid(canvas_item);
+	return canvas_item_owner.make_rid();
 }
 
 void VisualServerCanvas::canvas_item_set_parent(RID p_item, RID p_parent) {
@@ -901,9 +894,10 @@ void VisualServerCanvas::canvas_item_set_use_parent_material(RID p_item, bool p_
 
 RID VisualServerCanvas::canvas_light_create() {
 
-	RasterizerCanvas::Light *clight = memnew(RasterizerCanvas::Light);
+	RID rid = canvas_light_owner.make_rid();
+	RasterizerCanvas::Light *clight = canvas_light_owner.get(rid);
 	clight->light_internal = VSG::canvas_render->light_internal_create();
-	return canvas_light_owner.make_rid(clight);
+	return rid;
 }
 void VisualServerCanvas::canvas_light_attach_to_canvas(RID p_light, RID p_canvas) {
 
@@ -1088,9 +1082,7 @@ void VisualServerCanvas::canvas_light_set_shadow_smooth(RID p_light, float p_smo
 
 RID VisualServerCanvas::canvas_light_occluder_create() {
 
-	RasterizerCanvas::LightOccluderInstance *occluder = memnew(RasterizerCanvas::LightOccluderInstance);
-
-	return canvas_light_occluder_owner.make_rid(occluder);
+	return canvas_light_occluder_owner.make_rid();
 }
 void VisualServerCanvas::canvas_light_occluder_attach_to_canvas(RID p_occluder, RID p_canvas) {
 
@@ -1166,9 +1158,10 @@ void VisualServerCanvas::canvas_light_occluder_set_light_mask(RID p_occluder, in
 
 RID VisualServerCanvas::canvas_occluder_polygon_create() {
 
-	LightOccluderPolygon *occluder_poly = memnew(LightOccluderPolygon);
+	RID rid = canvas_light_occluder_polygon_owner.make_rid();
+	LightOccluderPolygon *occluder_poly = canvas_light_occluder_polygon_owner.get(rid);
 	occluder_poly->occluder = VSG::storage->canvas_light_occluder_create();
-	return canvas_light_occluder_polygon_owner.make_rid(occluder_poly);
+	return rid;
 }
 void VisualServerCanvas::canvas_occluder_polygon_set_shape(RID p_occluder_polygon, const PoolVector<Vector2> &p_shape, bool p_closed) {
 
@@ -1270,8 +1263,6 @@ bool VisualServerCanvas::free(RID p_rid) {
 
 		canvas_owner.free(p_rid);
 
-		memdelete(canvas);
-
 	} else if (canvas_item_owner.owns(p_rid)) {
 
 		Item *canvas_item = canvas_item_owner.get(p_rid);
@@ -1303,8 +1294,6 @@ bool VisualServerCanvas::free(RID p_rid) {
 
 		canvas_item_owner.free(p_rid);
 
-		memdelete(canvas_item);
-
 	} else if (canvas_light_owner.owns(p_rid)) {
 
 		RasterizerCanvas::Light *canvas_light = canvas_light_owner.get(p_rid);
@@ -1322,7 +1311,6 @@ bool VisualServerCanvas::free(RID p_rid) {
 		VSG::canvas_render->light_internal_free(canvas_light->light_internal);
 
 		canvas_light_owner.free(p_rid);
-		memdelete(canvas_light);
 
 	} else if (canvas_light_occluder_owner.owns(p_rid)) {
 
@@ -1344,7 +1332,6 @@ bool VisualServerCanvas::free(RID p_rid) {
 		}
 
 		canvas_light_occluder_owner.free(p_rid);
-		memdelete(occluder);
 
 	} else if (canvas_light_occluder_polygon_owner.owns(p_rid)) {
 
@@ -1359,7 +1346,6 @@ bool VisualServerCanvas::free(RID p_rid) {
 		}
 
 		canvas_light_occluder_polygon_owner.free(p_rid);
-		memdelete(occluder_poly);
 	} else {
 		return false;
 	}
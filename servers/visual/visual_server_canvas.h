@@ -99,9 +99,9 @@ public:
 		}
 	};
 
-	RID_Owner<LightOccluderPolygon> canvas_light_occluder_polygon_owner;
+	RID_SlabOwner<LightOccluderPolygon> canvas_light_occluder_polygon_owner;
 
-	RID_Owner<RasterizerCanvas::LightOccluderInstance> canvas_light_occluder_owner;
+	RID_SlabOwner<RasterizerCanvas::LightOccluderInstance> canvas_light_occluder_owner;
 
 	struct Canvas : public VisualServerViewport::CanvasBase {
 
@@ -142,9 +142,9 @@ public:
 		}
 	};
 
-	RID_Owner<Canvas> canvas_owner;
-	RID_Owner<Item> canvas_item_owner;
-	RID_Owner<RasterizerCanvas::Light> canvas_light_owner;
+	RID_SlabOwner<Canvas> canvas_owner;
+	RID_SlabOwner<Item> canvas_item_owner;
+	RID_SlabOwner<RasterizerCanvas::Light> canvas_light_owner;
 
 private:
 	void _render_canvas_item_tree(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights);
@@ -30,14 +30,17 @@
 
 #include "visual_server_scene.h"
 #include "os/os.h"
+#include "os/thread_pool.h"
+#include "project_settings.h"
+#include "scenario_index_bvh.h"
+#include "scenario_index_octree.h"
 #include "visual_server_global.h"
 #include "visual_server_raster.h"
 /* CAMERA API */
 
 RID VisualServerScene::camera_create() {
 
-	Camera *camera = memnew(Camera);
-	return camera_owner.make_rid(camera);
+	return camera_owner.make_rid();
 }
 
 void VisualServerScene::camera_set_perspective(RID p_camera, float p_fovy_degrees, float p_z_near, float p_z_far) {
@@ -91,7 +94,7 @@ void VisualServerScene::camera_set_use_vertical_aspect(RID p_camera, bool p_enab
 
 /* SCENARIO API */
 
-void *VisualServerScene::_instance_pair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int) {
+void *VisualServerScene::_instance_pair(void *p_self, Instance *p_A, Instance *p_B) {
 
 	//VisualServerScene *self = (VisualServerScene*)p_self;
 	Instance *A = p_A;
@@ -170,7 +173,7 @@ void *VisualServerScene::_instance_pair(void *p_self, OctreeElementID, Instance
 
 	return NULL;
 }
-void VisualServerScene::_instance_unpair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int, void *udata) {
+void VisualServerScene::_instance_unpair(void *p_self, Instance *p_A, Instance *p_B, void *udata) {
 
 	//VisualServerScene *self = (VisualServerScene*)p_self;
 	Instance *A = p_A;
@@ -241,13 +244,13 @@ void VisualServerScene::_instance_unpair(void *p_self, OctreeElementID, Instance
 
 RID VisualServerScene::scenario_create() {
 
-	Scenario *scenario = memnew(Scenario);
-	ERR_FAIL_COND_V(!scenario, RID());
-	RID scenario_rid = scenario_owner.make_rid(scenario);
+	RID scenario_rid = scenario_owner.make_rid();
+	Scenario *scenario = scenario_owner.get(scenario_rid);
 	scenario->self = scenario_rid;
 
-	scenario->octree.set_pair_callback(_instance_pair, this);
-	scenario->octree.set_unpair_callback(_instance_unpair, this);
+	scenario->index = ScenarioIndex::create_func();
+	scenario->index->set_pair_callback(_instance_pair, this);
+	scenario->index->set_unpair_callback(_instance_unpair, this);
 	scenario->reflection_probe_shadow_atlas = VSG::scene_render->shadow_atlas_create();
 	VSG::scene_render->shadow_atlas_set_size(scenario->reflection_probe_shadow_atlas, 1024); //make enough shadows for close distance, don't bother with rest
 	VSG::scene_render->shadow_atlas_set_quadrant_subdivision(scenario->reflection_probe_shadow_atlas, 0, 4);
@@ -259,6 +262,14 @@ RID VisualServerScene::scenario_create() {
 	return scenario_rid;
 }
 
+void VisualServerScene::_scenario_queue_update(Scenario *p_scenario) {
+
+	if (p_scenario->update_item.in_list())
+		return;
+
+	_scenario_update_list.add(&p_scenario->update_item);
+}
+
 void VisualServerScene::scenario_set_debug(RID p_scenario, VS::ScenarioDebugMode p_debug_mode) {
 
 	Scenario *scenario = scenario_owner.get(p_scenario);
@@ -306,10 +317,8 @@ void VisualServerScene::_instance_queue_update(Instance *p_instance, bool p_upda
 // from can be mesh, light,  area and portal so far.
 RID VisualServerScene::instance_create() {
 
-	Instance *instance = memnew(Instance);
-	ERR_FAIL_COND_V(!instance, RID());
-
-	RID instance_rid = instance_owner.make_rid(instance);
+	RID instance_rid = instance_owner.make_rid();
+	Instance *instance = instance_owner.get(instance_rid);
 	instance->self = instance_rid;
 
 	return instance_rid;
@@ -344,9 +353,9 @@ void VisualServerScene::instance_set_base(RID p_instance, RID p_base) {
 			}
 		}
 
-		if (scenario && instance->octree_id) {
-			scenario->octree.erase(instance->octree_id); //make dependencies generated by the octree go away
-			instance->octree_id = 0;
+		if (scenario && instance->index_id) {
+			scenario->index->erase(instance->index_id); //make dependencies generated by the index go away
+			instance->index_id = 0;
 		}
 
 		switch (instance->base_type) {
@@ -490,9 +499,9 @@ void VisualServerScene::instance_set_scenario(RID p_instance, RID p_scenario) {
 
 		instance->scenario->instances.remove(&instance->scenario_item);
 
-		if (instance->octree_id) {
-			instance->scenario->octree.erase(instance->octree_id); //make dependencies generated by the octree go away
-			instance->octree_id = 0;
+		if (instance->index_id) {
+			instance->scenario->index->erase(instance->index_id); //make dependencies generated by the index go away
+			instance->index_id = 0;
 		}
 
 		switch (instance->base_type) {
@@ -626,26 +635,30 @@ void VisualServerScene::instance_set_visible(RID p_instance, bool p_visible) {
 
 	switch (instance->base_type) {
 		case VS::INSTANCE_LIGHT: {
-			if (VSG::storage->light_get_type(instance->base) != VS::LIGHT_DIRECTIONAL && instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_LIGHT, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
+			if (VSG::storage->light_get_type(instance->base) != VS::LIGHT_DIRECTIONAL && instance->index_id && instance->scenario) {
+				instance->scenario->index->set_pairable(instance->index_id, p_visible, 1 << VS::INSTANCE_LIGHT, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
+				_scenario_queue_update(instance->scenario);
 			}
 
 		} break;
 		case VS::INSTANCE_REFLECTION_PROBE: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_REFLECTION_PROBE, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
+			if (instance->index_id && instance->scenario) {
+				instance->scenario->index->set_pairable(instance->index_id, p_visible, 1 << VS::INSTANCE_REFLECTION_PROBE, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
+				_scenario_queue_update(instance->scenario);
 			}
 
 		} break;
 		case VS::INSTANCE_LIGHTMAP_CAPTURE: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_LIGHTMAP_CAPTURE, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
+			if (instance->index_id && instance->scenario) {
+				instance->scenario->index->set_pairable(instance->index_id, p_visible, 1 << VS::INSTANCE_LIGHTMAP_CAPTURE, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
+				_scenario_queue_update(instance->scenario);
 			}
 
 		} break;
 		case VS::INSTANCE_GI_PROBE: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_GI_PROBE, p_visible ? (VS::INSTANCE_GEOMETRY_MASK | (1 << VS::INSTANCE_LIGHT)) : 0);
+			if (instance->index_id && instance->scenario) {
+				instance->scenario->index->set_pairable(instance->index_id, p_visible, 1 << VS::INSTANCE_GI_PROBE, p_visible ? (VS::INSTANCE_GEOMETRY_MASK | (1 << VS::INSTANCE_LIGHT)) : 0);
+				_scenario_queue_update(instance->scenario);
 			}
 
 		} break;
@@ -747,7 +760,7 @@ Vector<ObjectID> VisualServerScene::instances_cull_aabb(const AABB &p_aabb, RID
 
 	int culled = 0;
 	Instance *cull[1024];
-	culled = scenario->octree.cull_aabb(p_aabb, cull, 1024);
+	culled = scenario->index->cull_aabb(p_aabb, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 
@@ -770,7 +783,7 @@ Vector<ObjectID> VisualServerScene::instances_cull_ray(const Vector3 &p_from, co
 
 	int culled = 0;
 	Instance *cull[1024];
-	culled = scenario->octree.cull_segment(p_from, p_from + p_to * 10000, cull, 1024);
+	culled = scenario->index->cull_segment(p_from, p_from + p_to * 10000, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 		Instance *instance = cull[i];
@@ -793,7 +806,7 @@ Vector<ObjectID> VisualServerScene::instances_cull_convex(const Vector<Plane> &p
 	int culled = 0;
 	Instance *cull[1024];
 
-	culled = scenario->octree.cull_convex(p_convex, cull, 1024);
+	culled = scenario->index->cull_convex(p_convex, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 
@@ -915,7 +928,7 @@ void VisualServerScene::_update_instance(Instance *p_instance) {
 		return;
 	}
 
-	if (p_instance->octree_id == 0) {
+	if (p_instance->index_id == 0) {
 
 		uint32_t base_type = 1 << p_instance->base_type;
 		uint32_t pairable_mask = 0;
@@ -933,8 +946,8 @@ void VisualServerScene::_update_instance(Instance *p_instance) {
 			pairable = true;
 		}
 
-		// not inside octree
-		p_instance->octree_id = p_instance->scenario->octree.create(p_instance, new_aabb, 0, pairable, base_type, pairable_mask);
+		// not inside the index
+		p_instance->index_id = p_instance->scenario->index->create(p_instance, new_aabb, pairable, base_type, pairable_mask);
 
 	} else {
 
@@ -943,8 +956,10 @@ void VisualServerScene::_update_instance(Instance *p_instance) {
 			return;
 		*/
 
-		p_instance->scenario->octree.move(p_instance->octree_id, new_aabb);
+		p_instance->scenario->index->move(p_instance->index_id, new_aabb);
 	}
+
+	_scenario_queue_update(p_instance->scenario);
 }
 
 void VisualServerScene::_update_instance_aabb(Instance *p_instance) {
@@ -1253,9 +1268,45 @@ void VisualServerScene::_update_instance_lightmap_captures(Instance *p_instance)
 	}
 }
 
-void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario) {
+VisualServerScene::ShadowCullJob *VisualServerScene::_add_shadow_cull_job(Instance *p_light) {
+
+	if (shadow_cull_job_count == shadow_cull_jobs.size()) {
+		shadow_cull_jobs.resize(shadow_cull_job_count + 1);
+	}
+
+	ShadowCullJob *job = &shadow_cull_jobs[shadow_cull_job_count++];
+	job->light = p_light;
+	job->directional_texture_size = 0;
+	job->pass_count = 0;
+	job->restore_transform = false;
+
+	return job;
+}
+
+static _FORCE_INLINE_ bool _is_shadow_caster(const VisualServerScene::Instance *p_instance) {
+
+	return p_instance->visible && ((1 << p_instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) && static_cast<VisualServerScene::InstanceGeometryData *>(p_instance->base_data)->can_cast_shadows;
+}
+
+static void _remove_non_shadow_casters(LocalVector<VisualServerScene::Instance *> &r_instances) {
+
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < r_instances.size(); i++) {
+		if (_is_shadow_caster(r_instances[i])) {
+			r_instances[count++] = r_instances[i];
+		}
+	}
+	r_instances.resize(count);
+}
+
+void VisualServerScene::_light_instance_cull_shadow(ShadowCullJob *p_job, const CullData *p_data) {
 
-	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
+	// Runs on the worker threads: it may only read the scenario and the light parameters.
+	Instance *p_instance = p_job->light;
+	Scenario *p_scenario = p_data->scenario;
+	const Transform &p_cam_transform = p_data->cam_transform;
+	const CameraMatrix &p_cam_projection = p_data->cam_projection;
+	bool p_cam_orthogonal = p_data->cam_orthogonal;
 
 	switch (VSG::storage->light_get_type(p_instance->base)) {
 
@@ -1273,8 +1324,8 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 			if (depth_range_mode == VS::LIGHT_DIRECTIONAL_SHADOW_DEPTH_RANGE_OPTIMIZED) {
 				//optimize min/max
-				Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
-				int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+				LocalVector<Instance *> &range_cull = p_job->passes[0].instances;
+				p_scenario->index->cull_convex_threadsafe(p_data->cam_planes, range_cull, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
 				Plane base(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2));
 				//check distance max and min
 
@@ -1282,10 +1333,10 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 				float z_max = -1e20;
 				float z_min = 1e20;
 
-				for (int i = 0; i < cull_count; i++) {
+				for (uint32_t i = 0; i < range_cull.size(); i++) {
 
-					Instance *instance = instance_shadow_cull_result[i];
-					if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
+					Instance *instance = range_cull[i];
+					if (!_is_shadow_caster(instance)) {
 						continue;
 					}
 
@@ -1327,14 +1378,18 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 			distances[splits] = max_distance;
 
-			float texture_size = VSG::scene_render->get_directional_light_shadow_size(light->instance);
+			float texture_size = p_job->directional_texture_size;
 
 			bool overlap = VSG::storage->light_directional_get_blend_splits(p_instance->base);
 
 			float first_radius = 0.0;
 
+			p_job->pass_count = splits;
+
 			for (int i = 0; i < splits; i++) {
 
+				p_job->passes[i].active = false;
+
 				// setup a camera matrix for that range!
 				CameraMatrix camera_matrix;
 
@@ -1465,26 +1520,16 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 				light_frustum_planes[4] = Plane(z_vec, z_max + 1e6);
 				light_frustum_planes[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
 
-				int cull_count = p_scenario->octree.cull_convex(light_frustum_planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+				ShadowCullPass &pass = p_job->passes[i];
+				p_scenario->index->cull_convex_threadsafe(light_frustum_planes, pass.instances, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+				_remove_non_shadow_casters(pass.instances);
 
 				// a pre pass will need to be needed to determine the actual z-near to be used
 
-				Plane near_plane(p_instance->transform.origin, -p_instance->transform.basis.get_axis(2));
-
-				for (int j = 0; j < cull_count; j++) {
+				for (uint32_t j = 0; j < pass.instances.size(); j++) {
 
 					float min, max;
-					Instance *instance = instance_shadow_cull_result[j];
-					if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-						cull_count--;
-						SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-						j--;
-						continue;
-					}
-
-					instance->transformed_aabb.project_range_in_plane(Plane(z_vec, 0), min, max);
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
+					pass.instances[j]->transformed_aabb.project_range_in_plane(Plane(z_vec, 0), min, max);
 					if (max > z_max)
 						z_max = max;
 				}
@@ -1501,10 +1546,14 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 					ortho_transform.basis = transform.basis;
 					ortho_transform.origin = x_vec * (x_min_cam + half_x) + y_vec * (y_min_cam + half_y) + z_vec * z_max;
 
-					VSG::scene_render->light_instance_set_shadow_transform(light->instance, ortho_camera, ortho_transform, 0, distances[i + 1], i, bias_scale);
+					pass.near_plane = Plane(p_instance->transform.origin, -p_instance->transform.basis.get_axis(2));
+					pass.projection = ortho_camera;
+					pass.transform = ortho_transform;
+					pass.far = 0;
+					pass.split = distances[i + 1];
+					pass.bias_scale = bias_scale;
+					pass.active = true;
 				}
-
-				VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
 			}
 
 		} break;
@@ -1530,25 +1579,20 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 						planes[3] = p_instance->transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
 						planes[4] = p_instance->transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
 
-						int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
-						Plane near_plane(p_instance->transform.origin, p_instance->transform.basis.get_axis(2) * z);
-
-						for (int j = 0; j < cull_count; j++) {
-
-							Instance *instance = instance_shadow_cull_result[j];
-							if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-								cull_count--;
-								SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-								j--;
-							} else {
-								instance->depth = near_plane.distance_to(instance->transform.origin);
-								instance->depth_layer = 0;
-							}
-						}
-
-						VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), p_instance->transform, radius, 0, i);
-						VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+						ShadowCullPass &pass = p_job->passes[i];
+						p_scenario->index->cull_convex_threadsafe(planes, pass.instances, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+						_remove_non_shadow_casters(pass.instances);
+
+						pass.near_plane = Plane(p_instance->transform.origin, p_instance->transform.basis.get_axis(2) * z);
+						pass.projection = CameraMatrix();
+						pass.transform = p_instance->transform;
+						pass.far = radius;
+						pass.split = 0;
+						pass.bias_scale = 1.0;
+						pass.active = true;
 					}
+
+					p_job->pass_count = 2;
 				} break;
 				case VS::LIGHT_OMNI_SHADOW_CUBE: {
 
@@ -1581,28 +1625,22 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 						Vector<Plane> planes = cm.get_projection_planes(xform);
 
-						int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
-
-						Plane near_plane(xform.origin, -xform.basis.get_axis(2));
-						for (int j = 0; j < cull_count; j++) {
-
-							Instance *instance = instance_shadow_cull_result[j];
-							if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-								cull_count--;
-								SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-								j--;
-							} else {
-								instance->depth = near_plane.distance_to(instance->transform.origin);
-								instance->depth_layer = 0;
-							}
-						}
-
-						VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, xform, radius, 0, i);
-						VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+						ShadowCullPass &pass = p_job->passes[i];
+						p_scenario->index->cull_convex_threadsafe(planes, pass.instances, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+						_remove_non_shadow_casters(pass.instances);
+
+						pass.near_plane = Plane(xform.origin, -xform.basis.get_axis(2));
+						pass.projection = cm;
+						pass.transform = xform;
+						pass.far = radius;
+						pass.split = 0;
+						pass.bias_scale = 1.0;
+						pass.active = true;
 					}
 
-					//restore the regular DP matrix
-					VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), p_instance->transform, radius, 0, 0);
+					p_job->pass_count = 6;
+					//restore the regular DP matrix after rendering
+					p_job->restore_transform = true;
 
 				} break;
 			}
@@ -1617,29 +1655,83 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 			cm.set_perspective(angle * 2.0, 1.0, 0.01, radius);
 
 			Vector<Plane> planes = cm.get_projection_planes(p_instance->transform);
-			int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
 
-			Plane near_plane(p_instance->transform.origin, -p_instance->transform.basis.get_axis(2));
-			for (int j = 0; j < cull_count; j++) {
+			ShadowCullPass &pass = p_job->passes[0];
+			p_scenario->index->cull_convex_threadsafe(planes, pass.instances, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+			_remove_non_shadow_casters(pass.instances);
 
-				Instance *instance = instance_shadow_cull_result[j];
-				if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-					cull_count--;
-					SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-					j--;
-				} else {
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
-				}
-			}
+			pass.near_plane = Plane(p_instance->transform.origin, -p_instance->transform.basis.get_axis(2));
+			pass.projection = cm;
+			pass.transform = p_instance->transform;
+			pass.far = radius;
+			pass.split = 0;
+			pass.bias_scale = 1.0;
+			pass.active = true;
 
-			VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, p_instance->transform, radius, 0, 0);
-			VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, 0, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+			p_job->pass_count = 1;
 
 		} break;
 	}
 }
 
+void VisualServerScene::_light_instance_render_shadow(ShadowCullJob *p_job, RID p_shadow_atlas) {
+
+	InstanceLightData *light = static_cast<InstanceLightData *>(p_job->light->base_data);
+
+	for (int i = 0; i < p_job->pass_count; i++) {
+
+		ShadowCullPass &pass = p_job->passes[i];
+		if (!pass.active)
+			continue;
+
+		// Depth is stored in the instances, so it can only be set right before rendering each pass.
+		for (uint32_t j = 0; j < pass.instances.size(); j++) {
+
+			Instance *instance = pass.instances[j];
+			instance->depth = pass.near_plane.distance_to(instance->transform.origin);
+			instance->depth_layer = 0;
+		}
+
+		VSG::scene_render->light_instance_set_shadow_transform(light->instance, pass.projection, pass.transform, pass.far, pass.split, i, pass.bias_scale);
+		VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)pass.instances.ptr(), pass.instances.size());
+	}
+
+	if (p_job->restore_transform) {
+		VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), p_job->light->transform, p_job->passes[0].far, 0, 0);
+	}
+}
+
+void VisualServerScene::_cull_job(uint32_t p_index, CullData *p_data) {
+
+	if (p_data->cull_camera) {
+		if (p_index == 0) {
+			p_data->scenario->index->cull_convex_threadsafe(p_data->cam_planes, instance_cull_result, MAX_INSTANCE_CULL);
+			return;
+		}
+		p_index--;
+	}
+
+	_light_instance_cull_shadow(&shadow_cull_jobs[p_data->first_job + p_index], p_data);
+}
+
+void VisualServerScene::_run_cull_jobs(CullData *p_data, uint32_t p_job_count) {
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	ThreadPool *pool = ThreadPool::get_singleton();
+
+	if (thread_cull && pool && p_job_count > 1) {
+		ThreadPool::GroupID group = pool->add_template_group_task(this, &VisualServerScene::_cull_job, p_data, p_job_count);
+		pool->wait_for_group(group);
+	} else {
+		for (uint32_t i = 0; i < p_job_count; i++) {
+			_cull_job(i, p_data);
+		}
+	}
+
+	cull_time_usec += OS::get_singleton()->get_ticks_usec() - begin;
+}
+
 void VisualServerScene::render_camera(RID p_camera, RID p_scenario, Size2 p_viewport_size, RID p_shadow_atlas) {
 	// render to mono camera
 
@@ -1707,13 +1799,48 @@ void VisualServerScene::_render_scene(const Transform p_cam_transform, const Cam
 
 	//rasterizer->set_camera(camera->transform, camera_matrix,ortho);
 
-	Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
+	CullData cull_data;
+	cull_data.cam_transform = p_cam_transform;
+	cull_data.cam_projection = p_cam_projection;
+	cull_data.cam_planes = p_cam_projection.get_projection_planes(p_cam_transform);
+	cull_data.cam_orthogonal = p_cam_orthogonal;
+	cull_data.scenario = scenario;
 
 	Plane near_plane(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2).normalized());
 	float z_far = p_cam_projection.get_z_far();
 
+	/* STEP 1 - DIRECTIONAL SHADOWS */
+
+	// They only depend on the camera, so they are culled along with it.
+	shadow_cull_job_count = 0;
+
+	if (p_shadow_atlas.is_valid()) {
+
+		for (List<Instance *>::Element *E = scenario->directional_lights.front(); E; E = E->next()) {
+
+			if (E->get()->visible && E->get()->base_data && VSG::storage->light_has_shadow(E->get()->base)) {
+				_add_shadow_cull_job(E->get());
+			}
+		}
+	}
+
+	uint32_t directional_shadow_count = shadow_cull_job_count;
+
+	VSG::scene_render->set_directional_shadow_count(directional_shadow_count);
+
+	for (uint32_t i = 0; i < directional_shadow_count; i++) {
+
+		InstanceLightData *light = static_cast<InstanceLightData *>(shadow_cull_jobs[i].light->base_data);
+		shadow_cull_jobs[i].directional_texture_size = VSG::scene_render->get_directional_light_shadow_size(light->instance);
+	}
+
 	/* STEP 2 - CULL */
-	int cull_count = scenario->octree.cull_convex(planes, instance_cull_result, MAX_INSTANCE_CULL);
+
+	cull_data.cull_camera = true;
+	cull_data.first_job = 0;
+	_run_cull_jobs(&cull_data, 1 + directional_shadow_count);
+
+	int cull_count = instance_cull_result.size();
 	light_cull_count = 0;
 
 	reflection_probe_cull_count = 0;
@@ -1875,9 +2002,6 @@ void VisualServerScene::_render_scene(const Transform p_cam_transform, const Cam
 	// directional lights
 	{
 
-		Instance **lights_with_shadow = (Instance **)alloca(sizeof(Instance *) * scenario->directional_lights.size());
-		int directional_shadow_count = 0;
-
 		for (List<Instance *>::Element *E = scenario->directional_lights.front(); E; E = E->next()) {
 
 			if (light_cull_count + directional_light_count >= MAX_LIGHTS_CULLED) {
@@ -1889,22 +2013,15 @@ void VisualServerScene::_render_scene(const Transform p_cam_transform, const Cam
 
 			InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
 
-			//check shadow..
-
 			if (light) {
-				if (p_shadow_atlas.is_valid() && VSG::storage->light_has_shadow(E->get()->base)) {
-					lights_with_shadow[directional_shadow_count++] = E->get();
-				}
 				//add to list
 				directional_light_ptr[directional_light_count++] = light->instance;
 			}
 		}
 
-		VSG::scene_render->set_directional_shadow_count(directional_shadow_count);
+		for (uint32_t i = 0; i < directional_shadow_count; i++) {
 
-		for (int i = 0; i < directional_shadow_count; i++) {
-
-			_light_instance_update_shadow(lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+			_light_instance_render_shadow(&shadow_cull_jobs[i], p_shadow_atlas);
 		}
 	}
 
@@ -2003,9 +2120,18 @@ void VisualServerScene::_render_scene(const Transform p_cam_transform, const Cam
 
 			if (redraw) {
 				//must redraw!
-				_light_instance_update_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+				_add_shadow_cull_job(ins);
 			}
 		}
+
+		cull_data.cull_camera = false;
+		cull_data.first_job = directional_shadow_count;
+		_run_cull_jobs(&cull_data, shadow_cull_job_count - directional_shadow_count);
+
+		for (uint32_t i = directional_shadow_count; i < shadow_cull_job_count; i++) {
+
+			_light_instance_render_shadow(&shadow_cull_jobs[i], p_shadow_atlas);
+		}
 	}
 
 	/* ENVIRONMENT */
@@ -2020,7 +2146,7 @@ void VisualServerScene::_render_scene(const Transform p_cam_transform, const Cam
 
 	/* STEP 6 - PROCESS GEOMETRY AND DRAW SCENE*/
 
-	VSG::scene_render->render_scene(p_cam_transform, p_cam_projection, p_cam_orthogonal, (RasterizerScene::InstanceBase **)instance_cull_result, cull_count, light_instance_cull_result, light_cull_count + directional_light_count, reflection_probe_instance_cull_result, reflection_probe_cull_count, environment, p_shadow_atlas, scenario->reflection_atlas, p_reflection_probe, p_reflection_probe_pass);
+	VSG::scene_render->render_scene(p_cam_transform, p_cam_projection, p_cam_orthogonal, (RasterizerScene::InstanceBase **)instance_cull_result.ptr(), cull_count, light_instance_cull_result, light_cull_count + directional_light_count, reflection_probe_instance_cull_result, reflection_probe_cull_count, environment, p_shadow_atlas, scenario->reflection_atlas, p_reflection_probe, p_reflection_probe_pass);
 }
 
 void VisualServerScene::render_empty_scene(RID p_scenario, RID p_shadow_atlas) {
@@ -3268,20 +3394,29 @@ void VisualServerScene::update_dirty_instances() {
 
 	VSG::storage->update_dirty_resources();
 
-	while (_instance_update_list.first()) {
+	do {
 
-		_update_dirty_instance(_instance_update_list.first()->self());
-	}
+		while (_instance_update_list.first()) {
+
+			_update_dirty_instance(_instance_update_list.first()->self());
+		}
+
+		// report the pairs of everything moved above in one go, pairing may dirty instances again
+		while (_scenario_update_list.first()) {
+
+			Scenario *scenario = _scenario_update_list.first()->self();
+			_scenario_update_list.remove(&scenario->update_item);
+			scenario->index->update();
+		}
+
+	} while (_instance_update_list.first());
 }
 
 bool VisualServerScene::free(RID p_rid) {
 
 	if (camera_owner.owns(p_rid)) {
 
-		Camera *camera = camera_owner.get(p_rid);
-
 		camera_owner.free(p_rid);
-		memdelete(camera);
 
 	} else if (scenario_owner.owns(p_rid)) {
 
@@ -3292,16 +3427,14 @@ bool VisualServerScene::free(RID p_rid) {
 		}
 		VSG::scene_render->free(scenario->reflection_probe_shadow_atlas);
 		VSG::scene_render->free(scenario->reflection_atlas);
+		memdelete(scenario->index);
 		scenario_owner.free(p_rid);
-		memdelete(scenario);
 
 	} else if (instance_owner.owns(p_rid)) {
 		// delete the instance
 
 		update_dirty_instances();
 
-		Instance *instance = instance_owner.get(p_rid);
-
 		instance_set_use_lightmap(p_rid, RID(), RID());
 		instance_set_scenario(p_rid, RID());
 		instance_set_base(p_rid, RID());
@@ -3311,7 +3444,6 @@ bool VisualServerScene::free(RID p_rid) {
 		update_dirty_instances(); //in case something changed this
 
 		instance_owner.free(p_rid);
-		memdelete(instance);
 	} else {
 		return false;
 	}
@@ -3332,6 +3464,18 @@ VisualServerScene::VisualServerScene() {
 
 	render_pass = 1;
 	singleton = this;
+
+	shadow_cull_job_count = 0;
+	cull_time_usec = 0;
+	thread_cull = GLOBAL_DEF("rendering/threads/thread_culling", true);
+
+	String scenario_index = GLOBAL_DEF("rendering/quality/spatial_partitioning/scenario_index", "Octree");
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/spatial_partitioning/scenario_index", PropertyInfo(Variant::STRING, "rendering/quality/spatial_partitioning/scenario_index", PROPERTY_HINT_ENUM, "Octree,BVH"));
+	if (scenario_index == "BVH") {
+		ScenarioIndex::create_func = ScenarioIndexBVH::_create;
+	} else {
+		ScenarioIndex::create_func = ScenarioIndexOctree::_create;
+	}
 }
 
 VisualServerScene::~VisualServerScene() {
@@ -35,12 +35,14 @@
 
 #include "allocators.h"
 #include "geometry.h"
-#include "octree.h"
+#include "local_vector.h"
 #include "os/semaphore.h"
 #include "os/thread.h"
 #include "self_list.h"
 #include "servers/arvr/arvr_interface.h"
 
+class ScenarioIndex;
+
 class VisualServerScene {
 public:
 	enum {
@@ -102,7 +104,7 @@ public:
 		}
 	};
 
-	mutable RID_Owner<Camera> camera_owner;
+	mutable RID_SlabOwner<Camera> camera_owner;
 
 	virtual RID camera_create();
 	virtual void camera_set_perspective(RID p_camera, float p_fovy_degrees, float p_z_near, float p_z_far);
@@ -120,9 +122,9 @@ public:
 
 		VS::ScenarioDebugMode debug;
 		RID self;
-		// well wtf, balloon allocator is slower?
 
-		Octree<Instance, true> octree;
+		ScenarioIndex *index;
+		SelfList<Scenario> update_item; // index has moves to pair
 
 		List<Instance *> directional_lights;
 		RID environment;
@@ -132,13 +134,20 @@ public:
 
 		SelfList<Instance>::List instances;
 
-		Scenario() { debug = VS::SCENARIO_DEBUG_DISABLED; }
+		Scenario() :
+				update_item(this) {
+			debug = VS::SCENARIO_DEBUG_DISABLED;
+			index = NULL;
+		}
 	};
 
-	mutable RID_Owner<Scenario> scenario_owner;
+	mutable RID_SlabOwner<Scenario> scenario_owner;
 
-	static void *_instance_pair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int);
-	static void _instance_unpair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int, void *);
+	SelfList<Scenario>::List _scenario_update_list;
+	void _scenario_queue_update(Scenario *p_scenario);
+
+	static void *_instance_pair(void *p_self, Instance *p_A, Instance *p_B);
+	static void _instance_unpair(void *p_self, Instance *p_A, Instance *p_B, void *p_pair_data);
 
 	virtual RID scenario_create();
 
@@ -158,7 +167,7 @@ public:
 
 		RID self;
 		//scenario stuff
-		OctreeElementID octree_id;
+		uint32_t index_id; // ScenarioIndex::ID
 		Scenario *scenario;
 		SelfList<Instance> scenario_item;
 
@@ -206,7 +215,7 @@ public:
 				scenario_item(this),
 				update_item(this) {
 
-			octree_id = 0;
+			index_id = 0;
 			scenario = NULL;
 
 			update_aabb = false;
@@ -434,15 +443,14 @@ public:
 		}
 	};
 
-	Instance *instance_cull_result[MAX_INSTANCE_CULL];
-	Instance *instance_shadow_cull_result[MAX_INSTANCE_CULL]; //used for generating shadowmaps
+	LocalVector<Instance *> instance_cull_result;
 	Instance *light_cull_result[MAX_LIGHTS_CULLED];
 	RID light_instance_cull_result[MAX_LIGHTS_CULLED];
 	int light_cull_count;
 	RID reflection_probe_instance_cull_result[MAX_REFLECTION_PROBES_CULLED];
 	int reflection_probe_cull_count;
 
-	RID_Owner<Instance> instance_owner;
+	RID_SlabOwner<Instance> instance_owner;
 
 	// from can be mesh, light,  area and portal so far.
 	virtual RID instance_create(); // from can be mesh, light, poly, area and portal so far.
@@ -481,7 +489,52 @@ public:
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 
-	_FORCE_INLINE_ void _light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario);
+	// Shadow maps are culled in parallel (one job per light, each with its own results) and rendered afterwards.
+	struct ShadowCullPass {
+
+		LocalVector<Instance *> instances;
+		Plane near_plane; // sorts the casters
+		CameraMatrix projection;
+		Transform transform;
+		float far;
+		float split;
+		float bias_scale;
+		bool active;
+	};
+
+	struct ShadowCullJob {
+
+		Instance *light;
+		float directional_texture_size;
+		int pass_count;
+		ShadowCullPass passes[6];
+		bool restore_transform; // cube shadows go back to the dual paraboloid transform when done
+	};
+
+	struct CullData {
+
+		Transform cam_transform;
+		CameraMatrix cam_projection;
+		Vector<Plane> cam_planes;
+		bool cam_orthogonal;
+		Scenario *scenario;
+		bool cull_camera; // job 0 culls the camera frustum
+		uint32_t first_job;
+	};
+
+	LocalVector<ShadowCullJob> shadow_cull_jobs;
+	uint32_t shadow_cull_job_count;
+	bool thread_cull;
+	uint64_t cull_time_usec;
+
+	ShadowCullJob *_add_shadow_cull_job(Instance *p_light);
+	void _cull_job(uint32_t p_index, CullData *p_data);
+	void _run_cull_jobs(CullData *p_data, uint32_t p_job_count);
+	void _light_instance_cull_shadow(ShadowCullJob *p_job, const CullData *p_data);
+	void _light_instance_render_shadow(ShadowCullJob *p_job, RID p_shadow_atlas);
+
+	void cull_time_reset() { cull_time_usec = 0; }
+	uint64_t get_cull_time_usec() const { return cull_time_usec; }
 
 	void _render_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass);
 	void render_empty_scene(RID p_scenario, RID p_shadow_atlas);
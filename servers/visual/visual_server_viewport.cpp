@@ -293,6 +293,7 @@ void VisualServerViewport::draw_viewports() {
 
 			VSG::scene_render->set_debug_draw_mode(vp->debug_draw);
 			VSG::storage->render_info_begin_capture();
+			VSG::scene->cull_time_reset();
 
 			// render standard mono camera
 			_draw_viewport(vp);
@@ -304,6 +305,7 @@ void VisualServerViewport::draw_viewports() {
 			vp->render_info[VS::VIEWPORT_RENDER_INFO_SHADER_CHANGES_IN_FRAME] = VSG::storage->get_captured_render_info(VS::INFO_SHADER_CHANGES_IN_FRAME);
 			vp->render_info[VS::VIEWPORT_RENDER_INFO_SURFACE_CHANGES_IN_FRAME] = VSG::storage->get_captured_render_info(VS::INFO_SURFACE_CHANGES_IN_FRAME);
 			vp->render_info[VS::VIEWPORT_RENDER_INFO_DRAW_CALLS_IN_FRAME] = VSG::storage->get_captured_render_info(VS::INFO_DRAW_CALLS_IN_FRAME);
+			vp->render_info[VS::VIEWPORT_RENDER_INFO_CULL_TIME_IN_FRAME] = VSG::scene->get_cull_time_usec();
 
 			if (vp->viewport_to_screen_rect != Rect2()) {
 				//copy to screen if set as such
@@ -321,9 +323,8 @@ void VisualServerViewport::draw_viewports() {
 
 RID VisualServerViewport::viewport_create() {
 
-	Viewport *viewport = memnew(Viewport);
-
-	RID rid = viewport_owner.make_rid(viewport);
+	RID rid = viewport_owner.make_rid();
+	Viewport *viewport = viewport_owner.get(rid);
 
 	viewport->self = rid;
 	viewport->hide_scenario = false;
@@ -634,7 +635,6 @@ bool VisualServerViewport::free(RID p_rid) {
 		active_viewports.erase(viewport);
 
 		viewport_owner.free(p_rid);
-		memdelete(viewport);
 
 		return true;
 	}
@@ -118,7 +118,7 @@ public:
 		}
 	};
 
-	mutable RID_Owner<Viewport> viewport_owner;
+	mutable RID_SlabOwner<Viewport> viewport_owner;
 
 	struct ViewportSort {
 		_FORCE_INLINE_ bool operator()(const Viewport *p_left, const Viewport *p_right) const {